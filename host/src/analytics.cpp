@@ -0,0 +1,345 @@
+#include "analytics.h"
+#include "recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#define ANALYTICS_CHUNK     16          // Roasts claimed per worker step
+
+// ============== Column Kernels ==============
+
+// Replaces missing chamber readings with the last good one
+static void _fill_forward(float* values, size_t n) {
+    float last = NAN;
+    for (size_t i = 0; i < n; i++) {
+        if (std::isnan(values[i])) values[i] = last;
+        else last = values[i];
+    }
+    // Leading gap takes the first good reading
+    size_t first = 0;
+    while (first < n && std::isnan(values[first])) first++;
+    for (size_t i = 0; i < first && first < n; i++) values[i] = values[first];
+}
+
+// Trailing-window rate of rise in °C/min
+static void _ror(const float* time, const float* temp, float* ror, size_t n) {
+    size_t j = 0;
+    for (size_t i = 0; i < n; i++) {
+        while (time[i] - time[j] > ANALYTICS_ROR_WINDOW_MS) j++;
+        float span = time[i] - time[j];
+        ror[i] = span >= ANALYTICS_ROR_WINDOW_MS / 2 ? (temp[i] - temp[j]) * 60000.0f / span : 0.0f;
+    }
+}
+
+// Time-weighted sum of values over [first, last), in value·ms
+static double _integrate(const float* time, const float* values, size_t first, size_t last) {
+    double sum = 0;
+    for (size_t i = first; i + 1 < last; i++) {
+        sum += (double)values[i] * (time[i + 1] - time[i]);
+    }
+    return sum;
+}
+
+static size_t _index_at(const float* time, size_t n, float t) {
+    return std::lower_bound(time, time + n, t) - time;
+}
+
+// ============== Milestones ==============
+
+static long _find_charge(const RoastView& roast, const float* time, const float* chamber,
+                         const float* setpoint, const float* state, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (state[i] == ROAST_STATE_ROASTING) return (long)i;
+    }
+
+    // UI exports: loadBeans switches the setpoint from preheat to roast
+    const ArchiveEntry& entry = roast.entry();
+    if (entry.roast_setpoint > 0 && fabsf(entry.roast_setpoint - entry.preheat_setpoint) > 0.5f) {
+        for (size_t i = 1; i < n; i++) {
+            if (fabsf(setpoint[i] - setpoint[i - 1]) > 0.5f && fabsf(setpoint[i] - entry.roast_setpoint) < 0.5f) {
+                return (long)i;
+            }
+        }
+    }
+
+    // Otherwise the largest chamber drop within a minute marks the charge
+    long best = -1;
+    float best_drop = ANALYTICS_CHARGE_DROP_C;
+    for (size_t i = 0; i < n; i++) {
+        float low = chamber[i];
+        for (size_t k = i; k < n && time[k] - time[i] <= 60000; k++) low = std::min(low, chamber[k]);
+        if (chamber[i] - low > best_drop) {
+            best_drop = chamber[i] - low;
+            best = (long)i;
+        }
+    }
+    return best;
+}
+
+// ============== Per-Roast Analysis ==============
+
+RoastMetrics analyze_roast(const RoastView& roast, RoastColumnsScratch& s, float heater_watts) {
+    RoastMetrics m;
+    size_t n = roast.size();
+    m.samples = (uint32_t)n;
+    if (n < 2) return m;
+
+    s.time.resize(n);
+    s.chamber.resize(n);
+    s.setpoint.resize(n);
+    s.ror.resize(n);
+    s.power.resize(n);
+    s.state.resize(n);
+    roast.decode(ArchiveColumn::TIME, 0, n, s.time.data());
+    roast.decode(ArchiveColumn::CHAMBER, 0, n, s.chamber.data());
+    roast.decode(ArchiveColumn::SETPOINT, 0, n, s.setpoint.data());
+    roast.decode(ArchiveColumn::POWER, 0, n, s.power.data());
+    roast.decode(ArchiveColumn::STATE, 0, n, s.state.data());
+
+    const float* t = s.time.data();
+    float* chamber = s.chamber.data();
+    const float* setpoint = s.setpoint.data();
+    const float* power = s.power.data();
+    const float* state = s.state.data();
+    float* ror = s.ror.data();
+
+    _fill_forward(chamber, n);
+    if (std::isnan(chamber[0])) return m;       // No readings at all
+    _ror(t, chamber, ror, n);
+
+    double wh_scale = heater_watts / 100.0 / 3.6e6;   // %·ms -> Wh
+    m.heater_wh = (float)(_integrate(t, power, 0, n) * wh_scale);
+
+    long charge = _find_charge(roast, t, chamber, setpoint, state, n);
+    if (charge < 0) return m;
+    m.charge_ms = (int32_t)t[charge];
+    m.charge_temp = chamber[charge];
+
+    // Turning point
+    size_t tp_end = _index_at(t, n, t[charge] + ANALYTICS_TP_WINDOW_MS);
+    size_t tp = charge;
+    for (size_t i = charge; i < tp_end; i++) {
+        if (chamber[i] < chamber[tp]) tp = i;
+    }
+    m.turning_point_ms = (int32_t)t[tp];
+    m.turning_point_temp = chamber[tp];
+
+    // Drop: last ROASTING sample, else the last one with heat applied
+    long drop = -1;
+    for (long i = (long)n - 1; i >= charge && drop < 0; i--) {
+        if (state[i] == ROAST_STATE_ROASTING) drop = i;
+    }
+    if (drop < 0) {
+        for (long i = (long)n - 1; i >= charge && drop < 0; i--) {
+            if (power[i] > 0) drop = i;
+        }
+    }
+    if (drop <= charge) drop = (long)n - 1;
+    m.drop_ms = (int32_t)t[drop];
+    m.drop_temp = chamber[drop];
+
+    for (size_t i = tp; i <= (size_t)drop; i++) {
+        if (chamber[i] >= ANALYTICS_DRY_END_C) {
+            m.dry_end_ms = (int32_t)t[i];
+            break;
+        }
+    }
+
+    const ArchiveEntry& entry = roast.entry();
+    if (entry.first_crack_ms > (uint32_t)m.charge_ms) m.first_crack_ms = (int32_t)entry.first_crack_ms;
+
+    // Phases and DTR
+    int32_t roast_ms = m.drop_ms - m.charge_ms;
+    if (m.dry_end_ms >= 0) m.drying_ms = m.dry_end_ms - m.charge_ms;
+    if (m.first_crack_ms >= 0 && m.first_crack_ms <= m.drop_ms) {
+        if (m.dry_end_ms >= 0) m.maillard_ms = m.first_crack_ms - m.dry_end_ms;
+        m.development_ms = m.drop_ms - m.first_crack_ms;
+        if (roast_ms > 0) m.dtr = 100.0f * m.development_ms / roast_ms;
+    }
+
+    // RoR
+    for (size_t i = tp; i <= (size_t)drop; i++) m.peak_ror = std::max(m.peak_ror, ror[i]);
+    m.ror_at_drop = ror[drop];
+    if (m.first_crack_ms >= 0) {
+        size_t fc = std::min(_index_at(t, n, (float)m.first_crack_ms), (size_t)drop);
+        m.ror_at_fc = ror[fc];
+        float high = ror[fc];
+        for (size_t i = fc; i <= (size_t)drop; i++) {
+            high = std::max(high, ror[i]);
+            m.ror_crash = std::max(m.ror_crash, high - ror[i]);
+        }
+    }
+
+    // Energy and output over the roast proper
+    if (roast_ms > 0) {
+        double power_ms = _integrate(t, power, charge, drop + 1);
+        m.roast_wh = (float)(power_ms * wh_scale);
+        m.heater_duty = (float)(power_ms / roast_ms);
+    }
+
+    // Setpoint tracking once the charge has been recovered
+    size_t settled = _index_at(t, n, t[charge] + ANALYTICS_SETTLE_MS);
+    double abs_sum = 0, sq_sum = 0;
+    float overshoot = -INFINITY;
+    size_t saturated = 0, count = 0;
+    for (size_t i = settled; i <= (size_t)drop; i++) {
+        float err = chamber[i] - setpoint[i];
+        abs_sum += fabsf(err);
+        sq_sum += err * err;
+        overshoot = std::max(overshoot, err);
+        saturated += power[i] >= 99.5f;
+        count++;
+    }
+    if (count) {
+        m.track_mae = (float)(abs_sum / count);
+        m.track_rms = (float)sqrt(sq_sum / count);
+        m.overshoot = std::max(0.0f, overshoot);
+        m.saturation = 100.0f * saturated / count;
+    }
+    return m;
+}
+
+std::vector<RoastMetrics> analyze_archive(const Archive& archive, const std::vector<size_t>& roasts,
+                                          unsigned threads, float heater_watts) {
+    std::vector<RoastMetrics> results(roasts.size());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<unsigned>(threads, (unsigned)((roasts.size() + ANALYTICS_CHUNK - 1) / ANALYTICS_CHUNK));
+
+    std::atomic<size_t> next { 0 };
+    auto worker = [&]() {
+        RoastColumnsScratch scratch;
+        for (;;) {
+            size_t first = next.fetch_add(ANALYTICS_CHUNK, std::memory_order_relaxed);
+            if (first >= roasts.size()) return;
+            size_t last = std::min(first + ANALYTICS_CHUNK, roasts.size());
+            for (size_t i = first; i < last; i++) {
+                results[i] = analyze_roast(archive.roast(roasts[i]), scratch, heater_watts);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& thread : pool) thread.join();
+    return results;
+}
+
+// ============== Distributions ==============
+
+static double _ms_to_s(int32_t ms) {
+    return ms >= 0 ? ms / 1000.0 : NAN;
+}
+
+static double _if_set(float value) {
+    return value >= 0 ? value : NAN;
+}
+
+const std::vector<MetricField>& metric_fields() {
+    static const std::vector<MetricField> fields = {
+        { "charge_temp",     "°C",    [](const RoastMetrics& m) { return m.charge_ms >= 0 ? (double)m.charge_temp : NAN; } },
+        { "turning_point",   "s",     [](const RoastMetrics& m) { return m.turning_point_ms >= 0 ? _ms_to_s(m.turning_point_ms - m.charge_ms) : NAN; } },
+        { "turning_temp",    "°C",    [](const RoastMetrics& m) { return m.turning_point_ms >= 0 ? (double)m.turning_point_temp : NAN; } },
+        { "drying",          "s",     [](const RoastMetrics& m) { return _ms_to_s(m.drying_ms); } },
+        { "maillard",        "s",     [](const RoastMetrics& m) { return _ms_to_s(m.maillard_ms); } },
+        { "development",     "s",     [](const RoastMetrics& m) { return _ms_to_s(m.development_ms); } },
+        { "first_crack",     "s",     [](const RoastMetrics& m) { return m.first_crack_ms >= 0 ? _ms_to_s(m.first_crack_ms - m.charge_ms) : NAN; } },
+        { "roast_time",      "s",     [](const RoastMetrics& m) { return m.drop_ms >= 0 ? _ms_to_s(m.drop_ms - m.charge_ms) : NAN; } },
+        { "drop_temp",       "°C",    [](const RoastMetrics& m) { return m.drop_ms >= 0 ? (double)m.drop_temp : NAN; } },
+        { "dtr",             "%",     [](const RoastMetrics& m) { return _if_set(m.dtr); } },
+        { "peak_ror",        "°C/min", [](const RoastMetrics& m) { return m.charge_ms >= 0 ? (double)m.peak_ror : NAN; } },
+        { "ror_at_fc",       "°C/min", [](const RoastMetrics& m) { return m.first_crack_ms >= 0 ? (double)m.ror_at_fc : NAN; } },
+        { "ror_at_drop",     "°C/min", [](const RoastMetrics& m) { return m.drop_ms >= 0 ? (double)m.ror_at_drop : NAN; } },
+        { "ror_crash",       "°C/min", [](const RoastMetrics& m) { return m.first_crack_ms >= 0 ? (double)m.ror_crash : NAN; } },
+        { "heater_energy",   "Wh",    [](const RoastMetrics& m) { return m.samples >= 2 ? (double)m.heater_wh : NAN; } },
+        { "roast_energy",    "Wh",    [](const RoastMetrics& m) { return m.charge_ms >= 0 ? (double)m.roast_wh : NAN; } },
+        { "heater_duty",     "%",     [](const RoastMetrics& m) { return m.charge_ms >= 0 ? (double)m.heater_duty : NAN; } },
+        { "track_mae",       "°C",    [](const RoastMetrics& m) { return m.charge_ms >= 0 ? (double)m.track_mae : NAN; } },
+        { "track_rms",       "°C",    [](const RoastMetrics& m) { return m.charge_ms >= 0 ? (double)m.track_rms : NAN; } },
+        { "overshoot",       "°C",    [](const RoastMetrics& m) { return m.charge_ms >= 0 ? (double)m.overshoot : NAN; } },
+        { "saturation",      "%",     [](const RoastMetrics& m) { return m.charge_ms >= 0 ? (double)m.saturation : NAN; } },
+    };
+    return fields;
+}
+
+static double _percentile(const std::vector<double>& sorted, double p) {
+    double pos = p * (sorted.size() - 1);
+    size_t lo = (size_t)pos;
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+std::vector<MetricSummary> summarize_metrics(const std::vector<RoastMetrics>& metrics) {
+    std::vector<MetricSummary> summaries;
+    std::vector<double> values;
+    for (const MetricField& field : metric_fields()) {
+        values.clear();
+        for (const RoastMetrics& m : metrics) {
+            double v = field.get(m);
+            if (!std::isnan(v)) values.push_back(v);
+        }
+
+        MetricSummary summary;
+        summary.name = field.name;
+        summary.count = values.size();
+        if (!values.empty()) {
+            std::sort(values.begin(), values.end());
+            double sum = 0, sq = 0;
+            for (double v : values) sum += v;
+            summary.mean = sum / values.size();
+            for (double v : values) sq += (v - summary.mean) * (v - summary.mean);
+            summary.stddev = sqrt(sq / values.size());
+            summary.min = values.front();
+            summary.max = values.back();
+            summary.p10 = _percentile(values, 0.10);
+            summary.p50 = _percentile(values, 0.50);
+            summary.p90 = _percentile(values, 0.90);
+        }
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+// ============== Downsampling ==============
+
+static void _collect(uint32_t index, void* context) {
+    ((std::vector<uint32_t>*)context)->push_back(index);
+}
+
+std::vector<uint32_t> roast_downsample(const RoastView& roast, RoastColumnsScratch& scratch, size_t first,
+                                       size_t last, size_t target, DownsampleMode mode) {
+    std::vector<uint32_t> picks;
+    last = std::min(last, roast.size());
+    if (first >= last) return picks;
+
+    // Leaves the gap-filled chamber curve and the state column in scratch
+    RoastMetrics metrics = analyze_roast(roast, scratch);
+    size_t count = last - first;
+    const float* time = scratch.time.data() + first;
+    const float* chamber = scratch.chamber.data() + first;
+    const float* state = scratch.state.data() + first;
+
+    std::vector<uint8_t> pinned(count, 0);
+    for (size_t i = 1; i < count; i++) {
+        if (state[i] != state[i - 1]) pinned[i] = 1;
+    }
+    for (int32_t ms : { metrics.charge_ms, metrics.turning_point_ms, metrics.dry_end_ms,
+                        metrics.first_crack_ms, metrics.drop_ms }) {
+        if (ms < 0) continue;
+        size_t i = std::lower_bound(time, time + count, (float)ms) - time;
+        if (i < count) pinned[i] = 1;
+    }
+
+    if (mode == DownsampleMode::LTTB) {
+        downsample_lttb(time, chamber, (uint32_t)count, (uint32_t)target, pinned.data(), _collect, &picks);
+    } else {
+        Downsampler reducer;
+        reducer.begin(mode, (uint32_t)count, (uint32_t)target, _collect, &picks);
+        for (size_t i = 0; i < count; i++) reducer.push(time[i], chamber[i], pinned[i]);
+        reducer.finish();
+    }
+    for (uint32_t& index : picks) index += (uint32_t)first;
+    return picks;
+}
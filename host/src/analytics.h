@@ -0,0 +1,120 @@
+#pragma once
+
+#include "archive.h"
+#include "downsample.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============== Roast Analytics ==============
+// Per-roast metrics computed straight from archive columns. Each roast is
+// decoded once into flat float arrays and every metric is a single pass
+// over them, so the kernels stay branch-light and vectorise.
+//
+// Milestones are detected in this order:
+//   charge          first ROASTING sample; for UI exports (no state
+//                   column) the switch from the preheat to the roast
+//                   setpoint, else the start of the largest early drop
+//   turning point   chamber minimum within ANALYTICS_TP_WINDOW_MS of charge
+//   dry end         first chamber reading >= ANALYTICS_DRY_END_C after TP
+//   first crack     as marked by the operator
+//   drop            last ROASTING sample, else the last sample with heat on
+//
+// Times are ms on the roast clock; a milestone that was not found is -1.
+
+#define ANALYTICS_DRY_END_C             150.0f
+#define ANALYTICS_TP_WINDOW_MS          240000
+#define ANALYTICS_ROR_WINDOW_MS         30000      // Same span as ROR_SAMPLE_INTERVAL_MS
+#define ANALYTICS_SETTLE_MS             120000     // Ignored for tracking error after charge
+#define ANALYTICS_CHARGE_DROP_C         8.0f       // Minimum chamber drop to call a charge
+#define ANALYTICS_DEFAULT_HEATER_W      1500.0f
+
+struct RoastMetrics {
+    uint32_t samples = 0;
+
+    // Milestones
+    int32_t charge_ms = -1;
+    float charge_temp = 0;
+    int32_t turning_point_ms = -1;
+    float turning_point_temp = 0;
+    int32_t dry_end_ms = -1;
+    int32_t first_crack_ms = -1;
+    int32_t drop_ms = -1;
+    float drop_temp = 0;
+
+    // Phases (ms) and development time ratio (% of charge -> drop)
+    int32_t drying_ms = -1;
+    int32_t maillard_ms = -1;
+    int32_t development_ms = -1;
+    float dtr = -1;
+
+    // Rate of rise (°C/min) from the chamber curve
+    float peak_ror = 0;
+    float ror_at_fc = 0;
+    float ror_at_drop = 0;
+    float ror_crash = 0;        // Largest RoR fall within a window after FC
+
+    // Energy
+    float heater_wh = 0;        // Whole session
+    float roast_wh = 0;         // Charge -> drop
+    float heater_duty = 0;      // Mean output % charge -> drop
+
+    // Control quality, charge + ANALYTICS_SETTLE_MS -> drop
+    float track_mae = 0;        // Mean |chamber - setpoint|
+    float track_rms = 0;
+    float overshoot = 0;        // Max chamber - setpoint
+    float saturation = 0;       // % of samples at 100% output
+};
+
+// Reusable decode buffers; one per worker thread
+struct RoastColumnsScratch {
+    std::vector<float> time;
+    std::vector<float> chamber;
+    std::vector<float> setpoint;
+    std::vector<float> ror;
+    std::vector<float> power;
+    std::vector<float> state;
+};
+
+RoastMetrics analyze_roast(const RoastView& roast, RoastColumnsScratch& scratch,
+                           float heater_watts = ANALYTICS_DEFAULT_HEATER_W);
+
+// Analyses the given archive roasts on `threads` workers (0 = all cores);
+// results[i] belongs to roasts[i]
+std::vector<RoastMetrics> analyze_archive(const Archive& archive, const std::vector<size_t>& roasts,
+                                          unsigned threads, float heater_watts = ANALYTICS_DEFAULT_HEATER_W);
+
+// ============== Distributions ==============
+
+struct MetricSummary {
+    std::string name;
+    size_t count = 0;           // Roasts where the metric was available
+    double mean = 0;
+    double stddev = 0;
+    double min = 0;
+    double p10 = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double max = 0;
+};
+
+struct MetricField {
+    const char* name;
+    const char* unit;
+    double (*get)(const RoastMetrics&);     // NaN when unavailable
+};
+
+// Every reported metric, in table order
+const std::vector<MetricField>& metric_fields();
+
+std::vector<MetricSummary> summarize_metrics(const std::vector<RoastMetrics>& metrics);
+
+// ============== Downsampling ==============
+
+// Indices (into the roast) of about `target` samples from [first, last),
+// reduced along the chamber curve. State changes and the milestones above
+// are always kept.
+std::vector<uint32_t> roast_downsample(const RoastView& roast, RoastColumnsScratch& scratch, size_t first,
+                                       size_t last, size_t target, DownsampleMode mode = DownsampleMode::LTTB);
@@ -0,0 +1,439 @@
+#include "archive.h"
+#include "crc32.h"
+#include "log.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+// Packed data is read with unaligned 64-bit loads; keep that many bytes of
+// slack after every column so the last block never reads past the map
+#define ARCHIVE_PAD                 8
+
+static bool _entry_valid(const ArchiveEntry& entry) {
+    return entry.magic == ARCHIVE_ENTRY_MAGIC && entry.crc == crc32(&entry, offsetof(ArchiveEntry, crc));
+}
+
+static bool _is_scaled(ArchiveColumn column) {
+    return column == ArchiveColumn::CHAMBER || column == ArchiveColumn::HEATER ||
+           column == ArchiveColumn::SETPOINT || column == ArchiveColumn::ROR;
+}
+
+static int32_t _quantise(float value) {
+    if (std::isnan(value)) return ARCHIVE_MISSING;
+    float scaled = value * ARCHIVE_VALUE_SCALE;
+    if (scaled >= (float)INT32_MAX) return INT32_MAX;
+    if (scaled <= (float)(INT32_MIN + 1)) return INT32_MIN + 1;
+    return (int32_t)lrintf(scaled);
+}
+
+static uint64_t _load64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// ============== Column Encoding ==============
+// Deltas use wrapping 32-bit arithmetic, so the ARCHIVE_MISSING sentinel
+// (or any other jump) only widens the block it lands in and still decodes
+// exactly.
+
+static void _encode_column(const std::vector<int32_t>& values, std::vector<ArchiveBlockDir>& dir,
+                           std::vector<uint8_t>& data) {
+    dir.clear();
+    data.clear();
+    uint32_t packed[ARCHIVE_BLOCK_VALUES];
+
+    for (size_t start = 0; start < values.size(); start += ARCHIVE_BLOCK_VALUES) {
+        size_t n = std::min<size_t>(ARCHIVE_BLOCK_VALUES, values.size() - start);
+        const int32_t* v = values.data() + start;
+
+        int32_t min_delta = 0;
+        for (size_t i = 1; i < n; i++) {
+            int32_t delta = (int32_t)((uint32_t)v[i] - (uint32_t)v[i - 1]);
+            if (i == 1 || delta < min_delta) min_delta = delta;
+        }
+        uint32_t max_packed = 0;
+        for (size_t i = 1; i < n; i++) {
+            int32_t delta = (int32_t)((uint32_t)v[i] - (uint32_t)v[i - 1]);
+            packed[i] = (uint32_t)delta - (uint32_t)min_delta;
+            max_packed |= packed[i];
+        }
+        uint8_t width = 0;
+        while (width < 32 && (max_packed >> width)) width++;
+
+        ArchiveBlockDir block {};
+        block.offset = (uint32_t)data.size();
+        block.first = v[0];
+        block.min_delta = min_delta;
+        block.width = width;
+        dir.push_back(block);
+
+        if (width == 0) continue;
+        size_t bytes = ((n - 1) * width + 7) / 8;
+        size_t base = data.size();
+        data.resize(base + bytes, 0);
+        uint64_t bit = 0;
+        for (size_t i = 1; i < n; i++, bit += width) {
+            uint64_t word = (uint64_t)packed[i] << (bit & 7);
+            for (size_t b = 0; word; b++, word >>= 8) data[base + bit / 8 + b] |= (uint8_t)word;
+        }
+    }
+    data.resize(data.size() + ARCHIVE_PAD, 0);
+}
+
+// Decodes one whole block (n values) into out
+static void _decode_block(const ArchiveBlockDir& block, const uint8_t* data, size_t n, int32_t* out) {
+    uint32_t value = (uint32_t)block.first;
+    out[0] = (int32_t)value;
+    uint32_t min_delta = (uint32_t)block.min_delta;
+
+    if (block.width == 0) {
+        for (size_t i = 1; i < n; i++) {
+            value += min_delta;
+            out[i] = (int32_t)value;
+        }
+        return;
+    }
+
+    const uint8_t* p = data + block.offset;
+    uint64_t mask = (1ull << block.width) - 1;
+    uint64_t bit = 0;
+    for (size_t i = 1; i < n; i++, bit += block.width) {
+        uint64_t word = _load64(p + bit / 8) >> (bit & 7);
+        value += (uint32_t)(word & mask) + min_delta;
+        out[i] = (int32_t)value;
+    }
+}
+
+// ============== RoastColumns ==============
+
+void RoastColumns::clear() {
+    time_ms.clear();
+    chamber.clear();
+    heater.clear();
+    setpoint.clear();
+    ror.clear();
+    fan.clear();
+    power.clear();
+    state.clear();
+}
+
+void RoastColumns::push(uint32_t t, float chamber_c, float heater_c, float setpoint_c, float ror_c,
+                        uint8_t fan_pct, uint8_t power_pct, uint8_t state_id) {
+    time_ms.push_back(t);
+    chamber.push_back(chamber_c);
+    heater.push_back(heater_c);
+    setpoint.push_back(setpoint_c);
+    ror.push_back(ror_c);
+    fan.push_back(fan_pct);
+    power.push_back(power_pct);
+    state.push_back(state_id);
+}
+
+// ============== RoastView ==============
+
+std::string_view RoastView::notes() const {
+    const RoastBlockHeader* header = _header();
+    return std::string_view((const char*)_block + header->notes_offset, header->notes_size);
+}
+
+void RoastView::decode(ArchiveColumn column, size_t first, size_t count, int32_t* out) const {
+    const RoastBlockHeader* header = _header();
+    if (first >= header->sample_count) return;
+    count = std::min<size_t>(count, header->sample_count - first);
+
+    const ArchiveColumnDesc& desc = header->column[(size_t)column];
+    const ArchiveBlockDir* dir = (const ArchiveBlockDir*)(_block + desc.dir_offset);
+    const uint8_t* data = _block + desc.data_offset;
+
+    int32_t scratch[ARCHIVE_BLOCK_VALUES];
+    size_t end = first + count;
+    for (size_t b = first / ARCHIVE_BLOCK_VALUES; b * ARCHIVE_BLOCK_VALUES < end; b++) {
+        size_t block_start = b * ARCHIVE_BLOCK_VALUES;
+        size_t n = std::min<size_t>(ARCHIVE_BLOCK_VALUES, header->sample_count - block_start);
+        size_t lo = std::max(first, block_start);
+        size_t hi = std::min(end, block_start + n);
+
+        if (lo == block_start && hi == block_start + n) {
+            // Whole block - decode straight into the caller's buffer
+            _decode_block(dir[b], data, n, out + (block_start - first));
+        } else {
+            _decode_block(dir[b], data, n, scratch);
+            memcpy(out + (lo - first), scratch + (lo - block_start), (hi - lo) * sizeof(int32_t));
+        }
+    }
+}
+
+void RoastView::decode(ArchiveColumn column, size_t first, size_t count, float* out) const {
+    if (first >= size()) return;
+    count = std::min(count, size() - first);
+
+    int32_t raw[ARCHIVE_BLOCK_VALUES * 8];
+    const float scale = _is_scaled(column) ? 1.0f / ARCHIVE_VALUE_SCALE : 1.0f;
+    for (size_t done = 0; done < count; ) {
+        size_t chunk = std::min(count - done, sizeof(raw) / sizeof(raw[0]));
+        decode(column, first + done, chunk, raw);
+        if (column == ArchiveColumn::TIME) {
+            for (size_t i = 0; i < chunk; i++) out[done + i] = (float)(uint32_t)raw[i];
+        } else {
+            for (size_t i = 0; i < chunk; i++) {
+                out[done + i] = raw[i] == ARCHIVE_MISSING ? NAN : (float)raw[i] * scale;
+            }
+        }
+        done += chunk;
+    }
+}
+
+std::vector<float> RoastView::column(ArchiveColumn column) const {
+    std::vector<float> values(size());
+    decode(column, 0, values.size(), values.data());
+    return values;
+}
+
+size_t RoastView::_lower_bound(uint32_t time_ms) const {
+    const RoastBlockHeader* header = _header();
+    const ArchiveColumnDesc& desc = header->column[(size_t)ArchiveColumn::TIME];
+    const ArchiveBlockDir* dir = (const ArchiveBlockDir*)(_block + desc.dir_offset);
+
+    // Last block starting at or before time_ms; only that block is decoded
+    size_t lo = 0, hi = header->block_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if ((uint32_t)dir[mid].first <= time_ms) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return 0;
+
+    size_t b = lo - 1;
+    size_t block_start = b * ARCHIVE_BLOCK_VALUES;
+    size_t n = std::min<size_t>(ARCHIVE_BLOCK_VALUES, header->sample_count - block_start);
+    int32_t times[ARCHIVE_BLOCK_VALUES];
+    _decode_block(dir[b], _block + desc.data_offset, n, times);
+    size_t i = std::lower_bound((const uint32_t*)times, (const uint32_t*)times + n, time_ms) - (const uint32_t*)times;
+    return block_start + i;
+}
+
+std::pair<size_t, size_t> RoastView::time_range(uint32_t from_ms, uint32_t to_ms) const {
+    if (size() == 0 || from_ms >= to_ms) return { 0, 0 };
+    size_t first = _lower_bound(from_ms);
+    size_t last = _lower_bound(to_ms);
+    return { first, std::max(first, last) };
+}
+
+// ============== Archive ==============
+
+static uint8_t* _map_file(const std::string& path, size_t& size) {
+    size = 0;
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    uint8_t* map = nullptr;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            map = (uint8_t*)addr;
+            size = st.st_size;
+        }
+    }
+    ::close(fd);
+    return map;
+}
+
+Archive::~Archive() {
+    close();
+}
+
+bool Archive::open(const std::string& dir) {
+    close();
+    _index = _map_file(dir + "/" ARCHIVE_INDEX_FILE, _index_size);
+    _data = _map_file(dir + "/" ARCHIVE_DATA_FILE, _data_size);
+    if (!_index || !_data) {
+        host_log(LogLevel::ERROR, "ARCHIVE", "No archive in %s", dir.c_str());
+        close();
+        return false;
+    }
+    madvise(_data, _data_size, MADV_WILLNEED);
+
+    size_t count = _index_size / sizeof(ArchiveEntry);
+    _entries.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const ArchiveEntry* entry = (const ArchiveEntry*)(_index + i * sizeof(ArchiveEntry));
+        if (!_entry_valid(*entry)) continue;
+        if (entry->block_offset + entry->block_size > _data_size) continue;
+        const RoastBlockHeader* header = (const RoastBlockHeader*)(_data + entry->block_offset);
+        if (header->magic != ARCHIVE_BLOCK_MAGIC || header->version != ARCHIVE_VERSION ||
+            header->sample_count != entry->sample_count) continue;
+        _entries.push_back(entry);
+    }
+    return true;
+}
+
+void Archive::close() {
+    if (_data) munmap(_data, _data_size);
+    if (_index) munmap(_index, _index_size);
+    _data = _index = nullptr;
+    _data_size = _index_size = 0;
+    _entries.clear();
+}
+
+RoastView Archive::roast(size_t i) const {
+    const ArchiveEntry* entry = _entries[i];
+    return RoastView(entry, _data + entry->block_offset);
+}
+
+std::vector<size_t> Archive::find(uint64_t from_unix_ms, uint64_t to_unix_ms) const {
+    std::vector<size_t> result;
+    for (size_t i = 0; i < _entries.size(); i++) {
+        uint64_t start = _entries[i]->start_unix_ms;
+        if (start >= from_unix_ms && start < to_unix_ms) result.push_back(i);
+    }
+    return result;
+}
+
+long Archive::find_id(std::string_view id) const {
+    long match = -1;
+    for (size_t i = 0; i < _entries.size(); i++) {
+        std::string_view entry_id(_entries[i]->id, strnlen(_entries[i]->id, sizeof(_entries[i]->id)));
+        if (entry_id == id) return (long)i;
+        if (!id.empty() && entry_id.compare(0, id.size(), id) == 0) {
+            if (match >= 0) return -1;          // Ambiguous prefix
+            match = (long)i;
+        }
+    }
+    return match;
+}
+
+// ============== ArchiveWriter ==============
+
+ArchiveWriter::~ArchiveWriter() {
+    flush();
+    if (_data_fd >= 0) ::close(_data_fd);
+    if (_index_fd >= 0) ::close(_index_fd);
+}
+
+bool ArchiveWriter::open() {
+    mkdir(_dir.c_str(), 0755);
+    _index_fd = ::open((_dir + "/" ARCHIVE_INDEX_FILE).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    _data_fd = ::open((_dir + "/" ARCHIVE_DATA_FILE).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_index_fd < 0 || _data_fd < 0) {
+        host_log(LogLevel::ERROR, "ARCHIVE", "Cannot open archive in %s: %s", _dir.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    fstat(_data_fd, &st);
+    uint64_t data_size = st.st_size;
+
+    // Keep the valid prefix of the index; everything after a torn or
+    // dangling entry was never published
+    ArchiveEntry entry;
+    off_t valid = 0;
+    while (pread(_index_fd, &entry, sizeof(entry), valid) == (ssize_t)sizeof(entry) &&
+           _entry_valid(entry) && entry.block_offset + entry.block_size <= data_size) {
+        _ids.insert(std::string(entry.id, strnlen(entry.id, sizeof(entry.id))));
+        _data_end = std::max<uint64_t>(_data_end, entry.block_offset + entry.block_size);
+        valid += sizeof(entry);
+    }
+    fstat(_index_fd, &st);
+    if (st.st_size != valid || data_size != _data_end) {
+        host_log(LogLevel::WARN, "ARCHIVE", "Trimming unpublished tail (%lld index bytes, %llu data bytes)",
+                 (long long)(st.st_size - valid), (unsigned long long)(data_size - _data_end));
+        if (ftruncate(_index_fd, valid) < 0 || ftruncate(_data_fd, _data_end) < 0) {
+            host_log(LogLevel::ERROR, "ARCHIVE", "Cannot trim archive: %s", strerror(errno));
+            return false;
+        }
+    }
+    lseek(_index_fd, 0, SEEK_END);
+    return true;
+}
+
+bool ArchiveWriter::append(ArchiveEntry entry, const RoastColumns& roast, std::string_view notes) {
+    entry.id[sizeof(entry.id) - 1] = '\0';
+    std::string id(entry.id);
+    if (id.empty() || _ids.count(id)) return false;
+
+    size_t n = roast.size();
+    std::vector<int32_t> values[ARCHIVE_COLUMNS];
+    for (auto& column : values) column.resize(n);
+    float max_chamber = NAN;
+    for (size_t i = 0; i < n; i++) {
+        values[(size_t)ArchiveColumn::TIME][i] = (int32_t)roast.time_ms[i];
+        values[(size_t)ArchiveColumn::CHAMBER][i] = _quantise(roast.chamber[i]);
+        values[(size_t)ArchiveColumn::HEATER][i] = _quantise(roast.heater[i]);
+        values[(size_t)ArchiveColumn::SETPOINT][i] = _quantise(roast.setpoint[i]);
+        values[(size_t)ArchiveColumn::ROR][i] = _quantise(roast.ror[i]);
+        values[(size_t)ArchiveColumn::FAN][i] = roast.fan[i];
+        values[(size_t)ArchiveColumn::POWER][i] = roast.power[i];
+        values[(size_t)ArchiveColumn::STATE][i] = roast.state[i];
+        if (roast.chamber[i] > max_chamber || (std::isnan(max_chamber) && !std::isnan(roast.chamber[i]))) {
+            max_chamber = roast.chamber[i];
+        }
+    }
+
+    std::vector<uint8_t> block(sizeof(RoastBlockHeader), 0);
+    RoastBlockHeader header {};
+    header.magic = ARCHIVE_BLOCK_MAGIC;
+    header.version = ARCHIVE_VERSION;
+    header.columns = ARCHIVE_COLUMNS;
+    header.sample_count = (uint32_t)n;
+    header.block_count = (uint32_t)((n + ARCHIVE_BLOCK_VALUES - 1) / ARCHIVE_BLOCK_VALUES);
+
+    std::vector<ArchiveBlockDir> dir;
+    std::vector<uint8_t> data;
+    for (size_t c = 0; c < ARCHIVE_COLUMNS; c++) {
+        _encode_column(values[c], dir, data);
+        header.column[c].dir_offset = (uint32_t)block.size();
+        block.insert(block.end(), (const uint8_t*)dir.data(), (const uint8_t*)(dir.data() + dir.size()));
+        header.column[c].data_offset = (uint32_t)block.size();
+        header.column[c].data_size = (uint32_t)data.size();
+        block.insert(block.end(), data.begin(), data.end());
+        block.resize((block.size() + 7) & ~(size_t)7, 0);
+    }
+    header.notes_offset = (uint32_t)block.size();
+    header.notes_size = (uint32_t)notes.size();
+    block.insert(block.end(), notes.begin(), notes.end());
+    block.resize((block.size() + 7) & ~(size_t)7, 0);
+    header.total_size = (uint32_t)block.size();
+    memcpy(block.data(), &header, sizeof(header));
+
+    if (pwrite(_data_fd, block.data(), block.size(), _data_end) != (ssize_t)block.size()) {
+        host_log(LogLevel::ERROR, "ARCHIVE", "Write failed for %s: %s", entry.id, strerror(errno));
+        return false;
+    }
+
+    entry.magic = ARCHIVE_ENTRY_MAGIC;
+    entry.block_offset = _data_end;
+    entry.block_size = header.total_size;
+    entry.sample_count = (uint32_t)n;
+    entry.duration_ms = n ? roast.time_ms[n - 1] : 0;
+    entry.max_chamber = std::isnan(max_chamber) ? 0.0f : max_chamber;
+    entry.crc = crc32(&entry, offsetof(ArchiveEntry, crc));
+    _pending.push_back(entry);
+
+    _data_end += block.size();
+    _ids.insert(id);
+    return true;
+}
+
+bool ArchiveWriter::flush() {
+    if (_pending.empty()) return true;
+    if (fdatasync(_data_fd) < 0) {
+        host_log(LogLevel::ERROR, "ARCHIVE", "Data sync failed: %s", strerror(errno));
+        return false;
+    }
+    size_t bytes = _pending.size() * sizeof(ArchiveEntry);
+    if (write(_index_fd, _pending.data(), bytes) != (ssize_t)bytes || fdatasync(_index_fd) < 0) {
+        host_log(LogLevel::ERROR, "ARCHIVE", "Index write failed: %s", strerror(errno));
+        return false;
+    }
+    _pending.clear();
+    return true;
+}
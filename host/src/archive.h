@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// ============== Roast Archive ==============
+// Columnar store for finished roasts, built for scanning hundreds of past
+// curves without parsing JSON. An archive directory holds two files:
+//
+//   roasts.dat   [RoastBlock][RoastBlock]...          append-only
+//   roasts.idx   [ArchiveEntry][ArchiveEntry]...      append-only
+//
+// A RoastBlock stores every series as its own column. Values are quantised
+// to int32 and split into blocks of ARCHIVE_BLOCK_VALUES; each block keeps
+// its first value and bit-packs the remaining deltas relative to the
+// block's smallest delta, so a steady 1 s time column or a constant fan
+// speed costs zero bits per sample. Per-column block directories carry the
+// first value of every block, which lets time-range queries binary search
+// the time column and decode only the blocks they touch.
+//
+// ArchiveEntry is the fixed-size per-roast metadata record (RoastSession's
+// parameters, milestones, rating, and where the notes live). A block is
+// written and synced before its entry, so a torn tail on either file is
+// simply ignored and trimmed on the next append.
+
+#define ARCHIVE_DATA_FILE           "roasts.dat"
+#define ARCHIVE_INDEX_FILE          "roasts.idx"
+#define ARCHIVE_BLOCK_MAGIC         0x4D434152      // "MCAR"
+#define ARCHIVE_ENTRY_MAGIC         0x4D434149      // "MCAI"
+#define ARCHIVE_VERSION             1
+#define ARCHIVE_BLOCK_VALUES        128
+#define ARCHIVE_VALUE_SCALE         100             // Temperatures and RoR in 0.01 units
+#define ARCHIVE_MISSING             INT32_MIN       // Quantised null / NaN
+
+enum class ArchiveColumn : uint8_t {
+    TIME = 0,           // ms since roast start
+    CHAMBER,            // °C, NaN when the reading was missing
+    HEATER,
+    SETPOINT,
+    ROR,                // °C/min
+    FAN,                // %
+    POWER,              // Heater output %
+    STATE,              // roasterState.stateId, 0 for UI exports
+    COUNT
+};
+
+#define ARCHIVE_COLUMNS             ((size_t)ArchiveColumn::COUNT)
+
+enum class ArchiveSource : uint8_t {
+    JSON_EXPORT = 1,    // RoastSession export from the web UI
+    RECORDER = 2,       // Segment written by roast-recorder
+    LOG_INGEST = 3      // Parsed from a captured NDJSON serial log
+};
+
+struct ArchiveBlockDir {
+    uint32_t offset;            // Packed deltas, relative to the column data
+    int32_t first;              // First value of the block
+    int32_t min_delta;          // Frame of reference for the packed deltas
+    uint8_t width;              // Bits per packed delta, 0..32
+    uint8_t reserved[3];
+};
+static_assert(sizeof(ArchiveBlockDir) == 16, "ArchiveBlockDir layout is on-disk format");
+
+struct ArchiveColumnDesc {
+    uint32_t dir_offset;        // Relative to the RoastBlock start
+    uint32_t data_offset;
+    uint32_t data_size;
+    uint32_t reserved;
+};
+
+struct RoastBlockHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t columns;
+    uint8_t reserved0;
+    uint32_t sample_count;
+    uint32_t block_count;       // Blocks per column
+    uint32_t notes_offset;      // UTF-8, relative to the RoastBlock start
+    uint32_t notes_size;
+    uint32_t total_size;        // Whole block including padding
+    uint32_t reserved1;
+    ArchiveColumnDesc column[ARCHIVE_COLUMNS];
+};
+static_assert(sizeof(RoastBlockHeader) == 32 + 16 * ARCHIVE_COLUMNS, "RoastBlockHeader layout is on-disk format");
+
+struct ArchiveEntry {
+    uint32_t magic;
+    uint8_t source;             // ArchiveSource
+    int8_t rating;              // 1-5, 0 when unrated
+    uint16_t reserved0;
+    char id[40];                // RoastSession.id (UUID) or recorder roast id
+    char device[32];            // Empty for UI exports
+    uint64_t start_unix_ms;
+    uint64_t end_unix_ms;       // 0 when unknown
+    uint64_t block_offset;      // RoastBlock position in roasts.dat
+    uint32_t block_size;
+    uint32_t sample_count;
+    uint32_t duration_ms;       // Last sample time
+    uint32_t first_crack_ms;    // On the time column (includes preheat), 0 = unmarked
+    uint32_t total_roast_ms;
+    float preheat_setpoint;
+    float roast_setpoint;
+    float max_chamber;          // Cheap prefilter for analytics
+    uint8_t reserved1[20];
+    uint32_t crc;
+};
+static_assert(sizeof(ArchiveEntry) == 160, "ArchiveEntry layout is on-disk format");
+
+// Decoded series for one roast, as handed to ArchiveWriter::append()
+struct RoastColumns {
+    std::vector<uint32_t> time_ms;
+    std::vector<float> chamber;         // NaN for missing readings
+    std::vector<float> heater;
+    std::vector<float> setpoint;
+    std::vector<float> ror;
+    std::vector<uint8_t> fan;
+    std::vector<uint8_t> power;
+    std::vector<uint8_t> state;
+
+    size_t size() const { return time_ms.size(); }
+    void clear();
+    void push(uint32_t t, float chamber_c, float heater_c, float setpoint_c, float ror_c,
+              uint8_t fan_pct, uint8_t power_pct, uint8_t state_id);
+};
+
+// Zero-copy view of one archived roast inside the mapped data file
+class RoastView {
+public:
+    RoastView() = default;
+    RoastView(const ArchiveEntry* entry, const uint8_t* block) : _entry(entry), _block(block) {}
+
+    const ArchiveEntry& entry() const { return *_entry; }
+    size_t size() const { return _entry->sample_count; }
+    std::string_view notes() const;
+
+    // Raw quantised values for samples [first, first + count)
+    void decode(ArchiveColumn column, size_t first, size_t count, int32_t* out) const;
+
+    // Values in natural units; ARCHIVE_MISSING decodes to NaN
+    void decode(ArchiveColumn column, size_t first, size_t count, float* out) const;
+
+    // Whole-column convenience
+    std::vector<float> column(ArchiveColumn column) const;
+
+    // Sample index range [first, last) with from_ms <= time < to_ms
+    std::pair<size_t, size_t> time_range(uint32_t from_ms, uint32_t to_ms) const;
+
+private:
+    const RoastBlockHeader* _header() const { return (const RoastBlockHeader*)_block; }
+    size_t _lower_bound(uint32_t time_ms) const;
+
+    const ArchiveEntry* _entry = nullptr;
+    const uint8_t* _block = nullptr;
+};
+
+// Read-only archive; the files are mapped once and never copied
+class Archive {
+public:
+    Archive() = default;
+    ~Archive();
+    Archive(const Archive&) = delete;
+    Archive& operator=(const Archive&) = delete;
+
+    bool open(const std::string& dir);
+    void close();
+
+    size_t size() const { return _entries.size(); }
+    const ArchiveEntry& entry(size_t i) const { return *_entries[i]; }
+    RoastView roast(size_t i) const;
+
+    // Roasts started within [from_unix_ms, to_unix_ms), in archive order
+    std::vector<size_t> find(uint64_t from_unix_ms, uint64_t to_unix_ms) const;
+
+    // Index of the roast with the given id (or unique id prefix), -1 if none
+    long find_id(std::string_view id) const;
+
+    uint64_t data_bytes() const { return _data_size; }
+
+private:
+    uint8_t* _data = nullptr;
+    size_t _data_size = 0;
+    uint8_t* _index = nullptr;
+    size_t _index_size = 0;
+    std::vector<const ArchiveEntry*> _entries;      // Valid entries only
+};
+
+class ArchiveWriter {
+public:
+    explicit ArchiveWriter(std::string dir) : _dir(std::move(dir)) {}
+    ~ArchiveWriter();
+
+    // Creates the directory and trims a torn tail left by a crash
+    bool open();
+
+    // Appends one roast; entry.id must be set. Returns false for
+    // duplicates (already archived) and on I/O errors. The roast becomes
+    // visible to readers at the next flush().
+    bool append(ArchiveEntry entry, const RoastColumns& roast, std::string_view notes);
+
+    // Syncs pending blocks, then publishes their index entries
+    bool flush();
+
+    bool contains(std::string_view id) const { return _ids.count(std::string(id)) > 0; }
+
+private:
+    std::string _dir;
+    int _data_fd = -1;
+    int _index_fd = -1;
+    uint64_t _data_end = 0;
+    std::vector<ArchiveEntry> _pending;
+    std::unordered_set<std::string> _ids;
+};
@@ -0,0 +1,185 @@
+#include "archive_import.h"
+#include "log.h"
+#include "ndjson.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// ============== JSON Scanning ==============
+// The export is pretty-printed JSON of a known shape, so a structural scan
+// that skips strings is enough to split it into sessions and data points;
+// values are then read with the flat json_get_* helpers.
+
+// Finds the matching close of the array/object opening at pos
+static size_t _match(std::string_view text, size_t pos) {
+    int depth = 0;
+    for (size_t i = pos; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"') {
+            for (i++; i < text.size() && text[i] != '"'; i++) {
+                if (text[i] == '\\') i++;
+            }
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// Calls fn for every object directly inside the array at [open, close]
+template <typename Fn>
+static void _for_each_object(std::string_view text, size_t open, size_t close, Fn&& fn) {
+    size_t pos = open + 1;
+    while (pos < close) {
+        size_t start = text.find('{', pos);
+        if (start == std::string_view::npos || start >= close) return;
+        size_t end = _match(text, start);
+        if (end == std::string_view::npos || end > close) return;
+        fn(text.substr(start, end - start + 1));
+        pos = end + 1;
+    }
+}
+
+static double _number(std::string_view json, std::string_view key, double fallback) {
+    double value;
+    return json_get_number(json, key, value) ? value : fallback;
+}
+
+static uint8_t _percent(double value) {
+    if (!(value > 0)) return 0;
+    return value >= 255 ? 255 : (uint8_t)lround(value);
+}
+
+static void _import_session(std::string_view session, ArchiveWriter& writer, ImportStats& stats) {
+    // Metadata lookups must not wander into the data array
+    std::string meta(session);
+    RoastColumns roast;
+    size_t key = session.find("\"temperatureData\"");
+    size_t open = key == std::string_view::npos ? key : session.find('[', key);
+    if (open != std::string_view::npos) {
+        size_t close = _match(session, open);
+        if (close == std::string_view::npos) {
+            stats.skipped++;
+            return;
+        }
+        meta = std::string(session.substr(0, open)) + "[]" + std::string(session.substr(close + 1));
+
+        _for_each_object(session, open, close, [&roast](std::string_view point) {
+            double t;
+            if (!json_get_number(point, "time", t) || t < 0) return;
+            roast.push((uint32_t)t,
+                       (float)_number(point, "chamberTemp", NAN),      // null -> NaN
+                       (float)_number(point, "heaterTemp", NAN),
+                       (float)_number(point, "setpoint", NAN),
+                       (float)_number(point, "ror", NAN),
+                       _percent(_number(point, "fanSpeed", 0)),
+                       _percent(_number(point, "heaterPower", 0)),
+                       0);
+        });
+    }
+
+    std::string_view id;
+    if (!json_get_string(meta, "id", id) || id.empty()) {
+        stats.skipped++;
+        return;
+    }
+
+    ArchiveEntry entry {};
+    entry.source = (uint8_t)ArchiveSource::JSON_EXPORT;
+    snprintf(entry.id, sizeof(entry.id), "%.*s", (int)id.size(), id.data());
+    entry.start_unix_ms = (uint64_t)_number(meta, "startTime", 0);
+    entry.end_unix_ms = (uint64_t)_number(meta, "endTime", 0);
+    entry.preheat_setpoint = (float)_number(meta, "preheatSetpoint", 0);
+    entry.roast_setpoint = (float)_number(meta, "roastSetpoint", 0);
+    entry.first_crack_ms = (uint32_t)_number(meta, "firstCrackTime", 0);
+    entry.total_roast_ms = (uint32_t)_number(meta, "totalRoastTime", 0);
+    entry.rating = (int8_t)_number(meta, "rating", 0);
+
+    std::string notes;
+    std::string_view raw_notes;
+    if (json_get_string(meta, "notes", raw_notes)) notes = json_unescape(raw_notes);
+
+    if (writer.append(entry, roast, notes)) {
+        stats.roasts++;
+        stats.samples += roast.size();
+    } else if (writer.contains(entry.id)) {
+        stats.duplicates++;
+    } else {
+        stats.skipped++;
+    }
+}
+
+bool archive_import_json(std::string_view text, ArchiveWriter& writer, ImportStats& stats) {
+    size_t start = text.find_first_of("[{");
+    if (start == std::string_view::npos) return false;
+    size_t end = _match(text, start);
+    if (end == std::string_view::npos) return false;
+
+    if (text[start] == '{') {
+        _import_session(text.substr(start, end - start + 1), writer, stats);
+    } else {
+        _for_each_object(text, start, end, [&](std::string_view session) {
+            _import_session(session, writer, stats);
+        });
+    }
+    return true;
+}
+
+// ============== Recorder Import ==============
+
+uint32_t archive_first_crack_time(uint32_t time_ms, const SampleRecord& sample) {
+    uint32_t since = sample.roast_time_ms > sample.first_crack_ms ? sample.roast_time_ms - sample.first_crack_ms : 0;
+    return time_ms > since ? time_ms - since : 0;
+}
+
+bool archive_import_recorder(const std::string& dir, ArchiveWriter& writer, ImportStats& stats) {
+    std::vector<IndexEntry> entries = index_load(dir);
+    if (entries.empty()) return false;
+
+    RoastColumns roast;
+    for (const IndexEntry& index : entries) {
+        if (index.status == (uint8_t)RoastStatus::OPEN) continue;      // Still recording
+
+        ArchiveEntry entry {};
+        entry.source = (uint8_t)ArchiveSource::RECORDER;
+        snprintf(entry.id, sizeof(entry.id), "rec-%llu", (unsigned long long)index.roast_id);
+        if (writer.contains(entry.id)) {
+            stats.duplicates++;
+            continue;
+        }
+
+        SegmentView segment;
+        if (!segment.open(dir + "/" + index.segment)) {
+            stats.skipped++;
+            continue;
+        }
+
+        roast.clear();
+        const SampleRecord* samples = segment.samples();
+        for (size_t i = 0; i < segment.count(); i++) {
+            const SampleRecord& s = samples[i];
+            roast.push(s.time_ms, s.chamber_temp, s.heater_temp, s.setpoint, s.ror,
+                       s.fan_speed, s.heater_power, s.state);
+            // The index holds the roast clock; segment time includes preheat
+            if (s.first_crack_ms && !entry.first_crack_ms) entry.first_crack_ms = archive_first_crack_time(s.time_ms, s);
+        }
+
+        memcpy(entry.device, index.device, sizeof(entry.device));
+        entry.start_unix_ms = index.start_unix_ms;
+        entry.end_unix_ms = index.end_unix_ms;
+        entry.preheat_setpoint = index.preheat_setpoint;
+        entry.roast_setpoint = index.roast_setpoint;
+        entry.total_roast_ms = index.total_roast_ms;
+
+        if (writer.append(entry, roast, std::string_view())) {
+            stats.roasts++;
+            stats.samples += roast.size();
+        } else {
+            stats.skipped++;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "archive.h"
+#include "recorder.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// ============== Archive Import ==============
+// Converters from the existing roast formats into the columnar archive.
+
+struct ImportStats {
+    size_t roasts = 0;          // Newly archived
+    size_t duplicates = 0;      // Already in the archive
+    size_t skipped = 0;         // Malformed or empty
+    size_t samples = 0;
+};
+
+// Imports a web UI export: one JSON.stringify(RoastSession) object, or the
+// RoastSession[] array kept in localStorage
+bool archive_import_json(std::string_view text, ArchiveWriter& writer, ImportStats& stats);
+
+// Imports the closed and recovered roasts of a roast-recorder directory
+bool archive_import_recorder(const std::string& dir, ArchiveWriter& writer, ImportStats& stats);
+
+// First crack on a roast's time column, from a sample that carries it on
+// the device roast clock (roastTimeMs and firstCrackTimeMs share a base:
+// preheat start on the firmware, charge on the emulator)
+uint32_t archive_first_crack_time(uint32_t time_ms, const SampleRecord& sample);
@@ -0,0 +1,205 @@
+#include "bridge.h"
+#include "log.h"
+
+#include <algorithm>
+
+#define BRIDGE_MAX_REPLAY   BRIDGE_STATE_CACHE
+
+static bool _is_type(std::string_view line, std::string_view& type) {
+    return json_get_string(line, "type", type);
+}
+
+// Cached live frames are re-marked as replays when served for a resend
+static FramePtr _as_replay(const Frame& frame) {
+    size_t pos = frame.text.find("\"seq\":");
+    if (pos == std::string::npos) return nullptr;
+    pos += 6;
+    while (pos < frame.text.size() && frame.text[pos] >= '0' && frame.text[pos] <= '9') pos++;
+
+    std::string line = frame.text.substr(0, pos);
+    line += ",\"replay\":true";
+    line.append(frame.text, pos, frame.text.size() - pos - 1);
+    return frame_make(line);
+}
+
+Bridge::Bridge(EventLoop& loop, const BridgeConfig& config)
+    : _loop(loop), _config(config), _server(loop, config.server),
+      _link(loop, config.device, config.baud) {}
+
+Bridge::~Bridge() {
+    if (_timer) _loop.cancel_timer(_timer);
+}
+
+bool Bridge::start() {
+    _server.on_open([this](ClientConn& client) { _on_client_open(client); });
+    _server.on_close([this](ClientConn& client) { _on_client_close(client); });
+    _server.on_line([this](ClientConn& client, std::string_view line) { _on_client_line(client, line); });
+    if (!_server.start()) return false;
+
+    _link.on_frame([this](const FramePtr& frame) { _on_device_frame(frame); });
+    _link.on_state([this](LinkState state, const char* reason) { _on_link_state(state, reason); });
+    if (!_config.device.empty()) _link.open();
+
+    _timer = _loop.add_timer(100, 100, [this]() { _link.tick(); });
+    return true;
+}
+
+// ============== Serial Link ==============
+
+void Bridge::_on_link_state(LinkState state, const char* reason) {
+    if (state == LinkState::DOWN) {
+        _broadcast_log("warn", std::string("Bridge lost serial link: ") + reason);
+    }
+}
+
+void Bridge::_update_keepalive() {
+    // Feed the firmware watchdog only on behalf of attached clients
+    _link.set_keepalive(_server.client_count() > 0 ? _config.keepalive_ms : 0);
+}
+
+void Bridge::_on_device_frame(const FramePtr& frame) {
+    if (frame->type == "roasterState" && frame->seq > 0 &&
+        frame->text.find("\"replay\":true") == std::string::npos) {
+        // A smaller seq means the board restarted - old samples are stale
+        if (!_states.empty() && frame->seq <= _states.back()->seq) _states.clear();
+        _states.push_back(frame);
+        if (_states.size() > _config.state_cache) _states.pop_front();
+    } else if (frame->type == "connected") {
+        _connected = frame;
+    } else if (frame->type == "bootReport") {
+        _boot_report = frame;
+    } else if (frame->type == "selfTest") {
+        _self_test = frame;
+    }
+
+    _server.broadcast(frame);
+}
+
+// ============== Clients ==============
+
+void Bridge::_on_client_open(ClientConn& client) {
+    // Bring late joiners up to date without touching the serial link
+    if (_connected) client.send(_connected);
+    if (_boot_report) client.send(_boot_report);
+    if (_self_test) client.send(_self_test);
+    if (!_states.empty()) client.send(_states.back());
+    _send_control(client);
+
+    if (_server.client_count() == 1) {
+        _link.send("{\"type\":\"getState\",\"payload\":{}}");
+    }
+    _update_keepalive();
+}
+
+void Bridge::_on_client_close(ClientConn& client) {
+    if (_controller == client.id()) _set_controller(0);
+    _update_keepalive();
+}
+
+void Bridge::_on_client_line(ClientConn& client, std::string_view line) {
+    std::string_view type;
+    if (!_is_type(line, type)) {
+        _send_error(client, 400, "Missing message type");
+        return;
+    }
+
+    if (type == "getState" && !_states.empty()) {
+        client.send(_states.back());
+        _stats.served_locally++;
+        return;
+    }
+    if (type == "resend") {
+        _serve_resend(client, line);
+        return;
+    }
+    if (type == "requestControl") {
+        if (_acquire(client)) _send_control(client);
+        return;
+    }
+    if (type == "releaseControl") {
+        if (_controller == client.id()) _set_controller(0);
+        return;
+    }
+
+    bool open_command = type == "getState" || type == "getSelfTest" ||
+                        type == "getFaultHistory" || type == "getSensorStats" || type == "stop";
+    if (!open_command && !_acquire(client)) return;
+
+    if (!_link.send(line)) {
+        _send_error(client, 503, "Roaster serial link is down");
+        return;
+    }
+    _stats.commands_forwarded++;
+}
+
+void Bridge::_serve_resend(ClientConn& client, std::string_view line) {
+    uint64_t from = 0, to = 0;
+    if (!json_get_uint(line, "fromSeq", from) || !json_get_uint(line, "toSeq", to) || from > to) return;
+    if (to - from >= BRIDGE_MAX_REPLAY) from = to - BRIDGE_MAX_REPLAY + 1;
+
+    uint64_t oldest = _states.empty() ? to + 1 : _states.front()->seq;
+
+    // Anything older than our cache may still be in the firmware ring
+    if (from < oldest) {
+        std::string request = "{\"type\":\"resend\",\"payload\":{\"fromSeq\":" + std::to_string(from) +
+                              ",\"toSeq\":" + std::to_string(std::min<uint64_t>(to, oldest - 1)) + "}}";
+        if (_link.send(request)) _stats.commands_forwarded++;
+    }
+
+    auto it = std::lower_bound(_states.begin(), _states.end(), std::max(from, oldest),
+                               [](const FramePtr& f, uint64_t seq) { return f->seq < seq; });
+    for (; it != _states.end() && (*it)->seq <= to; ++it) {
+        FramePtr replay = _as_replay(**it);
+        if (replay) client.send(replay);
+    }
+    _stats.served_locally++;
+}
+
+// ============== Control Arbitration ==============
+
+bool Bridge::_acquire(ClientConn& client) {
+    if (_controller == client.id()) return true;
+    if (_controller == 0) {
+        _set_controller(client.id());
+        return true;
+    }
+
+    _stats.commands_rejected++;
+    _send_error(client, BRIDGE_ERROR_CONTROL_HELD,
+                "Roaster is controlled by client #" + std::to_string(_controller));
+    return false;
+}
+
+void Bridge::_set_controller(uint32_t id) {
+    if (_controller == id) return;
+    _controller = id;
+
+    if (id) {
+        ClientConn* holder = _server.find(id);
+        host_log(LogLevel::INFO, "BRIDGE", "Control lease -> #%u %s", id, holder ? holder->peer().c_str() : "?");
+    } else {
+        host_log(LogLevel::INFO, "BRIDGE", "Control lease released");
+    }
+    _server.for_each([this](ClientConn& client) { _send_control(client); });
+}
+
+void Bridge::_send_control(ClientConn& client) {
+    std::string json = "{\"type\":\"bridgeControl\",\"timestamp\":" + std::to_string(host_now_ms()) +
+                       ",\"payload\":{\"holder\":" + (_controller ? std::to_string(_controller) : "null") +
+                       ",\"clientId\":" + std::to_string(client.id()) + "}}";
+    client.send(frame_make(json));
+}
+
+void Bridge::_send_error(ClientConn& client, int code, const std::string& message) {
+    std::string json = "{\"type\":\"error\",\"timestamp\":" + std::to_string(host_now_ms()) +
+                       ",\"payload\":{\"code\":" + std::to_string(code) +
+                       ",\"message\":\"" + json_escape(message) + "\"}}";
+    client.send(frame_make(json));
+}
+
+void Bridge::_broadcast_log(const char* level, const std::string& message) {
+    std::string json = "{\"type\":\"log\",\"timestamp\":" + std::to_string(host_now_ms()) +
+                       ",\"payload\":{\"level\":\"" + level + "\",\"source\":\"BRIDGE\",\"message\":\"" +
+                       json_escape(message) + "\"}}";
+    _server.broadcast(frame_make(json));
+}
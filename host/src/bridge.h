@@ -0,0 +1,93 @@
+#pragma once
+
+#include "client_server.h"
+#include "event_loop.h"
+#include "ndjson.h"
+#include "roaster_link.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+// ============== Serial Bridge ==============
+// Owns the roaster's USB serial link, parses each NDJSON line once and fans
+// it out to every connected client. Commands from all clients are
+// serialized onto the single serial link:
+//
+//   - getState and resend are answered from the bridge's own cache, so N
+//     browser tabs polling getState don't multiply serial traffic
+//   - getSelfTest, getFaultHistory, getSensorStats and stop are accepted from anyone
+//     (stop is a safety command and must never be refused)
+//   - every other command needs the control lease. The first client to send
+//     one takes the lease; it is released on disconnect or releaseControl,
+//     and others get an error until then
+//
+// The bridge keeps the firmware's connection watchdog fed only while at
+// least one client is attached, so losing every client still cools the
+// roaster exactly as losing the browser did.
+
+#define BRIDGE_KEEPALIVE_MS         2000
+#define BRIDGE_STATE_CACHE          600     // 10 minutes of 1 Hz roasterState frames
+#define BRIDGE_ERROR_CONTROL_HELD   409
+
+struct BridgeConfig {
+    std::string device;
+    int baud = 115200;
+    ClientServerConfig server;
+    uint32_t keepalive_ms = BRIDGE_KEEPALIVE_MS;
+    size_t state_cache = BRIDGE_STATE_CACHE;
+};
+
+class Bridge {
+public:
+    struct Stats {
+        uint64_t commands_forwarded = 0;
+        uint64_t commands_rejected = 0;
+        uint64_t served_locally = 0;
+    };
+
+    Bridge(EventLoop& loop, const BridgeConfig& config);
+    ~Bridge();
+
+    // Starts listening; the serial device is (re)opened in the background
+    bool start();
+
+    // Use an already-open tty (e.g. a pty from the emulator) as the device
+    void attach_fd(int fd) { _link.attach_fd(fd); }
+
+    ClientServer& server() { return _server; }
+    RoasterLink& link() { return _link; }
+    const Stats& stats() const { return _stats; }
+    uint32_t controller() const { return _controller; }
+
+private:
+    void _on_device_frame(const FramePtr& frame);
+    void _on_link_state(LinkState state, const char* reason);
+    void _on_client_line(ClientConn& client, std::string_view line);
+    void _on_client_open(ClientConn& client);
+    void _on_client_close(ClientConn& client);
+    void _tick();
+
+    void _update_keepalive();
+    void _serve_resend(ClientConn& client, std::string_view line);
+    bool _acquire(ClientConn& client);
+    void _set_controller(uint32_t id);
+    void _send_control(ClientConn& client);
+    void _send_error(ClientConn& client, int code, const std::string& message);
+    void _broadcast_log(const char* level, const std::string& message);
+
+    EventLoop& _loop;
+    BridgeConfig _config;
+    ClientServer _server;
+    RoasterLink _link;
+    uint64_t _timer = 0;
+
+    std::deque<FramePtr> _states;   // Live roasterState frames by ascending seq
+    FramePtr _connected;
+    FramePtr _boot_report;
+    FramePtr _self_test;
+
+    uint32_t _controller = 0;
+    Stats _stats;
+};
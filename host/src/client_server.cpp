@@ -0,0 +1,405 @@
+#include "client_server.h"
+#include "log.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#define CLIENT_READ_CHUNK   16384
+#define CLIENT_MAX_IOV      64
+#define CLIENT_MAX_LINE     4096
+
+// ============== Client Connection ==============
+
+ClientConn::ClientConn(ClientServer& server, int fd, uint32_t id, std::string peer)
+    : _server(server), _fd(fd), _id(id), _peer(std::move(peer)),
+      _accepted_ms(host_now_ms()), _lines(CLIENT_MAX_LINE) {}
+
+size_t ClientConn::_wire_size(const Frame& frame) const {
+    if (_mode == Mode::WEBSOCKET) return frame.ws_header_len + frame.text.size() - 1;
+    return frame.text.size();
+}
+
+void ClientConn::send(const FramePtr& frame) {
+    if (!is_open()) return;
+
+    _queue.push_back(frame);
+    _queued_bytes += _wire_size(*frame);
+    if (_queued_bytes > _server._config.max_queue_bytes) {
+        _shed();
+        if (_closing) return;
+    }
+
+    // Fast path: most clients keep up, so write now instead of waiting for EPOLLOUT
+    if (!_want_write) _flush();
+}
+
+void ClientConn::_shed() {
+    // Never touch a partially written head frame - that would corrupt the stream
+    size_t first = _offset > 0 ? 1 : 0;
+    for (size_t i = first; i < _queue.size() && _queued_bytes > _server._config.max_queue_bytes; ) {
+        if (_queue[i]->droppable) {
+            _queued_bytes -= _wire_size(*_queue[i]);
+            _queue.erase(_queue.begin() + i);
+            _dropped++;
+            _server._stats.dropped_frames++;
+        } else {
+            i++;
+        }
+    }
+
+    if (_queued_bytes > _server._config.max_queue_bytes) {
+        _server._stats.evicted++;
+        _server.close_client(*this, "too slow for non-droppable frames");
+    }
+}
+
+void ClientConn::_flush() {
+    while (!_closing) {
+        // Control bytes go out only on a frame boundary
+        if (_offset == 0 && !_control_out.empty()) {
+            ssize_t n = ::send(_fd, _control_out.data(), _control_out.size(), MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                _server.close_client(*this, strerror(errno));
+                return;
+            }
+            _control_out.erase(0, n);
+            if (!_control_out.empty()) break;
+            continue;
+        }
+        if (_queue.empty()) break;
+
+        // Gather queued frames straight from the shared buffers
+        iovec iov[CLIENT_MAX_IOV];
+        int count = 0;
+        size_t skip = _offset;
+        size_t max_frames = _control_out.empty() ? _queue.size() : 1;
+        for (size_t i = 0; i < _queue.size() && i < max_frames && count + 2 <= CLIENT_MAX_IOV; i++) {
+            const Frame& frame = *_queue[i];
+            const char* parts[2];
+            size_t lens[2];
+            int nparts = 0;
+            if (_mode == Mode::WEBSOCKET) {
+                parts[nparts] = (const char*)frame.ws_header;
+                lens[nparts++] = frame.ws_header_len;
+                parts[nparts] = frame.text.data();
+                lens[nparts++] = frame.text.size() - 1;
+            } else {
+                parts[nparts] = frame.text.data();
+                lens[nparts++] = frame.text.size();
+            }
+            for (int p = 0; p < nparts; p++) {
+                if (skip >= lens[p]) {
+                    skip -= lens[p];
+                    continue;
+                }
+                iov[count].iov_base = (void*)(parts[p] + skip);
+                iov[count].iov_len = lens[p] - skip;
+                skip = 0;
+                count++;
+            }
+        }
+
+        msghdr msg {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t n = sendmsg(_fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            _server.close_client(*this, strerror(errno));
+            return;
+        }
+
+        size_t written = (size_t)n;
+        _queued_bytes -= written;
+        while (written > 0) {
+            size_t left = _wire_size(*_queue.front()) - _offset;
+            if (written < left) {
+                _offset += written;
+                break;
+            }
+            written -= left;
+            _offset = 0;
+            _queue.pop_front();
+        }
+    }
+
+    _update_interest();
+}
+
+void ClientConn::_update_interest() {
+    if (_closing) return;
+    bool want = !_queue.empty() || !_control_out.empty();
+    if (want == _want_write) return;
+    _want_write = want;
+    _server._loop.modify(_fd, EPOLLIN | EPOLLRDHUP | (want ? (uint32_t)EPOLLOUT : 0u));
+}
+
+void ClientConn::_open() {
+    _server._open_count++;
+    host_log(LogLevel::INFO, "CLIENT", "#%u %s connected (%s)", _id, _peer.c_str(),
+             _mode == Mode::WEBSOCKET ? "websocket" : "tcp");
+    if (_server._on_open) _server._on_open(*this);
+}
+
+void ClientConn::_on_readable() {
+    char buf[CLIENT_READ_CHUNK];
+    while (!_closing) {
+        ssize_t n = recv(_fd, buf, sizeof(buf), 0);
+        if (n == 0) {
+            _server.close_client(*this, "peer closed");
+            return;
+        }
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            _server.close_client(*this, strerror(errno));
+            return;
+        }
+        _on_bytes(buf, n);
+    }
+}
+
+void ClientConn::_on_bytes(const char* data, size_t len) {
+    if (_mode == Mode::DETECT) {
+        if (data[0] == 'G') {
+            _mode = Mode::HTTP;
+        } else {
+            _mode = Mode::RAW;
+            _open();
+        }
+    }
+
+    switch (_mode) {
+        case Mode::HTTP:
+            _on_http(data, len);
+            break;
+
+        case Mode::RAW:
+            _lines.feed(data, len, [this](std::string_view line) {
+                if (!_closing && _server._on_line) _server._on_line(*this, line);
+            });
+            break;
+
+        case Mode::WEBSOCKET: {
+            bool ok = _ws.feed((const uint8_t*)data, len, [this](uint8_t opcode, std::string_view payload) {
+                if (!_closing) _on_ws_message(opcode, payload);
+            });
+            if (!ok) _server.close_client(*this, "websocket protocol error");
+            break;
+        }
+
+        case Mode::DETECT:
+            break;
+    }
+}
+
+void ClientConn::_on_http(const char* data, size_t len) {
+    _http.append(data, len);
+    size_t end = _http.find("\r\n\r\n");
+    if (end == std::string::npos) {
+        if (_http.size() > CLIENT_HTTP_MAX_BYTES) _server.close_client(*this, "oversized HTTP request");
+        return;
+    }
+
+    std::string key;
+    size_t line_start = _http.find("\r\n") + 2;
+    while (line_start < end) {
+        size_t line_end = _http.find("\r\n", line_start);
+        if (strncasecmp(_http.c_str() + line_start, "Sec-WebSocket-Key:", 18) == 0) {
+            size_t value = line_start + 18;
+            while (value < line_end && _http[value] == ' ') value++;
+            key = _http.substr(value, line_end - value);
+        }
+        line_start = line_end + 2;
+    }
+
+    if (key.empty()) {
+        _control_out = "HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n";
+        _flush();
+        _server.close_client(*this, "not a websocket upgrade");
+        return;
+    }
+
+    _control_out = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                   "Connection: Upgrade\r\nSec-WebSocket-Accept: " + ws_accept_key(key) + "\r\n\r\n";
+    std::string rest = _http.substr(end + 4);
+    _http.clear();
+    _http.shrink_to_fit();
+
+    _mode = Mode::WEBSOCKET;
+    _flush();
+    _open();
+    if (!rest.empty() && !_closing) _on_bytes(rest.data(), rest.size());
+}
+
+void ClientConn::_on_ws_message(uint8_t opcode, std::string_view payload) {
+    uint8_t header[10];
+    switch (opcode) {
+        case WS_OPCODE_TEXT:
+            while (!payload.empty() && (payload.back() == '\n' || payload.back() == '\r')) {
+                payload.remove_suffix(1);
+            }
+            if (!payload.empty() && _server._on_line) _server._on_line(*this, payload);
+            break;
+
+        case WS_OPCODE_PING: {
+            size_t n = ws_encode_header(WS_OPCODE_PONG, payload.size(), header);
+            _control_out.append((const char*)header, n);
+            _control_out.append(payload);
+            _flush();
+            break;
+        }
+
+        case WS_OPCODE_CLOSE: {
+            size_t n = ws_encode_header(WS_OPCODE_CLOSE, 0, header);
+            _control_out.append((const char*)header, n);
+            _flush();
+            _server.close_client(*this, "websocket close");
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// ============== Server ==============
+
+ClientServer::ClientServer(EventLoop& loop, const ClientServerConfig& config)
+    : _loop(loop), _config(config) {}
+
+ClientServer::~ClientServer() {
+    if (_timer) _loop.cancel_timer(_timer);
+    for (auto& entry : _clients) {
+        if (!entry.second->_closing) {
+            _loop.remove(entry.second->_fd);
+            close(entry.second->_fd);
+        }
+    }
+    if (_listen_fd >= 0) {
+        _loop.remove(_listen_fd);
+        close(_listen_fd);
+    }
+}
+
+bool ClientServer::start() {
+    _listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_listen_fd < 0) return false;
+
+    int one = 1;
+    setsockopt(_listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(_config.port);
+    if (inet_pton(AF_INET, _config.bind_address.c_str(), &addr.sin_addr) != 1) {
+        host_log(LogLevel::ERROR, "CLIENT", "Invalid bind address %s", _config.bind_address.c_str());
+        return false;
+    }
+    if (bind(_listen_fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(_listen_fd, 512) < 0) {
+        host_log(LogLevel::ERROR, "CLIENT", "Cannot listen on %s:%u: %s",
+                 _config.bind_address.c_str(), _config.port, strerror(errno));
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(_listen_fd, (sockaddr*)&addr, &len);
+    _bound_port = ntohs(addr.sin_port);
+
+    _loop.add(_listen_fd, EPOLLIN, [this](uint32_t) { _accept(); });
+    _timer = _loop.add_timer(100, 100, [this]() { _housekeeping(); });
+
+    host_log(LogLevel::INFO, "CLIENT", "Listening on %s:%u", _config.bind_address.c_str(), _bound_port);
+    return true;
+}
+
+void ClientServer::_accept() {
+    while (true) {
+        sockaddr_in addr {};
+        socklen_t len = sizeof(addr);
+        int fd = accept4(_listen_fd, (sockaddr*)&addr, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                host_log(LogLevel::WARN, "CLIENT", "accept failed: %s", strerror(errno));
+            }
+            return;
+        }
+
+        if (_clients.size() >= _config.max_clients) {
+            _stats.rejected++;
+            close(fd);
+            continue;
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
+        std::string peer = std::string(ip) + ":" + std::to_string(ntohs(addr.sin_port));
+
+        uint32_t id = _next_id++;
+        ClientConn* client = new ClientConn(*this, fd, id, peer);
+        _clients[id].reset(client);
+        _stats.accepted++;
+
+        _loop.add(fd, EPOLLIN | EPOLLRDHUP, [this, id](uint32_t events) {
+            ClientConn* c = find(id);
+            if (!c) return;
+            if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) c->_on_readable();
+            if (!c->_closing && (events & EPOLLOUT)) c->_flush();
+        });
+    }
+}
+
+void ClientServer::_housekeeping() {
+    uint64_t now = host_now_ms();
+    for (auto& entry : _clients) {
+        ClientConn& client = *entry.second;
+        if (client._closing || client._mode != ClientConn::Mode::DETECT) continue;
+        if (now - client._accepted_ms >= CLIENT_DETECT_TIMEOUT_MS) {
+            client._mode = ClientConn::Mode::RAW;
+            client._open();
+        }
+    }
+}
+
+void ClientServer::broadcast(const FramePtr& frame) {
+    for (auto& entry : _clients) {
+        if (entry.second->is_open()) entry.second->send(frame);
+    }
+}
+
+ClientConn* ClientServer::find(uint32_t id) {
+    auto it = _clients.find(id);
+    if (it == _clients.end() || it->second->_closing) return nullptr;
+    return it->second.get();
+}
+
+void ClientServer::close_client(ClientConn& client, const char* reason) {
+    if (client._closing) return;
+
+    bool was_open = client.is_open();
+    client._closing = true;
+    _loop.remove(client._fd);
+    close(client._fd);
+    client._queue.clear();
+
+    if (was_open) {
+        _open_count--;
+        host_log(LogLevel::INFO, "CLIENT", "#%u %s disconnected: %s", client._id, client._peer.c_str(), reason);
+        if (_on_close) _on_close(client);
+    }
+
+    // Callers up the stack may still hold a reference - free after dispatch
+    uint32_t id = client._id;
+    _loop.defer([this, id]() { _clients.erase(id); });
+}
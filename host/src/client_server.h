@@ -0,0 +1,145 @@
+#pragma once
+
+#include "event_loop.h"
+#include "ndjson.h"
+#include "websocket.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// ============== Client Server ==============
+// TCP listener serving NDJSON to local clients. As on the firmware WiFi
+// sink, the first bytes decide the framing: an HTTP "GET" upgrades to a
+// WebSocket, anything else (or silence) is raw NDJSON over TCP.
+//
+// Frames are shared: broadcast() queues the same FramePtr on every client
+// and each client writes it straight from the shared buffer. Each client
+// has its own byte budget; over budget the oldest droppable frames are
+// shed, and a client that can't even keep up with non-droppable frames is
+// disconnected rather than allowed to stall the others.
+
+#define CLIENT_DEFAULT_PORT         8765
+#define CLIENT_MAX_QUEUE_BYTES      (256 * 1024)
+#define CLIENT_MAX_CONNECTIONS      1024
+#define CLIENT_DETECT_TIMEOUT_MS    250     // Silent clients become raw TCP listeners
+#define CLIENT_HTTP_MAX_BYTES       8192
+
+struct ClientServerConfig {
+    std::string bind_address = "127.0.0.1";
+    uint16_t port = CLIENT_DEFAULT_PORT;
+    size_t max_queue_bytes = CLIENT_MAX_QUEUE_BYTES;
+    size_t max_clients = CLIENT_MAX_CONNECTIONS;
+};
+
+class ClientServer;
+
+class ClientConn {
+public:
+    uint32_t id() const { return _id; }
+    const std::string& peer() const { return _peer; }
+    bool is_websocket() const { return _mode == Mode::WEBSOCKET; }
+    bool is_open() const { return !_closing && (_mode == Mode::RAW || _mode == Mode::WEBSOCKET); }
+
+    // Queues a shared frame; never blocks
+    void send(const FramePtr& frame);
+
+    size_t queued_bytes() const { return _queued_bytes; }
+    uint64_t dropped_frames() const { return _dropped; }
+
+private:
+    friend class ClientServer;
+    enum class Mode { DETECT, HTTP, RAW, WEBSOCKET };
+
+    ClientConn(ClientServer& server, int fd, uint32_t id, std::string peer);
+
+    size_t _wire_size(const Frame& frame) const;
+    void _shed();
+    void _flush();
+    void _update_interest();
+    void _on_readable();
+    void _on_bytes(const char* data, size_t len);
+    void _on_http(const char* data, size_t len);
+    void _on_ws_message(uint8_t opcode, std::string_view payload);
+    void _open();
+
+    ClientServer& _server;
+    int _fd;
+    uint32_t _id;
+    std::string _peer;
+    Mode _mode = Mode::DETECT;
+    uint64_t _accepted_ms;
+    bool _closing = false;
+
+    std::string _http;
+    LineBuffer _lines;
+    WsDecoder _ws;
+
+    std::deque<FramePtr> _queue;
+    size_t _offset = 0;             // Bytes of the front frame already written
+    size_t _queued_bytes = 0;
+    std::string _control_out;       // Handshake / pong / close bytes
+    bool _want_write = false;
+    uint64_t _dropped = 0;
+};
+
+class ClientServer {
+public:
+    using LineHandler = std::function<void(ClientConn& client, std::string_view line)>;
+    using ClientHandler = std::function<void(ClientConn& client)>;
+
+    struct Stats {
+        uint64_t accepted = 0;
+        uint64_t rejected = 0;
+        uint64_t evicted = 0;
+        uint64_t dropped_frames = 0;
+    };
+
+    ClientServer(EventLoop& loop, const ClientServerConfig& config);
+    ~ClientServer();
+
+    bool start();
+
+    void on_open(ClientHandler handler) { _on_open = std::move(handler); }
+    void on_close(ClientHandler handler) { _on_close = std::move(handler); }
+    void on_line(LineHandler handler) { _on_line = std::move(handler); }
+
+    void broadcast(const FramePtr& frame);
+    ClientConn* find(uint32_t id);
+    void close_client(ClientConn& client, const char* reason);
+
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (auto& entry : _clients) {
+            if (entry.second->is_open()) fn(*entry.second);
+        }
+    }
+
+    size_t client_count() const { return _open_count; }
+    uint16_t port() const { return _bound_port; }
+    const Stats& stats() const { return _stats; }
+
+private:
+    friend class ClientConn;
+
+    void _accept();
+    void _housekeeping();
+
+    EventLoop& _loop;
+    ClientServerConfig _config;
+    int _listen_fd = -1;
+    uint16_t _bound_port = 0;
+    uint32_t _next_id = 1;
+    uint64_t _timer = 0;
+    size_t _open_count = 0;
+    std::unordered_map<uint32_t, std::unique_ptr<ClientConn>> _clients;
+    Stats _stats;
+
+    ClientHandler _on_open;
+    ClientHandler _on_close;
+    LineHandler _on_line;
+};
@@ -0,0 +1,26 @@
+#include "crc32.h"
+
+static uint32_t _table[256];
+static bool _table_ready = false;
+
+static void _build_table() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+        _table[i] = crc;
+    }
+    _table_ready = true;
+}
+
+uint32_t crc32(const void* data, size_t len, uint32_t seed) {
+    if (!_table_ready) _build_table();
+
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t crc = ~seed;
+    for (size_t i = 0; i < len; i++) {
+        crc = _table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
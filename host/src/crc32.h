@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3, reflected 0xEDB88320) - same checksum as the
+// firmware's EEPROM checkpoint records
+uint32_t crc32(const void* data, size_t len, uint32_t seed = 0);
@@ -0,0 +1,306 @@
+#include "emulator.h"
+#include "log.h"
+#include "serial_port.h"
+#include "telemetry_codec.h"
+
+#include <pty.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#define EMU_STEP_MS         100
+#define EMU_TIME_CONSTANT_S 90.0f   // Chamber lag toward its equilibrium
+#define EMU_PREHEAT_MARGIN  5.0f
+
+static float _clamp(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+RoasterEmulator::RoasterEmulator(EventLoop& loop, const EmulatorOptions& options)
+    : _loop(loop), _options(options) {
+    _chamber = _heater = _prev_chamber = options.ambient_temp;
+}
+
+RoasterEmulator::~RoasterEmulator() {
+    if (_timer) _loop.cancel_timer(_timer);
+    if (_master >= 0) {
+        _loop.remove(_master);
+        close(_master);
+    }
+    if (_slave >= 0) close(_slave);
+    if (!_link_path.empty()) unlink(_link_path.c_str());
+}
+
+bool RoasterEmulator::start(const std::string& link_path) {
+    char name[128];
+    if (openpty(&_master, &_slave, name, nullptr, nullptr) < 0) {
+        host_log(LogLevel::ERROR, "EMU", "openpty failed: %s", strerror(errno));
+        return false;
+    }
+    // Holding the slave open keeps the master readable across host reconnects
+    serial_configure(_slave, SERIAL_DEFAULT_BAUD);
+    serial_configure(_master, SERIAL_DEFAULT_BAUD);
+    _slave_path = name;
+
+    if (!link_path.empty()) {
+        unlink(link_path.c_str());
+        if (symlink(name, link_path.c_str()) < 0) {
+            host_log(LogLevel::ERROR, "EMU", "symlink %s failed: %s", link_path.c_str(), strerror(errno));
+            return false;
+        }
+        _link_path = link_path;
+    }
+
+    _start_ms = host_now_ms();
+    _last_step_ms = _start_ms;
+    _loop.add(_master, EPOLLIN, [this](uint32_t) { _on_readable(); });
+    _timer = _loop.add_timer(EMU_STEP_MS, EMU_STEP_MS, [this]() { _step(); });
+
+    if (_options.boot_chatter && !_options.silent) {
+        _send("McRoaster bootloader");
+    }
+    return true;
+}
+
+// ============== Protocol ==============
+
+void RoasterEmulator::_on_readable() {
+    char buf[1024];
+    while (true) {
+        ssize_t n = read(_master, buf, sizeof(buf));
+        if (n <= 0) return;
+        if (_options.silent) continue;
+
+        _last_rx_ms = host_now_ms();
+        if (!_session) {
+            _session = true;
+            _send_connected();
+        }
+        _lines.feed(buf, n, [this](std::string_view line) { _on_command(line); });
+    }
+}
+
+void RoasterEmulator::_on_command(std::string_view line) {
+    std::string_view type;
+    if (!json_get_string(line, "type", type)) return;
+    double value = 0;
+
+    if (type == "startPreheat") {
+        _setpoint = json_get_number(line, "targetTemp", value) ? (float)value : 180.0f;
+        if (_state == State::OFF || _state == State::FAN_ONLY) _set_state(State::PREHEAT);
+    } else if (type == "loadBeans") {
+        _setpoint = json_get_number(line, "setpoint", value) ? (float)value : 200.0f;
+        if (_state == State::PREHEAT) _set_state(State::ROASTING);
+    } else if (type == "endRoast") {
+        if (_state == State::ROASTING) _set_state(State::COOLING);
+    } else if (type == "markFirstCrack") {
+        // The firmware acknowledges every request with the event
+        if (_state == State::ROASTING && !_first_crack_ms) _first_crack_ms = host_now_ms();
+        char payload[96];
+        snprintf(payload, sizeof(payload), "\"event\":\"FIRST_CRACK\",\"roastTimeMs\":%llu,\"chamberTemp\":%.1f",
+                 (unsigned long long)(_roast_start_ms ? host_now_ms() - _roast_start_ms : 0), _chamber);
+        _send_reply("roastEvent", payload);
+    } else if (type == "stop") {
+        _set_state(State::OFF);
+    } else if (type == "enterFanOnly") {
+        if (_state == State::OFF) {
+            _set_state(State::FAN_ONLY);
+            if (json_get_number(line, "fanSpeed", value)) _fan = (uint8_t)_clamp(value, 0, 100);
+        }
+    } else if (type == "exitFanOnly" || type == "exitManual") {
+        _set_state(State::OFF);
+    } else if (type == "enterManual") {
+        if (_state == State::OFF) _set_state(State::MANUAL);
+    } else if (type == "setSetpoint") {
+        if (json_get_number(line, "value", value)) _setpoint = (float)value;
+    } else if (type == "setFanSpeed") {
+        if (json_get_number(line, "value", value)) _fan = (uint8_t)_clamp(value, 0, 100);
+    } else if (type == "setHeaterPower") {
+        if (_state == State::MANUAL && json_get_number(line, "value", value)) _power = (uint8_t)_clamp(value, 0, 100);
+    } else if (type == "getState") {
+        _send_state();
+    } else if (type == "getSelfTest") {
+        std::string payload = "\"passed\":true,\"tests\":[";
+        const char* names[] = { "max31855Present", "max31855Fault", "coldJunction", "thermistor", "fanPins", "ssrReadback" };
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+            if (i) payload += ',';
+            payload += "{\"name\":\"";
+            payload += names[i];
+            payload += "\",\"status\":\"pass\",\"durationUs\":0,\"value\":null}";
+        }
+        _send_reply("selfTest", payload + "]");
+    } else if (type == "getFaultHistory") {
+        _send_reply("faultHistory", "\"faults\":[]");
+    } else if (type == "getSensorStats") {
+        char payload[256];
+        snprintf(payload, sizeof(payload),
+                 "\"ssrGuardMs\":0,\"deferred\":0,\"intervalMs\":%u,"
+                 "\"heaterOn\":{\"samples\":0,\"faults\":0,\"noiseRms\":null},"
+                 "\"heaterOff\":{\"samples\":%u,\"faults\":0,\"noiseRms\":null}",
+                 _options.state_interval_ms, _seq);
+        _send_reply("sensorStats", payload);
+    } else if (type == "resend") {
+        // No telemetry ring - the whole range has been evicted
+        uint64_t from = 0, to = 0;
+        if (json_get_uint(line, "fromSeq", from) && json_get_uint(line, "toSeq", to) && from && from <= to) {
+            char payload[64];
+            snprintf(payload, sizeof(payload), "\"fromSeq\":%llu,\"toSeq\":%llu",
+                     (unsigned long long)from, (unsigned long long)to);
+            _send_reply("resendMiss", payload);
+        }
+    } else if (type == "downloadHistory") {
+        _send_reply("historyEnd", "\"fromSeq\":0,\"toSeq\":0,\"points\":0");
+    } else if (type == "profileEnd") {
+        _send_profile_status("Profiles are not supported by the emulator");
+    } else if (type == "clearProfile" || type == "getProfile") {
+        _send_profile_status(nullptr);
+    }
+}
+
+void RoasterEmulator::_set_state(State state) {
+    _state = state;
+    switch (state) {
+        case State::OFF:
+            _fan = 0;
+            _power = 0;
+            _roast_start_ms = 0;
+            _first_crack_ms = 0;
+            break;
+        case State::FAN_ONLY:
+            _fan = 50;
+            _power = 0;
+            break;
+        case State::PREHEAT:
+            _preheat_ready = false;
+            _fan = 60;
+            break;
+        case State::ROASTING:
+            _roast_start_ms = host_now_ms();
+            _first_crack_ms = 0;
+            _fan = 65;
+            break;
+        case State::COOLING:
+            _fan = 100;
+            _power = 0;
+            break;
+        case State::MANUAL:
+            _fan = 0;
+            _power = 0;
+            break;
+        case State::ERROR:
+            _power = 0;
+            break;
+    }
+}
+
+// ============== Simulation ==============
+
+void RoasterEmulator::_step() {
+    uint64_t now = host_now_ms();
+    float dt = (now - _last_step_ms) / 1000.0f;
+    _last_step_ms = now;
+
+    // Session watchdog - same behaviour as serial_comm_update()
+    if (_session && now - _last_rx_ms > EMU_SESSION_TIMEOUT_MS) {
+        _session = false;
+        if (_state == State::PREHEAT || _state == State::ROASTING) {
+            _send_log("warn", "Disconnect during active state - entering cooling");
+            _set_state(State::COOLING);
+        } else if (_state == State::MANUAL || _state == State::FAN_ONLY) {
+            _set_state(State::OFF);
+        }
+    }
+
+    // Crude proportional heater in automatic states
+    if (_state == State::PREHEAT || _state == State::ROASTING) {
+        _power = (uint8_t)_clamp((_setpoint - _chamber) * 8.0f, 0, 100);
+        if (_state == State::PREHEAT && !_preheat_ready && _chamber >= _setpoint - EMU_PREHEAT_MARGIN) {
+            _preheat_ready = true;
+            _send_log("info", "Preheat target reached");
+        }
+    }
+    if (_state == State::COOLING && _chamber < 50.0f) _set_state(State::OFF);
+
+    // Airflow carries heat away; more fan means a lower equilibrium
+    float equilibrium = _options.ambient_temp + _power * 2.8f * (1.0f - _fan * 0.004f);
+    _chamber += (equilibrium - _chamber) * dt / EMU_TIME_CONSTANT_S;
+    _heater += (_options.ambient_temp + _power * 0.8f - _heater) * dt / 30.0f;
+
+    if (_session && now - _last_state_ms >= _options.state_interval_ms) {
+        _ror = (_chamber - _prev_chamber) * 60000.0f / (now - _last_state_ms);
+        _prev_chamber = _chamber;
+        _send_state();
+    }
+}
+
+// ============== Output ==============
+
+void RoasterEmulator::_send(const std::string& line) {
+    std::string out = line + "\r\n";
+    // A full pty buffer means nobody is reading - drop like a real USB CDC
+    if (write(_master, out.data(), out.size()) < 0 && errno != EAGAIN) {
+        host_log(LogLevel::DEBUG, "EMU", "write failed: %s", strerror(errno));
+    }
+}
+
+void RoasterEmulator::_send_connected() {
+    char json[160];
+    snprintf(json, sizeof(json),
+             "{\"type\":\"connected\",\"timestamp\":%llu,\"payload\":{\"firmware\":\"%s\",\"seq\":%u}}",
+             (unsigned long long)(host_now_ms() - _start_ms), EMU_FIRMWARE_VERSION, _seq);
+    _send(json);
+}
+
+void RoasterEmulator::_send_log(const char* level, const char* message) {
+    char json[256];
+    snprintf(json, sizeof(json),
+             "{\"type\":\"log\",\"timestamp\":%llu,\"payload\":{\"level\":\"%s\",\"source\":\"EMU\",\"message\":\"%s\"}}",
+             (unsigned long long)(host_now_ms() - _start_ms), level, message);
+    _send(json);
+}
+
+void RoasterEmulator::_send_reply(const char* type, const std::string& payload) {
+    char head[96];
+    snprintf(head, sizeof(head), "{\"type\":\"%s\",\"timestamp\":%llu,\"payload\":{",
+             type, (unsigned long long)(host_now_ms() - _start_ms));
+    _send(head + payload + "}}");
+}
+
+void RoasterEmulator::_send_profile_status(const char* error) {
+    std::string payload = "\"loaded\":false,\"active\":false,\"points\":0,\"received\":0,\"stepMs\":0,"
+                          "\"fanEvents\":0,\"durationMs\":0,\"elapsedMs\":0,\"error\":";
+    payload += error ? "\"" + std::string(error) + "\"" : "null";
+    _send_reply("profileStatus", payload);
+}
+
+void RoasterEmulator::_send_state() {
+    uint64_t now = host_now_ms();
+    _last_state_ms = now;
+    _seq++;
+
+    TelemetrySample sample = {};
+    sample.seq = _seq;
+    sample.timestampMs = (uint32_t)(now - _start_ms);
+    sample.roastTimeMs = (uint32_t)(_roast_start_ms ? now - _roast_start_ms : 0);
+    sample.firstCrackTimeMs = (uint32_t)(_first_crack_ms ? _first_crack_ms - _roast_start_ms : 0);
+    sample.chamberTemp = _chamber;
+    sample.heaterTemp = _heater;
+    sample.setpoint = _setpoint;
+    sample.ror = _ror;
+    sample.profileLeadMs = TELEMETRY_NULL_I32;
+    sample.preheatEtaMs = TELEMETRY_NULL_I32;
+    sample.stateId = (uint8_t)_state;
+    sample.fanSpeed = _fan;
+    sample.heaterPower = _power;
+    if (_state == State::PREHEAT || _state == State::ROASTING || _state == State::MANUAL) {
+        sample.flags |= TELEMETRY_FLAG_HEATER_ENABLED;
+    }
+    if (_state == State::PREHEAT || _state == State::ROASTING) sample.flags |= TELEMETRY_FLAG_PID_ENABLED;
+    if (_first_crack_ms) sample.flags |= TELEMETRY_FLAG_FIRST_CRACK;
+    if (_state == State::PREHEAT && _preheat_ready) sample.flags |= TELEMETRY_FLAG_PREHEAT_READY;
+
+    char json[TELEMETRY_JSON_MAX];
+    if (telemetry_encode_json(sample, false, "\"error\":null", json, sizeof(json))) _send(json);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "event_loop.h"
+#include "ndjson.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ============== Roaster Emulator ==============
+// Speaks the firmware's serial protocol on a pty so host tools can be
+// exercised without hardware. Mirrors serial_comm.cpp's session rules:
+// "connected" is sent when the first byte arrives after an idle period, a
+// roasterState frame goes out every second, and 5 s without input counts
+// as a disconnect (active roasts fall back to COOLING).
+//
+// The thermal model is a single first-order lag toward a temperature set
+// by heater power and fan speed - enough for plausible curves, not physics.
+//
+// Every command that the firmware answers gets its reply message. There is
+// no telemetry ring, self-test hardware or profile engine behind them:
+// selfTest always passes, faultHistory is empty, resend reports the whole
+// range missed, downloadHistory ends with no points, and profileEnd
+// rejects the upload.
+
+#define EMU_STATE_INTERVAL_MS   1000
+#define EMU_SESSION_TIMEOUT_MS  5000
+#define EMU_FIRMWARE_VERSION    "3.0.0-emu"
+
+struct EmulatorOptions {
+    uint32_t state_interval_ms = EMU_STATE_INTERVAL_MS;
+    float ambient_temp = 22.0f;
+    bool silent = false;        // Never answers - models a non-roaster tty
+    bool boot_chatter = true;   // Non-JSON text before the first frame
+};
+
+class RoasterEmulator {
+public:
+    RoasterEmulator(EventLoop& loop, const EmulatorOptions& options);
+    ~RoasterEmulator();
+
+    RoasterEmulator(const RoasterEmulator&) = delete;
+    RoasterEmulator& operator=(const RoasterEmulator&) = delete;
+
+    // Creates the pty; link_path (optional) becomes a symlink to its slave
+    bool start(const std::string& link_path);
+
+    const std::string& slave_path() const { return _slave_path; }
+    uint32_t frames_sent() const { return _seq; }
+
+private:
+    enum class State : uint8_t { OFF, FAN_ONLY, PREHEAT, ROASTING, COOLING, MANUAL, ERROR };
+
+    void _on_readable();
+    void _on_command(std::string_view line);
+    void _step();
+    void _set_state(State state);
+    void _send(const std::string& line);
+    void _send_state();
+    void _send_connected();
+    void _send_log(const char* level, const char* message);
+    void _send_reply(const char* type, const std::string& payload);
+    void _send_profile_status(const char* error);
+
+    EventLoop& _loop;
+    EmulatorOptions _options;
+    int _master = -1;
+    int _slave = -1;
+    std::string _slave_path;
+    std::string _link_path;
+    uint64_t _timer = 0;
+    uint64_t _start_ms = 0;
+    LineBuffer _lines;
+
+    bool _session = false;
+    uint64_t _last_rx_ms = 0;
+    uint64_t _last_state_ms = 0;
+    uint64_t _last_step_ms = 0;
+    uint32_t _seq = 0;
+
+    State _state = State::OFF;
+    float _chamber = 0;
+    float _heater = 0;
+    float _setpoint = 0;
+    float _prev_chamber = 0;
+    float _ror = 0;
+    uint8_t _fan = 0;
+    uint8_t _power = 0;
+    uint64_t _roast_start_ms = 0;
+    uint64_t _first_crack_ms = 0;
+    bool _preheat_ready = false;
+};
@@ -0,0 +1,147 @@
+#include "event_loop.h"
+#include "log.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#define EVENT_BATCH_SIZE 256
+
+EventLoop::EventLoop() {
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd < 0) {
+        host_log(LogLevel::ERROR, "LOOP", "epoll_create1 failed: %s", strerror(errno));
+    }
+}
+
+EventLoop::~EventLoop() {
+    if (_epoll_fd >= 0) close(_epoll_fd);
+}
+
+// ============== File Descriptors ==============
+
+bool EventLoop::add(int fd, uint32_t events, FdHandler handler) {
+    epoll_event ev {};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        host_log(LogLevel::ERROR, "LOOP", "epoll add fd %d failed: %s", fd, strerror(errno));
+        return false;
+    }
+    _handlers[fd] = std::make_shared<FdHandler>(std::move(handler));
+    return true;
+}
+
+bool EventLoop::modify(int fd, uint32_t events) {
+    epoll_event ev {};
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EventLoop::remove(int fd) {
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    _handlers.erase(fd);
+}
+
+// ============== Timers ==============
+
+uint64_t EventLoop::add_timer(uint32_t delay_ms, uint32_t interval_ms, Callback callback) {
+    uint64_t id = _next_timer_id++;
+    _timers.push_back({ id, host_now_ms() + delay_ms, interval_ms, std::move(callback) });
+    return id;
+}
+
+void EventLoop::cancel_timer(uint64_t id) {
+    for (Timer& timer : _timers) {
+        if (timer.id == id) {
+            // Erased lazily so cancelling from inside a timer callback is safe
+            timer.callback = nullptr;
+        }
+    }
+}
+
+int EventLoop::_next_timeout_ms(int max_wait_ms) const {
+    if (!_deferred.empty()) return 0;
+
+    uint64_t now = host_now_ms();
+    int timeout = max_wait_ms;
+    for (const Timer& timer : _timers) {
+        if (!timer.callback) continue;
+        int wait = timer.due_ms > now ? (int)(timer.due_ms - now) : 0;
+        if (timeout < 0 || wait < timeout) timeout = wait;
+    }
+    return timeout;
+}
+
+void EventLoop::_run_timers() {
+    uint64_t now = host_now_ms();
+
+    // Index loop - callbacks may append new timers
+    for (size_t i = 0; i < _timers.size(); i++) {
+        if (!_timers[i].callback || _timers[i].due_ms > now) continue;
+
+        Callback callback = _timers[i].callback;
+        if (_timers[i].interval_ms > 0) {
+            _timers[i].due_ms += _timers[i].interval_ms;
+            if (_timers[i].due_ms <= now) _timers[i].due_ms = now + _timers[i].interval_ms;
+        } else {
+            _timers[i].callback = nullptr;
+        }
+        callback();
+    }
+
+    _timers.erase(std::remove_if(_timers.begin(), _timers.end(),
+                                 [](const Timer& t) { return !t.callback; }),
+                  _timers.end());
+}
+
+// ============== Dispatch ==============
+
+void EventLoop::defer(Callback callback) {
+    _deferred.push_back(std::move(callback));
+}
+
+void EventLoop::_run_deferred() {
+    while (!_deferred.empty()) {
+        std::vector<Callback> batch;
+        batch.swap(_deferred);
+        for (Callback& callback : batch) callback();
+    }
+}
+
+void EventLoop::run_once(int max_wait_ms) {
+    epoll_event events[EVENT_BATCH_SIZE];
+    int count = epoll_wait(_epoll_fd, events, EVENT_BATCH_SIZE, _next_timeout_ms(max_wait_ms));
+    if (count < 0 && errno != EINTR) {
+        host_log(LogLevel::ERROR, "LOOP", "epoll_wait failed: %s", strerror(errno));
+        _running = false;
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        auto it = _handlers.find(events[i].data.fd);
+        if (it == _handlers.end()) continue;
+
+        // Hold a reference - the handler may remove itself
+        std::shared_ptr<FdHandler> handler = it->second;
+        (*handler)(events[i].events);
+    }
+
+    _run_deferred();
+    _run_timers();
+    _run_deferred();
+}
+
+void EventLoop::run() {
+    _running = true;
+    while (_running) {
+        run_once(-1);
+    }
+}
+
+void EventLoop::stop() {
+    _running = false;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// ============== Event Loop ==============
+// Single-threaded epoll loop with fd handlers, periodic/one-shot timers and
+// deferred callbacks. Handlers may add/remove fds (including their own) from
+// inside a callback.
+
+class EventLoop {
+public:
+    using FdHandler = std::function<void(uint32_t events)>;
+    using Callback = std::function<void()>;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool add(int fd, uint32_t events, FdHandler handler);
+    bool modify(int fd, uint32_t events);
+    void remove(int fd);
+
+    // Returns a timer id for cancel_timer(); interval 0 = one-shot
+    uint64_t add_timer(uint32_t delay_ms, uint32_t interval_ms, Callback callback);
+    void cancel_timer(uint64_t id);
+
+    // Runs after the current batch of fd events has been dispatched
+    void defer(Callback callback);
+
+    void run();
+    void run_once(int max_wait_ms);
+    // Safe to call from another thread; takes effect within one wait
+    void stop();
+
+private:
+    struct Timer {
+        uint64_t id;
+        uint64_t due_ms;
+        uint32_t interval_ms;
+        Callback callback;
+    };
+
+    int _next_timeout_ms(int max_wait_ms) const;
+    void _run_timers();
+    void _run_deferred();
+
+    int _epoll_fd;
+    std::atomic<bool> _running { false };
+    uint64_t _next_timer_id = 1;
+    std::unordered_map<int, std::shared_ptr<FdHandler>> _handlers;
+    std::vector<Timer> _timers;
+    std::vector<Callback> _deferred;
+};
@@ -0,0 +1,241 @@
+#include "fleet.h"
+#include "log.h"
+
+#include <glob.h>
+#include <climits>
+#include <cstdlib>
+
+// Extracts the "payload" object of a firmware frame for embedding
+static std::string_view _payload_of(const Frame& frame) {
+    size_t pos = frame.text.find("\"payload\":");
+    if (pos == std::string::npos || frame.text.size() < pos + 12) return {};
+    // Envelope always ends with the payload object and one closing brace
+    return std::string_view(frame.text).substr(pos + 10, frame.text.size() - 2 - (pos + 10));
+}
+
+FleetManager::FleetManager(EventLoop& loop, const FleetConfig& config)
+    : _loop(loop), _config(config), _server(loop, config.server) {}
+
+FleetManager::~FleetManager() {
+    if (_timer) _loop.cancel_timer(_timer);
+}
+
+bool FleetManager::start() {
+    _server.on_line([this](ClientConn& client, std::string_view line) { _on_client_line(client, line); });
+    _server.on_open([this](ClientConn& client) { client.send(frame_make(status_json())); });
+    if (!_server.start()) return false;
+
+    _rescan();
+    _timer = _loop.add_timer(100, 100, [this]() { _tick(); });
+    return true;
+}
+
+size_t FleetManager::devices_up() const {
+    size_t up = 0;
+    for (const auto& entry : _devices) {
+        if (entry.second->link->state() == LinkState::UP) up++;
+    }
+    return up;
+}
+
+// ============== Devices ==============
+
+void FleetManager::_tick() {
+    uint64_t now = host_now_ms();
+
+    for (auto& entry : _devices) entry.second->link->tick();
+
+    if (now - _last_rescan_ms >= _config.rescan_ms) _rescan();
+
+    if (now - _last_status_ms >= _config.status_ms) {
+        _last_status_ms = now;
+        if (_server.client_count() > 0) _server.broadcast(frame_make(status_json()));
+    }
+}
+
+void FleetManager::_rescan() {
+    uint64_t now = host_now_ms();
+    _last_rescan_ms = now;
+
+    for (auto& entry : _devices) entry.second->present = false;
+
+    for (const std::string& pattern : _config.patterns) {
+        glob_t matches;
+        if (glob(pattern.c_str(), 0, nullptr, &matches) != 0) continue;
+
+        for (size_t i = 0; i < matches.gl_pathc; i++) {
+            std::string path = matches.gl_pathv[i];
+            auto known = _path_ids.find(path);
+            if (known != _path_ids.end()) {
+                _devices[known->second]->present = true;
+                continue;
+            }
+
+            auto ignored = _ignored.find(path);
+            if (ignored != _ignored.end() && now < ignored->second) continue;
+            _add_device(path);
+        }
+        globfree(&matches);
+    }
+
+    // Units that are unplugged and not reconnecting leave the fleet
+    std::vector<std::string> gone;
+    for (auto& entry : _devices) {
+        if (!entry.second->present && entry.second->link->state() == LinkState::DOWN) gone.push_back(entry.first);
+    }
+    for (const std::string& id : gone) _remove_device(id);
+}
+
+void FleetManager::_add_device(const std::string& path) {
+    // Short ids for the stream; fall back to the full path on a clash
+    std::string id = path.substr(path.find_last_of('/') + 1);
+    if (_devices.count(id)) id = path;
+
+    auto device = std::make_unique<Device>();
+    device->id = id;
+    device->link = std::make_unique<RoasterLink>(_loop, path, _config.baud);
+    device->link->set_keepalive(_config.keepalive_ms);
+
+    Device* raw = device.get();
+    device->link->on_frame([this, raw](const FramePtr& frame) { _on_device_frame(*raw, frame); });
+    device->link->on_state([this, raw](LinkState state, const char*) { _on_device_state(*raw, state); });
+
+    _path_ids[path] = id;
+    _devices[id] = std::move(device);
+    _ignored.erase(path);
+
+    host_log(LogLevel::DEBUG, "FLEET", "Probing %s as %s", path.c_str(), id.c_str());
+    raw->link->open();
+}
+
+void FleetManager::_remove_device(const std::string& id) {
+    auto it = _devices.find(id);
+    if (it == _devices.end()) return;
+
+    host_log(LogLevel::INFO, "FLEET", "%s left the fleet", id.c_str());
+    _path_ids.erase(it->second->link->path());
+    _devices.erase(it);
+}
+
+void FleetManager::_on_device_state(Device& device, LinkState state) {
+    if (state == LinkState::UP && !device.ever_up) {
+        device.ever_up = true;
+        host_log(LogLevel::INFO, "FLEET", "%s joined (firmware %s)", device.id.c_str(),
+                 device.link->firmware().empty() ? "?" : device.link->firmware().c_str());
+    }
+
+    if (state == LinkState::DOWN && !device.ever_up) {
+        // Never handshook - not a roaster. Drop it once the link call returns.
+        std::string id = device.id;
+        _ignored[device.link->path()] = host_now_ms() + FLEET_IGNORE_MS;
+        _loop.defer([this, id]() { _remove_device(id); });
+        return;
+    }
+
+    if (_server.client_count() > 0) _server.broadcast(frame_make(status_json()));
+}
+
+void FleetManager::_on_device_frame(Device& device, const FramePtr& frame) {
+    if (frame->type == "roasterState" && frame->text.find("\"replay\":true") == std::string::npos) {
+        device.last_state = frame;
+    }
+    if (_server.client_count() == 0) return;
+
+    // Tag once, then share the tagged frame with every client
+    std::string line = "{\"device\":\"" + json_escape(device.id) + "\",";
+    line.append(frame->text, 1, frame->text.size() - 2);
+    _server.broadcast(frame_make(line));
+}
+
+// ============== Clients ==============
+
+void FleetManager::_on_client_line(ClientConn& client, std::string_view line) {
+    std::string_view type;
+    if (!json_get_string(line, "type", type)) {
+        _send_error(client, 400, "Missing message type");
+        return;
+    }
+    if (type == "getFleetStatus") {
+        client.send(frame_make(status_json()));
+        return;
+    }
+
+    std::string_view target;
+    if (!json_get_string(line, "device", target)) {
+        _send_error(client, 400, "Missing device");
+        return;
+    }
+
+    if (target == "*") {
+        if (type != "stop" && type != "getState") {
+            _send_error(client, 400, "Only stop and getState may target every device");
+            return;
+        }
+        for (auto& entry : _devices) entry.second->link->send(line);
+        return;
+    }
+
+    auto it = _devices.find(std::string(target));
+    if (it == _devices.end()) {
+        _send_error(client, 404, "Unknown device " + std::string(target));
+        return;
+    }
+    if (!it->second->link->send(line)) {
+        _send_error(client, 503, "Device " + std::string(target) + " link is down");
+    }
+}
+
+void FleetManager::_send_error(ClientConn& client, int code, const std::string& message) {
+    std::string json = "{\"type\":\"error\",\"timestamp\":" + std::to_string(host_now_ms()) +
+                       ",\"payload\":{\"code\":" + std::to_string(code) +
+                       ",\"message\":\"" + json_escape(message) + "\"}}";
+    client.send(frame_make(json));
+}
+
+// ============== Status ==============
+
+std::string FleetManager::status_json() const {
+    uint64_t now = host_now_ms();
+    std::string json = "{\"type\":\"fleetStatus\",\"timestamp\":" + std::to_string(now) +
+                       ",\"payload\":{\"devices\":[";
+
+    bool first = true;
+    for (const auto& entry : _devices) {
+        const Device& device = *entry.second;
+        if (!device.ever_up) continue;
+
+        const RoasterLink& link = *device.link;
+        const RoasterLink::Stats& stats = link.stats();
+        const LatencyHistogram& rtt = link.rtt();
+        char metrics[384];
+        snprintf(metrics, sizeof(metrics),
+                 "\"framesIn\":%llu,\"commandsOut\":%llu,\"seqGaps\":%llu,\"reconnects\":%llu,"
+                 "\"lineOverflows\":%llu,\"lastFrameAgeMs\":%lld,"
+                 "\"rttMs\":{\"last\":%.1f,\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f,\"count\":%llu}",
+                 (unsigned long long)stats.frames_in, (unsigned long long)stats.commands_out,
+                 (unsigned long long)stats.seq_gaps, (unsigned long long)stats.reconnects,
+                 (unsigned long long)link.line_overflows(),
+                 stats.last_frame_ms ? (long long)(now - stats.last_frame_ms) : -1LL,
+                 rtt.last() / 1000.0, rtt.percentile(0.5) / 1000.0, rtt.percentile(0.99) / 1000.0,
+                 rtt.max() / 1000.0, (unsigned long long)rtt.count());
+
+        // A live link with no frames for a while is reported as stale
+        const char* health = link_state_name(link.state());
+        if (link.state() == LinkState::UP && stats.last_frame_ms && now - stats.last_frame_ms > LINK_STALE_MS) {
+            health = "stale";
+        }
+
+        if (!first) json += ",";
+        first = false;
+        json += "{\"id\":\"" + json_escape(device.id) + "\",\"path\":\"" + json_escape(link.path()) +
+                "\",\"link\":\"" + health + "\",\"firmware\":\"" + json_escape(link.firmware()) + "\",";
+        json += metrics;
+        json += ",\"state\":";
+        std::string_view payload = device.last_state ? _payload_of(*device.last_state) : std::string_view();
+        json += payload.empty() ? std::string_view("null") : payload;
+        json += "}";
+    }
+
+    json += "]}}";
+    return json;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "client_server.h"
+#include "event_loop.h"
+#include "ndjson.h"
+#include "roaster_link.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// ============== Fleet Manager ==============
+// Runs many roaster serial links in one event loop and merges them into a
+// single client stream. Device paths come from glob patterns that are
+// rescanned periodically; a tty only joins the fleet once it answers with
+// the firmware handshake, so unrelated serial devices are probed and then
+// left alone for a while.
+//
+// Every device frame is forwarded with a "device" field added up front:
+//   {"device":"ttyACM0","type":"roasterState","seq":12,...}
+// Clients address commands the same way; "device":"*" fans a stop or
+// getState out to every unit. A fleetStatus message with per-device link
+// health, latency and last state is broadcast periodically and on request
+// (getFleetStatus).
+//
+// While the service runs it is the host for every unit, so each link's
+// firmware watchdog is always fed.
+
+#define FLEET_DEFAULT_PORT      8766
+#define FLEET_KEEPALIVE_MS      2000
+#define FLEET_RESCAN_MS         5000
+#define FLEET_STATUS_MS         5000
+#define FLEET_IGNORE_MS         60000   // Back-off for ttys that never handshake
+
+struct FleetConfig {
+    std::vector<std::string> patterns;
+    int baud = 115200;
+    ClientServerConfig server;
+    uint32_t keepalive_ms = FLEET_KEEPALIVE_MS;
+    uint32_t rescan_ms = FLEET_RESCAN_MS;
+    uint32_t status_ms = FLEET_STATUS_MS;
+};
+
+class FleetManager {
+public:
+    FleetManager(EventLoop& loop, const FleetConfig& config);
+    ~FleetManager();
+
+    bool start();
+
+    size_t device_count() const { return _devices.size(); }
+    size_t devices_up() const;
+    ClientServer& server() { return _server; }
+
+    std::string status_json() const;
+
+private:
+    struct Device {
+        std::string id;
+        std::unique_ptr<RoasterLink> link;
+        bool ever_up = false;
+        bool present = true;        // Matched by the latest rescan
+        FramePtr last_state;
+    };
+
+    void _tick();
+    void _rescan();
+    void _add_device(const std::string& path);
+    void _remove_device(const std::string& id);
+    void _on_device_frame(Device& device, const FramePtr& frame);
+    void _on_device_state(Device& device, LinkState state);
+    void _on_client_line(ClientConn& client, std::string_view line);
+    void _send_error(ClientConn& client, int code, const std::string& message);
+
+    EventLoop& _loop;
+    FleetConfig _config;
+    ClientServer _server;
+    uint64_t _timer = 0;
+    uint64_t _last_rescan_ms = 0;
+    uint64_t _last_status_ms = 0;
+
+    std::map<std::string, std::unique_ptr<Device>> _devices;    // By id, stable order
+    std::unordered_map<std::string, std::string> _path_ids;     // path -> id
+    std::unordered_map<std::string, uint64_t> _ignored;         // path -> retry time
+};
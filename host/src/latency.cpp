@@ -0,0 +1,47 @@
+#include "latency.h"
+
+uint32_t LatencyHistogram::_bucket(uint64_t us) {
+    if (us < LATENCY_SUB_BUCKETS) return (uint32_t)us;
+
+    uint32_t range = 63 - __builtin_clzll(us);     // floor(log2(us)), >= 3
+    uint32_t sub = (uint32_t)(us >> (range - 3)) & (LATENCY_SUB_BUCKETS - 1);
+    uint32_t bucket = (range - 2) * LATENCY_SUB_BUCKETS + sub;
+    return bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1;
+}
+
+uint64_t LatencyHistogram::_bucket_upper(uint32_t bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS) return bucket;
+
+    uint32_t range = bucket / LATENCY_SUB_BUCKETS + 2;
+    uint64_t sub = bucket % LATENCY_SUB_BUCKETS;
+    return ((LATENCY_SUB_BUCKETS + sub + 1) << (range - 3)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t us) {
+    _buckets[_bucket(us)]++;
+    _count++;
+    _sum += us;
+    _last = us;
+    if (us > _max) _max = us;
+}
+
+void LatencyHistogram::reset() {
+    *this = LatencyHistogram();
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (_count == 0) return 0;
+
+    uint64_t target = (uint64_t)(p * _count);
+    if (target >= _count) target = _count - 1;
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += _buckets[i];
+        if (seen > target) {
+            uint64_t upper = _bucket_upper(i);
+            return upper < _max ? upper : _max;
+        }
+    }
+    return _max;
+}
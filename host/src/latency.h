@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// ============== Latency Histogram ==============
+// Fixed-size log-linear histogram of microsecond samples: power-of-two
+// ranges split into 8 linear sub-buckets (~12% resolution), so recording is
+// O(1) with no allocation and percentiles stay cheap to query.
+
+#define LATENCY_SUB_BUCKETS     8
+#define LATENCY_RANGES          32
+#define LATENCY_BUCKETS         (LATENCY_RANGES * LATENCY_SUB_BUCKETS)
+
+class LatencyHistogram {
+public:
+    void record(uint64_t us);
+    void reset();
+
+    uint64_t count() const { return _count; }
+    uint64_t max() const { return _max; }
+    uint64_t last() const { return _last; }
+    double mean() const { return _count ? (double)_sum / _count : 0.0; }
+
+    // Upper bound of the bucket holding the p-th quantile (0..1)
+    uint64_t percentile(double p) const;
+
+private:
+    static uint32_t _bucket(uint64_t us);
+    static uint64_t _bucket_upper(uint32_t bucket);
+
+    uint64_t _buckets[LATENCY_BUCKETS] = {};
+    uint64_t _count = 0;
+    uint64_t _sum = 0;
+    uint64_t _max = 0;
+    uint64_t _last = 0;
+};
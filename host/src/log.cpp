@@ -0,0 +1,40 @@
+#include "log.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+
+static LogLevel _min_level = LogLevel::INFO;
+
+static const char* _level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "debug";
+        case LogLevel::INFO:  return "info";
+        case LogLevel::WARN:  return "warn";
+        case LogLevel::ERROR: return "error";
+    }
+    return "?";
+}
+
+void host_log_set_level(LogLevel level) {
+    _min_level = level;
+}
+
+void host_log(LogLevel level, const char* source, const char* fmt, ...) {
+    if (level < _min_level) return;
+
+    char message[512];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(message, sizeof(message), fmt, args);
+    va_end(args);
+
+    fprintf(stderr, "[%10.3f] %-5s %-8s %s\n",
+            host_now_ms() / 1000.0, _level_name(level), source, message);
+}
+
+uint64_t host_now_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// ============== Host Logging ==============
+// Mirrors the firmware's serial_send_log(level, SOURCE, msg) convention,
+// written to stderr so stdout stays free for data streams.
+
+enum class LogLevel : uint8_t {
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR
+};
+
+void host_log_set_level(LogLevel level);
+void host_log(LogLevel level, const char* source, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Monotonic milliseconds since an arbitrary epoch
+uint64_t host_now_ms();
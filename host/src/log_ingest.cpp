@@ -0,0 +1,483 @@
+#include "log_ingest.h"
+#include "crc32.h"
+#include "log.h"
+#include "ndjson.h"
+#include "telemetry_codec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Runs fn() on `threads` threads including the caller
+template <typename Fn>
+static void _parallel(unsigned threads, Fn&& fn) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) pool.emplace_back(fn);
+    fn();
+    for (std::thread& thread : pool) thread.join();
+}
+
+// ============== Line Scanning ==============
+
+// Bit i set where block[i] == '\n'
+static inline uint64_t _newline_mask(const char* block) {
+#if defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+        mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, nl)) << (16 * i);
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++) mask |= (uint64_t)(block[i] == '\n') << i;
+    return mask;
+#endif
+}
+
+// Calls fn(begin, end) for every line in [begin, end), newline excluded
+template <typename Fn>
+static void _for_each_line(const char* begin, const char* end, Fn&& fn) {
+    const char* line = begin;
+    const char* p = begin;
+    for (; end - p >= 64; p += 64) {
+        for (uint64_t mask = _newline_mask(p); mask; mask &= mask - 1) {
+            const char* nl = p + __builtin_ctzll(mask);
+            fn(line, nl);
+            line = nl + 1;
+        }
+    }
+    for (; p < end; p++) {
+        if (*p == '\n') {
+            fn(line, p);
+            line = p + 1;
+        }
+    }
+    if (line < end) fn(line, end);
+}
+
+// ============== Line Classification ==============
+
+template <size_t N>
+static inline bool _lit(const char*& p, const char* end, const char (&text)[N]) {
+    if ((size_t)(end - p) < N - 1 || memcmp(p, text, N - 1) != 0) return false;
+    p += N - 1;
+    return true;
+}
+
+// ============== Chunk Parsing ==============
+
+struct ChunkResult {
+    std::vector<IngestSample> samples;
+    std::vector<std::string> devices;   // Local names; index 0 = default device
+    IngestStats stats;
+};
+
+static uint32_t _local_device(ChunkResult& chunk, std::string_view name) {
+    for (size_t i = 1; i < chunk.devices.size(); i++) {
+        if (chunk.devices[i] == name) return (uint32_t)i;
+    }
+    chunk.devices.emplace_back(name);
+    return (uint32_t)chunk.devices.size() - 1;
+}
+
+static void _parse_line(const char* p, const char* end, ChunkResult& chunk) {
+    if (end > p && end[-1] == '\r') end--;
+    if (end == p) return;
+    IngestStats& stats = chunk.stats;
+    stats.lines++;
+    const char* line = p;
+
+    // {"device":"id",<original fields>} from the fleet service
+    uint32_t device = 0;
+    if (_lit(p, end, "{\"device\":\"")) {
+        const char* quote = (const char*)memchr(p, '"', end - p);
+        if (!quote) {
+            stats.malformed++;
+            return;
+        }
+        device = _local_device(chunk, std::string_view(p, quote - p));
+        p = quote + 1;
+        if (!_lit(p, end, ",")) {
+            stats.malformed++;
+            return;
+        }
+    } else if (!_lit(p, end, "{")) {
+        stats.malformed++;
+        return;
+    }
+
+    IngestSample out;
+    out.device = device;
+    bool replay = false;
+    if (_lit(p, end, "\"type\":\"")) {
+        if (_lit(p, end, "roasterState\",")) {
+            TelemetrySample frame;
+            TelemetryDecode decoded = telemetry_decode_json(line, end - line, frame, replay);
+            if (decoded == TelemetryDecode::INVALID) {
+                stats.malformed++;
+                return;
+            }
+            if (replay) {
+                stats.replays++;
+                return;
+            }
+            stats.states++;
+            if (decoded == TelemetryDecode::FIXED_LAYOUT) stats.fast_path++;
+            memset(&out.sample, 0, sizeof(out.sample));
+            sample_from_telemetry(frame, out.sample);
+            chunk.samples.push_back(out);
+            return;
+        }
+        if (_lit(p, end, "log\"")) stats.logs++;
+        else if (_lit(p, end, "roastEvent\"")) stats.events++;
+        else stats.other++;
+        return;
+    }
+
+    // Type not first - generic lookup
+    std::string_view text(line, end - line);
+    std::string_view type;
+    if (!json_get_string(text, "type", type)) {
+        stats.malformed++;
+    } else if (type == "roasterState") {
+        if (text.find("\"replay\":true") != std::string_view::npos) {
+            stats.replays++;
+        } else if (sample_from_frame(text, out.sample)) {
+            stats.states++;
+            chunk.samples.push_back(out);
+        } else {
+            stats.malformed++;
+        }
+    } else if (type == "log") {
+        stats.logs++;
+    } else if (type == "roastEvent") {
+        stats.events++;
+    } else {
+        stats.other++;
+    }
+}
+
+static void _add_stats(IngestStats& total, const IngestStats& part) {
+    total.lines += part.lines;
+    total.states += part.states;
+    total.replays += part.replays;
+    total.events += part.events;
+    total.logs += part.logs;
+    total.other += part.other;
+    total.malformed += part.malformed;
+    total.fast_path += part.fast_path;
+}
+
+bool ingest_parse(const std::string& path, const IngestOptions& options, IngestLog& log, IngestStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        host_log(LogLevel::ERROR, "INGEST", "Cannot open %s: %s", path.c_str(), strerror(errno));
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    log.source = path.substr(path.rfind('/') + 1);
+    log.mtime_ms = (uint64_t)st.st_mtim.tv_sec * 1000 + st.st_mtim.tv_nsec / 1000000;
+    log.devices.assign(1, options.device.empty() ? INGEST_DEFAULT_DEVICE : options.device);
+    log.samples.clear();
+    size_t size = (size_t)st.st_size;
+    if (size == 0) {
+        close(fd);
+        return true;
+    }
+
+    const char* data = (const char*)mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        host_log(LogLevel::ERROR, "INGEST", "Cannot map %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    madvise((void*)data, size, MADV_SEQUENTIAL | MADV_WILLNEED);
+
+    // Chunk boundaries just past a newline, so no line straddles two chunks
+    std::vector<size_t> bounds { 0 };
+    while (bounds.back() < size) {
+        size_t next = bounds.back() + INGEST_CHUNK_BYTES;
+        if (next >= size) {
+            next = size;
+        } else {
+            const char* nl = (const char*)memchr(data + next, '\n', size - next);
+            next = nl ? (size_t)(nl - data) + 1 : size;
+        }
+        bounds.push_back(next);
+    }
+
+    std::vector<ChunkResult> chunks(bounds.size() - 1);
+    std::atomic<size_t> next { 0 };
+    _parallel(options.threads, [&]() {
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks.size(); ) {
+            ChunkResult& chunk = chunks[c];
+            chunk.devices.emplace_back();
+#ifdef MADV_POPULATE_READ
+            // Fault the chunk in with one call instead of a fault per page
+            size_t page = bounds[c] & ~(size_t)(sysconf(_SC_PAGESIZE) - 1);
+            madvise((void*)(data + page), bounds[c + 1] - page, MADV_POPULATE_READ);
+#endif
+            chunk.samples.reserve((bounds[c + 1] - bounds[c]) / 256);
+            _for_each_line(data + bounds[c], data + bounds[c + 1], [&chunk](const char* b, const char* e) {
+                _parse_line(b, e, chunk);
+            });
+        }
+    });
+    munmap((void*)data, size);
+
+    // Merge in file order, renumbering chunk-local devices
+    size_t total = 0;
+    for (const ChunkResult& chunk : chunks) total += chunk.samples.size();
+    log.samples.reserve(total);
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<uint32_t> remap;
+    for (ChunkResult& chunk : chunks) {
+        remap.assign(chunk.devices.size(), 0);
+        for (size_t i = 1; i < chunk.devices.size(); i++) {
+            auto it = ids.find(chunk.devices[i]);
+            if (it == ids.end()) {
+                it = ids.emplace(chunk.devices[i], (uint32_t)log.devices.size()).first;
+                log.devices.push_back(chunk.devices[i]);
+            }
+            remap[i] = it->second;
+        }
+        for (IngestSample& s : chunk.samples) {
+            s.device = remap[s.device];
+            log.samples.push_back(s);
+        }
+        _add_stats(stats, chunk.stats);
+        std::vector<IngestSample>().swap(chunk.samples);
+    }
+
+    stats.bytes += size;
+    stats.parse_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+// ============== Archive Output ==============
+
+struct Boot {
+    uint32_t first_ms;
+    uint32_t last_ms;
+    uint64_t start_unix_ms;
+};
+
+// A device clock running backwards means the roaster reset
+static bool _rebooted(uint32_t previous_ms, uint32_t now_ms) {
+    return now_ms < previous_ms;
+}
+
+static bool _active(uint8_t state) {
+    return state == ROAST_STATE_PREHEAT || state == ROAST_STATE_ROASTING || state == ROAST_STATE_COOLING;
+}
+
+struct OpenRoast {
+    bool open = false;
+    size_t boot = 0;
+    uint32_t first_ms = 0;
+    uint32_t last_ms = 0;
+    uint32_t key = 0;                   // Identity of the first sample
+    ArchiveEntry entry {};
+    RoastColumns columns;
+};
+
+static void _close_roast(const IngestLog& log, uint32_t device, OpenRoast& roast, const std::vector<Boot>& boots,
+                         ArchiveWriter& writer, ImportStats& stats) {
+    roast.open = false;
+    ArchiveEntry& entry = roast.entry;
+    entry.source = (uint8_t)ArchiveSource::LOG_INGEST;
+    const std::string& name = log.devices[device];
+    snprintf(entry.id, sizeof(entry.id), "log-%08x%08x", crc32(name.data(), name.size()), roast.key);
+    if (writer.contains(entry.id)) {
+        stats.duplicates++;
+        return;
+    }
+
+    const Boot& boot = boots[roast.boot];
+    snprintf(entry.device, sizeof(entry.device), "%s", name.c_str());
+    entry.start_unix_ms = boot.start_unix_ms + (roast.first_ms - boot.first_ms);
+    entry.end_unix_ms = boot.start_unix_ms + (roast.last_ms - boot.first_ms);
+
+    std::string notes = "Ingested from " + log.source;
+    if (writer.append(entry, roast.columns, notes)) {
+        stats.roasts++;
+        stats.samples += roast.columns.size();
+    } else {
+        stats.skipped++;
+    }
+}
+
+void ingest_archive(const IngestLog& log, const IngestOptions& options, ArchiveWriter& writer,
+                    ImportStats& stats) {
+    size_t devices = log.devices.size();
+
+    // 1. Boots per device, laid back to back ending at the capture end
+    std::vector<std::vector<Boot>> boots(devices);
+    std::vector<uint32_t> previous(devices, 0);
+    for (const IngestSample& s : log.samples) {
+        std::vector<Boot>& list = boots[s.device];
+        uint32_t t = s.sample.device_ms;
+        if (list.empty() || _rebooted(previous[s.device], t)) list.push_back({ t, t, 0 });
+        list.back().last_ms = t;
+        previous[s.device] = t;
+    }
+    uint64_t end = options.end_unix_ms ? options.end_unix_ms : log.mtime_ms;
+    for (std::vector<Boot>& list : boots) {
+        uint64_t boot_end = end;
+        for (size_t i = list.size(); i-- > 0; ) {
+            list[i].start_unix_ms = boot_end - (list[i].last_ms - list[i].first_ms);
+            boot_end = list[i].start_unix_ms;
+        }
+    }
+
+    // 2. Roasts, as roast-recorder would have split them
+    std::vector<OpenRoast> roasts(devices);
+    std::vector<size_t> boot(devices, 0);
+    std::fill(previous.begin(), previous.end(), 0);
+    std::vector<bool> seen(devices, false);
+    for (const IngestSample& in : log.samples) {
+        const SampleRecord& s = in.sample;
+        OpenRoast& roast = roasts[in.device];
+        if (seen[in.device] && _rebooted(previous[in.device], s.device_ms)) {
+            boot[in.device]++;
+            if (roast.open) _close_roast(log, in.device, roast, boots[in.device], writer, stats);
+        }
+        seen[in.device] = true;
+        previous[in.device] = s.device_ms;
+
+        if (!roast.open) {
+            if (s.state != ROAST_STATE_PREHEAT && s.state != ROAST_STATE_ROASTING) continue;
+            roast.open = true;
+            roast.boot = boot[in.device];
+            roast.first_ms = s.device_ms;
+            roast.key = crc32(&s, sizeof(s));
+            roast.entry = ArchiveEntry {};
+            roast.columns.clear();
+        }
+
+        uint32_t time_ms = s.device_ms - roast.first_ms;
+        roast.last_ms = s.device_ms;
+        roast.columns.push(time_ms, s.chamber_temp, s.heater_temp, s.setpoint, s.ror,
+                           s.fan_speed, s.heater_power, s.state);
+
+        // Same metadata as the recorder index
+        ArchiveEntry& entry = roast.entry;
+        if (s.state == ROAST_STATE_PREHEAT) entry.preheat_setpoint = s.setpoint;
+        if (s.state == ROAST_STATE_ROASTING && entry.roast_setpoint == 0) entry.roast_setpoint = s.setpoint;
+        if (s.first_crack_ms && !entry.first_crack_ms) entry.first_crack_ms = archive_first_crack_time(time_ms, s);
+        if (s.roast_time_ms > entry.total_roast_ms) entry.total_roast_ms = s.roast_time_ms;
+
+        if (!_active(s.state)) _close_roast(log, in.device, roast, boots[in.device], writer, stats);
+    }
+
+    for (const OpenRoast& roast : roasts) {
+        if (roast.open) stats.skipped++;        // Capture ended mid-roast
+    }
+}
+
+// ============== CSV Output ==============
+
+static void _append_uint(std::string& out, uint64_t value) {
+    char buf[20];
+    int n = 0;
+    do {
+        buf[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n) out += buf[--n];
+}
+
+// One decimal, like the firmware; NaN is an empty field
+static void _append_temp(std::string& out, float value) {
+    if (std::isnan(value)) return;
+    long tenths = lroundf(value * 10);
+    if (tenths < 0) {
+        out += '-';
+        tenths = -tenths;
+    }
+    _append_uint(out, (uint64_t)tenths / 10);
+    out += '.';
+    out += (char)('0' + tenths % 10);
+}
+
+bool ingest_csv(const IngestLog& log, FILE* out, bool header, unsigned threads) {
+    if (header) {
+        fputs("device,seq,device_ms,state,roast_time_ms,chamber_c,heater_c,setpoint_c,ror_c_min,"
+              "fan_pct,power_pct,flags,first_crack_ms\n", out);
+    }
+
+    // Format fixed-size slices in parallel, write them in order
+    const size_t slice = 1 << 16;
+    size_t slices = (log.samples.size() + slice - 1) / slice;
+    std::vector<std::string> text(slices);
+    std::atomic<size_t> next { 0 };
+    std::atomic<size_t> written { 0 };
+    std::atomic<bool> failed { false };
+    std::mutex lock;
+    std::condition_variable turn;
+    _parallel(threads, [&]() {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < slices; ) {
+            std::string& csv = text[i];
+            csv.reserve(slice * 64);
+            size_t last = std::min(log.samples.size(), (i + 1) * slice);
+            for (size_t k = i * slice; k < last; k++) {
+                const SampleRecord& s = log.samples[k].sample;
+                csv += log.devices[log.samples[k].device];
+                csv += ',';
+                _append_uint(csv, s.seq);
+                csv += ',';
+                _append_uint(csv, s.device_ms);
+                csv += ',';
+                _append_uint(csv, s.state);
+                csv += ',';
+                _append_uint(csv, s.roast_time_ms);
+                csv += ',';
+                _append_temp(csv, s.chamber_temp);
+                csv += ',';
+                _append_temp(csv, s.heater_temp);
+                csv += ',';
+                _append_temp(csv, s.setpoint);
+                csv += ',';
+                _append_temp(csv, s.ror);
+                csv += ',';
+                _append_uint(csv, s.fan_speed);
+                csv += ',';
+                _append_uint(csv, s.heater_power);
+                csv += ',';
+                _append_uint(csv, s.flags);
+                csv += ',';
+                _append_uint(csv, s.first_crack_ms);
+                csv += '\n';
+            }
+
+            // Slices are claimed in order, so waiting for our turn cannot deadlock
+            std::unique_lock<std::mutex> guard(lock);
+            turn.wait(guard, [&]() { return written == i; });
+            if (fwrite(csv.data(), 1, csv.size(), out) != csv.size()) failed = true;
+            std::string().swap(csv);
+            written++;
+            turn.notify_all();
+        }
+    });
+    return !failed && fflush(out) == 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "archive.h"
+#include "archive_import.h"
+#include "recorder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ============== Telemetry Log Ingestion ==============
+// Bulk parser for captured NDJSON serial logs (the lines serial_comm.cpp
+// emits, optionally prefixed with a fleet "device" key).
+//
+// The capture is mapped read-only and cut into INGEST_CHUNK_BYTES pieces at
+// newline boundaries; worker threads claim chunks from an atomic cursor.
+// Within a chunk, newlines are found 64 bytes at a time as a bitmask (SSE2
+// compares where available) and every line is classified by its prefix.
+// roasterState lines go through the schema decoder (lib/protocol), which
+// matches the firmware's key order with literal compares and only falls
+// back to key lookup for lines that do not fit it (older firmware,
+// reordered keys).
+//
+// Samples are kept per chunk and merged in file order afterwards, so the
+// output is identical for any thread count.
+
+#define INGEST_CHUNK_BYTES          (8u << 20)
+#define INGEST_DEFAULT_DEVICE       "roaster"       // Same as roast-recorder
+
+struct IngestOptions {
+    unsigned threads = 0;               // 0 = all cores
+    std::string device;                 // Name for lines without a "device" key
+    uint64_t end_unix_ms = 0;           // Wall time of the last line; 0 = file mtime
+};
+
+struct IngestStats {
+    uint64_t bytes = 0;
+    uint64_t lines = 0;
+    uint64_t states = 0;                // roasterState samples kept
+    uint64_t replays = 0;               // Resent roasterState frames (dropped)
+    uint64_t events = 0;                // roastEvent
+    uint64_t logs = 0;                  // log
+    uint64_t other = 0;                 // Any other message type
+    uint64_t malformed = 0;
+    uint64_t fast_path = 0;             // roasterState lines parsed by the fixed-layout parser
+    double parse_ms = 0;
+};
+
+struct IngestSample {
+    SampleRecord sample;                // time_ms and crc unused
+    uint32_t device;                    // Index into IngestLog::devices
+};
+
+// One parsed capture file
+struct IngestLog {
+    std::string source;                 // File name, recorded in archive notes
+    uint64_t mtime_ms = 0;
+    std::vector<std::string> devices;
+    std::vector<IngestSample> samples;  // File order
+};
+
+// Maps and parses one capture file
+bool ingest_parse(const std::string& path, const IngestOptions& options, IngestLog& log, IngestStats& stats);
+
+// Splits every device's samples into roasts (preheat or charge through the
+// end of cooling) and appends them to the archive. A roast still running
+// at the end of the capture is left out, like an open recorder roast.
+//
+// Serial lines carry only the device clock, so wall time is anchored at
+// the capture end and each earlier boot is placed back to back before the
+// next one.
+void ingest_archive(const IngestLog& log, const IngestOptions& options, ArchiveWriter& writer,
+                    ImportStats& stats);
+
+// Writes every kept sample as CSV (formatted in parallel, written in order)
+bool ingest_csv(const IngestLog& log, FILE* out, bool header, unsigned threads);
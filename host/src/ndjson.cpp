@@ -0,0 +1,184 @@
+#include "ndjson.h"
+#include "websocket.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+// ============== Field Lookup ==============
+
+static size_t _find_value(std::string_view json, std::string_view key) {
+    // Match "key": with the quotes so "seq" doesn't hit "fromSeq"
+    size_t pos = 0;
+    while ((pos = json.find(key, pos)) != std::string_view::npos) {
+        size_t after = pos + key.size();
+        if (pos > 0 && json[pos - 1] == '"' &&
+            after + 1 < json.size() && json[after] == '"' && json[after + 1] == ':') {
+            after += 2;
+            while (after < json.size() && json[after] == ' ') after++;
+            return after;
+        }
+        pos = after;
+    }
+    return std::string_view::npos;
+}
+
+bool json_get_string(std::string_view json, std::string_view key, std::string_view& out) {
+    size_t start = _find_value(json, key);
+    if (start == std::string_view::npos || start >= json.size() || json[start] != '"') return false;
+
+    size_t end = start + 1;
+    while (end < json.size() && json[end] != '"') {
+        if (json[end] == '\\') end++;
+        end++;
+    }
+    if (end >= json.size()) return false;
+
+    out = json.substr(start + 1, end - start - 1);
+    return true;
+}
+
+bool json_get_number(std::string_view json, std::string_view key, double& out) {
+    size_t start = _find_value(json, key);
+    if (start == std::string_view::npos) return false;
+
+    char buf[48];
+    size_t len = 0;
+    while (start + len < json.size() && len < sizeof(buf) - 1) {
+        char c = json[start + len];
+        if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) break;
+        buf[len] = c;
+        len++;
+    }
+    if (len == 0) return false;
+    buf[len] = '\0';
+
+    char* end = nullptr;
+    out = strtod(buf, &end);
+    return end != buf;
+}
+
+bool json_get_uint(std::string_view json, std::string_view key, uint64_t& out) {
+    size_t start = _find_value(json, key);
+    if (start == std::string_view::npos || start >= json.size()) return false;
+    if (json[start] < '0' || json[start] > '9') return false;
+
+    uint64_t value = 0;
+    while (start < json.size() && json[start] >= '0' && json[start] <= '9') {
+        value = value * 10 + (json[start] - '0');
+        start++;
+    }
+    out = value;
+    return true;
+}
+
+std::string json_escape(std::string_view text) {
+    std::string out;
+    out.reserve(text.size() + 8);
+    for (char c : text) {
+        if (c == '"') out += "\\\"";
+        else if (c == '\\') out += "\\\\";
+        else if (c == '\n') out += "\\n";
+        else if ((unsigned char)c < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out += esc;
+        }
+        else out += c;
+    }
+    return out;
+}
+
+static void _append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+static bool _hex4(std::string_view text, size_t pos, uint32_t& out) {
+    if (pos + 4 > text.size()) return false;
+    out = 0;
+    for (size_t i = pos; i < pos + 4; i++) {
+        char c = text[i];
+        out <<= 4;
+        if (c >= '0' && c <= '9') out |= c - '0';
+        else if (c >= 'a' && c <= 'f') out |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') out |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+std::string json_unescape(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c != '\\' || i + 1 >= text.size()) {
+            out += c;
+            continue;
+        }
+        char e = text[++i];
+        switch (e) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                uint32_t cp;
+                if (!_hex4(text, i + 1, cp)) break;
+                i += 4;
+                // Surrogate pair
+                uint32_t low;
+                if (cp >= 0xD800 && cp < 0xDC00 && i + 2 < text.size() && text[i + 1] == '\\' &&
+                    text[i + 2] == 'u' && _hex4(text, i + 3, low) && low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                _append_utf8(out, cp);
+                break;
+            }
+            default: out += e; break;        // \" \\ \/
+        }
+    }
+    return out;
+}
+
+// ============== Frames ==============
+
+FramePtr frame_make(std::string_view line) {
+    auto frame = std::make_shared<Frame>();
+    frame->text.reserve(line.size() + 1);
+    frame->text.append(line);
+    frame->text.push_back('\n');
+
+    std::string_view type;
+    if (json_get_string(line, "type", type)) {
+        frame->type.assign(type);
+    }
+
+    uint64_t seq = 0;
+    if (frame->type == "roasterState" && json_get_uint(line, "seq", seq)) {
+        frame->seq = (uint32_t)seq;
+    }
+
+    // Same shedding rule as the firmware transport layer
+    std::string_view level;
+    frame->droppable = frame->type == "roasterState" ||
+        (frame->type == "log" && json_get_string(line, "level", level) && level == "debug");
+
+    frame->ws_header_len = (uint8_t)ws_encode_header(WS_OPCODE_TEXT, line.size(), frame->ws_header);
+    return frame;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// ============== Line Splitting ==============
+// Splits a byte stream into NDJSON lines. Complete lines inside one read are
+// handed out as views into the caller's buffer; only a trailing partial line
+// is copied.
+
+class LineBuffer {
+public:
+    explicit LineBuffer(size_t max_line = 4096) : _max_line(max_line) {}
+
+    template <typename Fn>
+    void feed(const char* data, size_t len, Fn&& on_line) {
+        const char* end = data + len;
+        while (data < end) {
+            const char* nl = (const char*)memchr(data, '\n', end - data);
+            if (!nl) {
+                _append(data, end - data);
+                return;
+            }
+            if (_partial.empty() && !_discarding) {
+                _emit(std::string_view(data, nl - data), on_line);
+            } else {
+                _append(data, nl - data);
+                if (!_discarding) _emit(std::string_view(_partial), on_line);
+                _partial.clear();
+                _discarding = false;
+            }
+            data = nl + 1;
+        }
+    }
+
+    void clear() {
+        _partial.clear();
+        _discarding = false;
+    }
+
+    uint64_t overflows() const { return _overflows; }
+
+private:
+    template <typename Fn>
+    static void _emit(std::string_view line, Fn& on_line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty()) on_line(line);
+    }
+
+    void _append(const char* data, size_t len) {
+        if (_discarding) return;
+        if (_partial.size() + len > _max_line) {
+            // Same policy as the firmware input buffer - drop the whole line
+            _partial.clear();
+            _discarding = true;
+            _overflows++;
+            return;
+        }
+        _partial.append(data, len);
+    }
+
+    std::string _partial;
+    size_t _max_line;
+    bool _discarding = false;
+    uint64_t _overflows = 0;
+};
+
+// ============== Field Lookup ==============
+// Flat "key":value lookup in the style of the firmware's indexOf() parser.
+// Finds the first occurrence of the key anywhere in the line, which is
+// sufficient for the roaster protocol where "type" always comes first.
+
+bool json_get_string(std::string_view json, std::string_view key, std::string_view& out);
+bool json_get_number(std::string_view json, std::string_view key, double& out);
+bool json_get_uint(std::string_view json, std::string_view key, uint64_t& out);
+
+// Escapes quotes, backslashes and control characters for embedding in JSON
+std::string json_escape(std::string_view text);
+
+// Inverse of json_escape for a raw string value from json_get_string();
+// \uXXXX escapes are emitted as UTF-8
+std::string json_unescape(std::string_view text);
+
+// ============== Frames ==============
+// One parsed protocol line shared by every client it is fanned out to.
+
+struct Frame {
+    std::string text;           // NDJSON line including the trailing '\n'
+    std::string type;           // Envelope "type"
+    uint32_t seq = 0;           // roasterState sequence number, 0 if absent
+    bool droppable = false;     // Telemetry and debug logs may be shed
+    uint8_t ws_header[10];      // WebSocket text frame header for the payload
+    uint8_t ws_header_len = 0;
+
+    std::string_view payload() const {
+        return std::string_view(text.data(), text.size() - 1);
+    }
+};
+
+using FramePtr = std::shared_ptr<const Frame>;
+
+// Builds a frame from a line without its newline
+FramePtr frame_make(std::string_view line);
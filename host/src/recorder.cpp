@@ -0,0 +1,424 @@
+#include "recorder.h"
+#include "crc32.h"
+#include "log.h"
+#include "telemetry_codec.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+static uint64_t _unix_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static bool _is_active(uint8_t state) {
+    return state == ROAST_STATE_PREHEAT || state == ROAST_STATE_ROASTING || state == ROAST_STATE_COOLING;
+}
+
+static bool _record_valid(const SampleRecord& record) {
+    return record.crc == crc32(&record, offsetof(SampleRecord, crc));
+}
+
+static bool _header_valid(const SegmentHeader& header) {
+    return header.magic == SEGMENT_MAGIC && header.version == SEGMENT_VERSION &&
+           header.record_size == sizeof(SampleRecord) &&
+           header.crc == crc32(&header, offsetof(SegmentHeader, crc));
+}
+
+static bool _entry_valid(const IndexEntry& entry) {
+    return entry.magic == INDEX_MAGIC && entry.crc == crc32(&entry, offsetof(IndexEntry, crc));
+}
+
+// Index metadata mirrors RoastSession's parameters and milestones
+static void _apply_metadata(IndexEntry& entry, const SampleRecord& sample) {
+    if (sample.state == ROAST_STATE_PREHEAT) entry.preheat_setpoint = sample.setpoint;
+    if (sample.state == ROAST_STATE_ROASTING && entry.roast_setpoint == 0) entry.roast_setpoint = sample.setpoint;
+    if (sample.first_crack_ms) entry.first_crack_ms = sample.first_crack_ms;
+    if (sample.roast_time_ms > entry.total_roast_ms) entry.total_roast_ms = sample.roast_time_ms;
+}
+
+// ============== Frame Parsing ==============
+
+bool sample_from_frame(std::string_view line, SampleRecord& sample) {
+    TelemetrySample frame;
+    bool replay = false;
+    if (telemetry_decode_json(line.data(), line.size(), frame, replay) == TelemetryDecode::INVALID || replay) {
+        return false;
+    }
+    memset(&sample, 0, sizeof(sample));
+    sample_from_telemetry(frame, sample);
+    return true;
+}
+
+void sample_from_telemetry(const TelemetrySample& frame, SampleRecord& sample) {
+    sample.seq = frame.seq;
+    sample.device_ms = frame.timestampMs;
+    sample.roast_time_ms = frame.roastTimeMs;
+    sample.chamber_temp = frame.chamberTemp;
+    sample.heater_temp = frame.heaterTemp;
+    sample.setpoint = frame.setpoint;
+    sample.ror = frame.ror;
+    sample.state = frame.stateId;
+    sample.fan_speed = frame.fanSpeed;
+    sample.heater_power = frame.heaterPower;
+    sample.flags = frame.flags;
+    sample.first_crack_ms = frame.firstCrackTimeMs;
+}
+
+// ============== Index ==============
+
+std::vector<IndexEntry> index_load(const std::string& dir) {
+    std::vector<IndexEntry> entries;
+    std::unordered_map<uint64_t, size_t> positions;
+
+    int fd = ::open((dir + "/" RECORDER_INDEX_FILE).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return entries;
+
+    IndexEntry entry;
+    while (read(fd, &entry, sizeof(entry)) == (ssize_t)sizeof(entry)) {
+        // A torn final entry fails its CRC and is ignored
+        if (!_entry_valid(entry)) continue;
+        auto it = positions.find(entry.roast_id);
+        if (it == positions.end()) {
+            positions[entry.roast_id] = entries.size();
+            entries.push_back(entry);
+        } else {
+            entries[it->second] = entry;
+        }
+    }
+    close(fd);
+    return entries;
+}
+
+// ============== Segment View ==============
+
+SegmentView::~SegmentView() {
+    close();
+}
+
+SegmentView::SegmentView(SegmentView&& other) noexcept {
+    *this = std::move(other);
+}
+
+SegmentView& SegmentView::operator=(SegmentView&& other) noexcept {
+    if (this != &other) {
+        close();
+        _map = other._map;
+        _size = other._size;
+        _count = other._count;
+        other._map = nullptr;
+        other._size = other._count = 0;
+    }
+    return *this;
+}
+
+bool SegmentView::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(SegmentHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    _map = (uint8_t*)map;
+    _size = st.st_size;
+    if (!_header_valid(*header())) {
+        close();
+        return false;
+    }
+    // A segment still being written is preallocated - trust only what the
+    // last sync vouched for
+    size_t capacity = (_size - sizeof(SegmentHeader)) / sizeof(SampleRecord);
+    _count = header()->committed < capacity ? header()->committed : capacity;
+    return true;
+}
+
+void SegmentView::close() {
+    if (_map) munmap(_map, _size);
+    _map = nullptr;
+    _size = _count = 0;
+}
+
+// ============== Recorder ==============
+
+RoastRecorder::RoastRecorder(std::string dir) : _dir(std::move(dir)) {}
+
+RoastRecorder::~RoastRecorder() {
+    close_all();
+    if (_index_fd >= 0) close(_index_fd);
+}
+
+bool RoastRecorder::open() {
+    mkdir(_dir.c_str(), 0755);
+    _index_fd = ::open((_dir + "/" RECORDER_INDEX_FILE).c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (_index_fd < 0) {
+        host_log(LogLevel::ERROR, "RECORD", "Cannot open index in %s: %s", _dir.c_str(), strerror(errno));
+        return false;
+    }
+
+    // Drop a torn trailing entry so new entries stay aligned
+    struct stat st;
+    if (fstat(_index_fd, &st) == 0 && st.st_size % sizeof(IndexEntry) != 0) {
+        if (ftruncate(_index_fd, st.st_size - st.st_size % sizeof(IndexEntry)) < 0) {
+            host_log(LogLevel::WARN, "RECORD", "Cannot trim index: %s", strerror(errno));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const IndexEntry& entry : index_load(_dir)) {
+        if (entry.status == (uint8_t)RoastStatus::OPEN) _recover(entry);
+    }
+    _stats.recovery_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if (_stats.roasts_recovered) {
+        host_log(LogLevel::INFO, "RECORD", "Recovered %llu roasts (%llu samples) in %.2f ms",
+                 (unsigned long long)_stats.roasts_recovered, (unsigned long long)_stats.recovered_samples,
+                 _stats.recovery_us / 1000.0);
+    }
+    _last_durable_ms = host_now_ms();
+    return true;
+}
+
+void RoastRecorder::_recover(const IndexEntry& open_entry) {
+    std::string path = _dir + "/" + open_entry.segment;
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        host_log(LogLevel::WARN, "RECORD", "Open roast %s has no segment", open_entry.segment);
+        return;
+    }
+
+    struct stat st;
+    fstat(fd, &st);
+    size_t capacity = st.st_size > (off_t)sizeof(SegmentHeader)
+        ? (st.st_size - sizeof(SegmentHeader)) / sizeof(SampleRecord) : 0;
+
+    IndexEntry entry = open_entry;
+    SegmentHeader header;
+    uint32_t count = 0;
+    if (pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) && _header_valid(header)) {
+        count = header.committed <= capacity ? header.committed : 0;
+        entry.preheat_setpoint = header.preheat_setpoint;
+        entry.roast_setpoint = header.roast_setpoint;
+        entry.first_crack_ms = header.first_crack_ms;
+        entry.total_roast_ms = header.total_roast_ms;
+    } else {
+        // Header never made it to disk - rebuild it from the index entry
+        memset(&header, 0, sizeof(header));
+        header.magic = SEGMENT_MAGIC;
+        header.version = SEGMENT_VERSION;
+        header.record_size = sizeof(SampleRecord);
+        header.roast_id = open_entry.roast_id;
+        header.start_unix_ms = open_entry.start_unix_ms;
+        memcpy(header.device, open_entry.device, sizeof(header.device));
+    }
+
+    // Only the tail written since the last header refresh needs checking
+    SampleRecord record;
+    while (count < capacity &&
+           pread(fd, &record, sizeof(record), sizeof(SegmentHeader) + (off_t)count * sizeof(record)) == (ssize_t)sizeof(record) &&
+           _record_valid(record)) {
+        _apply_metadata(entry, record);
+        count++;
+    }
+
+    SampleRecord last {};
+    if (count > 0 && pread(fd, &last, sizeof(last), sizeof(SegmentHeader) + (off_t)(count - 1) * sizeof(last)) != (ssize_t)sizeof(last)) {
+        memset(&last, 0, sizeof(last));
+    }
+
+    header.committed = count;
+    header.preheat_setpoint = entry.preheat_setpoint;
+    header.roast_setpoint = entry.roast_setpoint;
+    header.first_crack_ms = entry.first_crack_ms;
+    header.total_roast_ms = entry.total_roast_ms;
+    header.crc = crc32(&header, offsetof(SegmentHeader, crc));
+    bool ok = pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+              ftruncate(fd, sizeof(SegmentHeader) + (off_t)count * sizeof(SampleRecord)) == 0;
+    fdatasync(fd);
+    close(fd);
+    if (!ok) {
+        host_log(LogLevel::WARN, "RECORD", "Recovery of %s failed: %s", open_entry.segment, strerror(errno));
+        return;
+    }
+
+    entry.status = (uint8_t)RoastStatus::RECOVERED;
+    entry.sample_count = count;
+    entry.end_unix_ms = open_entry.start_unix_ms + (count ? last.time_ms : 0);
+    _append_index(entry);
+
+    _stats.roasts_recovered++;
+    _stats.recovered_samples += count;
+}
+
+void RoastRecorder::on_frame(std::string_view device, std::string_view line) {
+    SampleRecord sample;
+    if (sample_from_frame(line, sample)) record(std::string(device), sample);
+}
+
+void RoastRecorder::record(const std::string& device, const SampleRecord& input) {
+    auto it = _active.find(device);
+
+    if (it == _active.end()) {
+        // A roast starts at preheat or charge; cooling alone is not a roast
+        if (input.state != ROAST_STATE_PREHEAT && input.state != ROAST_STATE_ROASTING) return;
+        ActiveRoast roast;
+        if (!_begin(device, roast)) return;
+        it = _active.emplace(device, roast).first;
+    }
+
+    ActiveRoast& roast = it->second;
+    if (roast.count >= roast.capacity && !_grow(roast)) return;
+
+    SampleRecord sample = input;
+    sample.time_ms = (uint32_t)(host_now_ms() - roast.opened_ms);
+    sample.reserved = 0;
+    sample.crc = crc32(&sample, offsetof(SampleRecord, crc));
+    memcpy(roast.map + sizeof(SegmentHeader) + (size_t)roast.count * sizeof(SampleRecord), &sample, sizeof(sample));
+    roast.count++;
+    _stats.samples++;
+
+    _apply_metadata(roast.entry, sample);
+
+    if (!_is_active(sample.state)) {
+        _finish(roast, RoastStatus::CLOSED);
+        _active.erase(it);
+    }
+}
+
+bool RoastRecorder::_begin(const std::string& device, ActiveRoast& roast) {
+    uint64_t start = _unix_ms();
+    IndexEntry& entry = roast.entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.magic = INDEX_MAGIC;
+    entry.status = (uint8_t)RoastStatus::OPEN;
+    entry.roast_id = start * 1000 + (_stats.roasts_opened % 1000);
+    entry.start_unix_ms = start;
+    snprintf(entry.device, sizeof(entry.device), "%s", device.empty() ? "roaster" : device.c_str());
+    snprintf(entry.segment, sizeof(entry.segment), "%s-%llu.seg", entry.device, (unsigned long long)entry.roast_id);
+
+    std::string path = _dir + "/" + entry.segment;
+    roast.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (roast.fd < 0) {
+        host_log(LogLevel::ERROR, "RECORD", "Cannot create %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    roast.opened_ms = host_now_ms();
+    if (!_grow(roast)) {
+        close(roast.fd);
+        unlink(path.c_str());
+        return false;
+    }
+
+    SegmentHeader* header = (SegmentHeader*)roast.map;
+    memset(header, 0, sizeof(*header));
+    header->magic = SEGMENT_MAGIC;
+    header->version = SEGMENT_VERSION;
+    header->record_size = sizeof(SampleRecord);
+    header->roast_id = entry.roast_id;
+    header->start_unix_ms = start;
+    memcpy(header->device, entry.device, sizeof(header->device));
+    _refresh_header(roast);
+
+    _append_index(entry);
+    _stats.roasts_opened++;
+    host_log(LogLevel::INFO, "RECORD", "Recording %s", entry.segment);
+    return true;
+}
+
+bool RoastRecorder::_grow(ActiveRoast& roast) {
+    size_t old_bytes = roast.map ? sizeof(SegmentHeader) + roast.capacity * sizeof(SampleRecord) : 0;
+    size_t capacity = roast.capacity + SEGMENT_GROW_RECORDS;
+    size_t bytes = sizeof(SegmentHeader) + capacity * sizeof(SampleRecord);
+
+    // Preallocate so page faults in the mapping never hit ENOSPC as SIGBUS
+    if (posix_fallocate(roast.fd, 0, bytes) != 0 && ftruncate(roast.fd, bytes) < 0) {
+        host_log(LogLevel::ERROR, "RECORD", "Cannot extend segment: %s", strerror(errno));
+        return false;
+    }
+
+    void* map = roast.map
+        ? mremap(roast.map, old_bytes, bytes, MREMAP_MAYMOVE)
+        : mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, roast.fd, 0);
+    if (map == MAP_FAILED) {
+        host_log(LogLevel::ERROR, "RECORD", "Cannot map segment: %s", strerror(errno));
+        return false;
+    }
+    roast.map = (uint8_t*)map;
+    roast.capacity = capacity;
+    return true;
+}
+
+void RoastRecorder::_refresh_header(ActiveRoast& roast) {
+    SegmentHeader* header = (SegmentHeader*)roast.map;
+    header->committed = roast.count;
+    header->preheat_setpoint = roast.entry.preheat_setpoint;
+    header->roast_setpoint = roast.entry.roast_setpoint;
+    header->first_crack_ms = roast.entry.first_crack_ms;
+    header->total_roast_ms = roast.entry.total_roast_ms;
+    header->crc = crc32(header, offsetof(SegmentHeader, crc));
+}
+
+void RoastRecorder::_finish(ActiveRoast& roast, RoastStatus status) {
+    size_t bytes = sizeof(SegmentHeader) + roast.capacity * sizeof(SampleRecord);
+    _refresh_header(roast);
+    msync(roast.map, bytes, MS_SYNC);
+    munmap(roast.map, bytes);
+
+    // Trim the preallocated tail - closed segments are exactly header + records
+    if (ftruncate(roast.fd, sizeof(SegmentHeader) + (off_t)roast.count * sizeof(SampleRecord)) < 0) {
+        host_log(LogLevel::WARN, "RECORD", "Cannot trim %s: %s", roast.entry.segment, strerror(errno));
+    }
+    fdatasync(roast.fd);
+    close(roast.fd);
+
+    roast.entry.status = (uint8_t)status;
+    roast.entry.sample_count = roast.count;
+    roast.entry.end_unix_ms = _unix_ms();
+    _append_index(roast.entry);
+    fdatasync(_index_fd);
+
+    _stats.roasts_closed++;
+    host_log(LogLevel::INFO, "RECORD", "Closed %s (%u samples)", roast.entry.segment, roast.count);
+}
+
+void RoastRecorder::_append_index(IndexEntry& entry) {
+    entry.crc = crc32(&entry, offsetof(IndexEntry, crc));
+    if (write(_index_fd, &entry, sizeof(entry)) != (ssize_t)sizeof(entry)) {
+        host_log(LogLevel::ERROR, "RECORD", "Index write failed: %s", strerror(errno));
+    }
+}
+
+void RoastRecorder::sync(bool durable) {
+    uint64_t now = host_now_ms();
+    if (now - _last_durable_ms >= RECORDER_DURABLE_MS) durable = true;
+
+    for (auto& entry : _active) {
+        ActiveRoast& roast = entry.second;
+        // Records first, then the header that vouches for them
+        size_t used = sizeof(SegmentHeader) + (size_t)roast.count * sizeof(SampleRecord);
+        msync(roast.map, used, durable ? MS_SYNC : MS_ASYNC);
+        _refresh_header(roast);
+        msync(roast.map, sizeof(SegmentHeader), durable ? MS_SYNC : MS_ASYNC);
+    }
+    if (durable) _last_durable_ms = now;
+}
+
+void RoastRecorder::close_all() {
+    for (auto& entry : _active) _finish(entry.second, RoastStatus::CLOSED);
+    _active.clear();
+}
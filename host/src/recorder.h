@@ -0,0 +1,188 @@
+#pragma once
+
+#include "telemetry_schema.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// ============== Roast Recorder ==============
+// Crash-safe on-disk roast log. Each roast is one append-only segment file:
+//
+//   [SegmentHeader 128 B][SampleRecord 48 B][SampleRecord]...
+//
+// The file grows in preallocated, memory-mapped chunks and a sample is a
+// single memcpy. Every record carries its own CRC, so a torn write at the
+// tail is detected and cut off; nothing before it can be damaged. The
+// header's committed count is refreshed at each sync, so recovery only has
+// to scan the few records written since then.
+//
+// index.bin is an append-only list of fixed-size IndexEntry records, one
+// written when a roast opens and one when it closes (or is recovered). The
+// last valid entry for a roast id wins.
+
+#define SEGMENT_MAGIC               0x4D435347      // "MCSG"
+#define INDEX_MAGIC                 0x4D435849      // "MCXI"
+#define SEGMENT_VERSION             1
+#define SEGMENT_GROW_RECORDS        4096            // 192 KiB per extension
+#define RECORDER_SYNC_INTERVAL_MS   1000            // Header refresh + async msync
+#define RECORDER_DURABLE_MS         10000           // Blocking msync
+#define RECORDER_INDEX_FILE         "index.bin"
+
+// Roast states as sent in roasterState.stateId (see src/state.h)
+#define ROAST_STATE_OFF             0
+#define ROAST_STATE_FAN_ONLY        1
+#define ROAST_STATE_PREHEAT         2
+#define ROAST_STATE_ROASTING        3
+#define ROAST_STATE_COOLING         4
+#define ROAST_STATE_MANUAL          5
+#define ROAST_STATE_ERROR           6
+
+struct SampleRecord {
+    uint32_t seq;               // Firmware telemetry sequence number
+    uint32_t device_ms;         // Firmware millis() timestamp
+    uint32_t time_ms;           // Host time since the segment was opened
+    uint32_t roast_time_ms;     // Firmware roast clock (0 before charge)
+    float chamber_temp;         // NaN when the thermocouple read failed
+    float heater_temp;
+    float setpoint;
+    float ror;
+    uint8_t state;
+    uint8_t fan_speed;
+    uint8_t heater_power;
+    uint8_t flags;              // TELEMETRY_FLAG_* from src/telemetry.h
+    uint32_t first_crack_ms;    // 0 when not marked
+    uint32_t reserved;
+    uint32_t crc;               // Over all preceding bytes
+};
+static_assert(sizeof(SampleRecord) == 48, "SampleRecord layout is on-disk format");
+
+struct SegmentHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint64_t roast_id;
+    uint64_t start_unix_ms;
+    char device[32];
+    uint32_t committed;         // Records known good at the last sync
+    float preheat_setpoint;     // Roast metadata as of the last sync
+    float roast_setpoint;
+    uint32_t first_crack_ms;
+    uint32_t total_roast_ms;
+    uint8_t reserved[48];
+    uint32_t crc;
+};
+static_assert(sizeof(SegmentHeader) == 128, "SegmentHeader layout is on-disk format");
+
+enum class RoastStatus : uint8_t {
+    OPEN = 1,
+    CLOSED = 2,
+    RECOVERED = 3       // Closed by crash recovery
+};
+
+struct IndexEntry {
+    uint32_t magic;
+    uint8_t status;             // RoastStatus
+    uint8_t reserved0[3];
+    uint64_t roast_id;
+    uint64_t start_unix_ms;
+    uint64_t end_unix_ms;       // 0 while open
+    char device[32];
+    char segment[48];           // File name relative to the archive directory
+    uint32_t sample_count;
+    float preheat_setpoint;
+    float roast_setpoint;
+    uint32_t first_crack_ms;    // Roast clock, 0 when not marked
+    uint32_t total_roast_ms;
+    uint32_t crc;
+};
+static_assert(sizeof(IndexEntry) == 136, "IndexEntry layout is on-disk format");
+
+// Sample field extraction from a roasterState frame; false for other frames
+// and for replayed ones
+bool sample_from_frame(std::string_view line, SampleRecord& sample);
+
+// Copies a decoded frame's fields (time_ms and crc are left alone)
+void sample_from_telemetry(const TelemetrySample& frame, SampleRecord& sample);
+
+// Latest valid index entry per roast, in first-seen order
+std::vector<IndexEntry> index_load(const std::string& dir);
+
+// Read-only mmap of a closed or recovered segment
+class SegmentView {
+public:
+    SegmentView() = default;
+    ~SegmentView();
+    SegmentView(SegmentView&& other) noexcept;
+    SegmentView& operator=(SegmentView&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+
+    const SegmentHeader* header() const { return (const SegmentHeader*)_map; }
+    const SampleRecord* samples() const { return (const SampleRecord*)(_map + sizeof(SegmentHeader)); }
+    size_t count() const { return _count; }
+
+private:
+    uint8_t* _map = nullptr;
+    size_t _size = 0;
+    size_t _count = 0;
+};
+
+class RoastRecorder {
+public:
+    struct Stats {
+        uint64_t samples = 0;
+        uint64_t roasts_opened = 0;
+        uint64_t roasts_closed = 0;
+        uint64_t roasts_recovered = 0;
+        uint64_t recovered_samples = 0;
+        uint64_t recovery_us = 0;
+    };
+
+    explicit RoastRecorder(std::string dir);
+    ~RoastRecorder();
+
+    // Creates the directory, recovers roasts left open by a crash
+    bool open();
+
+    // Feeds one protocol frame; device is "" for a single-roaster bridge
+    void on_frame(std::string_view device, std::string_view line);
+
+    // Appends a sample, opening or closing the device's roast as its state changes
+    void record(const std::string& device, const SampleRecord& sample);
+
+    // Refreshes headers and msyncs; call about once a second
+    void sync(bool durable);
+
+    void close_all();
+
+    const Stats& stats() const { return _stats; }
+    size_t active_roasts() const { return _active.size(); }
+
+private:
+    struct ActiveRoast {
+        int fd = -1;
+        uint8_t* map = nullptr;
+        size_t capacity = 0;        // Records that fit in the mapping
+        uint32_t count = 0;
+        uint64_t opened_ms = 0;
+        IndexEntry entry {};
+    };
+
+    bool _begin(const std::string& device, ActiveRoast& roast);
+    bool _grow(ActiveRoast& roast);
+    void _finish(ActiveRoast& roast, RoastStatus status);
+    void _refresh_header(ActiveRoast& roast);
+    void _append_index(IndexEntry& entry);
+    void _recover(const IndexEntry& entry);
+
+    std::string _dir;
+    int _index_fd = -1;
+    uint64_t _last_durable_ms = 0;
+    std::unordered_map<std::string, ActiveRoast> _active;
+    Stats _stats;
+};
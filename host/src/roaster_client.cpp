@@ -0,0 +1,499 @@
+#include "roaster_client.h"
+#include "log.h"
+#include "telemetry_codec.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#define CLIENT_GET_STATE    "{\"type\":\"getState\",\"payload\":{}}"
+
+static uint64_t _now_us() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ============== Command Table ==============
+
+// Reply message that completes each command; nullptr = getState probe
+struct CommandSpec {
+    const char* name;
+    const char* reply;
+};
+
+static const CommandSpec _commands[(size_t)RoasterCommand::COUNT] = {
+    { "startPreheat",    nullptr },
+    { "loadBeans",       nullptr },
+    { "endRoast",        nullptr },
+    { "markFirstCrack",  "roastEvent" },
+    { "resumeRoast",     nullptr },
+    { "stop",            nullptr },
+    { "enterFanOnly",    nullptr },
+    { "exitFanOnly",     nullptr },
+    { "enterManual",     nullptr },
+    { "exitManual",      nullptr },
+    { "clearFault",      nullptr },
+    { "setSetpoint",     nullptr },
+    { "setFanSpeed",     nullptr },
+    { "setHeaterPower",  nullptr },
+    { "getState",        "roasterState" },
+    { "getSelfTest",     "selfTest" },
+    { "getFaultHistory", "faultHistory" },
+    { "resend",          "resendMiss" },        // Or the first replayed roasterState
+    { "downloadHistory", "historyEnd" },
+    { "profileBegin",    nullptr },
+    { "profileData",     nullptr },
+    { "profileFan",      nullptr },
+    { "profileEnd",      "profileStatus" },
+    { "clearProfile",    "profileStatus" },
+    { "getProfile",      "profileStatus" },
+    { "requestControl",  "bridgeControl" },
+    { "releaseControl",  nullptr },
+    { "debugFan",        nullptr },
+    { "testFanPins",     nullptr },
+    { "getSensorStats",  "sensorStats" },
+};
+
+const char* roaster_command_name(RoasterCommand command) {
+    return command < RoasterCommand::COUNT ? _commands[(size_t)command].name : "?";
+}
+
+bool roaster_command_from_name(std::string_view name, RoasterCommand& out) {
+    for (size_t i = 0; i < (size_t)RoasterCommand::COUNT; i++) {
+        if (name == _commands[i].name) {
+            out = (RoasterCommand)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* command_result_name(CommandResult result) {
+    switch (result) {
+        case CommandResult::OK:           return "ok";
+        case CommandResult::ERROR:        return "error";
+        case CommandResult::TIMEOUT:      return "timeout";
+        case CommandResult::DISCONNECTED: return "disconnected";
+    }
+    return "?";
+}
+
+static bool _is_profile_upload(RoasterCommand command) {
+    return command == RoasterCommand::PROFILE_BEGIN || command == RoasterCommand::PROFILE_DATA ||
+           command == RoasterCommand::PROFILE_FAN;
+}
+
+// ============== Message Parsing ==============
+
+static bool _get_bool(std::string_view json, std::string_view key) {
+    std::string pattern = "\"" + std::string(key) + "\":true";
+    return json.find(pattern) != std::string_view::npos;
+}
+
+static float _get_float(std::string_view json, std::string_view key, float fallback) {
+    double value;
+    return json_get_number(json, key, value) ? (float)value : fallback;
+}
+
+static std::string _get_text(std::string_view json, std::string_view key) {
+    std::string_view raw;
+    return json_get_string(json, key, raw) ? json_unescape(raw) : std::string();
+}
+
+static const char* const _state_names[TELEMETRY_STATE_COUNT] = TELEMETRY_STATE_NAMES;
+
+// Same decoder as the recorder and log ingest; the error object is not
+// part of the sample, so it is picked out of the line separately
+bool parse_roaster_state(std::string_view line, RoasterStateFrame& out) {
+    TelemetrySample sample;
+    bool replay = false;
+    if (telemetry_decode_json(line.data(), line.size(), sample, replay) == TelemetryDecode::INVALID) return false;
+
+    out = RoasterStateFrame();
+    out.seq = sample.seq;
+    out.replay = replay;
+    out.timestamp = sample.timestampMs;
+    out.state = sample.stateId < TELEMETRY_STATE_COUNT ? _state_names[sample.stateId] : "UNKNOWN";
+    out.state_id = sample.stateId;
+    out.chamber_temp = sample.chamberTemp;
+    out.heater_temp = sample.heaterTemp;
+    out.setpoint = sample.setpoint;
+    out.fan_speed = sample.fanSpeed;
+    out.heater_power = sample.heaterPower;
+    out.heater_enabled = sample.flags & TELEMETRY_FLAG_HEATER_ENABLED;
+    out.pid_enabled = sample.flags & TELEMETRY_FLAG_PID_ENABLED;
+    out.roast_time_ms = sample.roastTimeMs;
+    out.first_crack_marked = sample.flags & TELEMETRY_FLAG_FIRST_CRACK;
+    out.first_crack_time_ms = sample.firstCrackTimeMs;
+    out.ror = sample.ror;
+    out.resume_available = sample.flags & TELEMETRY_FLAG_RESUME_AVAILABLE;
+    out.profile_active = sample.flags & TELEMETRY_FLAG_PROFILE_ACTIVE;
+    out.has_profile_lead = sample.profileLeadMs != TELEMETRY_NULL_I32;
+    if (out.has_profile_lead) out.profile_lead_ms = sample.profileLeadMs;
+    out.preheat_ready = sample.flags & TELEMETRY_FLAG_PREHEAT_READY;
+    out.has_preheat_eta = sample.preheatEtaMs != TELEMETRY_NULL_I32;
+    if (out.has_preheat_eta) out.preheat_eta_ms = sample.preheatEtaMs;
+
+    // "error" is null unless the roaster is in ERROR
+    size_t error = line.find("\"error\":{");
+    if (error != std::string_view::npos) {
+        std::string_view body = line.substr(error);
+        out.has_error = true;
+        out.error_code = _get_text(body, "code");
+        out.error_message = _get_text(body, "message");
+        out.error_fatal = _get_bool(body, "fatal");
+    }
+    return true;
+}
+
+bool parse_roast_event(std::string_view line, RoastEventFrame& out) {
+    std::string_view event;
+    if (!json_get_string(line, "event", event)) return false;
+
+    uint64_t value = 0;
+    out = RoastEventFrame();
+    out.event.assign(event.data(), event.size());
+    if (json_get_uint(line, "timestamp", value)) out.timestamp = value;
+    if (json_get_uint(line, "roastTimeMs", value)) out.roast_time_ms = (uint32_t)value;
+    out.chamber_temp = _get_float(line, "chamberTemp", NAN);
+    out.data = _get_text(line, "data");
+    return true;
+}
+
+bool parse_log(std::string_view line, LogFrame& out) {
+    std::string_view level;
+    if (!json_get_string(line, "level", level)) return false;
+
+    uint64_t value = 0;
+    out = LogFrame();
+    out.level.assign(level.data(), level.size());
+    if (json_get_uint(line, "timestamp", value)) out.timestamp = value;
+    out.source = _get_text(line, "source");
+    out.message = _get_text(line, "message");
+    return true;
+}
+
+// ============== Connection ==============
+
+RoasterClient::RoasterClient(EventLoop& loop, ClientOptions options)
+    : _loop(loop), _options(std::move(options)) {}
+
+RoasterClient::~RoasterClient() {
+    stop();
+}
+
+bool RoasterClient::start() {
+    const std::string& target = _options.target;
+    size_t colon = target.rfind(':');
+    bool is_path = !target.empty() && target[0] == '/';
+
+    if (is_path) {
+        _link.reset(new RoasterLink(_loop, target, _options.baud));
+        _link->set_keepalive(CLIENT_KEEPALIVE_MS);
+        _link->on_frame([this](const FramePtr& frame) { _on_line(frame->payload()); });
+        _link->on_state([this](LinkState state, const char*) {
+            // Ready once the handshake's own roasterState is through, so it
+            // cannot be taken for the reply to the first command
+            _awaiting_state = state == LinkState::UP;
+            if (state != LinkState::UP) _set_connected(false);
+        });
+        _link->open();
+    } else if (colon != std::string::npos && colon > 0 && colon + 1 < target.size()) {
+        int port = atoi(target.c_str() + colon + 1);
+        if (port <= 0 || port > 65535) return false;
+        _stream.reset(new StreamClient(_loop, target.substr(0, colon), (uint16_t)port));
+        _stream->on_line([this](std::string_view line) { _on_line(line); });
+        _stream->on_state([this](bool connected) { _set_connected(connected); });
+        _stream->start();
+        _leased = _options.device.empty();
+    } else {
+        return false;
+    }
+
+    _timer = _loop.add_timer(CLIENT_TICK_MS, CLIENT_TICK_MS, [this]() { _tick(); });
+    return true;
+}
+
+void RoasterClient::stop() {
+    if (_timer) {
+        _loop.cancel_timer(_timer);
+        _timer = 0;
+    }
+    if (_stream) _stream->stop();
+    _stream.reset();
+    _link.reset();
+    if (_connected) {
+        _connected = false;
+        _fail_all(CommandResult::DISCONNECTED);
+    }
+}
+
+void RoasterClient::_set_connected(bool connected) {
+    if (_connected == connected) return;
+    _connected = connected;
+    if (connected) {
+        _last_seq = 0;
+    } else {
+        _stats.reconnects++;
+        _fail_all(CommandResult::DISCONNECTED);
+    }
+    if (_on_connection) _on_connection(connected);
+}
+
+void RoasterClient::_tick() {
+    if (_link) _link->tick();
+
+    // Deadlines are in send order, so only the front can be due
+    uint64_t now = host_now_ms();
+    while (!_pending.empty() && _pending.front().deadline_ms <= now) {
+        _complete(0, CommandResult::TIMEOUT, {}, "no reply");
+    }
+}
+
+bool RoasterClient::_write(std::string_view line) {
+    if (!_connected) return false;
+    if (_options.device.empty()) {
+        return _link ? _link->send(line) : _stream->send(line);
+    }
+
+    // Fleet addressing: {"device":"id", ...rest of the command
+    std::string addressed = "{\"device\":\"" + json_escape(_options.device) + "\",";
+    addressed.append(line.substr(1));
+    return _link ? _link->send(addressed) : _stream->send(addressed);
+}
+
+// ============== Commands ==============
+
+void RoasterClient::send(RoasterCommand command, std::string_view payload, ReplyHandler done) {
+    if (command >= RoasterCommand::COUNT) return;
+    const CommandSpec& spec = _commands[(size_t)command];
+
+    std::string line = "{\"type\":\"";
+    line += spec.name;
+    line += "\",\"payload\":{";
+    line.append(payload);
+    line += "}}";
+
+    _stats.sent++;
+    if (!_write(line)) {
+        _stats.disconnected++;
+        if (done) {
+            _loop.defer([command, done]() {
+                CommandReply reply;
+                reply.command = command;
+                reply.result = CommandResult::DISCONNECTED;
+                reply.message = "not connected";
+                done(reply);
+            });
+        }
+        return;
+    }
+
+    // Nothing arbitrates control on a direct link, and release has no reply
+    bool immediate = command == RoasterCommand::RELEASE_CONTROL ||
+                     (command == RoasterCommand::REQUEST_CONTROL && !_leased);
+    if (immediate) {
+        _stats.completed++;
+        _latency[(size_t)command].record(0);
+        if (done) {
+            _loop.defer([command, done]() {
+                CommandReply reply;
+                reply.command = command;
+                done(reply);
+            });
+        }
+        return;
+    }
+
+    const char* reply = spec.reply;
+    if (!reply) {
+        _write(CLIENT_GET_STATE);
+        reply = "roasterState";
+    }
+    _pending.push_back({ command, reply, _now_us(), host_now_ms() + _options.timeout_ms, std::move(done) });
+}
+
+static std::string _num(double value) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%g", value);
+    return buf;
+}
+
+static std::string _array(const std::vector<int16_t>& values) {
+    std::string out = "[";
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i) out += ',';
+        out += std::to_string(values[i]);
+    }
+    return out + "]";
+}
+
+void RoasterClient::start_preheat(float target_temp, ReplyHandler done) {
+    send(RoasterCommand::START_PREHEAT, "\"targetTemp\":" + _num(target_temp), std::move(done));
+}
+
+void RoasterClient::load_beans(float setpoint, ReplyHandler done) {
+    send(RoasterCommand::LOAD_BEANS, "\"setpoint\":" + _num(setpoint), std::move(done));
+}
+
+void RoasterClient::end_roast(ReplyHandler done) { send(RoasterCommand::END_ROAST, {}, std::move(done)); }
+void RoasterClient::mark_first_crack(ReplyHandler done) { send(RoasterCommand::MARK_FIRST_CRACK, {}, std::move(done)); }
+void RoasterClient::resume_roast(ReplyHandler done) { send(RoasterCommand::RESUME_ROAST, {}, std::move(done)); }
+void RoasterClient::stop_roaster(ReplyHandler done) { send(RoasterCommand::STOP, {}, std::move(done)); }
+
+void RoasterClient::enter_fan_only(int fan_speed, ReplyHandler done) {
+    send(RoasterCommand::ENTER_FAN_ONLY, "\"fanSpeed\":" + std::to_string(fan_speed), std::move(done));
+}
+
+void RoasterClient::exit_fan_only(ReplyHandler done) { send(RoasterCommand::EXIT_FAN_ONLY, {}, std::move(done)); }
+void RoasterClient::enter_manual(ReplyHandler done) { send(RoasterCommand::ENTER_MANUAL, {}, std::move(done)); }
+void RoasterClient::exit_manual(ReplyHandler done) { send(RoasterCommand::EXIT_MANUAL, {}, std::move(done)); }
+void RoasterClient::clear_fault(ReplyHandler done) { send(RoasterCommand::CLEAR_FAULT, {}, std::move(done)); }
+
+void RoasterClient::set_setpoint(float value, ReplyHandler done) {
+    send(RoasterCommand::SET_SETPOINT, "\"value\":" + _num(value), std::move(done));
+}
+
+void RoasterClient::set_fan_speed(int value, ReplyHandler done) {
+    send(RoasterCommand::SET_FAN_SPEED, "\"value\":" + std::to_string(value), std::move(done));
+}
+
+void RoasterClient::set_heater_power(int value, ReplyHandler done) {
+    send(RoasterCommand::SET_HEATER_POWER, "\"value\":" + std::to_string(value), std::move(done));
+}
+
+void RoasterClient::get_state(ReplyHandler done) { send(RoasterCommand::GET_STATE, {}, std::move(done)); }
+void RoasterClient::get_self_test(ReplyHandler done) { send(RoasterCommand::GET_SELF_TEST, {}, std::move(done)); }
+void RoasterClient::get_fault_history(ReplyHandler done) { send(RoasterCommand::GET_FAULT_HISTORY, {}, std::move(done)); }
+void RoasterClient::get_sensor_stats(ReplyHandler done) { send(RoasterCommand::GET_SENSOR_STATS, {}, std::move(done)); }
+
+void RoasterClient::resend(uint32_t from_seq, uint32_t to_seq, ReplyHandler done) {
+    send(RoasterCommand::RESEND, "\"fromSeq\":" + std::to_string(from_seq) + ",\"toSeq\":" + std::to_string(to_seq),
+         std::move(done));
+}
+
+void RoasterClient::download_history(uint32_t points, bool min_max, ReplyHandler done) {
+    std::string payload = "\"points\":" + std::to_string(points);
+    if (min_max) payload += ",\"mode\":\"minmax\"";
+    send(RoasterCommand::DOWNLOAD_HISTORY, payload, std::move(done));
+}
+
+void RoasterClient::profile_begin(uint16_t points, uint16_t step_ms, ReplyHandler done) {
+    send(RoasterCommand::PROFILE_BEGIN, "\"points\":" + std::to_string(points) + ",\"stepMs\":" + std::to_string(step_ms),
+         std::move(done));
+}
+
+void RoasterClient::profile_data(uint16_t offset, const std::vector<int16_t>& temps, ReplyHandler done) {
+    send(RoasterCommand::PROFILE_DATA, "\"offset\":" + std::to_string(offset) + ",\"temps\":" + _array(temps),
+         std::move(done));
+}
+
+void RoasterClient::profile_fan(const std::vector<int16_t>& events, ReplyHandler done) {
+    send(RoasterCommand::PROFILE_FAN, "\"events\":" + _array(events), std::move(done));
+}
+
+void RoasterClient::profile_end(ReplyHandler done) { send(RoasterCommand::PROFILE_END, {}, std::move(done)); }
+void RoasterClient::clear_profile(ReplyHandler done) { send(RoasterCommand::CLEAR_PROFILE, {}, std::move(done)); }
+void RoasterClient::get_profile(ReplyHandler done) { send(RoasterCommand::GET_PROFILE, {}, std::move(done)); }
+void RoasterClient::request_control(ReplyHandler done) { send(RoasterCommand::REQUEST_CONTROL, {}, std::move(done)); }
+void RoasterClient::release_control(ReplyHandler done) { send(RoasterCommand::RELEASE_CONTROL, {}, std::move(done)); }
+
+// ============== Replies ==============
+
+void RoasterClient::_complete(size_t index, CommandResult result, std::string_view line, std::string message) {
+    // Taken out first: the callback may queue further commands
+    Pending pending = std::move(_pending[index]);
+    _pending.erase(_pending.begin() + index);
+
+    CommandReply reply;
+    reply.command = pending.command;
+    reply.result = result;
+    reply.latency_us = _now_us() - pending.sent_us;
+    reply.line = line;
+    reply.message = std::move(message);
+
+    switch (result) {
+        case CommandResult::OK:
+            _stats.completed++;
+            _latency[(size_t)pending.command].record(reply.latency_us);
+            break;
+        case CommandResult::ERROR:        _stats.errors++; break;
+        case CommandResult::TIMEOUT:      _stats.timeouts++; break;
+        case CommandResult::DISCONNECTED: _stats.disconnected++; break;
+    }
+    if (pending.done) pending.done(reply);
+}
+
+void RoasterClient::_fail_all(CommandResult result) {
+    while (!_pending.empty()) _complete(0, result, {}, "link lost");
+}
+
+void RoasterClient::_on_line(std::string_view line) {
+    std::string_view type, device;
+    if (!json_get_string(line, "type", type)) return;
+    if (!_options.device.empty() && json_get_string(line, "device", device) && device != _options.device) return;
+
+    bool replay = false;
+    if (type == "roasterState") {
+        RoasterStateFrame state;
+        if (!parse_roaster_state(line, state)) return;
+        replay = state.replay;
+        if (!replay) {
+            if (_last_seq && state.seq > _last_seq + 1) _stats.seq_gaps += state.seq - _last_seq - 1;
+            if (state.seq) _last_seq = state.seq;
+            _last_state = state;
+        }
+        if (_on_state) _on_state(state);
+        if (!replay && _awaiting_state) {
+            _awaiting_state = false;
+            _set_connected(true);
+            return;
+        }
+    } else if (type == "roastEvent") {
+        RoastEventFrame event;
+        if (parse_roast_event(line, event) && _on_event) _on_event(event);
+    } else if (type == "log") {
+        LogFrame log;
+        if (parse_log(line, log) && _on_log) _on_log(log);
+    } else if (_on_message) {
+        _on_message(type, line);
+    }
+
+    if (type == "error") {
+        if (!_pending.empty()) _complete(0, CommandResult::ERROR, line, _get_text(line, "message"));
+        return;
+    }
+
+    // A profileStatus carrying an error is the refusal of an upload step
+    if (type == "profileStatus") {
+        std::string error = _get_text(line, "error");
+        for (size_t i = 0; !error.empty() && i < _pending.size(); i++) {
+            if (_is_profile_upload(_pending[i].command)) {
+                _complete(i, CommandResult::ERROR, line, error);
+                return;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < _pending.size(); i++) {
+        const Pending& pending = _pending[i];
+        bool match;
+        if (pending.command == RoasterCommand::RESEND) {
+            match = type == "resendMiss" || (type == "roasterState" && replay);
+        } else if (pending.command == RoasterCommand::REQUEST_CONTROL) {
+            // The bridge also sends bridgeControl on connect and on every lease change
+            uint64_t holder = 0, self = 0;
+            match = type == "bridgeControl" && json_get_uint(line, "holder", holder) &&
+                    json_get_uint(line, "clientId", self) && holder == self;
+        } else if (type == "roasterState") {
+            match = !replay && strcmp(pending.reply_type, "roasterState") == 0;
+        } else {
+            match = type == pending.reply_type;
+        }
+        if (match) {
+            _complete(i, CommandResult::OK, line, {});
+            return;
+        }
+    }
+}
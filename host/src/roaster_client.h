@@ -0,0 +1,269 @@
+#pragma once
+
+#include "event_loop.h"
+#include "latency.h"
+#include "ndjson.h"
+#include "roaster_link.h"
+#include "stream_client.h"
+
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============== Roaster Client ==============
+// Typed, asynchronous access to one roaster - the host-side counterpart of
+// parseCommand() in serial_comm.cpp. The target is either a tty path
+// (direct serial, including roaster-emu ptys) or HOST:PORT of a bridge or
+// fleet service; both transports reconnect on their own.
+//
+// Every command takes an optional completion callback. The firmware only
+// answers some commands, so each one completes on a fixed rule:
+//
+//   - commands with a reply message (getSelfTest -> selfTest, getProfile ->
+//     profileStatus, downloadHistory -> historyEnd, ...) complete on it
+//   - the rest are followed by a getState probe and complete on the next
+//     live roasterState; the firmware handles lines in order, so that frame
+//     reflects the command
+//   - an "error" message (firmware or bridge lease refusal) fails the
+//     oldest outstanding command
+//
+// Round trips are recorded per command in log-linear histograms. Through a
+// bridge, getState is answered from the bridge's cache, so probe-completed
+// commands measure the client-bridge hop rather than the serial link.
+
+#define CLIENT_REPLY_TIMEOUT_MS     3000
+#define CLIENT_KEEPALIVE_MS         2000    // Direct serial: feed the firmware watchdog
+#define CLIENT_TICK_MS              100
+
+enum class RoasterCommand : uint8_t {
+    START_PREHEAT,
+    LOAD_BEANS,
+    END_ROAST,
+    MARK_FIRST_CRACK,
+    RESUME_ROAST,
+    STOP,
+    ENTER_FAN_ONLY,
+    EXIT_FAN_ONLY,
+    ENTER_MANUAL,
+    EXIT_MANUAL,
+    CLEAR_FAULT,
+    SET_SETPOINT,
+    SET_FAN_SPEED,
+    SET_HEATER_POWER,
+    GET_STATE,
+    GET_SELF_TEST,
+    GET_FAULT_HISTORY,
+    RESEND,
+    DOWNLOAD_HISTORY,
+    PROFILE_BEGIN,
+    PROFILE_DATA,
+    PROFILE_FAN,
+    PROFILE_END,
+    CLEAR_PROFILE,
+    GET_PROFILE,
+    REQUEST_CONTROL,            // Bridge only
+    RELEASE_CONTROL,            // Bridge only
+    DEBUG_FAN,
+    TEST_FAN_PINS,
+    GET_SENSOR_STATS,
+    COUNT
+};
+
+// Protocol "type" string, e.g. "setFanSpeed"
+const char* roaster_command_name(RoasterCommand command);
+
+// Lookup by protocol name; false if unknown
+bool roaster_command_from_name(std::string_view name, RoasterCommand& out);
+
+// ============== Typed Messages ==============
+
+struct RoasterStateFrame {
+    uint32_t seq = 0;
+    bool replay = false;
+    uint64_t timestamp = 0;             // Device millis()
+    std::string state;                  // "ROASTING", ...
+    uint8_t state_id = 0;               // ROAST_STATE_* in recorder.h
+    float chamber_temp = NAN;           // NaN on thermocouple fault
+    float heater_temp = NAN;
+    float setpoint = 0;
+    uint8_t fan_speed = 0;
+    uint8_t heater_power = 0;
+    bool heater_enabled = false;
+    bool pid_enabled = false;
+    uint32_t roast_time_ms = 0;
+    bool first_crack_marked = false;
+    uint32_t first_crack_time_ms = 0;
+    float ror = 0;
+    bool resume_available = false;
+    bool profile_active = false;
+    bool has_profile_lead = false;
+    int32_t profile_lead_ms = 0;
+    bool preheat_ready = false;
+    bool has_preheat_eta = false;
+    int32_t preheat_eta_ms = 0;
+    bool has_error = false;
+    std::string error_code;
+    std::string error_message;
+    bool error_fatal = false;
+};
+
+struct RoastEventFrame {
+    uint64_t timestamp = 0;
+    std::string event;                  // "FIRST_CRACK", "STATE_CHANGE", ...
+    uint32_t roast_time_ms = 0;
+    float chamber_temp = NAN;
+    std::string data;
+};
+
+struct LogFrame {
+    uint64_t timestamp = 0;
+    std::string level;
+    std::string source;
+    std::string message;
+};
+
+bool parse_roaster_state(std::string_view line, RoasterStateFrame& out);
+bool parse_roast_event(std::string_view line, RoastEventFrame& out);
+bool parse_log(std::string_view line, LogFrame& out);
+
+// ============== Client ==============
+
+enum class CommandResult : uint8_t {
+    OK,
+    ERROR,                              // Refused by the firmware or bridge
+    TIMEOUT,
+    DISCONNECTED
+};
+
+const char* command_result_name(CommandResult result);
+
+struct CommandReply {
+    RoasterCommand command = RoasterCommand::GET_STATE;
+    CommandResult result = CommandResult::OK;
+    uint64_t latency_us = 0;
+    std::string_view line;              // Completing message (valid during the callback)
+    std::string message;                // Error text
+};
+
+struct ClientOptions {
+    std::string target;                 // tty path or HOST:PORT
+    int baud = 115200;
+    std::string device;                 // Fleet device id ("" = no device key)
+    uint32_t timeout_ms = CLIENT_REPLY_TIMEOUT_MS;
+};
+
+class RoasterClient {
+public:
+    using ReplyHandler = std::function<void(const CommandReply& reply)>;
+    using StateHandler = std::function<void(const RoasterStateFrame& state)>;
+    using EventHandler = std::function<void(const RoastEventFrame& event)>;
+    using LogHandler = std::function<void(const LogFrame& log)>;
+    using MessageHandler = std::function<void(std::string_view type, std::string_view line)>;
+    using ConnectionHandler = std::function<void(bool connected)>;
+
+    struct Stats {
+        uint64_t sent = 0;
+        uint64_t completed = 0;
+        uint64_t errors = 0;
+        uint64_t timeouts = 0;
+        uint64_t disconnected = 0;      // Failed because the link was down
+        uint64_t seq_gaps = 0;          // Missing live roasterState sequence numbers
+        uint64_t reconnects = 0;
+    };
+
+    RoasterClient(EventLoop& loop, ClientOptions options);
+    ~RoasterClient();
+
+    RoasterClient(const RoasterClient&) = delete;
+    RoasterClient& operator=(const RoasterClient&) = delete;
+
+    // False if the target is malformed; connection happens in the background
+    bool start();
+    void stop();
+    bool connected() const { return _connected; }
+
+    void on_state(StateHandler handler) { _on_state = std::move(handler); }
+    void on_event(EventHandler handler) { _on_event = std::move(handler); }
+    void on_log(LogHandler handler) { _on_log = std::move(handler); }
+    void on_message(MessageHandler handler) { _on_message = std::move(handler); }   // Everything else
+    void on_connection(ConnectionHandler handler) { _on_connection = std::move(handler); }
+
+    // Any command; `payload` is the JSON object body (without braces)
+    void send(RoasterCommand command, std::string_view payload = {}, ReplyHandler done = {});
+
+    void start_preheat(float target_temp, ReplyHandler done = {});
+    void load_beans(float setpoint, ReplyHandler done = {});
+    void end_roast(ReplyHandler done = {});
+    void mark_first_crack(ReplyHandler done = {});
+    void resume_roast(ReplyHandler done = {});
+    void stop_roaster(ReplyHandler done = {});
+    void enter_fan_only(int fan_speed, ReplyHandler done = {});
+    void exit_fan_only(ReplyHandler done = {});
+    void enter_manual(ReplyHandler done = {});
+    void exit_manual(ReplyHandler done = {});
+    void clear_fault(ReplyHandler done = {});
+    void set_setpoint(float value, ReplyHandler done = {});
+    void set_fan_speed(int value, ReplyHandler done = {});
+    void set_heater_power(int value, ReplyHandler done = {});
+    void get_state(ReplyHandler done = {});
+    void get_self_test(ReplyHandler done = {});
+    void get_fault_history(ReplyHandler done = {});
+    void get_sensor_stats(ReplyHandler done = {});
+    void resend(uint32_t from_seq, uint32_t to_seq, ReplyHandler done = {});
+    void download_history(uint32_t points, bool min_max, ReplyHandler done = {});
+    void profile_begin(uint16_t points, uint16_t step_ms, ReplyHandler done = {});
+    void profile_data(uint16_t offset, const std::vector<int16_t>& temps, ReplyHandler done = {});
+    void profile_fan(const std::vector<int16_t>& events, ReplyHandler done = {});
+    void profile_end(ReplyHandler done = {});
+    void clear_profile(ReplyHandler done = {});
+    void get_profile(ReplyHandler done = {});
+    void request_control(ReplyHandler done = {});
+    void release_control(ReplyHandler done = {});
+
+    size_t pending() const { return _pending.size(); }
+    const LatencyHistogram& latency(RoasterCommand command) const { return _latency[(size_t)command]; }
+    const Stats& stats() const { return _stats; }
+    const RoasterStateFrame& last_state() const { return _last_state; }
+
+private:
+    struct Pending {
+        RoasterCommand command;
+        const char* reply_type;         // Message that completes it
+        uint64_t sent_us;
+        uint64_t deadline_ms;
+        ReplyHandler done;
+    };
+
+    bool _write(std::string_view line);
+    void _on_line(std::string_view line);
+    void _set_connected(bool connected);
+    void _complete(size_t index, CommandResult result, std::string_view line, std::string message);
+    void _fail_all(CommandResult result);
+    void _tick();
+
+    EventLoop& _loop;
+    ClientOptions _options;
+    std::unique_ptr<RoasterLink> _link;
+    std::unique_ptr<StreamClient> _stream;
+    uint64_t _timer = 0;
+    bool _connected = false;
+    bool _awaiting_state = false;       // Direct link up, handshake frame pending
+    bool _leased = false;               // Bridge target: control is arbitrated
+
+    std::deque<Pending> _pending;
+    LatencyHistogram _latency[(size_t)RoasterCommand::COUNT];
+    Stats _stats;
+    RoasterStateFrame _last_state;
+    uint32_t _last_seq = 0;
+
+    StateHandler _on_state;
+    EventHandler _on_event;
+    LogHandler _on_log;
+    MessageHandler _on_message;
+    ConnectionHandler _on_connection;
+};
@@ -0,0 +1,185 @@
+#include "roaster_link.h"
+#include "log.h"
+#include "serial_port.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#define LINK_READ_CHUNK 4096
+#define LINK_GET_STATE  "{\"type\":\"getState\",\"payload\":{}}"
+
+static uint64_t _now_us() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+const char* link_state_name(LinkState state) {
+    switch (state) {
+        case LinkState::DOWN:      return "down";
+        case LinkState::DETECTING: return "detecting";
+        case LinkState::UP:        return "up";
+    }
+    return "?";
+}
+
+RoasterLink::RoasterLink(EventLoop& loop, std::string path, int baud)
+    : _loop(loop), _path(std::move(path)), _baud(baud) {}
+
+RoasterLink::~RoasterLink() {
+    if (_fd >= 0) {
+        _loop.remove(_fd);
+        close(_fd);
+    }
+}
+
+// ============== Connection ==============
+
+bool RoasterLink::open() {
+    _last_attempt_ms = host_now_ms();
+    int fd = serial_open(_path.c_str(), _baud);
+    if (fd < 0) {
+        host_log(LogLevel::DEBUG, "LINK", "Cannot open %s: %s", _path.c_str(), strerror(errno));
+        return false;
+    }
+    attach_fd(fd);
+    return true;
+}
+
+void RoasterLink::attach_fd(int fd) {
+    if (_fd >= 0) close_link("replaced");
+
+    _fd = fd;
+    _want_write = false;
+    _out.clear();
+    _lines.clear();
+    _opened_ms = host_now_ms();
+    _probe_sent_us = 0;
+    _loop.add(_fd, EPOLLIN, [this](uint32_t events) { _on_events(events); });
+    _set_state(LinkState::DETECTING, "port open");
+
+    // Any inbound line activates the firmware session and its "connected" reply
+    send(LINK_GET_STATE);
+}
+
+void RoasterLink::close_link(const char* reason) {
+    if (_fd < 0) return;
+    _loop.remove(_fd);
+    close(_fd);
+    _fd = -1;
+    _out.clear();
+    _stats.reconnects++;
+    _set_state(LinkState::DOWN, reason);
+}
+
+void RoasterLink::_set_state(LinkState state, const char* reason) {
+    if (_state == state) return;
+    _state = state;
+    host_log(state == LinkState::DOWN ? LogLevel::WARN : LogLevel::INFO, "LINK", "%s %s (%s)",
+             _path.c_str(), link_state_name(state), reason);
+    if (_on_state) _on_state(state, reason);
+}
+
+void RoasterLink::tick() {
+    uint64_t now = host_now_ms();
+
+    if (_fd < 0) {
+        if (!_path.empty() && now - _last_attempt_ms >= LINK_RECONNECT_MS) open();
+        return;
+    }
+
+    if (_state == LinkState::DETECTING && now - _opened_ms >= LINK_DETECT_TIMEOUT_MS) {
+        close_link("no roaster handshake");
+        return;
+    }
+
+    if (_keepalive_ms && now - _last_write_ms >= _keepalive_ms) {
+        if (_probe_sent_us == 0) _probe_sent_us = _now_us();
+        send(LINK_GET_STATE);
+    }
+}
+
+// ============== I/O ==============
+
+bool RoasterLink::send(std::string_view line) {
+    if (_fd < 0) return false;
+    _out.append(line);
+    _out.push_back('\n');
+    _last_write_ms = host_now_ms();
+    _stats.commands_out++;
+    if (!_want_write) _flush();
+    return true;
+}
+
+void RoasterLink::_flush() {
+    while (!_out.empty()) {
+        ssize_t n = write(_fd, _out.data(), _out.size());
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            close_link(strerror(errno));
+            return;
+        }
+        _out.erase(0, n);
+    }
+
+    bool want = !_out.empty();
+    if (want != _want_write) {
+        _want_write = want;
+        _loop.modify(_fd, EPOLLIN | (want ? (uint32_t)EPOLLOUT : 0u));
+    }
+}
+
+void RoasterLink::_on_events(uint32_t events) {
+    if (events & EPOLLIN) {
+        char buf[LINK_READ_CHUNK];
+        while (_fd >= 0) {
+            ssize_t n = read(_fd, buf, sizeof(buf));
+            if (n > 0) {
+                _stats.bytes_in += n;
+                _lines.feed(buf, n, [this](std::string_view line) { _on_line(line); });
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            // EOF or EIO - USB unplugged or board reset
+            close_link(n == 0 ? "end of file" : strerror(errno));
+            return;
+        }
+    }
+    if (_fd >= 0 && (events & EPOLLOUT)) _flush();
+    if (_fd >= 0 && (events & (EPOLLHUP | EPOLLERR)) && !(events & EPOLLIN)) {
+        close_link("hangup");
+    }
+}
+
+void RoasterLink::_on_line(std::string_view line) {
+    // Boot chatter before the first JSON line is not protocol
+    if (line.front() != '{') return;
+
+    FramePtr frame = frame_make(line);
+    _stats.frames_in++;
+    _stats.last_frame_ms = host_now_ms();
+
+    if (frame->type == "connected") {
+        std::string_view firmware;
+        if (json_get_string(line, "firmware", firmware)) _firmware.assign(firmware);
+        _set_state(LinkState::UP, "handshake");
+    } else if (frame->type == "roasterState") {
+        _set_state(LinkState::UP, "live session");
+
+        if (_probe_sent_us) {
+            _rtt.record(_now_us() - _probe_sent_us);
+            _probe_sent_us = 0;
+        }
+
+        bool replay = line.find("\"replay\":true") != std::string_view::npos;
+        if (!replay && frame->seq > 0) {
+            if (_last_seq && frame->seq > _last_seq + 1) _stats.seq_gaps += frame->seq - _last_seq - 1;
+            _last_seq = frame->seq;
+        }
+    }
+
+    if (_on_frame) _on_frame(frame);
+}
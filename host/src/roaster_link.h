@@ -0,0 +1,101 @@
+#pragma once
+
+#include "event_loop.h"
+#include "latency.h"
+#include "ndjson.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// ============== Roaster Link ==============
+// One roaster's serial connection: opens/reopens the tty, splits NDJSON,
+// queues outgoing commands and tracks link health. A freshly opened port
+// is DETECTING until the firmware proves itself with a "connected"
+// handshake (or a roasterState frame, if its session was already live).
+
+#define LINK_RECONNECT_MS       2000
+#define LINK_DETECT_TIMEOUT_MS  3000
+#define LINK_STALE_MS           5000    // Firmware sends state at 1 Hz
+
+enum class LinkState : uint8_t {
+    DOWN,
+    DETECTING,
+    UP
+};
+
+const char* link_state_name(LinkState state);
+
+class RoasterLink {
+public:
+    using FrameHandler = std::function<void(const FramePtr& frame)>;
+    using StateHandler = std::function<void(LinkState state, const char* reason)>;
+
+    struct Stats {
+        uint64_t frames_in = 0;
+        uint64_t bytes_in = 0;
+        uint64_t commands_out = 0;
+        uint64_t seq_gaps = 0;          // Missing roasterState sequence numbers
+        uint64_t reconnects = 0;
+        uint64_t last_frame_ms = 0;
+    };
+
+    RoasterLink(EventLoop& loop, std::string path, int baud);
+    ~RoasterLink();
+
+    RoasterLink(const RoasterLink&) = delete;
+    RoasterLink& operator=(const RoasterLink&) = delete;
+
+    bool open();
+    void attach_fd(int fd);
+    void close_link(const char* reason);
+
+    // Queues one NDJSON command line; false if the link is down
+    bool send(std::string_view line);
+
+    // 0 disables; otherwise getState is sent when the link has been idle
+    void set_keepalive(uint32_t interval_ms) { _keepalive_ms = interval_ms; }
+
+    // Drives reconnects, detection timeouts and keepalives; call periodically
+    void tick();
+
+    void on_frame(FrameHandler handler) { _on_frame = std::move(handler); }
+    void on_state(StateHandler handler) { _on_state = std::move(handler); }
+
+    LinkState state() const { return _state; }
+    const std::string& path() const { return _path; }
+    const std::string& firmware() const { return _firmware; }
+    const Stats& stats() const { return _stats; }
+    const LatencyHistogram& rtt() const { return _rtt; }
+    uint64_t line_overflows() const { return _lines.overflows(); }
+
+private:
+    void _set_state(LinkState state, const char* reason);
+    void _on_events(uint32_t events);
+    void _on_line(std::string_view line);
+    void _flush();
+
+    EventLoop& _loop;
+    std::string _path;
+    int _baud;
+    int _fd = -1;
+    LinkState _state = LinkState::DOWN;
+    std::string _firmware;
+
+    LineBuffer _lines;
+    std::string _out;
+    bool _want_write = false;
+
+    uint32_t _keepalive_ms = 0;
+    uint64_t _last_write_ms = 0;
+    uint64_t _opened_ms = 0;
+    uint64_t _last_attempt_ms = 0;
+    uint64_t _probe_sent_us = 0;    // Outstanding getState for RTT
+    uint32_t _last_seq = 0;
+
+    Stats _stats;
+    LatencyHistogram _rtt;
+    FrameHandler _on_frame;
+    StateHandler _on_state;
+};
@@ -0,0 +1,54 @@
+#include "serial_port.h"
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cerrno>
+
+static speed_t _baud_constant(int baud) {
+    switch (baud) {
+        case 9600:   return B9600;
+        case 19200:  return B19200;
+        case 38400:  return B38400;
+        case 57600:  return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default:     return B115200;
+    }
+}
+
+bool serial_configure(int fd, int baud) {
+    termios tio;
+    if (tcgetattr(fd, &tio) < 0) return false;
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~CRTSCTS;
+    // VMIN=1 so an empty non-blocking read is EAGAIN and 0 really means hangup
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, _baud_constant(baud));
+    cfsetospeed(&tio, _baud_constant(baud));
+    if (tcsetattr(fd, TCSANOW, &tio) < 0) return false;
+
+    int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int serial_open(const char* path, int baud) {
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    if (!serial_configure(fd, baud)) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+
+    // Drop whatever the board printed before we attached
+    tcflush(fd, TCIFLUSH);
+    return fd;
+}
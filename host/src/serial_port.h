@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+// ============== Serial Port ==============
+// Raw 8N1 non-blocking tty setup matching the firmware's Serial.begin().
+// Works on USB CDC devices and on pty slaves used by the emulator.
+
+#define SERIAL_DEFAULT_BAUD 115200
+
+// Returns an fd, or -1 with errno set
+int serial_open(const char* path, int baud);
+
+// Puts an already-open tty (e.g. a pty end) into raw non-blocking mode
+bool serial_configure(int fd, int baud);
@@ -0,0 +1,227 @@
+#include "similarity.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+// Runs fn(worker) on `threads` threads including the caller
+template <typename Fn>
+static void _parallel(unsigned threads, Fn&& fn) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) pool.emplace_back(fn);
+    fn();
+    for (std::thread& thread : pool) thread.join();
+}
+
+static double _elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ============== Curve Extraction ==============
+
+bool curve_extract(const RoastView& roast, RoastColumnsScratch& scratch, CurveFeatures& curve) {
+    curve.temp.clear();
+    curve.ror.clear();
+    RoastMetrics metrics = analyze_roast(roast, scratch);
+    if (metrics.charge_ms < 0 || metrics.drop_ms <= metrics.charge_ms) return false;
+
+    // analyze_roast leaves the gap-filled chamber curve and its RoR in scratch
+    const float* time = scratch.time.data();
+    const float* temp = scratch.chamber.data();
+    const float* ror = scratch.ror.data();
+    size_t n = roast.size();
+
+    size_t i = 0;
+    for (float t = metrics.charge_ms; t <= metrics.drop_ms && curve.temp.size() < SIMILARITY_MAX_POINTS;
+         t += SIMILARITY_STEP_MS) {
+        while (i + 1 < n && time[i + 1] <= t) i++;
+        if (i + 1 < n && time[i + 1] > time[i]) {
+            float f = (t - time[i]) / (time[i + 1] - time[i]);
+            curve.temp.push_back(temp[i] + (temp[i + 1] - temp[i]) * f);
+            curve.ror.push_back(ror[i] + (ror[i + 1] - ror[i]) * f);
+        } else {
+            curve.temp.push_back(temp[i]);
+            curve.ror.push_back(ror[i]);
+        }
+    }
+    return curve.temp.size() >= 2;
+}
+
+// Candidate resampled to the reference length: cut, or held at its drop values
+static void _fit(const CurveFeatures& curve, size_t length, CurveFeatures& out) {
+    out.temp.resize(length);
+    out.ror.resize(length);
+    size_t copy = std::min(length, curve.temp.size());
+    std::copy(curve.temp.begin(), curve.temp.begin() + copy, out.temp.begin());
+    std::copy(curve.ror.begin(), curve.ror.begin() + copy, out.ror.begin());
+    std::fill(out.temp.begin() + copy, out.temp.end(), curve.temp.back());
+    std::fill(out.ror.begin() + copy, out.ror.end(), curve.ror.back());
+}
+
+// ============== LB_Keogh ==============
+
+struct Envelope {
+    std::vector<float> temp_upper, temp_lower;
+    std::vector<float> ror_upper, ror_lower;
+};
+
+static void _envelope(const CurveFeatures& curve, size_t band, Envelope& env) {
+    size_t n = curve.temp.size();
+    env.temp_upper.resize(n);
+    env.temp_lower.resize(n);
+    env.ror_upper.resize(n);
+    env.ror_lower.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        size_t lo = i > band ? i - band : 0;
+        size_t hi = std::min(n, i + band + 1);
+        auto temp = std::minmax_element(curve.temp.begin() + lo, curve.temp.begin() + hi);
+        auto ror = std::minmax_element(curve.ror.begin() + lo, curve.ror.begin() + hi);
+        env.temp_lower[i] = *temp.first;
+        env.temp_upper[i] = *temp.second;
+        env.ror_lower[i] = *ror.first;
+        env.ror_upper[i] = *ror.second;
+    }
+}
+
+static inline float _outside(float value, float lower, float upper) {
+    float above = std::max(value - upper, 0.0f);
+    float below = std::max(lower - value, 0.0f);
+    return above * above + below * below;
+}
+
+// Every candidate point is matched to at least one reference point inside
+// the band, so its distance to the band's envelope bounds its DTW cost
+static float _lb_keogh(const CurveFeatures& candidate, const Envelope& env, float ror_weight) {
+    size_t n = env.temp_upper.size();
+    size_t len = candidate.temp.size();
+    float sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t c = std::min(i, len - 1);
+        sum += _outside(candidate.temp[c], env.temp_lower[i], env.temp_upper[i]) +
+               ror_weight * _outside(candidate.ror[c], env.ror_lower[i], env.ror_upper[i]);
+    }
+    return sum;
+}
+
+// ============== DTW ==============
+
+float dtw_distance(const CurveFeatures& a, const CurveFeatures& b, size_t band, float ror_weight,
+                   float abandon) {
+    size_t n = a.temp.size();
+    if (n == 0 || b.temp.size() != n) return INFINITY;
+
+    std::vector<float> prev(n + 1, INFINITY), cur(n + 1, INFINITY);
+    prev[0] = 0;
+    for (size_t i = 1; i <= n; i++) {
+        size_t lo = i > band ? i - band : 1;
+        size_t hi = std::min(n, i + band);
+        std::fill(cur.begin(), cur.end(), INFINITY);
+        float row_min = INFINITY;
+        float at = a.temp[i - 1], ar = a.ror[i - 1];
+        for (size_t j = lo; j <= hi; j++) {
+            float dt = at - b.temp[j - 1];
+            float dr = ar - b.ror[j - 1];
+            float cost = dt * dt + ror_weight * dr * dr;
+            float best = std::min(std::min(prev[j], cur[j - 1]), prev[j - 1]);
+            cur[j] = cost + best;
+            row_min = std::min(row_min, cur[j]);
+        }
+        if (row_min > abandon) return INFINITY;
+        std::swap(prev, cur);
+    }
+    return prev[n];
+}
+
+// ============== Search ==============
+
+void SimilarityIndex::build(const Archive& archive, const std::vector<size_t>& roasts, unsigned threads,
+                            SimilarityStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    _roasts = roasts;
+    _curves.assign(roasts.size(), CurveFeatures());
+
+    std::atomic<size_t> next { 0 };
+    _parallel(threads, [&]() {
+        RoastColumnsScratch scratch;
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < _roasts.size(); ) {
+            curve_extract(archive.roast(_roasts[i]), scratch, _curves[i]);
+        }
+    });
+    if (stats) stats->extract_ms = _elapsed_ms(start);
+}
+
+std::vector<SimilarityMatch> SimilarityIndex::query(const CurveFeatures& reference, const SimilarityOptions& options,
+                                                    size_t exclude, SimilarityStats* stats) const {
+    auto start = std::chrono::steady_clock::now();
+    size_t length = reference.temp.size();
+    if (length < 2 || options.k == 0) return {};
+
+    Envelope env;
+    _envelope(reference, options.band, env);
+
+    // 1. Lower bounds
+    std::vector<std::pair<float, size_t>> bounds(_curves.size());
+    std::atomic<size_t> next { 0 };
+    _parallel(options.threads, [&]() {
+        for (size_t i; (i = next.fetch_add(64, std::memory_order_relaxed)) < _curves.size(); ) {
+            for (size_t c = i; c < std::min(i + 64, _curves.size()); c++) {
+                bool usable = !_curves[c].temp.empty() && _roasts[c] != exclude;
+                bounds[c] = { usable ? _lb_keogh(_curves[c], env, options.ror_weight) : INFINITY, c };
+            }
+        }
+    });
+    std::sort(bounds.begin(), bounds.end());
+    size_t candidates = std::find_if(bounds.begin(), bounds.end(),
+                                     [](const std::pair<float, size_t>& b) { return std::isinf(b.first); }) - bounds.begin();
+
+    // 2. DTW in bound order against a shared k-th best threshold
+    std::mutex lock;
+    std::priority_queue<std::pair<float, size_t>> best;     // Max-heap of the current top k
+    std::atomic<float> threshold { INFINITY };
+    std::atomic<size_t> dtw_done { 0 }, abandoned { 0 };
+    next = 0;
+    _parallel(options.threads, [&]() {
+        CurveFeatures fitted;
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < candidates; ) {
+            float limit = threshold.load(std::memory_order_relaxed);
+            if (bounds[i].first >= limit) return;       // Every later bound is larger
+
+            size_t c = bounds[i].second;
+            _fit(_curves[c], length, fitted);
+            float distance = dtw_distance(reference, fitted, options.band, options.ror_weight, limit);
+            if (std::isinf(distance)) {
+                abandoned++;
+                continue;
+            }
+            dtw_done++;
+
+            std::lock_guard<std::mutex> guard(lock);
+            if (best.size() < options.k || distance < best.top().first) {
+                best.push({ distance, c });
+                if (best.size() > options.k) best.pop();
+                if (best.size() == options.k) threshold = best.top().first;
+            }
+        }
+    });
+
+    std::vector<SimilarityMatch> matches;
+    while (!best.empty()) {
+        matches.push_back({ _roasts[best.top().second], sqrtf(best.top().first / length) });
+        best.pop();
+    }
+    std::reverse(matches.begin(), matches.end());
+
+    if (stats) {
+        stats->candidates = candidates;
+        stats->dtw = dtw_done;
+        stats->abandoned = abandoned;
+        stats->pruned = candidates - dtw_done - abandoned;
+        stats->search_ms = _elapsed_ms(start);
+    }
+    return matches;
+}
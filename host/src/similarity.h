@@ -0,0 +1,82 @@
+#pragma once
+
+#include "analytics.h"
+#include "archive.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============== Curve Similarity ==============
+// Finds the archived roasts whose chamber temperature and RoR curves are
+// closest to a reference, by dynamic time warping.
+//
+// Curves are resampled every SIMILARITY_STEP_MS from the charge, so every
+// roast is aligned on the same event. A candidate is compared over the
+// reference's length: longer roasts are cut at that point, shorter ones
+// hold their drop values. Equal lengths let LB_Keogh bound the banded DTW
+// distance from below, which is how the search discards most candidates
+// without running DTW at all.
+//
+// Search:
+//   1. LB_Keogh for every candidate against the reference envelope (parallel)
+//   2. candidates sorted by bound, DTW in that order (parallel); stops once
+//      the next bound exceeds the current k-th best distance
+//   3. DTW abandons a candidate as soon as a whole band row is worse
+
+#define SIMILARITY_STEP_MS          5000
+#define SIMILARITY_BAND_MS          60000       // Sakoe-Chiba warping window
+#define SIMILARITY_ROR_WEIGHT       0.5f        // RoR error weight vs temperature (°C)
+#define SIMILARITY_MAX_POINTS       720         // One hour at 5 s
+
+struct CurveFeatures {
+    std::vector<float> temp;        // °C, charge-aligned
+    std::vector<float> ror;         // °C/min
+};
+
+// Charge-to-drop curve of one roast; false when no charge was found
+bool curve_extract(const RoastView& roast, RoastColumnsScratch& scratch, CurveFeatures& curve);
+
+// Banded DTW over two equal-length curves, as a sum of squared errors;
+// returns INFINITY once every path exceeds `abandon`
+float dtw_distance(const CurveFeatures& a, const CurveFeatures& b, size_t band, float ror_weight,
+                   float abandon);
+
+struct SimilarityOptions {
+    size_t k = 10;
+    unsigned threads = 0;           // 0 = all cores
+    size_t band = SIMILARITY_BAND_MS / SIMILARITY_STEP_MS;     // In steps
+    float ror_weight = SIMILARITY_ROR_WEIGHT;
+};
+
+struct SimilarityMatch {
+    size_t roast;                   // Archive index
+    float distance;                 // RMS error per step (°C equivalent)
+};
+
+struct SimilarityStats {
+    size_t candidates = 0;
+    size_t pruned = 0;              // Rejected by LB_Keogh alone
+    size_t abandoned = 0;           // DTW stopped early
+    size_t dtw = 0;                 // DTW run to completion
+    double extract_ms = 0;
+    double search_ms = 0;
+};
+
+// Extracted curves for a set of archive roasts, reusable across queries
+class SimilarityIndex {
+public:
+    void build(const Archive& archive, const std::vector<size_t>& roasts, unsigned threads,
+               SimilarityStats* stats = nullptr);
+
+    // Top-k nearest roasts to the reference; `exclude` (an archive index,
+    // usually the reference itself) is skipped
+    std::vector<SimilarityMatch> query(const CurveFeatures& reference, const SimilarityOptions& options,
+                                       size_t exclude = SIZE_MAX, SimilarityStats* stats = nullptr) const;
+
+    size_t size() const { return _roasts.size(); }
+
+private:
+    std::vector<size_t> _roasts;
+    std::vector<CurveFeatures> _curves;     // Empty when extraction failed
+};
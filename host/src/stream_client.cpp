@@ -0,0 +1,149 @@
+#include "stream_client.h"
+#include "log.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#define STREAM_READ_CHUNK   65536
+#define STREAM_MAX_LINE     65536
+
+StreamClient::StreamClient(EventLoop& loop, std::string host, uint16_t port)
+    : _loop(loop), _host(std::move(host)), _port(port), _lines(STREAM_MAX_LINE) {}
+
+StreamClient::~StreamClient() {
+    stop();
+}
+
+void StreamClient::start() {
+    _running = true;
+    _connect();
+}
+
+void StreamClient::stop() {
+    _running = false;
+    if (_retry_timer) {
+        _loop.cancel_timer(_retry_timer);
+        _retry_timer = 0;
+    }
+    if (_fd >= 0) _disconnect("stopped");
+}
+
+bool StreamClient::send(std::string_view line) {
+    if (!_connected) return false;
+    _out.append(line);
+    _out.push_back('\n');
+    if (!_want_write) _flush();
+    return true;
+}
+
+void StreamClient::_connect() {
+    _retry_timer = 0;
+    if (!_running) return;
+
+    addrinfo hints {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(_host.c_str(), std::to_string(_port).c_str(), &hints, &result) != 0 || !result) {
+        host_log(LogLevel::WARN, "STREAM", "Cannot resolve %s", _host.c_str());
+        _retry_timer = _loop.add_timer(STREAM_RECONNECT_MS, 0, [this]() { _connect(); });
+        return;
+    }
+
+    _fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int rc = connect(_fd, result->ai_addr, result->ai_addrlen);
+    freeaddrinfo(result);
+    if (rc < 0 && errno != EINPROGRESS) {
+        _disconnect(strerror(errno));
+        return;
+    }
+
+    int one = 1;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    _want_write = true;     // Writable = connect finished
+    _loop.add(_fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP, [this](uint32_t events) { _on_events(events); });
+}
+
+void StreamClient::_disconnect(const char* reason) {
+    if (_fd >= 0) {
+        _loop.remove(_fd);
+        close(_fd);
+        _fd = -1;
+    }
+    _out.clear();
+    _lines.clear();
+
+    bool was_connected = _connected;
+    _connected = false;
+    if (was_connected) {
+        _reconnects++;
+        host_log(LogLevel::WARN, "STREAM", "Disconnected from %s:%u: %s", _host.c_str(), _port, reason);
+        if (_on_state) _on_state(false);
+    }
+
+    if (_running && !_retry_timer) {
+        _retry_timer = _loop.add_timer(STREAM_RECONNECT_MS, 0, [this]() { _connect(); });
+    }
+}
+
+void StreamClient::_on_events(uint32_t events) {
+    if (!_connected && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(_fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err) {
+            _disconnect(strerror(err));
+            return;
+        }
+        _connected = true;
+        host_log(LogLevel::INFO, "STREAM", "Connected to %s:%u", _host.c_str(), _port);
+
+        // Any byte selects raw NDJSON framing on the server
+        _out.insert(0, "\n");
+        if (_on_state) _on_state(true);
+        if (_fd < 0) return;
+    }
+
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+        char buf[STREAM_READ_CHUNK];
+        while (_fd >= 0) {
+            ssize_t n = recv(_fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                _lines.feed(buf, n, [this](std::string_view line) {
+                    if (_on_line) _on_line(line);
+                });
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            _disconnect(n == 0 ? "server closed" : strerror(errno));
+            return;
+        }
+    }
+
+    if (_fd >= 0) _flush();
+}
+
+void StreamClient::_flush() {
+    while (!_out.empty()) {
+        ssize_t n = ::send(_fd, _out.data(), _out.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            _disconnect(strerror(errno));
+            return;
+        }
+        _out.erase(0, n);
+    }
+
+    bool want = !_out.empty();
+    if (want != _want_write) {
+        _want_write = want;
+        _loop.modify(_fd, EPOLLIN | EPOLLRDHUP | (want ? (uint32_t)EPOLLOUT : 0u));
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "event_loop.h"
+#include "ndjson.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// ============== Stream Client ==============
+// Raw NDJSON TCP client for the bridge / fleet services. Connects without
+// blocking, splits lines, and reconnects after a fixed delay when the
+// connection drops.
+
+#define STREAM_RECONNECT_MS 2000
+
+class StreamClient {
+public:
+    using LineHandler = std::function<void(std::string_view line)>;
+    using StateHandler = std::function<void(bool connected)>;
+
+    StreamClient(EventLoop& loop, std::string host, uint16_t port);
+    ~StreamClient();
+
+    StreamClient(const StreamClient&) = delete;
+    StreamClient& operator=(const StreamClient&) = delete;
+
+    void start();
+    void stop();
+
+    // Queues one NDJSON line; false while disconnected
+    bool send(std::string_view line);
+
+    void on_line(LineHandler handler) { _on_line = std::move(handler); }
+    void on_state(StateHandler handler) { _on_state = std::move(handler); }
+
+    bool connected() const { return _connected; }
+    uint64_t reconnects() const { return _reconnects; }
+
+private:
+    void _connect();
+    void _disconnect(const char* reason);
+    void _on_events(uint32_t events);
+    void _flush();
+
+    EventLoop& _loop;
+    std::string _host;
+    uint16_t _port;
+    int _fd = -1;
+    bool _connected = false;
+    bool _running = false;
+    bool _want_write = false;
+    uint64_t _retry_timer = 0;
+    uint64_t _reconnects = 0;
+
+    LineBuffer _lines;
+    std::string _out;
+    LineHandler _on_line;
+    StateHandler _on_state;
+};
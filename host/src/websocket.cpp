@@ -0,0 +1,151 @@
+#include "websocket.h"
+
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+// ============== SHA-1 / Base64 ==============
+
+static uint32_t _rol(uint32_t v, uint8_t bits) {
+    return (v << bits) | (v >> (32 - bits));
+}
+
+static void _sha1(const uint8_t* msg, size_t len, uint8_t out[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint8_t block[64];
+    size_t total = ((len + 8) / 64 + 1) * 64;
+
+    for (size_t off = 0; off < total; off += 64) {
+        for (uint8_t i = 0; i < 64; i++) {
+            size_t pos = off + i;
+            if (pos < len)                 block[i] = msg[pos];
+            else if (pos == len)           block[i] = 0x80;
+            else if (pos >= total - 8)     block[i] = (uint8_t)(((uint64_t)len * 8) >> ((total - 1 - pos) * 8));
+            else                           block[i] = 0;
+        }
+
+        uint32_t w[80];
+        for (uint8_t i = 0; i < 16; i++) {
+            w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+                   ((uint32_t)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+        }
+        for (uint8_t i = 16; i < 80; i++) {
+            w[i] = _rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (uint8_t i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            uint32_t t = _rol(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = _rol(b, 30); b = a; a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for (uint8_t i = 0; i < 20; i++) {
+        out[i] = (uint8_t)(h[i / 4] >> (24 - (i % 4) * 8));
+    }
+}
+
+static std::string _base64(const uint8_t* in, size_t len) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out += table[(v >> 18) & 0x3F];
+        out += table[(v >> 12) & 0x3F];
+        out += (i + 1 < len) ? table[(v >> 6) & 0x3F] : '=';
+        out += (i + 2 < len) ? table[v & 0x3F] : '=';
+    }
+    return out;
+}
+
+std::string ws_accept_key(std::string_view client_key) {
+    std::string combined(client_key);
+    combined += WS_GUID;
+    uint8_t digest[20];
+    _sha1((const uint8_t*)combined.data(), combined.size(), digest);
+    return _base64(digest, sizeof(digest));
+}
+
+// ============== Framing ==============
+
+size_t ws_encode_header(uint8_t opcode, uint64_t len, uint8_t out[10]) {
+    out[0] = 0x80 | opcode;
+    if (len < 126) {
+        out[1] = (uint8_t)len;
+        return 2;
+    }
+    if (len <= 0xFFFF) {
+        out[1] = 126;
+        out[2] = (uint8_t)(len >> 8);
+        out[3] = (uint8_t)len;
+        return 4;
+    }
+    out[1] = 127;
+    for (int i = 0; i < 8; i++) {
+        out[2 + i] = (uint8_t)(len >> (56 - i * 8));
+    }
+    return 10;
+}
+
+int WsDecoder::_parse(size_t pos, size_t& used) {
+    const uint8_t* p = (const uint8_t*)_buffer.data() + pos;
+    size_t avail = _buffer.size() - pos;
+    if (avail < 2) return 0;
+
+    bool fin = p[0] & 0x80;
+    uint8_t opcode = p[0] & 0x0F;
+    bool masked = p[1] & 0x80;
+    uint64_t len = p[1] & 0x7F;
+    size_t header = 2;
+
+    // Clients must mask (RFC 6455 5.1)
+    if (!masked) return -1;
+
+    if (len == 126) {
+        if (avail < 4) return 0;
+        len = ((uint64_t)p[2] << 8) | p[3];
+        header = 4;
+    } else if (len == 127) {
+        if (avail < 10) return 0;
+        len = 0;
+        for (int i = 0; i < 8; i++) len = (len << 8) | p[2 + i];
+        header = 10;
+    }
+    if (len > WS_MAX_MESSAGE_SIZE) return -1;
+    if (avail < header + 4 + len) return 0;
+
+    const uint8_t* mask = p + header;
+    const uint8_t* payload = mask + 4;
+
+    if (opcode >= WS_OPCODE_CLOSE) {
+        // Control frames can't be fragmented and carry at most 125 bytes
+        if (!fin || len > 125) return -1;
+        _control.resize(len);
+        for (size_t i = 0; i < len; i++) _control[i] = payload[i] ^ mask[i & 3];
+    } else {
+        if (opcode == WS_OPCODE_CONTINUATION) {
+            if (!_in_message) return -1;
+        } else {
+            if (_in_message) return -1;
+            _message.clear();
+            _message_opcode = opcode;
+        }
+        if (_message.size() + len > WS_MAX_MESSAGE_SIZE) return -1;
+
+        size_t start = _message.size();
+        _message.resize(start + len);
+        for (size_t i = 0; i < len; i++) _message[start + i] = payload[i] ^ mask[i & 3];
+        _in_message = !fin;
+    }
+
+    _frame_fin = fin;
+    _frame_opcode = opcode;
+    used = header + 4 + len;
+    return 1;
+}
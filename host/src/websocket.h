@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ============== WebSocket (RFC 6455) ==============
+// Server-side pieces shared by the bridge and fleet services: handshake
+// key derivation, unmasked server frame headers and a client frame decoder.
+
+#define WS_OPCODE_CONTINUATION  0x0
+#define WS_OPCODE_TEXT          0x1
+#define WS_OPCODE_BINARY        0x2
+#define WS_OPCODE_CLOSE         0x8
+#define WS_OPCODE_PING          0x9
+#define WS_OPCODE_PONG          0xA
+
+#define WS_MAX_MESSAGE_SIZE     65536
+
+// Sec-WebSocket-Accept value for a client's Sec-WebSocket-Key
+std::string ws_accept_key(std::string_view client_key);
+
+// Writes a FIN frame header for a payload of len bytes; returns header size
+size_t ws_encode_header(uint8_t opcode, uint64_t len, uint8_t out[10]);
+
+// Reassembles masked client frames. Data messages are delivered whole
+// (fragments joined); control frames are delivered as they arrive.
+class WsDecoder {
+public:
+    // on_message(opcode, payload); returns false on a protocol error
+    template <typename Fn>
+    bool feed(const uint8_t* data, size_t len, Fn&& on_message) {
+        _buffer.append((const char*)data, len);
+        size_t pos = 0;
+        while (true) {
+            size_t used = 0;
+            int result = _parse(pos, used);
+            if (result < 0) return false;
+            if (result == 0) break;
+
+            if (_frame_opcode >= WS_OPCODE_CLOSE) {
+                on_message(_frame_opcode, std::string_view(_control));
+            } else if (_frame_fin) {
+                on_message(_message_opcode, std::string_view(_message));
+                _message.clear();
+            }
+            pos += used;
+        }
+        _buffer.erase(0, pos);
+        return true;
+    }
+
+private:
+    // 1 = frame consumed, 0 = need more data, -1 = protocol error
+    int _parse(size_t pos, size_t& used);
+
+    std::string _buffer;
+    std::string _message;
+    std::string _control;
+    uint8_t _message_opcode = 0;
+    uint8_t _frame_opcode = 0;
+    bool _frame_fin = false;
+    bool _in_message = false;
+};
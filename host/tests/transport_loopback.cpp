@@ -0,0 +1,284 @@
+// transport-loopback: drives the firmware transport core (src/transport.cpp)
+// through in-memory sinks - shared-frame fan-out, reference release,
+// DROP_OLDEST shedding, overflow of frames that must be delivered, and
+// BLOCK sinks. Exits non-zero if any check fails.
+
+#include "transport.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static int _failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        _failures++; \
+    } \
+} while (0)
+
+// ============== Loopback Sinks ==============
+
+// Queued sink whose peer accepts `window` bytes per poll (0 = stalled)
+class LoopbackSink : public TransportSink {
+public:
+    explicit LoopbackSink(const char* name) : _name(name) {}
+
+    const char* name() const override { return _name; }
+    BackpressurePolicy policy() const override { return BackpressurePolicy::DROP_OLDEST; }
+    bool connected() override { return attached; }
+    int read() override { return -1; }
+
+    void poll() override {
+        size_t budget = window;
+        while (budget) {
+            TransportFrame* frame = frame_queue_front(queue);
+            if (!frame) return;
+            size_t n = frame->len - queue.offset;
+            if (n > budget) n = budget;
+            output.append(frame->data + queue.offset, n);
+            queue.offset += n;
+            budget -= n;
+            if (queue.offset == frame->len) {
+                output += '\n';
+                frame_queue_pop(queue);
+            }
+        }
+    }
+
+    void disconnect() override {
+        frame_queue_clear(queue);
+        attached = false;
+        disconnects++;
+    }
+
+    bool attached = true;
+    size_t window = 0;
+    int disconnects = 0;
+    std::string output;
+
+private:
+    const char* _name;
+};
+
+// Synchronous sink, like USB CDC
+class BlockingSink : public TransportSink {
+public:
+    const char* name() const override { return "block"; }
+    BackpressurePolicy policy() const override { return BackpressurePolicy::BLOCK; }
+    bool connected() override { return true; }
+    int read() override { return -1; }
+
+    void write_now(const TransportFrame* frame) override {
+        output.append(frame->data, frame->len);
+        output += '\n';
+    }
+
+    std::string output;
+};
+
+static void _send(const char* line, bool droppable) {
+    transport_send(line, strlen(line), droppable);
+}
+
+static std::string _queued(LoopbackSink& sink) {
+    std::string out;
+    for (uint8_t i = 0; i < sink.queue.count; i++) {
+        const TransportFrame* frame = sink.queue.frames[(sink.queue.head + i) % TRANSPORT_SINK_QUEUE];
+        out.append(frame->data, frame->len);
+    }
+    return out;
+}
+
+// ============== Cases ==============
+
+static void _test_fan_out() {
+    transport_init();
+    BlockingSink usb;
+    LoopbackSink a("a"), b("b");
+    transport_register(&usb);
+    transport_register(&a);
+    transport_register(&b);
+
+    _send("s1", true);
+
+    // Serialized once, held by both queues, none by the BLOCK sink
+    TransportFrame* frame = frame_queue_front(a.queue);
+    CHECK(frame != nullptr);
+    CHECK(frame == frame_queue_front(b.queue));
+    CHECK(frame && frame->refs == 2);
+    CHECK(usb.output == "s1\n");
+
+    // Released per sink as each one finishes writing it
+    a.window = 64;
+    transport_update();
+    CHECK(a.output == "s1\n");
+    CHECK(frame && frame->refs == 1);
+    b.window = 1;
+    transport_update();
+    CHECK(b.output == "s");
+    CHECK(frame && frame->refs == 1);
+    transport_update();
+    CHECK(b.output == "s1\n");
+    CHECK(frame && frame->refs == 0);
+
+    // A muted sink is skipped by broadcasts but still gets direct replies
+    b.muted = true;
+    b.window = 64;
+    _send("s2", true);
+    transport_send_to(2, "reply", 5);
+    transport_update();
+    CHECK(a.output == "s1\ns2\n");
+    CHECK(b.output == "s1\nreply\n");
+}
+
+static void _test_release() {
+    transport_init();
+    LoopbackSink a("a"), b("b");
+    transport_register(&a);
+    transport_register(&b);
+    a.window = 64;
+    b.window = 64;
+
+    // Far more frames than the pool holds - each must come back to it
+    std::string expected;
+    for (int i = 0; i < 10 * TRANSPORT_FRAME_POOL; i++) {
+        char line[16];
+        snprintf(line, sizeof(line), "f%d", i);
+        _send(line, i % 2 == 0);
+        transport_update();
+        expected += line;
+        expected += '\n';
+    }
+    CHECK(a.output == expected);
+    CHECK(b.output == expected);
+
+    // A disconnect drops the sink's references without touching the others
+    a.window = 0;
+    b.window = 0;
+    _send("x", false);
+    TransportFrame* frame = frame_queue_front(a.queue);
+    CHECK(frame && frame->refs == 2);
+    a.disconnect();
+    CHECK(a.queue.count == 0);
+    CHECK(frame && frame->refs == 1);
+    b.window = 64;
+    transport_update();
+    CHECK(frame && frame->refs == 0);
+
+    // Disconnected sinks are not offered frames
+    _send("y", true);
+    CHECK(a.queue.count == 0);
+    CHECK(b.queue.count == 1);
+}
+
+static void _test_drop_oldest() {
+    transport_init();
+    LoopbackSink a("a");
+    transport_register(&a);
+
+    // Telemetry backlog: the oldest sample goes first
+    _send("t1", true);
+    _send("t2", true);
+    _send("t3", true);
+    _send("t4", true);
+    CHECK(_queued(a) == "t2t3t4");
+    CHECK(a.dropped == 1);
+
+    // Telemetry is shed to make room for a frame that must arrive
+    _send("E1", false);
+    CHECK(_queued(a) == "t3t4E1");
+    CHECK(a.dropped == 2);
+    CHECK(a.disconnects == 0);
+
+    // A partially written head is never shed
+    a.window = 1;
+    transport_update();
+    CHECK(a.queue.offset == 1);
+    a.window = 0;
+    _send("E2", false);
+    CHECK(_queued(a) == "t3E1E2");
+    a.window = 64;
+    transport_update();
+    CHECK(a.output == "t3\nE1\nE2\n");
+    CHECK(a.disconnects == 0);
+}
+
+static void _test_overflow_disconnect() {
+    transport_init();
+    LoopbackSink a("a"), b("b");
+    transport_register(&a);
+    transport_register(&b);
+    b.window = 64;
+
+    for (int i = 0; i < TRANSPORT_SINK_QUEUE; i++) {
+        _send("E", false);
+        transport_update();
+    }
+    CHECK(a.queue.count == TRANSPORT_SINK_QUEUE);
+
+    // Nothing to shed: late telemetry is dropped, the sink kept
+    _send("t", true);
+    transport_update();
+    CHECK(a.dropped == 1);
+    CHECK(a.disconnects == 0);
+    CHECK(a.queue.count == TRANSPORT_SINK_QUEUE);
+
+    // ...but a frame that must arrive disconnects the peer
+    _send("E", false);
+    CHECK(a.disconnects == 1);
+    CHECK(!a.attached);
+    CHECK(a.queue.count == 0);
+
+    // Every frame it held is back in the pool once the healthy sink drains
+    transport_update();
+    CHECK(b.output == "E\nE\nE\nt\nE\n");
+    std::string expected = b.output;
+    for (int i = 0; i < 2 * TRANSPORT_FRAME_POOL; i++) {
+        _send("after", false);
+        transport_update();
+        expected += "after\n";
+    }
+    CHECK(b.output == expected);
+    CHECK(b.dropped == 0);
+}
+
+static void _test_block() {
+    transport_init();
+    BlockingSink usb;
+    LoopbackSink a("a");
+    transport_register(&usb);
+    transport_register(&a);
+
+    // A stalled network peer neither stalls nor thins the BLOCK sink
+    std::string expected;
+    for (int i = 0; i < 3 * TRANSPORT_SINK_QUEUE; i++) {
+        _send("t", true);
+        expected += "t\n";
+    }
+    CHECK(usb.output == expected);
+    CHECK(usb.dropped == 0);
+    CHECK(usb.queue.count == 0);
+    CHECK(a.queue.count == TRANSPORT_SINK_QUEUE);
+
+    // transport_update() never polls BLOCK sinks; direct replies are immediate
+    transport_update();
+    transport_send_to(0, "reply", 5);
+    CHECK(usb.output == expected + "reply\n");
+}
+
+int main() {
+    _test_fan_out();
+    _test_release();
+    _test_drop_oldest();
+    _test_overflow_disconnect();
+    _test_block();
+
+    if (_failures) {
+        fprintf(stderr, "transport-loopback: %d check(s) failed\n", _failures);
+        return 1;
+    }
+    printf("transport-loopback: ok\n");
+    return 0;
+}
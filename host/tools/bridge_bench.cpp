@@ -0,0 +1,249 @@
+// bridge-bench: fanout latency of the serial bridge with many clients.
+//
+// Runs a Bridge on a pty in a background thread, writes roasterState lines
+// into the other end at a fixed rate and measures the time until each
+// client receives each frame.
+//
+//   bridge-bench [--clients 500] [--rate 100] [--seconds 10] [--websocket]
+
+#include "bridge.h"
+#include "event_loop.h"
+#include "log.h"
+#include "ndjson.h"
+#include "serial_port.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pty.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+static uint64_t _now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+struct BenchClient {
+    int fd = -1;
+    bool websocket = false;
+    bool upgraded = false;
+    std::string buffer;
+    uint64_t frames = 0;
+};
+
+static int _connect(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void _on_line(std::string_view line, BenchClient& client, std::vector<uint64_t>& latencies) {
+    std::string_view type;
+    uint64_t sent_ns = 0;
+    if (!json_get_string(line, "type", type) || type != "roasterState") return;
+    if (line.find("\"bench\":true") == std::string_view::npos) return;
+    if (!json_get_uint(line, "timestamp", sent_ns)) return;
+    latencies.push_back(_now_ns() - sent_ns);
+    client.frames++;
+}
+
+// Splits received bytes into protocol lines for either framing
+static void _consume(BenchClient& client, std::vector<uint64_t>& latencies) {
+    std::string& buf = client.buffer;
+    size_t pos = 0;
+
+    if (client.websocket && !client.upgraded) {
+        size_t end = buf.find("\r\n\r\n");
+        if (end == std::string::npos) return;
+        client.upgraded = true;
+        pos = end + 4;
+    }
+
+    while (pos < buf.size()) {
+        if (client.websocket) {
+            if (buf.size() - pos < 2) break;
+            const uint8_t* p = (const uint8_t*)buf.data() + pos;
+            size_t len = p[1] & 0x7F, header = 2;
+            if (len == 126) {
+                if (buf.size() - pos < 4) break;
+                len = ((size_t)p[2] << 8) | p[3];
+                header = 4;
+            }
+            if (buf.size() - pos < header + len) break;
+            _on_line(std::string_view(buf.data() + pos + header, len), client, latencies);
+            pos += header + len;
+        } else {
+            size_t nl = buf.find('\n', pos);
+            if (nl == std::string::npos) break;
+            _on_line(std::string_view(buf.data() + pos, nl - pos), client, latencies);
+            pos = nl + 1;
+        }
+    }
+    buf.erase(0, pos);
+}
+
+int main(int argc, char** argv) {
+    int client_count = 500;
+    int rate_hz = 100;
+    int seconds = 10;
+    bool websocket = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : "0";
+        if (strcmp(argv[i], "--clients") == 0)      { client_count = atoi(value); i++; }
+        else if (strcmp(argv[i], "--rate") == 0)    { rate_hz = atoi(value); i++; }
+        else if (strcmp(argv[i], "--seconds") == 0) { seconds = atoi(value); i++; }
+        else if (strcmp(argv[i], "--websocket") == 0) websocket = true;
+        else {
+            fprintf(stderr, "Usage: %s [--clients N] [--rate HZ] [--seconds S] [--websocket]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rate_hz <= 0 || client_count <= 0) return 2;
+
+    signal(SIGPIPE, SIG_IGN);
+    host_log_set_level(LogLevel::WARN);
+
+    // Each client costs two fds in this process
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    int master = -1, slave = -1;
+    if (openpty(&master, &slave, nullptr, nullptr, nullptr) < 0 ||
+        !serial_configure(slave, SERIAL_DEFAULT_BAUD) || !serial_configure(master, SERIAL_DEFAULT_BAUD)) {
+        perror("openpty");
+        return 1;
+    }
+
+    EventLoop loop;
+    BridgeConfig config;
+    config.server.port = 0;
+    config.server.max_clients = client_count + 16;
+    Bridge bridge(loop, config);
+    if (!bridge.start()) return 1;
+    bridge.attach_fd(slave);
+    uint16_t port = bridge.server().port();
+
+    std::thread bridge_thread([&loop]() { loop.run(); });
+
+    // ---- Connect clients ----
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<BenchClient> clients(client_count);
+    for (int i = 0; i < client_count; i++) {
+        BenchClient& client = clients[i];
+        client.fd = _connect(port);
+        if (client.fd < 0) {
+            fprintf(stderr, "connect %d failed: %s\n", i, strerror(errno));
+            return 1;
+        }
+        client.websocket = websocket;
+        if (websocket) {
+            const char* request = "GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\n"
+                                  "Connection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                                  "Sec-WebSocket-Version: 13\r\n\r\n";
+            ::send(client.fd, request, strlen(request), 0);
+        } else {
+            // Any byte selects raw NDJSON immediately
+            ::send(client.fd, "\n", 1, 0);
+        }
+        epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.u32 = i;
+        epoll_ctl(ep, EPOLL_CTL_ADD, client.fd, &ev);
+    }
+    for (int wait = 0; wait < 100 && bridge.server().client_count() < (size_t)client_count; wait++) {
+        usleep(20000);
+    }
+    printf("clients connected: %zu / %d (%s)\n", bridge.server().client_count(), client_count,
+           websocket ? "websocket" : "tcp");
+
+    // ---- Produce frames and collect deliveries ----
+    std::vector<uint64_t> latencies;
+    latencies.reserve((size_t)client_count * rate_hz * seconds);
+    uint64_t interval_ns = 1000000000ull / rate_hz;
+    uint64_t start = _now_ns();
+    uint64_t end = start + (uint64_t)seconds * 1000000000ull;
+    uint64_t next_send = start;
+    uint32_t seq = 0;
+    char line[512];
+    char scratch[4096];
+    epoll_event events[256];
+
+    while (true) {
+        uint64_t now = _now_ns();
+        if (now >= next_send && now < end) {
+            seq++;
+            int len = snprintf(line, sizeof(line),
+                "{\"type\":\"roasterState\",\"seq\":%u,\"timestamp\":%llu,\"bench\":true,\"payload\":"
+                "{\"state\":\"ROASTING\",\"chamberTemp\":201.5,\"heaterTemp\":88.0,\"setpoint\":205.0,"
+                "\"fanSpeed\":65,\"heaterPower\":72,\"heaterEnabled\":true,\"pidEnabled\":true,"
+                "\"roastTimeMs\":%u,\"firstCrackMarked\":false,\"firstCrackTimeMs\":null,\"ror\":9.4,"
+                "\"resumeAvailable\":false,\"error\":null}}\n",
+                seq, (unsigned long long)_now_ns(), seq * 10);
+            if (write(master, line, len) != len) fprintf(stderr, "short pty write\n");
+            next_send += interval_ns;
+        }
+        if (now >= end + 500000000ull) break;
+
+        // Drain whatever the bridge wrote back to the "device" (keepalives)
+        while (read(master, scratch, sizeof(scratch)) > 0) {}
+
+        int wait_ms = now < next_send ? (int)((next_send - now) / 1000000) : 0;
+        int count = epoll_wait(ep, events, 256, std::max(wait_ms, 1));
+        for (int i = 0; i < count; i++) {
+            BenchClient& client = clients[events[i].data.u32];
+            ssize_t n;
+            while ((n = recv(client.fd, scratch, sizeof(scratch), MSG_DONTWAIT)) > 0) {
+                client.buffer.append(scratch, n);
+            }
+            _consume(client, latencies);
+        }
+    }
+
+    loop.stop();
+    bridge_thread.join();
+
+    // ---- Report ----
+    uint64_t expected = (uint64_t)seq * client_count;
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double p) -> double {
+        if (latencies.empty()) return 0;
+        return latencies[std::min(latencies.size() - 1, (size_t)(p * latencies.size()))] / 1000.0;
+    };
+
+    printf("frames sent:      %u at %d Hz over %d s\n", seq, rate_hz, seconds);
+    printf("deliveries:       %zu / %llu (%.2f%%)\n", latencies.size(), (unsigned long long)expected,
+           expected ? 100.0 * latencies.size() / expected : 0.0);
+    printf("fanout rate:      %.0f frames/s\n", latencies.size() / (double)seconds);
+    printf("latency (us):     p50 %.0f  p90 %.0f  p99 %.0f  max %.0f\n",
+           pct(0.50), pct(0.90), pct(0.99), latencies.empty() ? 0.0 : latencies.back() / 1000.0);
+    printf("bridge:           %llu frames in, %llu shed, %llu evicted\n",
+           (unsigned long long)bridge.link().stats().frames_in,
+           (unsigned long long)bridge.server().stats().dropped_frames,
+           (unsigned long long)bridge.server().stats().evicted);
+
+    for (BenchClient& client : clients) close(client.fd);
+    close(master);
+    return 0;
+}
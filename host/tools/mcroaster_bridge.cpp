@@ -0,0 +1,77 @@
+// mcroaster-bridge: share one roaster's USB serial link with many local
+// WebSocket / TCP clients.
+//
+//   mcroaster-bridge --device /dev/ttyACM0 [--port 8765] [--bind 127.0.0.1]
+
+#include "bridge.h"
+#include "event_loop.h"
+#include "log.h"
+#include "serial_port.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static EventLoop* _loop = nullptr;
+
+static void _on_signal(int) {
+    if (_loop) _loop->stop();
+}
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --device PATH [options]\n"
+            "  --device PATH     Roaster serial device (e.g. /dev/ttyACM0)\n"
+            "  --baud N          Baud rate (default %d)\n"
+            "  --bind ADDR       Listen address (default 127.0.0.1)\n"
+            "  --port N          Listen port (default %d)\n"
+            "  --queue-kb N      Per-client send budget in KiB (default %d)\n"
+            "  --verbose         Debug logging\n",
+            argv0, SERIAL_DEFAULT_BAUD, CLIENT_DEFAULT_PORT, CLIENT_MAX_QUEUE_BYTES / 1024);
+}
+
+int main(int argc, char** argv) {
+    BridgeConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--device") == 0 && value)        { config.device = value; i++; }
+        else if (strcmp(arg, "--baud") == 0 && value)     { config.baud = atoi(value); i++; }
+        else if (strcmp(arg, "--bind") == 0 && value)     { config.server.bind_address = value; i++; }
+        else if (strcmp(arg, "--port") == 0 && value)     { config.server.port = (uint16_t)atoi(value); i++; }
+        else if (strcmp(arg, "--queue-kb") == 0 && value) { config.server.max_queue_bytes = (size_t)atoi(value) * 1024; i++; }
+        else if (strcmp(arg, "--verbose") == 0)           { host_log_set_level(LogLevel::DEBUG); }
+        else {
+            _usage(argv[0]);
+            return 2;
+        }
+    }
+    if (config.device.empty()) {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    EventLoop loop;
+    _loop = &loop;
+    signal(SIGINT, _on_signal);
+    signal(SIGTERM, _on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    Bridge bridge(loop, config);
+    if (!bridge.start()) return 1;
+
+    loop.run();
+
+    const Bridge::Stats& stats = bridge.stats();
+    const ClientServer::Stats& clients = bridge.server().stats();
+    host_log(LogLevel::INFO, "BRIDGE",
+             "Shutdown: %llu frames in, %llu commands out, %llu rejected, %llu served locally, "
+             "%llu clients, %llu evicted, %llu frames shed",
+             (unsigned long long)bridge.link().stats().frames_in, (unsigned long long)stats.commands_forwarded,
+             (unsigned long long)stats.commands_rejected, (unsigned long long)stats.served_locally,
+             (unsigned long long)clients.accepted, (unsigned long long)clients.evicted,
+             (unsigned long long)clients.dropped_frames);
+    return 0;
+}
@@ -0,0 +1,68 @@
+// mcroaster-fleet: run several roasters from one host and serve their
+// combined stream to local WebSocket / TCP clients.
+//
+//   mcroaster-fleet --device '/dev/ttyACM*' [--device /dev/ttyUSB0] [--port 8766]
+
+#include "event_loop.h"
+#include "fleet.h"
+#include "log.h"
+#include "serial_port.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static EventLoop* _loop = nullptr;
+
+static void _on_signal(int) {
+    if (_loop) _loop->stop();
+}
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --device PATTERN [--device PATTERN ...] [options]\n"
+            "  --device PATTERN  Serial device path or glob (e.g. '/dev/ttyACM*')\n"
+            "  --baud N          Baud rate (default %d)\n"
+            "  --bind ADDR       Listen address (default 127.0.0.1)\n"
+            "  --port N          Listen port (default %d)\n"
+            "  --verbose         Debug logging\n",
+            argv0, SERIAL_DEFAULT_BAUD, FLEET_DEFAULT_PORT);
+}
+
+int main(int argc, char** argv) {
+    FleetConfig config;
+    config.server.port = FLEET_DEFAULT_PORT;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--device") == 0 && value)    { config.patterns.push_back(value); i++; }
+        else if (strcmp(arg, "--baud") == 0 && value) { config.baud = atoi(value); i++; }
+        else if (strcmp(arg, "--bind") == 0 && value) { config.server.bind_address = value; i++; }
+        else if (strcmp(arg, "--port") == 0 && value) { config.server.port = (uint16_t)atoi(value); i++; }
+        else if (strcmp(arg, "--verbose") == 0)       { host_log_set_level(LogLevel::DEBUG); }
+        else {
+            _usage(argv[0]);
+            return 2;
+        }
+    }
+    if (config.patterns.empty()) {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    EventLoop loop;
+    _loop = &loop;
+    signal(SIGINT, _on_signal);
+    signal(SIGTERM, _on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    FleetManager fleet(loop, config);
+    if (!fleet.start()) return 1;
+
+    loop.run();
+
+    host_log(LogLevel::INFO, "FLEET", "Shutdown with %zu devices (%zu up)", fleet.device_count(), fleet.devices_up());
+    return 0;
+}
@@ -0,0 +1,115 @@
+// protocol-gen: emits the parts of the roasterState contract that live
+// outside C++ from the schema in lib/protocol/telemetry_schema.h.
+//
+//   protocol-gen --ts > interface/src/types/telemetry.generated.ts
+//   protocol-gen --markdown > docs/telemetry-schema.md
+//
+// Re-run both after changing TELEMETRY_FIELDS.
+
+#include "telemetry_schema.h"
+
+#include <cstdio>
+#include <cstring>
+
+static const char* const _state_names[] = TELEMETRY_STATE_NAMES;
+
+static const char* _ts_type(TelemetryCodec codec) {
+    switch (codec) {
+        case TelemetryCodec::STATE_NAME:  return "RoasterStateName";
+        case TelemetryCodec::U8:
+        case TelemetryCodec::U32:
+        case TelemetryCodec::DECI:        return "number";
+        case TelemetryCodec::DECI_NULL:
+        case TelemetryCodec::U32_IF_FLAG:
+        case TelemetryCodec::I32_NULL:    return "number | null";
+        case TelemetryCodec::FLAG:        return "boolean";
+    }
+    return "unknown";
+}
+
+static const char* _json_form(TelemetryCodec codec) {
+    switch (codec) {
+        case TelemetryCodec::STATE_NAME:  return "string";
+        case TelemetryCodec::U8:          return "integer";
+        case TelemetryCodec::U32:         return "integer";
+        case TelemetryCodec::DECI:        return "number, 1 decimal";
+        case TelemetryCodec::DECI_NULL:   return "number, 1 decimal, or null";
+        case TelemetryCodec::FLAG:        return "boolean";
+        case TelemetryCodec::U32_IF_FLAG: return "integer or null";
+        case TelemetryCodec::I32_NULL:    return "signed integer or null";
+    }
+    return "?";
+}
+
+static const char* _binary_form(TelemetryCodec codec) {
+    switch (codec) {
+        case TelemetryCodec::STATE_NAME:  return "- (from stateId)";
+        case TelemetryCodec::U8:          return "u8";
+        case TelemetryCodec::U32:
+        case TelemetryCodec::U32_IF_FLAG: return "u32";
+        case TelemetryCodec::DECI:
+        case TelemetryCodec::DECI_NULL:   return "i16 tenths, -32768 = null";
+        case TelemetryCodec::FLAG:        return "flags bit";
+        case TelemetryCodec::I32_NULL:    return "i32, INT32_MIN = null";
+    }
+    return "?";
+}
+
+static void _emit_ts() {
+    printf("// Generated by host protocol-gen from lib/protocol/telemetry_schema.h.\n"
+           "// Do not edit - change TELEMETRY_FIELDS and re-run `protocol-gen --ts`.\n\n");
+
+    printf("export type RoasterStateName =\n");
+    for (size_t i = 0; i < TELEMETRY_STATE_COUNT; i++) {
+        printf("  | '%s'%s\n", _state_names[i], i + 1 == TELEMETRY_STATE_COUNT ? ";" : "");
+    }
+
+    printf("\n// roasterState payload fields, in the order the firmware sends them\n"
+           "export interface RoasterTelemetry {\n");
+    for (size_t i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        const TelemetryField& f = TELEMETRY_FIELD_TABLE[i];
+        char decl[64];
+        snprintf(decl, sizeof(decl), "%s: %s;", f.key, _ts_type(f.codec));
+        printf("  %-34s // %s\n", decl, f.description);
+    }
+    printf("}\n");
+}
+
+static void _emit_markdown() {
+    printf("# roasterState Schema\n\n"
+           "<!-- Generated by host protocol-gen from lib/protocol/telemetry_schema.h; "
+           "re-run `protocol-gen --markdown` after changing TELEMETRY_FIELDS. -->\n\n"
+           "Envelope: `{\"type\":\"roasterState\",\"seq\":N[,\"replay\":true],\"timestamp\":MS,"
+           "\"payload\":{...}}`. The payload members below are always sent in this order, "
+           "followed by `error` (an error object or null).\n\n");
+
+    printf("| Key | JSON | Binary | Description |\n"
+           "|-----|------|--------|-------------|\n");
+    for (size_t i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        const TelemetryField& f = TELEMETRY_FIELD_TABLE[i];
+        printf("| `%s` | %s | %s | %s |\n", f.key, _json_form(f.codec), _binary_form(f.codec), f.description);
+    }
+
+    printf("\n## States\n\n| stateId | state |\n|---------|-------|\n");
+    for (size_t i = 0; i < TELEMETRY_STATE_COUNT; i++) printf("| %zu | `%s` |\n", i, _state_names[i]);
+
+    printf("\n## Binary Form\n\n"
+           "Version %d, %zu bytes, little-endian: `version u8`, `seq u32`, `timestamp u32`, "
+           "`flags u8`, then the fields above in order (flag fields live only in `flags`).\n\n"
+           "| Flag | Bit |\n|------|-----|\n",
+           TELEMETRY_BINARY_VERSION, TELEMETRY_BINARY_SIZE);
+    for (size_t i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        const TelemetryField& f = TELEMETRY_FIELD_TABLE[i];
+        if (f.codec == TelemetryCodec::FLAG) printf("| `%s` | 0x%02X |\n", f.key, f.flag);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && strcmp(argv[1], "--ts") == 0) _emit_ts();
+    else if (argc == 2 && strcmp(argv[1], "--markdown") == 0) _emit_markdown();
+    else {
+        fprintf(stderr, "Usage: %s --ts | --markdown\n", argv[0]);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// roast-analytics: phase timings, RoR, energy and control-quality metrics
+// for every roast in an archive, computed in parallel.
+//
+//   roast-analytics --dir archive                      (distribution table)
+//   roast-analytics --dir archive --csv roasts.csv     (plus one row per roast)
+//   roast-analytics --dir archive --from 2026-01-01 --threads 8
+
+#include "analytics.h"
+#include "archive.h"
+#include "log.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --dir DIR [options]\n"
+            "  --from DATE         Only roasts started on or after DATE (YYYY-MM-DD)\n"
+            "  --to DATE           Only roasts started before DATE\n"
+            "  --csv FILE          Write per-roast metrics as CSV ('-' for stdout)\n"
+            "  --threads N         Worker threads (default: all cores)\n"
+            "  --heater-watts W    Rated heater power for energy figures (default %.0f)\n"
+            "  --repeat N          Run the analysis N times and report throughput\n",
+            argv0, ANALYTICS_DEFAULT_HEATER_W);
+}
+
+static bool _parse_date(const char* text, uint64_t& unix_ms) {
+    struct tm tm {};
+    if (!strptime(text, "%Y-%m-%d", &tm)) return false;
+    tm.tm_isdst = -1;
+    unix_ms = (uint64_t)mktime(&tm) * 1000;
+    return true;
+}
+
+static bool _write_csv(const char* path, const Archive& archive, const std::vector<size_t>& roasts,
+                       const std::vector<RoastMetrics>& metrics) {
+    FILE* out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!out) {
+        host_log(LogLevel::ERROR, "ANALYTICS", "Cannot write %s", path);
+        return false;
+    }
+    const std::vector<MetricField>& fields = metric_fields();
+    fprintf(out, "id,start_unix_ms,device,rating,samples");
+    for (const MetricField& field : fields) fprintf(out, ",%s", field.name);
+    fprintf(out, "\n");
+
+    for (size_t i = 0; i < roasts.size(); i++) {
+        const ArchiveEntry& entry = archive.entry(roasts[i]);
+        fprintf(out, "%s,%llu,%s,%d,%u", entry.id, (unsigned long long)entry.start_unix_ms, entry.device,
+                entry.rating, metrics[i].samples);
+        for (const MetricField& field : fields) {
+            double v = field.get(metrics[i]);
+            if (std::isnan(v)) fprintf(out, ",");
+            else fprintf(out, ",%.2f", v);
+        }
+        fprintf(out, "\n");
+    }
+    if (out != stdout) fclose(out);
+    return true;
+}
+
+static void _print_summary(const std::vector<MetricSummary>& summaries) {
+    const std::vector<MetricField>& fields = metric_fields();
+    printf("%-15s %-7s %6s %9s %8s %9s %9s %9s %9s %9s\n",
+           "metric", "unit", "count", "mean", "stddev", "min", "p10", "p50", "p90", "max");
+    for (size_t i = 0; i < summaries.size(); i++) {
+        const MetricSummary& s = summaries[i];
+        if (s.count == 0) {
+            printf("%-15s %-7s %6zu\n", s.name.c_str(), fields[i].unit, s.count);
+            continue;
+        }
+        printf("%-15s %-7s %6zu %9.1f %8.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", s.name.c_str(), fields[i].unit,
+               s.count, s.mean, s.stddev, s.min, s.p10, s.p50, s.p90, s.max);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string dir;
+    const char* csv = nullptr;
+    uint64_t from_ms = 0, to_ms = UINT64_MAX;
+    unsigned threads = 0;
+    float heater_watts = ANALYTICS_DEFAULT_HEATER_W;
+    int repeat = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--dir") == 0 && value)               { dir = value; i++; }
+        else if (strcmp(arg, "--csv") == 0 && value)          { csv = value; i++; }
+        else if (strcmp(arg, "--threads") == 0 && value)      { threads = atoi(value); i++; }
+        else if (strcmp(arg, "--heater-watts") == 0 && value) { heater_watts = atof(value); i++; }
+        else if (strcmp(arg, "--repeat") == 0 && value)       { repeat = std::max(1, atoi(value)); i++; }
+        else if (strcmp(arg, "--from") == 0 && value && _parse_date(value, from_ms)) { i++; }
+        else if (strcmp(arg, "--to") == 0 && value && _parse_date(value, to_ms))     { i++; }
+        else {
+            _usage(argv[0]);
+            return 2;
+        }
+    }
+    if (dir.empty()) {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    Archive archive;
+    if (!archive.open(dir)) return 1;
+    std::vector<size_t> roasts = archive.find(from_ms, to_ms);
+
+    std::vector<RoastMetrics> metrics;
+    uint64_t samples = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) metrics = analyze_archive(archive, roasts, threads, heater_watts);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (const RoastMetrics& m : metrics) samples += m.samples;
+
+    if (csv && !_write_csv(csv, archive, roasts, metrics)) return 1;
+    if (!csv || strcmp(csv, "-") != 0) _print_summary(summarize_metrics(metrics));
+
+    double analysed = (double)roasts.size() * repeat;
+    host_log(LogLevel::INFO, "ANALYTICS", "%zu roasts (%llu samples) x%d in %.3f s: %.0f roasts/min",
+             roasts.size(), (unsigned long long)samples, repeat, seconds, seconds > 0 ? analysed / seconds * 60 : 0.0);
+    return 0;
+}
@@ -0,0 +1,218 @@
+// roast-archive: build and query the columnar roast archive.
+//
+//   roast-archive --dir archive import roast-1a2b3c4d.json ...
+//   roast-archive --dir archive import roasts/            (roast-recorder dir)
+//   roast-archive --dir archive list [--from 2026-01-01] [--to 2026-02-01]
+//   roast-archive --dir archive dump ID [--from SEC] [--to SEC] [--points N [--minmax]]
+//   roast-archive --dir archive info
+
+#include "analytics.h"
+#include "archive.h"
+#include "archive_import.h"
+#include "log.h"
+
+#include <sys/stat.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const char* _column_names[ARCHIVE_COLUMNS] = {
+    "time_ms", "chamber", "heater", "setpoint", "ror", "fan", "power", "state"
+};
+
+// Keeps the benchmark decode from being optimised away
+static volatile float _sink;
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --dir DIR COMMAND [args]\n"
+            "  import PATH...          RoastSession JSON exports or roast-recorder directories\n"
+            "  list [--from DATE] [--to DATE]\n"
+            "                          Roasts started in [from, to), DATE as YYYY-MM-DD\n"
+            "  dump ID [--from S] [--to S] [--points N [--minmax]]\n"
+            "                          CSV of one roast (id or unique prefix), optional time window in seconds,\n"
+            "                          optionally reduced to about N points (LTTB, or min/max per bucket)\n"
+            "  info                    Size, compression and decode throughput\n",
+            argv0);
+}
+
+static bool _parse_date(const char* text, uint64_t& unix_ms) {
+    struct tm tm {};
+    if (!strptime(text, "%Y-%m-%d", &tm)) return false;
+    tm.tm_isdst = -1;
+    unix_ms = (uint64_t)mktime(&tm) * 1000;
+    return true;
+}
+
+static int _import(const std::string& dir, const std::vector<std::string>& paths) {
+    ArchiveWriter writer(dir);
+    if (!writer.open()) return 1;
+
+    ImportStats stats;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& path : paths) {
+        struct stat st;
+        bool ok;
+        if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            ok = archive_import_recorder(path, writer, stats);
+        } else {
+            std::ifstream file(path, std::ios::binary);
+            std::stringstream text;
+            text << file.rdbuf();
+            ok = file && archive_import_json(text.str(), writer, stats);
+        }
+        if (!ok) host_log(LogLevel::WARN, "ARCHIVE", "Nothing to import from %s", path.c_str());
+    }
+    if (!writer.flush()) return 1;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("imported %zu roasts (%zu samples) in %.3f s, %zu already archived, %zu skipped\n",
+           stats.roasts, stats.samples, seconds, stats.duplicates, stats.skipped);
+    return 0;
+}
+
+static int _list(const Archive& archive, uint64_t from, uint64_t to) {
+    printf("%-38s %-17s %-10s %8s %8s %7s %8s %8s %6s\n",
+           "id", "started", "device", "samples", "roast", "FC", "preheat", "setpoint", "rating");
+    for (size_t i : archive.find(from, to)) {
+        const ArchiveEntry& entry = archive.entry(i);
+        time_t start = entry.start_unix_ms / 1000;
+        char when[32];
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M", localtime(&start));
+        char fc[16] = "-";
+        if (entry.first_crack_ms) snprintf(fc, sizeof(fc), "%u:%02u", entry.first_crack_ms / 60000, entry.first_crack_ms / 1000 % 60);
+        char rating[8] = "-";
+        if (entry.rating > 0) snprintf(rating, sizeof(rating), "%d", entry.rating);
+        printf("%-38s %-17s %-10s %8u %5u:%02u %7s %8.0f %8.0f %6s\n", entry.id, when,
+               entry.device[0] ? entry.device : "-", entry.sample_count,
+               entry.total_roast_ms / 60000, entry.total_roast_ms / 1000 % 60, fc,
+               entry.preheat_setpoint, entry.roast_setpoint, rating);
+    }
+    return 0;
+}
+
+static int _dump(const Archive& archive, const char* id, double from_s, double to_s, size_t points,
+                 DownsampleMode mode) {
+    long index = archive.find_id(id);
+    if (index < 0) {
+        fprintf(stderr, "No unique roast matches '%s'\n", id);
+        return 1;
+    }
+    RoastView roast = archive.roast(index);
+    auto range = roast.time_range((uint32_t)(from_s * 1000), to_s > 0 ? (uint32_t)(to_s * 1000) : UINT32_MAX);
+    size_t count = range.second - range.first;
+
+    std::vector<float> columns[ARCHIVE_COLUMNS];
+    for (size_t c = 0; c < ARCHIVE_COLUMNS; c++) {
+        columns[c].resize(count);
+        roast.decode((ArchiveColumn)c, range.first, count, columns[c].data());
+    }
+
+    std::vector<uint32_t> rows;
+    if (points > 0) {
+        RoastColumnsScratch scratch;
+        rows = roast_downsample(roast, scratch, range.first, range.second, points, mode);
+        for (uint32_t& row : rows) row -= (uint32_t)range.first;
+    } else {
+        rows.resize(count);
+        for (size_t i = 0; i < count; i++) rows[i] = (uint32_t)i;
+    }
+
+    for (size_t c = 0; c < ARCHIVE_COLUMNS; c++) printf("%s%s", c ? "," : "", _column_names[c]);
+    printf("\n");
+    for (uint32_t i : rows) {
+        printf("%.0f", columns[0][i]);
+        for (size_t c = 1; c < ARCHIVE_COLUMNS; c++) {
+            if (std::isnan(columns[c][i])) printf(",");
+            else printf(",%g", columns[c][i]);
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+static int _info(const Archive& archive) {
+    uint64_t samples = 0;
+    for (size_t i = 0; i < archive.size(); i++) samples += archive.entry(i).sample_count;
+
+    // Full decode of every column of every roast
+    std::vector<float> buffer;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < archive.size(); i++) {
+        RoastView roast = archive.roast(i);
+        buffer.resize(roast.size());
+        for (size_t c = 0; c < ARCHIVE_COLUMNS; c++) {
+            roast.decode((ArchiveColumn)c, 0, roast.size(), buffer.data());
+            if (!buffer.empty()) _sink = buffer.back();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("roasts:        %zu\n", archive.size());
+    printf("samples:       %llu\n", (unsigned long long)samples);
+    printf("data bytes:    %llu (%.2f bytes/sample, %zu columns)\n", (unsigned long long)archive.data_bytes(),
+           samples ? (double)archive.data_bytes() / samples : 0.0, ARCHIVE_COLUMNS);
+    printf("full decode:   %.3f s (%.0f M values/s)\n", seconds,
+           seconds > 0 ? samples * ARCHIVE_COLUMNS / seconds / 1e6 : 0.0);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string dir;
+    std::string command;
+    std::vector<std::string> args;
+    const char* from = nullptr;
+    const char* to = nullptr;
+    size_t points = 0;
+    DownsampleMode mode = DownsampleMode::LTTB;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--dir") == 0 && value) { dir = value; i++; }
+        else if (strcmp(argv[i], "--from") == 0 && value) { from = value; i++; }
+        else if (strcmp(argv[i], "--to") == 0 && value) { to = value; i++; }
+        else if (strcmp(argv[i], "--points") == 0 && value) { points = (size_t)atoi(value); i++; }
+        else if (strcmp(argv[i], "--minmax") == 0) mode = DownsampleMode::MIN_MAX;
+        else if (strcmp(argv[i], "--verbose") == 0) host_log_set_level(LogLevel::DEBUG);
+        else if (command.empty()) command = argv[i];
+        else args.push_back(argv[i]);
+    }
+    if (dir.empty() || command.empty()) {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    if (command == "import") {
+        if (args.empty()) {
+            _usage(argv[0]);
+            return 2;
+        }
+        return _import(dir, args);
+    }
+
+    Archive archive;
+    if (!archive.open(dir)) return 1;
+
+    if (command == "list") {
+        uint64_t from_ms = 0, to_ms = UINT64_MAX;
+        if ((from && !_parse_date(from, from_ms)) || (to && !_parse_date(to, to_ms))) {
+            fprintf(stderr, "Dates are YYYY-MM-DD\n");
+            return 2;
+        }
+        return _list(archive, from_ms, to_ms);
+    }
+    if (command == "dump" && args.size() == 1) {
+        return _dump(archive, args[0].c_str(), from ? atof(from) : 0.0, to ? atof(to) : 0.0, points, mode);
+    }
+    if (command == "info") return _info(archive);
+
+    _usage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,100 @@
+// roast-ingest: convert captured NDJSON serial logs into the roast archive
+// and/or CSV.
+//
+//   roast-ingest --archive archive capture-*.ndjson
+//   roast-ingest --csv samples.csv --threads 8 capture.ndjson
+//   roast-ingest --csv - --device roaster-2 capture.ndjson | head
+
+#include "archive.h"
+#include "archive_import.h"
+#include "log.h"
+#include "log_ingest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s (--archive DIR | --csv FILE|-) [options] CAPTURE...\n"
+            "  --archive DIR       Append the roasts found in the captures\n"
+            "  --csv FILE|-        Write every roasterState sample as CSV\n"
+            "  --device NAME       Device name for lines without a \"device\" key (default %s)\n"
+            "  --end-unix MS       Wall time of the last line (default: file mtime)\n"
+            "  --threads N         Worker threads (default: all cores)\n",
+            argv0, INGEST_DEFAULT_DEVICE);
+}
+
+int main(int argc, char** argv) {
+    std::string archive_dir;
+    const char* csv_path = nullptr;
+    IngestOptions options;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--archive") == 0 && value)       { archive_dir = value; i++; }
+        else if (strcmp(arg, "--csv") == 0 && value)      { csv_path = value; i++; }
+        else if (strcmp(arg, "--device") == 0 && value)   { options.device = value; i++; }
+        else if (strcmp(arg, "--end-unix") == 0 && value) { options.end_unix_ms = strtoull(value, nullptr, 10); i++; }
+        else if (strcmp(arg, "--threads") == 0 && value)  { options.threads = atoi(value); i++; }
+        else if (arg[0] == '-' && arg[1]) {
+            _usage(argv[0]);
+            return 2;
+        }
+        else paths.push_back(arg);
+    }
+    if ((archive_dir.empty() && !csv_path) || paths.empty()) {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    ArchiveWriter writer(archive_dir);
+    if (!archive_dir.empty() && !writer.open()) return 1;
+
+    FILE* csv = nullptr;
+    if (csv_path) {
+        csv = strcmp(csv_path, "-") == 0 ? stdout : fopen(csv_path, "w");
+        if (!csv) {
+            host_log(LogLevel::ERROR, "INGEST", "Cannot write %s: %s", csv_path, strerror(errno));
+            return 1;
+        }
+    }
+
+    IngestStats stats;
+    ImportStats imported;
+    IngestLog log;
+    bool ok = true;
+    for (size_t i = 0; i < paths.size() && ok; i++) {
+        if (!ingest_parse(paths[i], options, log, stats)) {
+            ok = false;
+            break;
+        }
+        if (csv && !ingest_csv(log, csv, i == 0, options.threads)) {
+            host_log(LogLevel::ERROR, "INGEST", "CSV write failed: %s", strerror(errno));
+            ok = false;
+        }
+        if (!archive_dir.empty()) ingest_archive(log, options, writer, imported);
+    }
+    if (!archive_dir.empty() && !writer.flush()) ok = false;
+    if (csv && csv != stdout) fclose(csv);
+    if (!ok) return 1;
+
+    double mb = stats.bytes / 1e6;
+    host_log(LogLevel::INFO, "INGEST", "%.1f MB, %llu lines in %.0f ms (%.0f MB/s): %llu samples "
+             "(%.1f%% fixed-layout), %llu resends, %llu events, %llu logs, %llu other, %llu malformed",
+             mb, (unsigned long long)stats.lines, stats.parse_ms, mb / (stats.parse_ms / 1000),
+             (unsigned long long)stats.states, stats.states ? 100.0 * stats.fast_path / stats.states : 0.0,
+             (unsigned long long)stats.replays, (unsigned long long)stats.events,
+             (unsigned long long)stats.logs, (unsigned long long)stats.other,
+             (unsigned long long)stats.malformed);
+    if (!archive_dir.empty()) {
+        host_log(LogLevel::INFO, "INGEST", "archived %zu roasts (%zu samples), %zu already archived, "
+                 "%zu skipped or unfinished", imported.roasts, imported.samples, imported.duplicates,
+                 imported.skipped);
+    }
+    return 0;
+}
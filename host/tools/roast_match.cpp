@@ -0,0 +1,94 @@
+// roast-match: find the archived roasts whose curves are closest to a
+// reference roast (DTW over chamber temperature and RoR from charge).
+//
+//   roast-match --dir archive --ref 1a2b3c4d
+//   roast-match --dir archive --ref 1a2b3c4d --k 20 --band 90 --ror-weight 1
+
+#include "archive.h"
+#include "log.h"
+#include "similarity.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --dir DIR --ref ID [options]\n"
+            "  --ref ID            Reference roast (id or unique prefix)\n"
+            "  --k N               Matches to return (default 10)\n"
+            "  --band S            Warping window in seconds (default %d)\n"
+            "  --ror-weight W      RoR error weight relative to temperature (default %.1f)\n"
+            "  --threads N         Worker threads (default: all cores)\n",
+            argv0, SIMILARITY_BAND_MS / 1000, SIMILARITY_ROR_WEIGHT);
+}
+
+int main(int argc, char** argv) {
+    std::string dir;
+    const char* ref = nullptr;
+    SimilarityOptions options;
+    int band_s = SIMILARITY_BAND_MS / 1000;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--dir") == 0 && value)             { dir = value; i++; }
+        else if (strcmp(arg, "--ref") == 0 && value)        { ref = value; i++; }
+        else if (strcmp(arg, "--k") == 0 && value)          { options.k = atoi(value); i++; }
+        else if (strcmp(arg, "--band") == 0 && value)       { band_s = atoi(value); i++; }
+        else if (strcmp(arg, "--ror-weight") == 0 && value) { options.ror_weight = atof(value); i++; }
+        else if (strcmp(arg, "--threads") == 0 && value)    { options.threads = atoi(value); i++; }
+        else {
+            _usage(argv[0]);
+            return 2;
+        }
+    }
+    if (dir.empty() || !ref) {
+        _usage(argv[0]);
+        return 2;
+    }
+    options.band = std::max(1, band_s * 1000 / SIMILARITY_STEP_MS);
+
+    Archive archive;
+    if (!archive.open(dir)) return 1;
+    long ref_index = archive.find_id(ref);
+    if (ref_index < 0) {
+        fprintf(stderr, "No unique roast matches '%s'\n", ref);
+        return 1;
+    }
+
+    RoastColumnsScratch scratch;
+    CurveFeatures reference;
+    if (!curve_extract(archive.roast(ref_index), scratch, reference)) {
+        fprintf(stderr, "Reference roast has no detectable charge\n");
+        return 1;
+    }
+
+    std::vector<size_t> roasts(archive.size());
+    for (size_t i = 0; i < roasts.size(); i++) roasts[i] = i;
+
+    SimilarityStats stats;
+    SimilarityIndex index;
+    index.build(archive, roasts, options.threads, &stats);
+    std::vector<SimilarityMatch> matches = index.query(reference, options, ref_index, &stats);
+
+    printf("%4s  %-38s %-17s %-10s %9s %7s %6s\n", "rank", "id", "started", "device", "distance", "roast", "rating");
+    for (size_t i = 0; i < matches.size(); i++) {
+        const ArchiveEntry& entry = archive.entry(matches[i].roast);
+        time_t start = entry.start_unix_ms / 1000;
+        char when[32];
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M", localtime(&start));
+        char rating[8] = "-";
+        if (entry.rating > 0) snprintf(rating, sizeof(rating), "%d", entry.rating);
+        printf("%4zu  %-38s %-17s %-10s %7.2f°C %4u:%02u %6s\n", i + 1, entry.id, when,
+               entry.device[0] ? entry.device : "-", matches[i].distance,
+               entry.total_roast_ms / 60000, entry.total_roast_ms / 1000 % 60, rating);
+    }
+
+    host_log(LogLevel::INFO, "MATCH", "%zu candidates: %zu pruned by LB_Keogh, %zu abandoned, %zu full DTW; "
+             "extract %.1f ms, search %.1f ms", stats.candidates, stats.pruned, stats.abandoned, stats.dtw,
+             stats.extract_ms, stats.search_ms);
+    return 0;
+}
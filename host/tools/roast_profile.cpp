@@ -0,0 +1,227 @@
+// roast-profile: upload an archived roast to a roaster as its reference
+// curve. The next charge replays the roast's chamber temperature as the
+// setpoint and reapplies its fan changes at the same offsets.
+//
+//   roast-profile --dir archive --ref 1a2b3c4d --connect 127.0.0.1:8766
+//   roast-profile --dir archive --ref 1a2b3c4d --connect 127.0.0.1:8767 --device roaster-1
+//   roast-profile --dir archive --ref 1a2b3c4d --print       (commands to stdout)
+//   roast-profile --connect 127.0.0.1:8766 --clear
+
+#include "analytics.h"
+#include "archive.h"
+#include "event_loop.h"
+#include "log.h"
+#include "ndjson.h"
+#include "stream_client.h"
+
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Must match the firmware's config.h / serial_comm.cpp limits
+#define PROFILE_MAX_POINTS      360
+#define PROFILE_MAX_FAN_EVENTS  32
+#define PROFILE_CHUNK_POINTS    64      // Keeps each profileData line well under 512 bytes
+#define PROFILE_BASE_STEP_MS    5000
+#define PROFILE_FAN_SETTLE_MS   10000   // Fan moves closer together than this are merged
+#define PROFILE_REPLY_TIMEOUT_MS 5000
+
+struct FanEvent {
+    uint32_t at_ms;
+    uint8_t speed;
+};
+
+static std::string _device;
+
+static std::string _command(const std::string& type, const std::string& payload) {
+    std::string line = "{\"type\":\"" + type + "\",";
+    if (!_device.empty()) line += "\"device\":\"" + json_escape(_device) + "\",";
+    return line + "\"payload\":{" + payload + "}}";
+}
+
+// Charge-to-drop chamber curve at a fixed step, in 0.1 °C; the step grows
+// in whole multiples of the base step until the curve fits the device
+static bool _build(const RoastView& roast, uint32_t& step_ms, std::vector<int16_t>& points,
+                   std::vector<FanEvent>& fans) {
+    RoastColumnsScratch scratch;
+    RoastMetrics metrics = analyze_roast(roast, scratch);
+    if (metrics.charge_ms < 0 || metrics.drop_ms <= metrics.charge_ms) return false;
+
+    uint32_t span = metrics.drop_ms - metrics.charge_ms;
+    step_ms = PROFILE_BASE_STEP_MS;
+    while (span / step_ms + 1 > PROFILE_MAX_POINTS) step_ms += PROFILE_BASE_STEP_MS;
+
+    // analyze_roast leaves the gap-filled chamber curve in scratch
+    const float* time = scratch.time.data();
+    const float* temp = scratch.chamber.data();
+    size_t n = roast.size();
+    points.clear();
+    size_t i = 0;
+    for (uint32_t offset = 0; offset <= span; offset += step_ms) {
+        float t = metrics.charge_ms + (float)offset;
+        while (i + 1 < n && time[i + 1] <= t) i++;
+        float value = temp[i];
+        if (i + 1 < n && time[i + 1] > time[i]) {
+            value += (temp[i + 1] - temp[i]) * (t - time[i]) / (time[i + 1] - time[i]);
+        }
+        points.push_back((int16_t)lroundf(value * 10));
+    }
+
+    // Fan setting in force at charge, then every change up to the drop
+    std::vector<float> fan = roast.column(ArchiveColumn::FAN);
+    fans.clear();
+    int last = -1;
+    for (size_t s = 0; s < n; s++) {
+        if (time[s] > metrics.drop_ms) break;
+        if (std::isnan(fan[s])) continue;
+        int speed = (int)lroundf(fan[s]);
+        if (speed == last) continue;
+        last = speed;
+        uint32_t at = time[s] > metrics.charge_ms ? (uint32_t)(time[s] - metrics.charge_ms) : 0;
+        if (!fans.empty() && at - fans.back().at_ms < PROFILE_FAN_SETTLE_MS) {
+            fans.back().speed = (uint8_t)speed;
+        } else {
+            fans.push_back({ at, (uint8_t)speed });
+        }
+    }
+    if (fans.size() > PROFILE_MAX_FAN_EVENTS) {
+        host_log(LogLevel::WARN, "PROFILE", "%zu fan changes, keeping the first %d", fans.size(),
+                 PROFILE_MAX_FAN_EVENTS);
+        fans.resize(PROFILE_MAX_FAN_EVENTS);
+    }
+    return points.size() >= 2;
+}
+
+static std::vector<std::string> _upload_commands(uint32_t step_ms, const std::vector<int16_t>& points,
+                                                 const std::vector<FanEvent>& fans) {
+    std::vector<std::string> lines;
+    lines.push_back(_command("profileBegin", "\"points\":" + std::to_string(points.size()) +
+                                             ",\"stepMs\":" + std::to_string(step_ms)));
+    for (size_t offset = 0; offset < points.size(); offset += PROFILE_CHUNK_POINTS) {
+        std::string payload = "\"offset\":" + std::to_string(offset) + ",\"temps\":[";
+        for (size_t i = offset; i < std::min(points.size(), offset + PROFILE_CHUNK_POINTS); i++) {
+            if (i > offset) payload += ",";
+            payload += std::to_string(points[i]);
+        }
+        lines.push_back(_command("profileData", payload + "]"));
+    }
+    if (!fans.empty()) {
+        std::string payload = "\"events\":[";
+        for (size_t i = 0; i < fans.size(); i++) {
+            if (i > 0) payload += ",";
+            payload += std::to_string(fans[i].at_ms / 1000) + "," + std::to_string(fans[i].speed);
+        }
+        lines.push_back(_command("profileFan", payload + "]"));
+    }
+    lines.push_back(_command("profileEnd", ""));
+    return lines;
+}
+
+int main(int argc, char** argv) {
+    std::string dir;
+    const char* ref = nullptr;
+    std::string host = "127.0.0.1";
+    uint16_t port = 0;
+    bool print = false;
+    bool clear = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--dir") == 0 && value)         { dir = value; i++; }
+        else if (strcmp(argv[i], "--ref") == 0 && value)    { ref = value; i++; }
+        else if (strcmp(argv[i], "--device") == 0 && value) { _device = value; i++; }
+        else if (strcmp(argv[i], "--connect") == 0 && value) {
+            std::string target = value;
+            size_t colon = target.rfind(':');
+            host = colon == std::string::npos ? "127.0.0.1" : target.substr(0, colon);
+            port = (uint16_t)atoi(target.c_str() + (colon == std::string::npos ? 0 : colon + 1));
+            i++;
+        }
+        else if (strcmp(argv[i], "--print") == 0) print = true;
+        else if (strcmp(argv[i], "--clear") == 0) clear = true;
+        else {
+            port = 0;
+            print = false;
+            break;
+        }
+    }
+    bool have_roast = !dir.empty() && ref;
+    if ((!clear && !have_roast) || (!print && !port)) {
+        fprintf(stderr, "Usage: %s --dir DIR --ref ID (--connect HOST:PORT [--device ID] | --print)\n"
+                        "       %s --connect HOST:PORT [--device ID] --clear\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    std::vector<std::string> lines;
+    if (clear) {
+        lines.push_back(_command("clearProfile", ""));
+    } else {
+        Archive archive;
+        if (!archive.open(dir)) return 1;
+        long index = archive.find_id(ref);
+        if (index < 0) {
+            fprintf(stderr, "No unique roast matches '%s'\n", ref);
+            return 1;
+        }
+
+        uint32_t step_ms;
+        std::vector<int16_t> points;
+        std::vector<FanEvent> fans;
+        if (!_build(archive.roast(index), step_ms, points, fans)) {
+            fprintf(stderr, "Roast has no detectable charge and drop\n");
+            return 1;
+        }
+        host_log(LogLevel::INFO, "PROFILE", "%s: %zu points at %u s, %zu fan changes",
+                 archive.entry(index).id, points.size(), step_ms / 1000, fans.size());
+        lines = _upload_commands(step_ms, points, fans);
+    }
+
+    if (print) {
+        for (const std::string& line : lines) printf("%s\n", line.c_str());
+        return 0;
+    }
+
+    EventLoop loop;
+    signal(SIGPIPE, SIG_IGN);
+    int result = 1;
+
+    StreamClient stream(loop, host, port);
+    stream.on_state([&](bool connected) {
+        if (!connected) return;
+        for (const std::string& line : lines) stream.send(line);
+    });
+    stream.on_line([&](std::string_view line) {
+        std::string_view type, device;
+        if (!json_get_string(line, "type", type)) return;
+        if (!_device.empty() && json_get_string(line, "device", device) && device != _device) return;
+
+        if (type == "error") {
+            std::string_view message;
+            json_get_string(line, "message", message);
+            host_log(LogLevel::ERROR, "PROFILE", "Rejected: %.*s", (int)message.size(), message.data());
+            loop.stop();
+        } else if (type == "profileStatus") {
+            // The device replies to a rejected step and to profileEnd / clearProfile
+            std::string_view error;
+            if (json_get_string(line, "error", error)) {
+                host_log(LogLevel::ERROR, "PROFILE", "Device: %.*s", (int)error.size(), error.data());
+            } else {
+                host_log(LogLevel::INFO, "PROFILE", clear ? "Profile cleared" : "Profile armed for the next charge");
+                result = 0;
+            }
+            loop.stop();
+        }
+    });
+    stream.start();
+
+    loop.add_timer(PROFILE_REPLY_TIMEOUT_MS, 0, [&]() {
+        host_log(LogLevel::ERROR, "PROFILE", "No reply from the roaster");
+        loop.stop();
+    });
+    loop.run();
+    return result;
+}
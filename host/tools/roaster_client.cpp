@@ -0,0 +1,248 @@
+// roaster-client: scripting and round-trip benchmarking against a roaster,
+// directly on its tty or through the bridge / fleet service.
+//
+//   roaster-client /dev/ttyACM0 call setFanSpeed '"value":60'
+//   roaster-client 127.0.0.1:8765 watch
+//   roaster-client 127.0.0.1:8766 --device roaster-1 bench --command getState --count 1000
+//   roaster-client /tmp/mcroaster-emu/roaster-1 script < session.txt
+//
+// A script is one command per line - "TYPE [PAYLOAD]", where PAYLOAD is the
+// body of the payload object - run one at a time. "sleep MS" pauses and
+// lines starting with '#' are skipped.
+
+#include "event_loop.h"
+#include "log.h"
+#include "roaster_client.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define CLIENT_CONNECT_TIMEOUT_MS   10000
+
+static EventLoop* _loop = nullptr;
+
+static void _on_signal(int) {
+    if (_loop) _loop->stop();
+}
+
+static void _usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s TARGET [options] MODE [args]\n"
+            "  TARGET                  tty path, or HOST:PORT of mcroaster-bridge / mcroaster-fleet\n"
+            "  --device ID             Fleet device to address\n"
+            "  --timeout MS            Reply timeout per command (default %d)\n"
+            "Modes:\n"
+            "  call TYPE [PAYLOAD]     Send one command and print the message that completed it\n"
+            "  watch                   Print state, events and logs as they arrive\n"
+            "  script                  Run \"TYPE [PAYLOAD]\" / \"sleep MS\" lines from stdin\n"
+            "  bench [--command TYPE] [--count N] [--concurrency N]\n"
+            "                          Round-trip latency of one command\n",
+            argv0, CLIENT_REPLY_TIMEOUT_MS);
+}
+
+static void _print_latency(const RoasterClient& client) {
+    printf("%-16s %7s %9s %9s %9s %9s %9s\n", "command", "count", "mean_us", "p50_us", "p90_us", "p99_us", "max_us");
+    for (size_t i = 0; i < (size_t)RoasterCommand::COUNT; i++) {
+        const LatencyHistogram& h = client.latency((RoasterCommand)i);
+        if (h.count() == 0) continue;
+        printf("%-16s %7llu %9.0f %9llu %9llu %9llu %9llu\n", roaster_command_name((RoasterCommand)i),
+               (unsigned long long)h.count(), h.mean(), (unsigned long long)h.percentile(0.5),
+               (unsigned long long)h.percentile(0.9), (unsigned long long)h.percentile(0.99),
+               (unsigned long long)h.max());
+    }
+    const RoasterClient::Stats& s = client.stats();
+    printf("sent %llu, ok %llu, errors %llu, timeouts %llu, disconnected %llu, seq gaps %llu\n",
+           (unsigned long long)s.sent, (unsigned long long)s.completed, (unsigned long long)s.errors,
+           (unsigned long long)s.timeouts, (unsigned long long)s.disconnected, (unsigned long long)s.seq_gaps);
+}
+
+static void _print_state(const RoasterStateFrame& s) {
+    printf("state seq=%u%s %-8s chamber=%.1f heater=%.1f setpoint=%.1f fan=%u power=%u ror=%.1f roast=%us%s%s\n",
+           s.seq, s.replay ? " (replay)" : "", s.state.c_str(), s.chamber_temp, s.heater_temp, s.setpoint,
+           s.fan_speed, s.heater_power, s.ror, s.roast_time_ms / 1000, s.first_crack_marked ? " FC" : "",
+           s.has_error ? (" error=" + s.error_code).c_str() : "");
+}
+
+// ============== Script ==============
+
+struct Script {
+    std::vector<std::string> lines;
+    size_t next = 0;
+    int failures = 0;
+};
+
+static void _run_next(RoasterClient& client, Script& script) {
+    while (script.next < script.lines.size()) {
+        std::string line = script.lines[script.next++];
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') continue;
+        line = line.substr(start);
+
+        size_t space = line.find(' ');
+        std::string type = line.substr(0, space);
+        std::string payload = space == std::string::npos ? "" : line.substr(space + 1);
+
+        if (type == "sleep") {
+            _loop->add_timer((uint32_t)atoi(payload.c_str()), 0, [&client, &script]() { _run_next(client, script); });
+            return;
+        }
+
+        RoasterCommand command;
+        if (!roaster_command_from_name(type, command)) {
+            host_log(LogLevel::ERROR, "CLIENT", "Unknown command: %s", type.c_str());
+            script.failures++;
+            continue;
+        }
+        client.send(command, payload, [&client, &script](const CommandReply& reply) {
+            printf("%s %s %.1f ms%s%s\n", roaster_command_name(reply.command), command_result_name(reply.result),
+                   reply.latency_us / 1000.0, reply.message.empty() ? "" : ": ", reply.message.c_str());
+            if (reply.result != CommandResult::OK) script.failures++;
+            _run_next(client, script);
+        });
+        return;
+    }
+    _loop->stop();
+}
+
+// ============== Bench ==============
+
+struct Bench {
+    RoasterCommand command = RoasterCommand::GET_STATE;
+    uint64_t count = 100;
+    unsigned concurrency = 1;
+    uint64_t issued = 0;
+    uint64_t finished = 0;
+};
+
+static void _bench_issue(RoasterClient& client, Bench& bench) {
+    if (bench.issued >= bench.count) return;
+    bench.issued++;
+    client.send(bench.command, {}, [&client, &bench](const CommandReply&) {
+        if (++bench.finished >= bench.count) _loop->stop();
+        else _bench_issue(client, bench);
+    });
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    ClientOptions options;
+    options.target = argv[1];
+    std::string mode;
+    std::vector<std::string> args;
+    Bench bench;
+
+    for (int i = 2; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!mode.empty() && mode != "bench") args.push_back(argv[i]);
+        else if (strcmp(argv[i], "--device") == 0 && value)      { options.device = value; i++; }
+        else if (strcmp(argv[i], "--timeout") == 0 && value)     { options.timeout_ms = atoi(value); i++; }
+        else if (strcmp(argv[i], "--count") == 0 && value)       { bench.count = strtoull(value, nullptr, 10); i++; }
+        else if (strcmp(argv[i], "--concurrency") == 0 && value) { bench.concurrency = atoi(value); i++; }
+        else if (strcmp(argv[i], "--command") == 0 && value) {
+            if (!roaster_command_from_name(value, bench.command)) {
+                fprintf(stderr, "Unknown command: %s\n", value);
+                return 2;
+            }
+            i++;
+        }
+        else if (mode.empty() && argv[i][0] != '-') mode = argv[i];
+        else {
+            _usage(argv[0]);
+            return 2;
+        }
+    }
+    if (mode != "call" && mode != "watch" && mode != "script" && mode != "bench") {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    RoasterCommand command = RoasterCommand::GET_STATE;
+    if (mode == "call" && (args.empty() || !roaster_command_from_name(args[0], command))) {
+        fprintf(stderr, "call needs a command type\n");
+        return 2;
+    }
+
+    Script script;
+    if (mode == "script") {
+        std::string line;
+        while (std::getline(std::cin, line)) script.lines.push_back(line);
+    }
+
+    EventLoop loop;
+    _loop = &loop;
+    signal(SIGINT, _on_signal);
+    signal(SIGTERM, _on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    RoasterClient client(loop, options);
+    int result = 0;
+    bool started = false;
+    uint64_t connect_timer = loop.add_timer(CLIENT_CONNECT_TIMEOUT_MS, 0, [&]() {
+        host_log(LogLevel::ERROR, "CLIENT", "Could not reach %s", options.target.c_str());
+        result = 1;
+        loop.stop();
+    });
+
+    if (mode == "watch") {
+        setvbuf(stdout, nullptr, _IOLBF, 0);
+        client.on_state(_print_state);
+        client.on_event([](const RoastEventFrame& e) {
+            printf("event %s roast=%us chamber=%.1f%s%s\n", e.event.c_str(), e.roast_time_ms / 1000,
+                   e.chamber_temp, e.data.empty() ? "" : " ", e.data.c_str());
+        });
+        client.on_log([](const LogFrame& l) {
+            printf("log %s [%s] %s\n", l.level.c_str(), l.source.c_str(), l.message.c_str());
+        });
+        client.on_message([](std::string_view, std::string_view line) {
+            printf("%.*s\n", (int)line.size(), line.data());
+        });
+    }
+
+    client.on_connection([&](bool connected) {
+        host_log(connected ? LogLevel::INFO : LogLevel::WARN, "CLIENT", "%s %s", options.target.c_str(),
+                 connected ? "connected" : "disconnected");
+        if (!connected || started) return;
+        started = true;
+        loop.cancel_timer(connect_timer);
+
+        if (mode == "call") {
+            client.send(command, args.size() > 1 ? args[1] : "", [&](const CommandReply& reply) {
+                if (reply.result == CommandResult::OK) {
+                    printf("%.*s\n", (int)reply.line.size(), reply.line.data());
+                } else {
+                    host_log(LogLevel::ERROR, "CLIENT", "%s: %s%s%s", roaster_command_name(reply.command),
+                             command_result_name(reply.result), reply.message.empty() ? "" : " - ",
+                             reply.message.c_str());
+                    result = 1;
+                }
+                loop.stop();
+            });
+        } else if (mode == "script") {
+            _run_next(client, script);
+        } else if (mode == "bench") {
+            for (unsigned i = 0; i < std::max(1u, bench.concurrency); i++) _bench_issue(client, bench);
+            if (bench.count == 0) loop.stop();
+        }
+    });
+
+    if (!client.start()) {
+        fprintf(stderr, "Bad target: %s\n", options.target.c_str());
+        return 2;
+    }
+    loop.run();
+
+    if (mode == "bench" || mode == "script") _print_latency(client);
+    if (mode == "script" && script.failures) result = 1;
+    if (mode == "bench" && client.stats().completed < bench.count) result = 1;
+    return result;
+}
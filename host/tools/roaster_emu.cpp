@@ -0,0 +1,71 @@
+// roaster-emu: emulated roasters on ptys for exercising host tools.
+//
+//   roaster-emu [--count 4] [--dir /tmp/mcroaster-emu] [--silent 1]
+//
+// Creates DIR/roaster-1 .. DIR/roaster-N symlinks to pty slaves, plus
+// DIR/other-K ptys that never answer (to check handshake detection).
+// Point the bridge or fleet manager at them:
+//
+//   mcroaster-fleet --device '/tmp/mcroaster-emu/*'
+
+#include "emulator.h"
+#include "event_loop.h"
+#include "log.h"
+
+#include <sys/stat.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+static EventLoop* _loop = nullptr;
+
+static void _on_signal(int) {
+    if (_loop) _loop->stop();
+}
+
+int main(int argc, char** argv) {
+    int count = 4;
+    int silent = 0;
+    std::string dir = "/tmp/mcroaster-emu";
+    EmulatorOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--count") == 0 && value)         { count = atoi(value); i++; }
+        else if (strcmp(argv[i], "--silent") == 0 && value)   { silent = atoi(value); i++; }
+        else if (strcmp(argv[i], "--dir") == 0 && value)      { dir = value; i++; }
+        else if (strcmp(argv[i], "--interval") == 0 && value) { options.state_interval_ms = atoi(value); i++; }
+        else {
+            fprintf(stderr, "Usage: %s [--count N] [--silent N] [--dir DIR] [--interval MS]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    mkdir(dir.c_str(), 0755);
+
+    EventLoop loop;
+    _loop = &loop;
+    signal(SIGINT, _on_signal);
+    signal(SIGTERM, _on_signal);
+
+    std::vector<std::unique_ptr<RoasterEmulator>> emulators;
+    for (int i = 0; i < count + silent; i++) {
+        EmulatorOptions opts = options;
+        opts.silent = i >= count;
+        std::string link = dir + (opts.silent ? "/other-" + std::to_string(i - count + 1)
+                                              : "/roaster-" + std::to_string(i + 1));
+
+        auto emulator = std::make_unique<RoasterEmulator>(loop, opts);
+        if (!emulator->start(link)) return 1;
+        host_log(LogLevel::INFO, "EMU", "%s -> %s%s", link.c_str(), emulator->slave_path().c_str(),
+                 opts.silent ? " (silent)" : "");
+        emulators.push_back(std::move(emulator));
+    }
+
+    loop.run();
+    return 0;
+}
@@ -26,6 +26,9 @@ export default function Home() {
   const [throttledTempHistory, setThrottledTempHistory] = useState<any[]>([]);
   const lastGraphUpdateRef = useRef<number>(0);
 
+  // Number of backfilled frames already merged into the recording
+  const backfillCursorRef = useRef<number>(0);
+
   const {
     // Connection state
     isConnected,
@@ -53,10 +56,14 @@ export default function Home() {
     firstCrackMarked,
     firstCrackTimeMs,
     ror,
+    resumeAvailable,
+    preheatReady,
+    preheatEtaMs,
     roasterError,
 
     // Temperature history
     tempHistory,
+    backfill,
 
     // Logs
     logs,
@@ -68,6 +75,7 @@ export default function Home() {
     endRoast,
     markFirstCrack,
     stop,
+    resumeRoast,
     enterFanOnly,
     exitFanOnly,
     enterManual,
@@ -149,6 +157,30 @@ export default function Home() {
     addDataPoint,
   ]);
 
+  // Merge frames recovered after a telemetry gap into the recording
+  useEffect(() => {
+    if (backfill.length < backfillCursorRef.current) {
+      backfillCursorRef.current = 0;
+    }
+    if (isRecording) {
+      for (const p of backfill.slice(backfillCursorRef.current)) {
+        if (p.state === 'OFF' || p.state === 'ERROR') continue;
+        addDataPoint(
+          {
+            chamberTemp: p.chamberTemp,
+            heaterTemp: p.heaterTemp,
+            setpoint: p.setpoint,
+            ror: p.ror,
+            fanSpeed: p.fanSpeed,
+            heaterPower: p.heaterPower,
+          },
+          p.roastTimeMs
+        );
+      }
+    }
+    backfillCursorRef.current = backfill.length;
+  }, [backfill, isRecording, addDataPoint]);
+
   // Update setpoint in history
   useEffect(() => {
     if (isRecording) {
@@ -248,6 +280,8 @@ export default function Home() {
             <RoasterStatePanel
               state={roasterState}
               connected={isConnected}
+              preheatReady={preheatReady}
+              preheatEtaMs={preheatEtaMs}
             />
             <RoastTimer
               roastTimeMs={roastTimeMs}
@@ -314,7 +348,9 @@ export default function Home() {
             onEnterManual={enterManual}
             onExitManual={exitManual}
             onClearFault={clearFault}
+            onResumeRoast={resumeRoast}
             firstCrackMarked={firstCrackMarked}
+            resumeAvailable={resumeAvailable}
           />
 
           {/* Manual Mode Panel (only visible in MANUAL state) */}
@@ -17,7 +17,9 @@ interface ActionPanelProps {
   onEnterManual: () => void;
   onExitManual: () => void;
   onClearFault: () => void;
+  onResumeRoast: () => void;
   firstCrackMarked: boolean;
+  resumeAvailable: boolean;
 }
 
 export function ActionPanel({
@@ -33,7 +35,9 @@ export function ActionPanel({
   onEnterManual,
   onExitManual,
   onClearFault,
+  onResumeRoast,
   firstCrackMarked,
+  resumeAvailable,
 }: ActionPanelProps) {
   const [showStopConfirm, setShowStopConfirm] = useState(false);
 
@@ -206,6 +210,14 @@ export function ActionPanel({
                 Waiting for temperature to drop below {ROASTER_CONSTANTS.COOLING_TARGET_TEMP}°C
               </p>
             </div>
+            {resumeAvailable && (
+              <button
+                onClick={onResumeRoast}
+                className="px-6 py-3 bg-green-600 hover:bg-green-500 text-white rounded-lg font-bold text-lg transition-colors"
+              >
+                ▶️ Resume Roast
+              </button>
+            )}
             <button
               onClick={handleStop}
               className="px-6 py-3 bg-red-600 hover:bg-red-500 text-white rounded-lg font-medium transition-colors"
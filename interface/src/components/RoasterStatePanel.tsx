@@ -5,6 +5,8 @@ import type { RoasterState } from '@/types/roaster';
 interface RoasterStatePanelProps {
   state: RoasterState;
   connected: boolean;
+  preheatReady?: boolean;
+  preheatEtaMs?: number | null;
 }
 
 const STATE_COLORS: Record<RoasterState, string> = {
@@ -30,9 +32,18 @@ const STATE_LABELS: Record<RoasterState, string> = {
 // States that show pulsing animation
 const ACTIVE_STATES: RoasterState[] = ['FAN_ONLY', 'PREHEAT', 'ROASTING', 'COOLING'];
 
-export function RoasterStatePanel({ state, connected }: RoasterStatePanelProps) {
+// Preheat progress line: ready, or the firmware's predicted time to ready
+function preheatHint(ready: boolean, etaMs: number | null): string | null {
+  if (ready) return 'Ready to charge';
+  if (etaMs === null) return null;
+  const seconds = Math.ceil(etaMs / 1000);
+  return `Ready in ~${Math.floor(seconds / 60)}:${String(seconds % 60).padStart(2, '0')}`;
+}
+
+export function RoasterStatePanel({ state, connected, preheatReady = false, preheatEtaMs = null }: RoasterStatePanelProps) {
   const isActive = ACTIVE_STATES.includes(state);
   const bgColor = connected ? STATE_COLORS[state] : 'bg-zinc-800';
+  const hint = connected && state === 'PREHEAT' ? preheatHint(preheatReady, preheatEtaMs) : null;
   
   return (
     <div 
@@ -68,6 +79,13 @@ export function RoasterStatePanel({ state, connected }: RoasterStatePanelProps)
         </h2>
       </div>
       
+      {/* Preheat ETA / ready */}
+      {hint && (
+        <p className="text-white/80 text-sm text-center mt-2">
+          {hint}
+        </p>
+      )}
+
       {/* Connection status hint */}
       {!connected && (
         <p className="text-zinc-500 text-sm text-center mt-2">
@@ -268,10 +268,22 @@ export function useRoastHistory(): UseRoastHistoryReturn {
       ...data,
     };
 
+    // Backfilled points can arrive out of order - keep the series sorted by time
+    const points = currentSessionRef.current.temperatureData;
+    const last = points[points.length - 1];
+    let temperatureData: RoastDataPoint[];
+    if (!last || roastTimeMs >= last.time) {
+      temperatureData = [...points, dataPoint];
+    } else {
+      if (points.some(point => point.time === roastTimeMs)) return;
+      const insertAt = points.findIndex(point => point.time > roastTimeMs);
+      temperatureData = [...points.slice(0, insertAt), dataPoint, ...points.slice(insertAt)];
+    }
+
     const session = {
       ...currentSessionRef.current,
-      temperatureData: [...currentSessionRef.current.temperatureData, dataPoint],
-      totalRoastTime: roastTimeMs,
+      temperatureData,
+      totalRoastTime: Math.max(roastTimeMs, currentSessionRef.current.totalRoastTime),
     };
 
     setCurrentSession(session);
@@ -2,7 +2,7 @@
 
 import { useState, useCallback, useRef, useEffect } from 'react';
 import type { RoasterState, RoasterError, RoasterStatePayload, TemperatureDataPoint } from '@/types/roaster';
-import type { OutboundMessage, LogPayload } from '@/types/websocket';
+import type { OutboundMessage, LogPayload, SelfTestPayload } from '@/types/websocket';
 
 // Maximum temperature history entries (30 min at ~1 sample/sec)
 const MAX_TEMP_HISTORY = 1800;
@@ -10,6 +10,9 @@ const MAX_TEMP_HISTORY = 1800;
 // Maximum log entries to keep in memory
 const MAX_LOG_HISTORY = 500;
 
+// Largest resend range worth requesting (matches TELEMETRY_RING_SIZE in config.h)
+const MAX_RESEND_SPAN = 120;
+
 // Default serial options
 const DEFAULT_SERIAL_OPTIONS: SerialOptions = {
   baudRate: 115200,
@@ -53,12 +56,19 @@ export interface UseWebSerialReturn {
   firstCrackMarked: boolean;
   firstCrackTimeMs: number | null;
   ror: number;
+  resumeAvailable: boolean;
+  preheatReady: boolean;
+  preheatEtaMs: number | null;
   roasterError: RoasterError | null;
   firmware: string | null;
+  selfTest: SelfTestPayload | null;
 
   // Temperature history for graph
   tempHistory: TemperatureDataPoint[];
 
+  // Frames recovered via resend after a sequence gap (oldest first, cleared on OFF)
+  backfill: RoasterStatePayload[];
+
   // System logs
   logs: Array<LogPayload & { timestamp: number }>;
   clearLogs: () => void;
@@ -69,6 +79,7 @@ export interface UseWebSerialReturn {
   endRoast: () => void;
   markFirstCrack: () => void;
   stop: () => void;
+  resumeRoast: () => void;
   enterFanOnly: (fanSpeed?: number) => void;
   exitFanOnly: () => void;
   enterManual: () => void;
@@ -94,6 +105,7 @@ export function useWebSerial(): UseWebSerialReturn {
   const [portInfo, setPortInfo] = useState<SerialPortInfo | null>(null);
   const [error, setError] = useState<string | null>(null);
   const [firmware, setFirmware] = useState<string | null>(null);
+  const [selfTest, setSelfTest] = useState<SelfTestPayload | null>(null);
 
   // Roaster state
   const [roasterState, setRoasterState] = useState<RoasterState>('OFF');
@@ -108,6 +120,9 @@ export function useWebSerial(): UseWebSerialReturn {
   const [firstCrackMarked, setFirstCrackMarked] = useState(false);
   const [firstCrackTimeMs, setFirstCrackTimeMs] = useState<number | null>(null);
   const [ror, setRor] = useState(0);
+  const [resumeAvailable, setResumeAvailable] = useState(false);
+  const [preheatReady, setPreheatReady] = useState(false);
+  const [preheatEtaMs, setPreheatEtaMs] = useState<number | null>(null);
   const [roasterError, setRoasterError] = useState<RoasterError | null>(null);
 
   // Temperature history
@@ -115,6 +130,11 @@ export function useWebSerial(): UseWebSerialReturn {
   const tempHistoryRef = useRef<TemperatureDataPoint[]>([]);
   const prevStateRef = useRef<RoasterState>('OFF');
 
+  // Telemetry sequence tracking for gap detection
+  const lastSeqRef = useRef<number | null>(null);
+  const [backfill, setBackfill] = useState<RoasterStatePayload[]>([]);
+  const backfillRef = useRef<RoasterStatePayload[]>([]);
+
   // Log history
   const [logs, setLogs] = useState<Array<LogPayload & { timestamp: number }>>([]);
 
@@ -163,9 +183,45 @@ export function useWebSerial(): UseWebSerialReturn {
       const message = JSON.parse(line) as OutboundMessage;
       console.log('[Serial] Received:', message);
 
-      if (message.type === 'roasterState') {
+      if (message.type === 'roasterState' && message.replay) {
+        // Retransmitted frame - merge into history without touching live state
+        const p = message.payload as RoasterStatePayload;
+
+        if (p.state !== 'OFF' && p.state !== 'ERROR' && p.chamberTemp !== null) {
+          const history = tempHistoryRef.current;
+          if (!history.some(point => point.timeMs === p.roastTimeMs)) {
+            const dataPoint: TemperatureDataPoint = {
+              timeMs: p.roastTimeMs,
+              chamberTemp: p.chamberTemp,
+              setpoint: p.setpoint,
+              ror: p.ror,
+            };
+            const insertAt = history.findIndex(point => point.timeMs > p.roastTimeMs);
+            if (insertAt < 0) {
+              history.push(dataPoint);
+            } else {
+              history.splice(insertAt, 0, dataPoint);
+            }
+            setTempHistory([...history]);
+          }
+        }
+
+        backfillRef.current.push(p);
+        setBackfill([...backfillRef.current]);
+      } else if (message.type === 'roasterState') {
         const p = message.payload as RoasterStatePayload;
 
+        // Detect dropped frames and ask the device to resend them
+        if (typeof message.seq === 'number') {
+          const lastSeq = lastSeqRef.current;
+          if (lastSeq !== null && message.seq > lastSeq + 1) {
+            const fromSeq = Math.max(lastSeq + 1, message.seq - MAX_RESEND_SPAN);
+            sendMessage('resend', { fromSeq, toSeq: message.seq - 1 });
+          }
+          // Always follow the device - a lower seq means it rebooted
+          lastSeqRef.current = message.seq;
+        }
+
         // Track state transitions for history reset
         const prevState = prevStateRef.current;
         prevStateRef.current = p.state;
@@ -174,6 +230,8 @@ export function useWebSerial(): UseWebSerialReturn {
         if (p.state === 'OFF' && prevState !== 'OFF') {
           tempHistoryRef.current = [];
           setTempHistory([]);
+          backfillRef.current = [];
+          setBackfill([]);
         }
 
         // Update all state values
@@ -189,6 +247,9 @@ export function useWebSerial(): UseWebSerialReturn {
         setFirstCrackMarked(p.firstCrackMarked);
         setFirstCrackTimeMs(p.firstCrackTimeMs);
         setRor(p.ror);
+        setResumeAvailable(p.resumeAvailable ?? false);
+        setPreheatReady(p.preheatReady ?? false);
+        setPreheatEtaMs(p.preheatEtaMs ?? null);
         setRoasterError(p.error);
 
         // Add to temperature history during active states
@@ -262,6 +323,59 @@ export function useWebSerial(): UseWebSerialReturn {
           }];
           return newLogs.slice(-MAX_LOG_HISTORY);
         });
+      } else if (message.type === 'resendMiss') {
+        // Requested frames were already evicted from the device ring
+        const p = message.payload;
+        setLogs(prev => {
+          const newLogs = [...prev, {
+            level: 'warn' as const,
+            source: 'SERIAL',
+            message: `Telemetry frames ${p.fromSeq}-${p.toSeq} lost (no longer retained)`,
+            timestamp: message.timestamp
+          }];
+          return newLogs.slice(-MAX_LOG_HISTORY);
+        });
+      } else if (message.type === 'bootReport') {
+        // Summarize boot timing in the log
+        const p = message.payload;
+        const setupMs = (p.phasesUs.setupDone ?? 0) / 1000;
+        const sensorsMs = (p.phasesUs.sensorsReady ?? 0) / 1000;
+        setLogs(prev => {
+          const newLogs = [...prev, {
+            level: 'info' as const,
+            source: 'BOOT',
+            message: `Boot: loop started at ${setupMs.toFixed(1)}ms, sensors ready at ${sensorsMs.toFixed(1)}ms${p.resumed ? ' (roast recovered)' : ''}`,
+            timestamp: message.timestamp
+          }];
+          return newLogs.slice(-MAX_LOG_HISTORY);
+        });
+      } else if (message.type === 'selfTest') {
+        // Keep the latest report and log anything that did not pass
+        const p = message.payload;
+        setSelfTest(p);
+        const findings = p.tests.filter(t => t.status === 'warn' || t.status === 'fail');
+        setLogs(prev => {
+          const newLogs = [...prev, {
+            level: (p.passed ? (findings.length > 0 ? 'warn' : 'info') : 'error') as LogPayload['level'],
+            source: 'SELFTEST',
+            message: findings.length === 0
+              ? `Self-test passed (${p.tests.length} checks)`
+              : `Self-test ${p.passed ? 'passed with warnings' : 'FAILED'}: ${findings.map(t => `${t.name}=${t.status}`).join(', ')}`,
+            timestamp: message.timestamp
+          }];
+          return newLogs.slice(-MAX_LOG_HISTORY);
+        });
+      } else if (message.type === 'faultHistory') {
+        const p = message.payload;
+        setLogs(prev => {
+          const newLogs = [...prev, ...p.faults.map(f => ({
+            level: (f.fatal ? 'error' : 'warn') as LogPayload['level'],
+            source: 'FAULTS',
+            message: `${f.code} at ${Math.floor(f.timestampMs / 1000)}s uptime`,
+            timestamp: message.timestamp
+          }))];
+          return newLogs.slice(-MAX_LOG_HISTORY);
+        });
       } else if (message.type === 'log') {
         // Handle log messages
         setLogs(prev => {
@@ -273,7 +387,7 @@ export function useWebSerial(): UseWebSerialReturn {
     } catch (e) {
       console.error('[Serial] Failed to parse message:', line, e);
     }
-  }, []);
+  }, [sendMessage]);
 
   // Read loop for incoming data
   const readLoop = useCallback(async () => {
@@ -505,6 +619,10 @@ export function useWebSerial(): UseWebSerialReturn {
     sendMessage('stop', {});
   }, [sendMessage]);
 
+  const resumeRoast = useCallback(() => {
+    sendMessage('resumeRoast', {});
+  }, [sendMessage]);
+
   const enterFanOnly = useCallback((speed?: number) => {
     sendMessage('enterFanOnly', { fanSpeed: speed ?? 50 });
   }, [sendMessage]);
@@ -589,11 +707,16 @@ export function useWebSerial(): UseWebSerialReturn {
     firstCrackMarked,
     firstCrackTimeMs,
     ror,
+    resumeAvailable,
+    preheatReady,
+    preheatEtaMs,
     roasterError,
     firmware,
+    selfTest,
 
     // Temperature history
     tempHistory,
+    backfill,
 
     // Logs
     logs,
@@ -605,6 +728,7 @@ export function useWebSerial(): UseWebSerialReturn {
     endRoast,
     markFirstCrack,
     stop,
+    resumeRoast,
     enterFanOnly,
     exitFanOnly,
     enterManual,
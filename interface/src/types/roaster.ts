@@ -1,12 +1,8 @@
-// Roaster states matching firmware enum (src/state.h)
-export type RoasterState =
-  | 'OFF'
-  | 'FAN_ONLY'
-  | 'PREHEAT'
-  | 'ROASTING'
-  | 'COOLING'
-  | 'MANUAL'
-  | 'ERROR';
+import type { RoasterStateName, RoasterTelemetry } from './telemetry.generated';
+
+// Roaster states matching firmware enum (src/state.h), generated from the
+// telemetry schema in lib/protocol/telemetry_schema.h
+export type RoasterState = RoasterStateName;
 
 // State IDs for numeric comparison (matches firmware RoasterState enum values)
 export const STATE_IDS: Record<RoasterState, number> = {
@@ -27,21 +23,8 @@ export interface RoasterError {
 }
 
 // Main state payload sent by firmware every loop (~1000ms per STATE_SEND_INTERVAL_MS)
-// Matches websocket_send_state() in websocket.cpp
-export interface RoasterStatePayload {
-  state: RoasterState;
-  stateId: number;
-  chamberTemp: number | null;  // °C from thermocouple (null if NaN/fault)
-  heaterTemp: number;          // °C from safety thermistor
-  setpoint: number;            // Target temperature °C
-  fanSpeed: number;            // 0-100 percent
-  heaterPower: number;         // 0-100 percent (PID output or manual)
-  heaterEnabled: boolean;      // Is heater actively controlled
-  pidEnabled: boolean;         // Is PID active (false in MANUAL)
-  roastTimeMs: number;         // Elapsed roast time in milliseconds
-  firstCrackMarked: boolean;   // Has first crack been marked
-  firstCrackTimeMs: number | null;  // When first crack was marked
-  ror: number;                 // Rate of rise °C/min
+// Fields generated from lib/protocol/telemetry_schema.h (protocol-gen --ts)
+export interface RoasterStatePayload extends RoasterTelemetry {
   error: RoasterError | null;  // Current error if in ERROR state
 }
 
@@ -68,6 +51,7 @@ export type RoasterCommand =
   | { type: 'endRoast'; payload: Record<string, never> }
   | { type: 'markFirstCrack'; payload: Record<string, never> }
   | { type: 'stop'; payload: Record<string, never> }
+  | { type: 'resumeRoast'; payload: Record<string, never> }
   | { type: 'enterFanOnly'; payload: { fanSpeed?: number } }
   | { type: 'exitFanOnly'; payload: Record<string, never> }
   | { type: 'enterManual'; payload: Record<string, never> }
@@ -77,6 +61,17 @@ export type RoasterCommand =
   | { type: 'setFanSpeed'; payload: { value: number } }
   | { type: 'setHeaterPower'; payload: { value: number } }
   | { type: 'getState'; payload: Record<string, never> }
+  | { type: 'resend'; payload: { fromSeq: number; toSeq: number } }
+  | { type: 'downloadHistory'; payload: { points: number; mode?: 'lttb' | 'minmax' } }
+  | { type: 'getSelfTest'; payload: Record<string, never> }
+  | { type: 'getFaultHistory'; payload: Record<string, never> }
+  | { type: 'getSensorStats'; payload: Record<string, never> }
+  | { type: 'profileBegin'; payload: { points: number; stepMs: number } }
+  | { type: 'profileData'; payload: { offset: number; temps: number[] } }   // 0.1 °C units
+  | { type: 'profileFan'; payload: { events: number[] } }                   // [atSec, speed, ...]
+  | { type: 'profileEnd'; payload: Record<string, never> }
+  | { type: 'clearProfile'; payload: Record<string, never> }
+  | { type: 'getProfile'; payload: Record<string, never> }
   | { type: 'debugFan'; payload: Record<string, never> }
   | { type: 'testFanPins'; payload: Record<string, never> };
 
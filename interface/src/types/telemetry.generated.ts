@@ -0,0 +1,33 @@
+// Generated by host protocol-gen from lib/protocol/telemetry_schema.h.
+// Do not edit - change TELEMETRY_FIELDS and re-run `protocol-gen --ts`.
+
+export type RoasterStateName =
+  | 'OFF'
+  | 'FAN_ONLY'
+  | 'PREHEAT'
+  | 'ROASTING'
+  | 'COOLING'
+  | 'MANUAL'
+  | 'ERROR';
+
+// roasterState payload fields, in the order the firmware sends them
+export interface RoasterTelemetry {
+  state: RoasterStateName;           // State name, see stateId
+  stateId: number;                   // RoasterState enum value
+  chamberTemp: number | null;        // °C from thermocouple (null on fault)
+  heaterTemp: number;                // °C from safety thermistor
+  setpoint: number;                  // Target temperature °C
+  fanSpeed: number;                  // 0-100 percent
+  heaterPower: number;               // 0-100 percent (PID output or manual)
+  heaterEnabled: boolean;            // Heater actively controlled
+  pidEnabled: boolean;               // PID active (false in MANUAL)
+  roastTimeMs: number;               // Elapsed roast time in milliseconds
+  firstCrackMarked: boolean;         // First crack has been marked
+  firstCrackTimeMs: number | null;   // Roast time of first crack
+  ror: number;                       // Rate of rise °C/min
+  resumeAvailable: boolean;          // Roast recovered after MCU reset awaits resumeRoast
+  profileActive: boolean;            // Setpoint follows an uploaded reference roast
+  profileLeadMs: number | null;      // Ahead (+) / behind (-) the reference, null if not comparable
+  preheatReady: boolean;             // Preheat settled within the ready band
+  preheatEtaMs: number | null;       // Predicted time until preheat is ready, null if unknown
+}
@@ -10,12 +10,40 @@ export interface WebSocketMessage<T = unknown> {
 // ============== New Message Types (Firmware v2.0.0+) ==============
 
 // Main state message sent by firmware every ~1000ms
+// seq is monotonic per boot; replay is set on frames re-sent via the resend command
 export interface RoasterStateMessage {
   type: 'roasterState';
+  seq?: number;
+  replay?: boolean;
   timestamp: number;
   payload: RoasterStatePayload;
 }
 
+// Part of a resend range that has already been evicted from the device ring
+export interface ResendMissPayload {
+  fromSeq: number;
+  toSeq: number;
+}
+
+export interface ResendMissMessage {
+  type: 'resendMiss';
+  timestamp: number;
+  payload: ResendMissPayload;
+}
+
+// End of a downloadHistory transfer; the picked samples arrive first as replay frames
+export interface HistoryEndPayload {
+  fromSeq: number;
+  toSeq: number;
+  points: number;
+}
+
+export interface HistoryEndMessage {
+  type: 'historyEnd';
+  timestamp: number;
+  payload: HistoryEndPayload;
+}
+
 // Roast milestone events
 export interface RoastEventMessage {
   type: 'roastEvent';
@@ -34,6 +62,7 @@ export interface RoasterErrorMessage {
 export interface ConnectedPayload {
   ip: string;
   firmware: string;
+  seq?: number;   // Latest telemetry sequence number sent by the device
 }
 
 export type ConnectedMessage = WebSocketMessage<ConnectedPayload> & { type: 'connected' };
@@ -51,13 +80,115 @@ export interface LogMessage {
   payload: LogPayload;
 }
 
+// Boot phase timings in µs since reset (sent after boot and on each connect)
+export interface BootReportPayload {
+  phasesUs: Record<string, number>;
+  resumed: boolean;
+}
+
+export interface BootReportMessage {
+  type: 'bootReport';
+  timestamp: number;
+  payload: BootReportPayload;
+}
+
+// Boot hardware self-test results
+export interface SelfTestResult {
+  name: string;
+  status: 'pending' | 'pass' | 'warn' | 'fail';
+  durationUs: number;
+  value: number | null;
+}
+
+export interface SelfTestPayload {
+  passed: boolean;
+  tests: SelfTestResult[];
+}
+
+export interface SelfTestMessage {
+  type: 'selfTest';
+  timestamp: number;
+  payload: SelfTestPayload;
+}
+
+// Recent faults (including self-test findings), oldest first
+export interface FaultHistoryPayload {
+  faults: Array<{ timestampMs: number; code: string; fatal: boolean }>;
+}
+
+export interface FaultHistoryMessage {
+  type: 'faultHistory';
+  timestamp: number;
+  payload: FaultHistoryPayload;
+}
+
+// Thermocouple sample statistics since boot, split by heater SSR state
+export interface SensorStatsBucket {
+  samples: number;
+  faults: number;
+  noiseRms: number | null;   // °C, null until enough samples
+}
+
+export interface SensorStatsPayload {
+  ssrGuardMs: number;        // Reads kept this far from SSR switching (0 = not aligned)
+  deferred: number;          // Samples held back off an SSR transition
+  intervalMs: number;        // Current sampling interval
+  heaterOn: SensorStatsBucket;
+  heaterOff: SensorStatsBucket;
+}
+
+export interface SensorStatsMessage {
+  type: 'sensorStats';
+  timestamp: number;
+  payload: SensorStatsPayload;
+}
+
+// Reference profile upload / replay status (reply to profile commands)
+export interface ProfileStatusPayload {
+  loaded: boolean;        // Complete profile armed for the next charge
+  active: boolean;        // Replaying now
+  points: number;
+  received: number;
+  stepMs: number;
+  fanEvents: number;
+  durationMs: number;
+  elapsedMs: number;      // Time since charge while active
+  error: string | null;   // Why the last upload step was rejected
+}
+
+export interface ProfileStatusMessage {
+  type: 'profileStatus';
+  timestamp: number;
+  payload: ProfileStatusPayload;
+}
+
+// Sent by the host bridge (host/) when the control lease changes hands
+export interface BridgeControlPayload {
+  holder: number | null;  // Client id holding the lease, null when free
+  clientId: number;       // Recipient's own client id
+}
+
+export interface BridgeControlMessage {
+  type: 'bridgeControl';
+  timestamp: number;
+  payload: BridgeControlPayload;
+}
+
 // Union of all possible inbound messages from firmware
 export type OutboundMessage =
   | RoasterStateMessage
   | RoastEventMessage
   | RoasterErrorMessage
   | ConnectedMessage
-  | LogMessage;
+  | LogMessage
+  | ResendMissMessage
+  | HistoryEndMessage
+  | BootReportMessage
+  | SelfTestMessage
+  | FaultHistoryMessage
+  | SensorStatsMessage
+  | ProfileStatusMessage
+  | BridgeControlMessage;
 
 // ============== Legacy Types (kept for reference) ==============
 
@@ -95,10 +226,24 @@ export type InboundMessage =
   | { type: 'endRoast'; payload: Record<string, never> }
   | { type: 'markFirstCrack'; payload: Record<string, never> }
   | { type: 'stop'; payload: Record<string, never> }
+  | { type: 'resumeRoast'; payload: Record<string, never> }
   | { type: 'enterManual'; payload: Record<string, never> }
   | { type: 'exitManual'; payload: Record<string, never> }
   | { type: 'clearFault'; payload: Record<string, never> }
   | { type: 'setSetpoint'; payload: { value: number } }
   | { type: 'setFanSpeed'; payload: { value: number } }
   | { type: 'setHeaterPower'; payload: { value: number } }
-  | { type: 'getState'; payload: Record<string, never> };
+  | { type: 'getState'; payload: Record<string, never> }
+  | { type: 'resend'; payload: { fromSeq: number; toSeq: number } }
+  | { type: 'downloadHistory'; payload: { points: number; mode?: 'lttb' | 'minmax' } }
+  | { type: 'getSelfTest'; payload: Record<string, never> }
+  | { type: 'getFaultHistory'; payload: Record<string, never> }
+  | { type: 'getSensorStats'; payload: Record<string, never> }
+  | { type: 'profileBegin'; payload: { points: number; stepMs: number } }
+  | { type: 'profileData'; payload: { offset: number; temps: number[] } }   // 0.1 °C units
+  | { type: 'profileFan'; payload: { events: number[] } }                   // [atSec, speed, ...]
+  | { type: 'profileEnd'; payload: Record<string, never> }
+  | { type: 'clearProfile'; payload: Record<string, never> }
+  | { type: 'getProfile'; payload: Record<string, never> }
+  | { type: 'requestControl'; payload: Record<string, never> }
+  | { type: 'releaseControl'; payload: Record<string, never> };
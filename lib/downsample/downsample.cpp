@@ -0,0 +1,245 @@
+#include "downsample.h"
+
+#include <math.h>
+
+// Twice the area of the triangle a-b-c
+static inline float _area(float ax, float ay, float bx, float by, float cx, float cy) {
+    return fabsf((ax - cx) * (by - ay) - (ax - bx) * (cy - ay));
+}
+
+// First sample index of interior bucket b (samples 1 .. count-2 split
+// into `buckets` runs of near-equal length)
+static inline uint32_t _bucket_start(uint32_t b, uint32_t count, uint32_t buckets) {
+    return 1 + (uint32_t)((uint64_t)b * (count - 2) / buckets);
+}
+
+// ============== Exact LTTB ==============
+
+uint32_t downsample_lttb(const float* x, const float* y, uint32_t count, uint32_t target,
+                         const uint8_t* pinned, DownsampleEmit emit, void* context) {
+    if (target < 3) target = 3;
+    if (target >= count) {
+        for (uint32_t i = 0; i < count; i++) emit(i, context);
+        return count;
+    }
+
+    uint32_t buckets = target - 2;
+    uint32_t emitted = 1;
+    emit(0, context);
+
+    // Previous pick; a NaN first sample is replaced by the first real pick
+    float ax = x[0], ay = y[0];
+    for (uint32_t b = 0; b < buckets; b++) {
+        uint32_t lo = _bucket_start(b, count, buckets);
+        uint32_t hi = _bucket_start(b + 1, count, buckets);
+
+        // Average of the next bucket (the last sample for the final bucket)
+        float cx = x[count - 1], cy = y[count - 1];
+        if (b + 1 < buckets) {
+            uint32_t next_hi = _bucket_start(b + 2, count, buckets);
+            float sx = 0, sy = 0;
+            uint32_t n = 0;
+            for (uint32_t i = hi; i < next_hi; i++) {
+                if (isnan(y[i])) continue;
+                sx += x[i];
+                sy += y[i];
+                n++;
+            }
+            if (n > 0) {
+                cx = sx / n;
+                cy = sy / n;
+            }
+        }
+
+        uint32_t pick = UINT32_MAX;
+        float best = -1;
+        bool any_pinned = false;
+        for (uint32_t i = lo; i < hi; i++) {
+            if (pinned && pinned[i]) any_pinned = true;
+            if (isnan(y[i])) continue;
+            float area = isnan(ay) ? 0 : _area(ax, ay, x[i], y[i], cx, cy);
+            if (area > best) {
+                best = area;
+                pick = i;
+            }
+        }
+
+        if (any_pinned) {
+            for (uint32_t i = lo; i < hi; i++) {
+                if (i == pick || pinned[i]) {
+                    emit(i, context);
+                    emitted++;
+                }
+            }
+        } else if (pick != UINT32_MAX) {
+            emit(pick, context);
+            emitted++;
+        }
+        if (pick != UINT32_MAX) {
+            ax = x[pick];
+            ay = y[pick];
+        }
+    }
+
+    emit(count - 1, context);
+    return emitted + 1;
+}
+
+// ============== Streaming Reducer ==============
+
+void Downsampler::begin(DownsampleMode mode, uint32_t count, uint32_t target, DownsampleEmit emit, void* context) {
+    _mode = mode;
+    _emit_fn = emit;
+    _context = context;
+    _count = count;
+    _pushed = 0;
+    _emitted = 0;
+    _last_emitted = UINT32_MAX;
+    _pinned_dropped = 0;
+    _have_pending = false;
+    _current_bucket = 0;
+    _anchor.y = NAN;
+    _reset(_current);
+
+    if (target < 3) target = 3;
+    _passthrough = target >= count;
+
+    // MIN_MAX spends two points per bucket
+    uint32_t budget = target - 2;
+    _buckets = mode == DownsampleMode::MIN_MAX ? budget / 2 : budget;
+    if (_buckets == 0) _buckets = 1;
+}
+
+void Downsampler::push(float x, float y, bool pinned) {
+    uint32_t index = _pushed++;
+    if (_passthrough) {
+        _emit(index);
+        return;
+    }
+    if (index == 0) {
+        _emit(0);
+        _anchor = { x, y, 0 };
+        return;
+    }
+    if (index == _count - 1) {
+        // Final sample: decide what is left, then emit it
+        if (_have_pending) {
+            if (_current.valid > 0) _close(_pending, _current.sum_x / _current.valid, _current.sum_y / _current.valid);
+            else _close(_pending, x, y);
+            _have_pending = false;
+        }
+        if (_current.count > 0) _close(_current, x, y);
+        _reset(_current);
+        _emit(index);
+        return;
+    }
+    if (index >= _count) return;
+
+    uint32_t bucket = _bucket_of(index);
+    if (bucket != _current_bucket && _current.count > 0) {
+        if (_have_pending) {
+            if (_current.valid > 0) {
+                _close(_pending, _current.sum_x / _current.valid, _current.sum_y / _current.valid);
+            } else {
+                _close(_pending, _pending.last.x, _pending.last.y);
+            }
+        }
+        _pending = _current;
+        _have_pending = true;
+        _reset(_current);
+    }
+    _current_bucket = bucket;
+
+    Bucket& b = _current;
+    b.count++;
+    if (pinned) {
+        if (b.pinned_count < DOWNSAMPLE_MAX_PINNED) b.pinned[b.pinned_count++] = index;
+        else _pinned_dropped++;
+    }
+    if (isnan(y)) return;
+
+    Point p = { x, y, index };
+    if (b.valid == 0) {
+        b.first = b.low = b.high = p;
+    }
+    b.last = p;
+    if (y < b.low.y) b.low = p;
+    if (y > b.high.y) b.high = p;
+    b.sum_x += x;
+    b.sum_y += y;
+    b.valid++;
+}
+
+void Downsampler::finish() {
+    // Normally the final push has flushed everything; this covers a
+    // caller that pushed fewer samples than announced
+    if (_passthrough) return;
+    if (_have_pending) {
+        const Bucket& next = _current;
+        if (next.valid > 0) _close(_pending, next.sum_x / next.valid, next.sum_y / next.valid);
+        else _close(_pending, _pending.last.x, _pending.last.y);
+        _have_pending = false;
+    }
+    if (_current.count > 0) _close(_current, _current.last.x, _current.last.y);
+    _reset(_current);
+}
+
+void Downsampler::_reset(Bucket& bucket) {
+    bucket.count = 0;
+    bucket.sum_x = 0;
+    bucket.sum_y = 0;
+    bucket.valid = 0;
+    bucket.pinned_count = 0;
+}
+
+uint32_t Downsampler::_bucket_of(uint32_t index) const {
+    return (uint32_t)((uint64_t)(index - 1) * _buckets / (_count - 2));
+}
+
+void Downsampler::_close(Bucket& bucket, float next_x, float next_y) {
+    uint32_t picks[2];
+    uint8_t pick_count = 0;
+
+    if (bucket.valid > 0) {
+        if (_mode == DownsampleMode::MIN_MAX) {
+            const Point& a = bucket.low.index < bucket.high.index ? bucket.low : bucket.high;
+            const Point& b = bucket.low.index < bucket.high.index ? bucket.high : bucket.low;
+            picks[pick_count++] = a.index;
+            if (b.index != a.index) picks[pick_count++] = b.index;
+            _anchor = b;
+        } else {
+            const Point* candidates[4] = { &bucket.first, &bucket.low, &bucket.high, &bucket.last };
+            const Point* best = candidates[0];
+            if (!isnan(_anchor.y)) {
+                float best_area = -1;
+                for (const Point* c : candidates) {
+                    float area = _area(_anchor.x, _anchor.y, c->x, c->y, next_x, next_y);
+                    if (area > best_area) {
+                        best_area = area;
+                        best = c;
+                    }
+                }
+            }
+            picks[pick_count++] = best->index;
+            _anchor = *best;
+        }
+    }
+    _emit_sorted(picks, pick_count, bucket);
+}
+
+// Merges the bucket's picks with its pinned samples (both ascending)
+void Downsampler::_emit_sorted(uint32_t* picks, uint8_t pick_count, const Bucket& bucket) {
+    uint8_t p = 0, q = 0;
+    while (p < pick_count || q < bucket.pinned_count) {
+        bool take_pick = q >= bucket.pinned_count || (p < pick_count && picks[p] <= bucket.pinned[q]);
+        uint32_t index = take_pick ? picks[p++] : bucket.pinned[q++];
+        _emit(index);
+    }
+}
+
+void Downsampler::_emit(uint32_t index) {
+    if (_last_emitted != UINT32_MAX && index <= _last_emitted) return;     // Already sent
+    _last_emitted = index;
+    _emitted++;
+    _emit_fn(index, _context);
+}
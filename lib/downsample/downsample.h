@@ -0,0 +1,109 @@
+#ifndef DOWNSAMPLE_H
+#define DOWNSAMPLE_H
+
+#include <stdint.h>
+
+// ============== Curve Downsampling ==============
+// Shared by the firmware (PlatformIO builds lib/ automatically) and the
+// host tools (host/CMakeLists.txt). No heap, no STL - only fixed-size
+// state, so it runs on the Uno R4 as well as over archive queries.
+//
+// Both reducers pick sample *indices* along one series (usually chamber
+// temperature); the caller then sends or copies every column of the picked
+// samples. Output is always in index order.
+//
+//   LTTB     Largest-Triangle-Three-Buckets: one point per bucket, the one
+//            forming the largest triangle with the previous pick and the
+//            next bucket's average. Keeps the visual shape of the curve.
+//   MIN_MAX  The lowest and highest point of every bucket. Keeps every
+//            excursion (spikes, overshoot) at twice the points per bucket.
+//
+// The first and last samples are always kept. Samples pushed as pinned
+// (charge, first crack, drop, state changes) are kept in addition to the
+// target budget, so key events never fall between picks. Samples with a
+// NaN value are only emitted when pinned.
+
+#define DOWNSAMPLE_MAX_PINNED   8       // Pinned samples held per bucket
+
+enum class DownsampleMode : uint8_t {
+    LTTB = 0,
+    MIN_MAX = 1
+};
+
+// Receives each picked sample index, in increasing order
+typedef void (*DownsampleEmit)(uint32_t index, void* context);
+
+// Exact LTTB over random-access arrays (two reads per sample, no extra
+// memory). `pinned` may be null. Returns the number of indices emitted.
+uint32_t downsample_lttb(const float* x, const float* y, uint32_t count, uint32_t target,
+                         const uint8_t* pinned, DownsampleEmit emit, void* context);
+
+// ============== Streaming Reducer ==============
+// One pass over a series whose length is known up front, with O(1) state
+// per bucket: a bucket keeps its first, last, lowest and highest samples,
+// running sums for its average, and its pinned samples. A bucket is
+// decided once the following bucket's average is known, so at most two
+// buckets are held at any time.
+//
+// In LTTB mode the pick is made among the bucket's four kept samples
+// rather than all of them. On roast curves the exact pick is almost always
+// one of those extremes or ends; use downsample_lttb() where the whole
+// series is addressable and exactness matters.
+
+class Downsampler {
+public:
+    // `count` samples will be pushed; about `target` are emitted (plus
+    // pinned samples). A target >= count keeps everything.
+    void begin(DownsampleMode mode, uint32_t count, uint32_t target, DownsampleEmit emit, void* context);
+
+    // Samples in order; their index is the number pushed before them
+    void push(float x, float y, bool pinned = false);
+
+    // Flushes the remaining buckets; call after the last push
+    void finish();
+
+    uint32_t emitted() const { return _emitted; }
+    uint32_t pinned_dropped() const { return _pinned_dropped; }    // Bucket overflows
+
+private:
+    struct Point {
+        float x;
+        float y;
+        uint32_t index;
+    };
+
+    struct Bucket {
+        uint32_t count;
+        float sum_x;
+        float sum_y;
+        uint32_t valid;                 // Samples with a non-NaN value
+        Point first, last, low, high;
+        uint32_t pinned[DOWNSAMPLE_MAX_PINNED];
+        uint8_t pinned_count;
+    };
+
+    void _reset(Bucket& bucket);
+    uint32_t _bucket_of(uint32_t index) const;
+    void _close(Bucket& bucket, float next_x, float next_y);
+    void _emit_sorted(uint32_t* picks, uint8_t pick_count, const Bucket& bucket);
+    void _emit(uint32_t index);
+
+    DownsampleMode _mode;
+    DownsampleEmit _emit_fn;
+    void* _context;
+    uint32_t _count;
+    uint32_t _buckets;                  // Between the first and last sample
+    uint32_t _pushed;
+    uint32_t _emitted;
+    uint32_t _last_emitted;
+    uint32_t _pinned_dropped;
+    bool _passthrough;
+
+    Point _anchor;                      // Previous LTTB pick
+    Bucket _pending;                    // Complete, waiting for the next average
+    Bucket _current;
+    bool _have_pending;
+    uint32_t _current_bucket;
+};
+
+#endif // DOWNSAMPLE_H
@@ -0,0 +1,429 @@
+#include "telemetry_codec.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const _state_names[TELEMETRY_STATE_COUNT] = TELEMETRY_STATE_NAMES;
+
+// ============== JSON Writer ==============
+
+struct _Writer {
+    char* p;
+    char* end;
+    bool ok;
+};
+
+static inline void _put(_Writer& w, const char* text, size_t len) {
+    if ((size_t)(w.end - w.p) < len) {
+        w.ok = false;
+        return;
+    }
+    memcpy(w.p, text, len);
+    w.p += len;
+}
+
+template <size_t N>
+static inline void _put(_Writer& w, const char (&text)[N]) {
+    _put(w, text, N - 1);
+}
+
+static inline void _put_u32(_Writer& w, uint32_t value) {
+    char digits[10];
+    uint8_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    if ((size_t)(w.end - w.p) < n) {
+        w.ok = false;
+        return;
+    }
+    while (n) *w.p++ = digits[--n];
+}
+
+static inline void _put_i32(_Writer& w, int32_t value) {
+    if (value < 0) _put(w, "-");
+    _put_u32(w, value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value);
+}
+
+// One decimal, rounded half away from zero like String(float, 1)
+static inline void _put_deci(_Writer& w, float value) {
+    if (isnan(value) || isinf(value)) {
+        _put(w, "null");
+        return;
+    }
+    bool negative = value < 0;
+    uint32_t tenths = (uint32_t)(fabsf(value) * 10.0f + 0.5f);
+    if (negative && tenths) _put(w, "-");
+    _put_u32(w, tenths / 10);
+    char frac[2] = { '.', (char)('0' + tenths % 10) };
+    _put(w, frac, 2);
+}
+
+// Per-codec JSON values; every one sees the flags byte for FLAG-style codecs
+static inline void _json_STATE_NAME(_Writer& w, uint8_t value, uint8_t, uint8_t) {
+    const char* name = value < TELEMETRY_STATE_COUNT ? _state_names[value] : "UNKNOWN";
+    _put(w, "\"");
+    _put(w, name, strlen(name));
+    _put(w, "\"");
+}
+
+static inline void _json_U8(_Writer& w, uint8_t value, uint8_t, uint8_t) { _put_u32(w, value); }
+static inline void _json_U32(_Writer& w, uint32_t value, uint8_t, uint8_t) { _put_u32(w, value); }
+static inline void _json_DECI(_Writer& w, float value, uint8_t, uint8_t) { _put_deci(w, value); }
+static inline void _json_DECI_NULL(_Writer& w, float value, uint8_t, uint8_t) { _put_deci(w, value); }
+
+static inline void _json_FLAG(_Writer& w, uint8_t, uint8_t flags, uint8_t flag) {
+    if (flags & flag) _put(w, "true");
+    else _put(w, "false");
+}
+
+static inline void _json_U32_IF_FLAG(_Writer& w, uint32_t value, uint8_t flags, uint8_t flag) {
+    if (flags & flag) _put_u32(w, value);
+    else _put(w, "null");
+}
+
+static inline void _json_I32_NULL(_Writer& w, int32_t value, uint8_t, uint8_t) {
+    if (value == TELEMETRY_NULL_I32) _put(w, "null");
+    else _put_i32(w, value);
+}
+
+size_t telemetry_encode_json(const TelemetrySample& sample, bool replay, const char* tail, char* out, size_t size) {
+    _Writer w = { out, out + size, true };
+
+    _put(w, "{\"type\":\"roasterState\",\"seq\":");
+    _put_u32(w, sample.seq);
+    if (replay) _put(w, ",\"replay\":true");
+    _put(w, ",\"timestamp\":");
+    _put_u32(w, sample.timestampMs);
+    _put(w, ",\"payload\":");
+
+    // Every field is written with a leading comma; the first one becomes
+    // the payload's opening brace
+    char* open = w.p;
+#define TELEMETRY_JSON_FIELD(key, member, codec, flag, description) \
+    _put(w, ",\"" #key "\":");                                      \
+    _json_##codec(w, sample.member, sample.flags, flag);
+    TELEMETRY_FIELDS(TELEMETRY_JSON_FIELD)
+#undef TELEMETRY_JSON_FIELD
+    if (w.ok) *open = '{';
+
+    if (tail && *tail) {
+        _put(w, ",");
+        _put(w, tail, strlen(tail));
+    }
+    _put(w, "}}");
+
+    if (!w.ok) return 0;
+    if (w.p < w.end) *w.p = '\0';
+    return (size_t)(w.p - out);
+}
+
+// ============== JSON Reader ==============
+
+template <size_t N>
+static inline bool _lit(const char*& p, const char* end, const char (&text)[N]) {
+    if ((size_t)(end - p) < N - 1 || memcmp(p, text, N - 1) != 0) return false;
+    p += N - 1;
+    return true;
+}
+
+static inline bool _uint(const char*& p, const char* end, uint32_t& out) {
+    const char* start = p;
+    uint64_t value = 0;
+    while (p < end && (unsigned)(*p - '0') < 10 && p - start < 11) value = value * 10 + (uint64_t)(*p++ - '0');
+    if (p == start || value > UINT32_MAX || (p < end && (unsigned)(*p - '0') < 10)) return false;
+    out = (uint32_t)value;
+    return true;
+}
+
+// Plain decimals with up to 6 fractional digits - what the encoders emit.
+// Rounded through double so the result matches strtod() on the same text.
+static inline bool _float_fast(const char*& p, const char* end, float& out) {
+    static const double scale[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+    bool negative = p < end && *p == '-';
+    if (negative) p++;
+    uint32_t whole;
+    if (!_uint(p, end, whole)) return false;
+    uint32_t frac = 0;
+    int digits = 0;
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && (unsigned)(*p - '0') < 10 && digits < 6) {
+            frac = frac * 10 + (uint32_t)(*p++ - '0');
+            digits++;
+        }
+        if (digits == 0 || (p < end && (unsigned)(*p - '0') < 10)) return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) return false;
+    double value = (double)whole + (double)frac / scale[digits];
+    out = (float)(negative ? -value : value);
+    return true;
+}
+
+// Any other JSON number (long fractions from a double round trip,
+// exponents, huge integers) goes through strtod() on a bounded copy -
+// the line is not NUL-terminated
+static bool _float_slow(const char*& p, const char* end, float& out) {
+    char buf[40];
+    size_t n = 0;
+    while (p + n < end && n < sizeof(buf) - 1 && p[n] && strchr("+-.0123456789eE", p[n])) {
+        buf[n] = p[n];
+        n++;
+    }
+    if (n == sizeof(buf) - 1) return false;
+    buf[n] = '\0';
+
+    char* stop;
+    double value = strtod(buf, &stop);
+    if (stop == buf || (size_t)(stop - buf) != n) return false;
+    p += n;
+    out = (float)value;
+    return true;
+}
+
+static inline bool _float(const char*& p, const char* end, float& out) {
+    const char* start = p;
+    if (_float_fast(p, end, out)) return true;
+    p = start;
+    return _float_slow(p, end, out);
+}
+
+static inline bool _dec_STATE_NAME(const char*& p, const char* end, uint8_t&, uint8_t&, uint8_t) {
+    if (!_lit(p, end, "\"")) return false;
+    const char* quote = (const char*)memchr(p, '"', end - p);
+    if (!quote) return false;
+    p = quote + 1;
+    return true;
+}
+
+static inline bool _dec_U8(const char*& p, const char* end, uint8_t& out, uint8_t&, uint8_t) {
+    uint32_t value;
+    if (!_uint(p, end, value)) return false;
+    out = value > 255 ? 255 : (uint8_t)value;
+    return true;
+}
+
+static inline bool _dec_U32(const char*& p, const char* end, uint32_t& out, uint8_t&, uint8_t) {
+    return _uint(p, end, out);
+}
+
+static inline bool _dec_DECI(const char*& p, const char* end, float& out, uint8_t&, uint8_t) {
+    if (_lit(p, end, "null")) {
+        out = NAN;
+        return true;
+    }
+    return _float(p, end, out);
+}
+
+static inline bool _dec_DECI_NULL(const char*& p, const char* end, float& out, uint8_t& flags, uint8_t flag) {
+    return _dec_DECI(p, end, out, flags, flag);
+}
+
+static inline bool _dec_FLAG(const char*& p, const char* end, uint8_t&, uint8_t& flags, uint8_t flag) {
+    if (_lit(p, end, "true")) {
+        flags |= flag;
+        return true;
+    }
+    return _lit(p, end, "false");
+}
+
+static inline bool _dec_U32_IF_FLAG(const char*& p, const char* end, uint32_t& out, uint8_t&, uint8_t) {
+    if (_lit(p, end, "null")) {
+        out = 0;
+        return true;
+    }
+    return _uint(p, end, out);
+}
+
+static inline bool _dec_I32_NULL(const char*& p, const char* end, int32_t& out, uint8_t&, uint8_t) {
+    if (_lit(p, end, "null")) {
+        out = TELEMETRY_NULL_I32;
+        return true;
+    }
+    bool negative = _lit(p, end, "-");
+    uint32_t value;
+    if (!_uint(p, end, value) || value > (uint32_t)INT32_MAX + (negative ? 1u : 0u)) return false;
+    out = negative ? (int32_t)(0 - value) : (int32_t)value;
+    return true;
+}
+
+static const char* _find(const char* p, const char* end, const char* needle, size_t len) {
+    while ((size_t)(end - p) >= len) {
+        const char* hit = (const char*)memchr(p, needle[0], end - p - len + 1);
+        if (!hit) return nullptr;
+        if (memcmp(hit, needle, len) == 0) return hit;
+        p = hit + 1;
+    }
+    return nullptr;
+}
+
+template <size_t N>
+static inline const char* _value_of(const char* p, const char* end, const char (&key)[N]) {
+    const char* hit = _find(p, end, key, N - 1);
+    return hit ? hit + N - 1 : nullptr;
+}
+
+static void _defaults(TelemetrySample& s) {
+    memset(&s, 0, sizeof(s));
+    s.chamberTemp = NAN;
+    s.heaterTemp = NAN;
+    s.profileLeadMs = TELEMETRY_NULL_I32;
+    s.preheatEtaMs = TELEMETRY_NULL_I32;
+}
+
+// `sep` followed by the quoted key; advances past both on a match
+template <size_t N>
+static inline bool _key(const char*& p, const char* end, char sep, const char (&key)[N]) {
+    if ((size_t)(end - p) < N || *p != sep || memcmp(p + 1, key, N - 1) != 0) return false;
+    p += N;
+    return true;
+}
+
+// The encoder's layout, key by key. Trailing fields may be missing (older
+// firmware); anything else out of place returns false.
+static bool _decode_fixed(const char* p, const char* end, TelemetrySample& s, bool& replay) {
+    if (!_lit(p, end, "\"type\":\"roasterState\",\"seq\":") || !_uint(p, end, s.seq)) return false;
+    replay = _lit(p, end, ",\"replay\":true");
+    if (!_lit(p, end, ",\"timestamp\":") || !_uint(p, end, s.timestampMs)) return false;
+    if (!_lit(p, end, ",\"payload\":")) return false;
+
+    char sep = '{';
+#define TELEMETRY_FIXED_FIELD(key, member, codec, flag, description)          \
+    if (!_key(p, end, sep, "\"" #key "\":")) {                                 \
+        return sep == ',' && p < end && (*p == '}' || _lit(p, end, ",\"error\":")); \
+    }                                                                         \
+    sep = ',';                                                                \
+    if (!_dec_##codec(p, end, s.member, s.flags, flag)) return false;
+    TELEMETRY_FIELDS(TELEMETRY_FIXED_FIELD)
+#undef TELEMETRY_FIXED_FIELD
+    return true;
+}
+
+static bool _decode_keyed(const char* p, const char* end, TelemetrySample& s, bool& replay) {
+    if (!_find(p, end, "\"type\":\"roasterState\"", 21)) return false;
+
+    const char* payload = _value_of(p, end, "\"payload\":{");
+    if (!payload) return false;
+    const char* v;
+    uint8_t ignored = 0;
+    // Envelope keys never appear inside the payload, so search the whole line
+    if ((v = _value_of(p, end, "\"seq\":")) && !_dec_U32(v, end, s.seq, ignored, 0)) return false;
+    if ((v = _value_of(p, end, "\"timestamp\":")) && !_dec_U32(v, end, s.timestampMs, ignored, 0)) return false;
+    replay = _find(p, end, "\"replay\":true", 13) != nullptr;
+
+#define TELEMETRY_KEYED_FIELD(key, member, codec, flag, description)              \
+    if ((v = _value_of(payload, end, "\"" #key "\":")) &&                           \
+        !_dec_##codec(v, end, s.member, s.flags, flag)) return false;
+    TELEMETRY_FIELDS(TELEMETRY_KEYED_FIELD)
+#undef TELEMETRY_KEYED_FIELD
+    return true;
+}
+
+TelemetryDecode telemetry_decode_json(const char* line, size_t len, TelemetrySample& out, bool& replay) {
+    const char* p = line;
+    const char* end = line + len;
+    replay = false;
+
+    // {"device":"id",<frame fields>} from the fleet service
+    if (!_lit(p, end, "{")) return TelemetryDecode::INVALID;
+    if (_lit(p, end, "\"device\":\"")) {
+        const char* quote = (const char*)memchr(p, '"', end - p);
+        if (!quote) return TelemetryDecode::INVALID;
+        p = quote + 1;
+        if (!_lit(p, end, ",")) return TelemetryDecode::INVALID;
+    }
+
+    _defaults(out);
+    if (_decode_fixed(p, end, out, replay)) return TelemetryDecode::FIXED_LAYOUT;
+
+    _defaults(out);
+    replay = false;
+    if (_decode_keyed(line, end, out, replay)) return TelemetryDecode::KEYED;
+    return TelemetryDecode::INVALID;
+}
+
+// ============== Binary ==============
+
+static inline void _le16(uint8_t*& p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p += 2;
+}
+
+static inline void _le32(uint8_t*& p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    p += 4;
+}
+
+static inline uint16_t _rd16(const uint8_t*& p) {
+    uint16_t v = (uint16_t)(p[0] | (p[1] << 8));
+    p += 2;
+    return v;
+}
+
+static inline uint32_t _rd32(const uint8_t*& p) {
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    p += 4;
+    return v;
+}
+
+static inline int16_t _to_tenths(float value) {
+    if (isnan(value)) return INT16_MIN;
+    float tenths = value * 10.0f + (value < 0 ? -0.5f : 0.5f);
+    if (tenths > INT16_MAX) return INT16_MAX;
+    if (tenths < INT16_MIN + 1) return INT16_MIN + 1;
+    return (int16_t)tenths;
+}
+
+static inline void _bin_STATE_NAME(uint8_t*&, uint8_t) {}
+static inline void _bin_FLAG(uint8_t*&, uint8_t) {}
+static inline void _bin_U8(uint8_t*& p, uint8_t value) { *p++ = value; }
+static inline void _bin_U32(uint8_t*& p, uint32_t value) { _le32(p, value); }
+static inline void _bin_U32_IF_FLAG(uint8_t*& p, uint32_t value) { _le32(p, value); }
+static inline void _bin_I32_NULL(uint8_t*& p, int32_t value) { _le32(p, (uint32_t)value); }
+static inline void _bin_DECI(uint8_t*& p, float value) { _le16(p, (uint16_t)_to_tenths(value)); }
+static inline void _bin_DECI_NULL(uint8_t*& p, float value) { _le16(p, (uint16_t)_to_tenths(value)); }
+
+static inline void _unbin_STATE_NAME(const uint8_t*&, uint8_t&) {}
+static inline void _unbin_FLAG(const uint8_t*&, uint8_t&) {}
+static inline void _unbin_U8(const uint8_t*& p, uint8_t& out) { out = *p++; }
+static inline void _unbin_U32(const uint8_t*& p, uint32_t& out) { out = _rd32(p); }
+static inline void _unbin_U32_IF_FLAG(const uint8_t*& p, uint32_t& out) { out = _rd32(p); }
+static inline void _unbin_I32_NULL(const uint8_t*& p, int32_t& out) { out = (int32_t)_rd32(p); }
+
+static inline void _unbin_DECI(const uint8_t*& p, float& out) {
+    int16_t tenths = (int16_t)_rd16(p);
+    out = tenths == INT16_MIN ? NAN : tenths / 10.0f;
+}
+
+static inline void _unbin_DECI_NULL(const uint8_t*& p, float& out) { _unbin_DECI(p, out); }
+
+size_t telemetry_encode_binary(const TelemetrySample& sample, uint8_t* out) {
+    uint8_t* p = out;
+    *p++ = TELEMETRY_BINARY_VERSION;
+    _le32(p, sample.seq);
+    _le32(p, sample.timestampMs);
+    *p++ = sample.flags;
+#define TELEMETRY_BINARY_FIELD(key, member, codec, flag, description) _bin_##codec(p, sample.member);
+    TELEMETRY_FIELDS(TELEMETRY_BINARY_FIELD)
+#undef TELEMETRY_BINARY_FIELD
+    return (size_t)(p - out);
+}
+
+bool telemetry_decode_binary(const uint8_t* data, size_t len, TelemetrySample& out) {
+    if (len < TELEMETRY_BINARY_SIZE || data[0] != TELEMETRY_BINARY_VERSION) return false;
+    const uint8_t* p = data + 1;
+    out.seq = _rd32(p);
+    out.timestampMs = _rd32(p);
+    out.flags = *p++;
+#define TELEMETRY_UNBINARY_FIELD(key, member, codec, flag, description) _unbin_##codec(p, out.member);
+    TELEMETRY_FIELDS(TELEMETRY_UNBINARY_FIELD)
+#undef TELEMETRY_UNBINARY_FIELD
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include "telemetry_schema.h"
+
+// ============== roasterState Codecs ==============
+// Encoders and decoders expanded field by field from TELEMETRY_FIELDS, so
+// each is straight-line code with the keys as literals. None of them
+// allocate; they run on the Uno R4 as well as in the host tools.
+
+// Longest JSON line the encoder produces without an error tail
+#define TELEMETRY_JSON_MAX      512
+
+// Writes one complete roasterState line (no newline) into `out`.
+// `tail` is raw JSON members appended to the payload - the firmware's
+// "error" object, which is not part of the retained sample - or null.
+// Returns the length, or 0 if `size` is too small.
+size_t telemetry_encode_json(const TelemetrySample& sample, bool replay, const char* tail, char* out, size_t size);
+
+enum class TelemetryDecode : uint8_t {
+    INVALID,                    // Not a roasterState line
+    KEYED,                      // Decoded by key lookup (reordered or unknown layout)
+    FIXED_LAYOUT                // Decoded in the encoder's key order
+};
+
+// Decodes a roasterState line, optionally prefixed with the fleet's
+// "device" key. Fields the line lacks keep their defaults (0, NaN
+// temperatures, null lead and ETA). The encoder's own layout is decoded
+// with literal key compares; anything else falls back to key lookup.
+TelemetryDecode telemetry_decode_json(const char* line, size_t len, TelemetrySample& out, bool& replay);
+
+// Fixed-size binary form (TELEMETRY_BINARY_SIZE bytes, see the schema)
+size_t telemetry_encode_binary(const TelemetrySample& sample, uint8_t* out);
+bool telemetry_decode_binary(const uint8_t* data, size_t len, TelemetrySample& out);
+
+#endif // TELEMETRY_CODEC_H
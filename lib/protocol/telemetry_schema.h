@@ -0,0 +1,134 @@
+#ifndef TELEMETRY_SCHEMA_H
+#define TELEMETRY_SCHEMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============== roasterState Schema ==============
+// The single definition of the telemetry frame. Everything that reads or
+// writes roasterState is expanded from TELEMETRY_FIELDS:
+//
+//   - the JSON and binary encoders/decoders (telemetry_codec.cpp), used by
+//     serial_comm.cpp, the emulator, the recorder and log ingestion
+//   - TELEMETRY_FIELD_TABLE, for code that walks the fields at run time
+//   - the TypeScript payload type and the docs table (host protocol-gen)
+//
+// Adding a field is one X() line plus the TelemetrySample member it reads;
+// keep new fields at the end so older readers still match the layout.
+//
+//   X(key, member, codec, flag, description)
+//
+// Codecs (JSON / binary):
+//   STATE_NAME   state name looked up from the member / not sent
+//   U8, U32      unsigned integer / 1 or 4 bytes
+//   DECI         float with one decimal, null if NaN / int16 tenths
+//   DECI_NULL    as DECI, and the TS type admits null
+//   FLAG         true/false from `flag` in the flags byte / in the flags byte
+//   U32_IF_FLAG  integer, null unless `flag` is set / 4 bytes
+//   I32_NULL     signed integer, null at TELEMETRY_NULL_I32 / 4 bytes
+
+// Flag bits for TelemetrySample::flags
+#define TELEMETRY_FLAG_HEATER_ENABLED   0x01
+#define TELEMETRY_FLAG_PID_ENABLED      0x02
+#define TELEMETRY_FLAG_FIRST_CRACK      0x04
+#define TELEMETRY_FLAG_RESUME_AVAILABLE 0x08
+#define TELEMETRY_FLAG_PROFILE_ACTIVE   0x10
+#define TELEMETRY_FLAG_PREHEAT_READY    0x20
+
+#define TELEMETRY_NULL_I32              INT32_MIN
+
+#define TELEMETRY_FIELDS(X) \
+    X(state,            stateId,          STATE_NAME,  0,                               "State name, see stateId") \
+    X(stateId,          stateId,          U8,          0,                               "RoasterState enum value") \
+    X(chamberTemp,      chamberTemp,      DECI_NULL,   0,                               "°C from thermocouple (null on fault)") \
+    X(heaterTemp,       heaterTemp,       DECI,        0,                               "°C from safety thermistor") \
+    X(setpoint,         setpoint,         DECI,        0,                               "Target temperature °C") \
+    X(fanSpeed,         fanSpeed,         U8,          0,                               "0-100 percent") \
+    X(heaterPower,      heaterPower,      U8,          0,                               "0-100 percent (PID output or manual)") \
+    X(heaterEnabled,    flags,            FLAG,        TELEMETRY_FLAG_HEATER_ENABLED,   "Heater actively controlled") \
+    X(pidEnabled,       flags,            FLAG,        TELEMETRY_FLAG_PID_ENABLED,      "PID active (false in MANUAL)") \
+    X(roastTimeMs,      roastTimeMs,      U32,         0,                               "Elapsed roast time in milliseconds") \
+    X(firstCrackMarked, flags,            FLAG,        TELEMETRY_FLAG_FIRST_CRACK,      "First crack has been marked") \
+    X(firstCrackTimeMs, firstCrackTimeMs, U32_IF_FLAG, TELEMETRY_FLAG_FIRST_CRACK,      "Roast time of first crack") \
+    X(ror,              ror,              DECI,        0,                               "Rate of rise °C/min") \
+    X(resumeAvailable,  flags,            FLAG,        TELEMETRY_FLAG_RESUME_AVAILABLE, "Roast recovered after MCU reset awaits resumeRoast") \
+    X(profileActive,    flags,            FLAG,        TELEMETRY_FLAG_PROFILE_ACTIVE,   "Setpoint follows an uploaded reference roast") \
+    X(profileLeadMs,    profileLeadMs,    I32_NULL,    0,                               "Ahead (+) / behind (-) the reference, null if not comparable") \
+    X(preheatReady,     flags,            FLAG,        TELEMETRY_FLAG_PREHEAT_READY,    "Preheat settled within the ready band") \
+    X(preheatEtaMs,     preheatEtaMs,     I32_NULL,    0,                               "Predicted time until preheat is ready, null if unknown")
+
+// Names for the STATE_NAME codec, indexed by stateId (src/state.h order)
+#define TELEMETRY_STATE_NAMES { "OFF", "FAN_ONLY", "PREHEAT", "ROASTING", "COOLING", "MANUAL", "ERROR" }
+#define TELEMETRY_STATE_COUNT 7
+
+// Compact snapshot of one roasterState frame, kept so the host can
+// request retransmission of frames it missed
+struct TelemetrySample {
+    uint32_t seq;               // Monotonic sequence number (1-based, 0 = invalid)
+    uint32_t timestampMs;       // millis() when the sample was taken
+    uint32_t roastTimeMs;
+    uint32_t firstCrackTimeMs;
+    float chamberTemp;          // NAN on thermocouple fault
+    float heaterTemp;
+    float setpoint;
+    float ror;
+    int32_t profileLeadMs;      // Ahead (+) / behind (-) the reference; TELEMETRY_NULL_I32 if none
+    int32_t preheatEtaMs;       // Until preheat is ready; TELEMETRY_NULL_I32 if unknown
+    uint8_t stateId;
+    uint8_t fanSpeed;
+    uint8_t heaterPower;
+    uint8_t flags;
+};
+
+// ============== Field Table ==============
+
+enum class TelemetryCodec : uint8_t {
+    STATE_NAME,
+    U8,
+    U32,
+    DECI,
+    DECI_NULL,
+    FLAG,
+    U32_IF_FLAG,
+    I32_NULL
+};
+
+struct TelemetryField {
+    const char* key;
+    TelemetryCodec codec;
+    uint16_t offset;            // Of the member in TelemetrySample
+    uint8_t flag;
+    const char* description;
+};
+
+#define TELEMETRY_FIELD_ENTRY(key, member, codec, flag, description) \
+    { #key, TelemetryCodec::codec, (uint16_t)offsetof(TelemetrySample, member), flag, description },
+
+static constexpr TelemetryField TELEMETRY_FIELD_TABLE[] = { TELEMETRY_FIELDS(TELEMETRY_FIELD_ENTRY) };
+static constexpr size_t TELEMETRY_FIELD_COUNT = sizeof(TELEMETRY_FIELD_TABLE) / sizeof(TELEMETRY_FIELD_TABLE[0]);
+
+#undef TELEMETRY_FIELD_ENTRY
+
+// ============== Binary Layout ==============
+// [version u8][seq u32][timestamp u32][flags u8] then each field's bytes in
+// schema order, little-endian. The size is fixed per schema version.
+
+#define TELEMETRY_BINARY_VERSION    2
+#define TELEMETRY_BINARY_HEADER     10
+
+constexpr size_t telemetry_binary_width(TelemetryCodec codec) {
+    return codec == TelemetryCodec::U8 ? 1
+         : codec == TelemetryCodec::DECI || codec == TelemetryCodec::DECI_NULL ? 2
+         : codec == TelemetryCodec::U32 || codec == TelemetryCodec::U32_IF_FLAG ||
+           codec == TelemetryCodec::I32_NULL ? 4
+         : 0;
+}
+
+#define TELEMETRY_BINARY_WIDTH(key, member, codec, flag, description) \
+    + telemetry_binary_width(TelemetryCodec::codec)
+
+static constexpr size_t TELEMETRY_BINARY_SIZE = TELEMETRY_BINARY_HEADER TELEMETRY_FIELDS(TELEMETRY_BINARY_WIDTH);
+
+#undef TELEMETRY_BINARY_WIDTH
+
+#endif // TELEMETRY_SCHEMA_H
@@ -0,0 +1,116 @@
+#include "boot.h"
+#include "config.h"
+#include "hardware.h"
+#include "state.h"
+#include "checkpoint.h"
+#include "safety.h"
+#include "selftest.h"
+#include "serial_comm.h"
+
+// ============== Internal State ==============
+
+static uint32_t _phase_us[(int)BootPhase::COUNT] = {0};
+static bool _complete = false;
+static bool _resumed = false;
+static bool _sensors_settled = false;
+static bool _selftest_done = false;
+static bool _restore_pending = false;
+static RoastCheckpoint _checkpoint;
+static unsigned long _restore_wait_start = 0;
+
+// ============== Boot Sequence Implementation ==============
+
+void boot_mark(BootPhase phase) {
+    _phase_us[(int)phase] = micros();
+}
+
+void boot_update() {
+    if (_complete) {
+        return;
+    }
+
+    // MAX31855 needs one conversion period after power-up before data is valid
+    if (millis() < BOOT_SENSOR_SETTLE_MS) {
+        return;
+    }
+
+    if (!_sensors_settled) {
+        // Drop anything the filter picked up before the first valid conversion
+        thermocouple_reset_filter();
+        selftest_begin();
+        _sensors_settled = true;
+        boot_mark(BootPhase::SENSORS_READY);
+    }
+
+    if (!_selftest_done) {
+        // One self-test per loop so serial handling keeps running in between
+        if (!selftest_step()) {
+            return;
+        }
+        _selftest_done = true;
+
+        // Record every non-passing test in the fault history
+        for (int i = 0; i < (int)SelfTestId::COUNT; i++) {
+            const SelfTestResult& result = selftest_get_result((SelfTestId)i);
+            if (result.status == SelfTestStatus::WARN || result.status == SelfTestStatus::FAIL) {
+                char code[32];
+                snprintf(code, sizeof(code), "SELFTEST_%s", selftest_get_name((SelfTestId)i));
+                safety_record_fault(code, result.status == SelfTestStatus::FAIL);
+            }
+        }
+
+        serial_send_selftest();
+
+        if (!selftest_passed()) {
+            // Block heater use until the operator has seen the report
+            safety_trigger_fault("SELF_TEST_FAILED", "Boot self-test failed - see selfTest report", false);
+        } else if (checkpoint_load(_checkpoint)) {
+            _restore_pending = true;
+            _restore_wait_start = millis();
+        }
+    }
+
+    // Roast restore judges the outage by the chamber temperature, so it
+    // waits for the sampler's first valid conversion after the settle
+    if (_restore_pending) {
+        if (!thermocouple_has_reading() && millis() - _restore_wait_start < BOOT_RESTORE_WAIT_MS) {
+            return;
+        }
+        _restore_pending = false;
+        _resumed = state_resume(_checkpoint);
+    }
+
+    boot_mark(BootPhase::SELF_TEST_DONE);
+    _complete = true;
+
+    serial_send_boot_report();
+    if (state_is_resume_pending()) {
+        serial_send_event("RESUME_AVAILABLE", nullptr);
+    }
+}
+
+bool boot_is_complete() {
+    return _complete;
+}
+
+uint32_t boot_get_phase_us(BootPhase phase) {
+    return _phase_us[(int)phase];
+}
+
+const char* boot_get_phase_name(BootPhase phase) {
+    switch (phase) {
+        case BootPhase::OUTPUTS_SAFE:  return "outputsSafe";
+        case BootPhase::SERIAL_INIT:   return "serialInit";
+        case BootPhase::HARDWARE_INIT: return "hardwareInit";
+        case BootPhase::CONTROL_INIT:  return "controlInit";
+        case BootPhase::DISPLAY_INIT:  return "displayInit";
+        case BootPhase::SETUP_DONE:    return "setupDone";
+        case BootPhase::SENSORS_READY: return "sensorsReady";
+        case BootPhase::SELF_TEST_DONE: return "selfTestDone";
+        default:                       return "unknown";
+    }
+}
+
+bool boot_was_resumed() {
+    return _resumed;
+}
@@ -0,0 +1,37 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <Arduino.h>
+
+// ============== Boot Phases ==============
+enum class BootPhase {
+    OUTPUTS_SAFE = 0,   // Heater SSR and fan driven low
+    SERIAL_INIT,
+    HARDWARE_INIT,
+    CONTROL_INIT,       // PID, safety, state machine, checkpoint scan
+    DISPLAY_INIT,
+    SETUP_DONE,         // setup() returned - main loop running
+    SENSORS_READY,      // First thermocouple conversion available
+    SELF_TEST_DONE,     // Hardware self-test and roast restore finished
+    COUNT
+};
+
+// ============== Boot Sequence Interface ==============
+
+// Record the end of a boot phase (µs since reset)
+void boot_mark(BootPhase phase);
+
+// Run deferred boot work from the main loop (sensor probe, roast restore)
+// Returns immediately until the sensors have had time to settle; a roast
+// restore further waits for the first valid chamber reading
+void boot_update();
+
+// True once all deferred boot work has run
+bool boot_is_complete();
+
+// Boot timing accessors for reporting
+uint32_t boot_get_phase_us(BootPhase phase);
+const char* boot_get_phase_name(BootPhase phase);
+bool boot_was_resumed();
+
+#endif // BOOT_H
@@ -0,0 +1,65 @@
+#include "cascade.h"
+#include "config.h"
+#include "hardware.h"
+#include "serial_comm.h"
+
+// ============== Internal State ==============
+
+static float _element_target = CASCADE_ELEMENT_MIN;
+static float _integral = 0;             // Output counts
+static float _output = 0;
+static unsigned long _last_time = 0;
+static bool _ceiling_hit = false;
+
+// ============== Cascade Implementation ==============
+
+void cascade_reset() {
+    _integral = 0;
+    _output = 0;
+    _last_time = 0;
+    _ceiling_hit = false;
+}
+
+float cascade_update(float outer_output) {
+    unsigned long now = millis();
+    if (_last_time != 0 && now - _last_time < CASCADE_INNER_INTERVAL_MS) {
+        return _output;
+    }
+    float dt = _last_time ? (now - _last_time) / 1000.0 : 0;
+    _last_time = now;
+
+    float demand = constrain(outer_output, (float)PID_OUTPUT_MIN, (float)PID_OUTPUT_MAX) / PID_OUTPUT_MAX;
+    _element_target = CASCADE_ELEMENT_MIN + demand * (CASCADE_ELEMENT_CEILING - CASCADE_ELEMENT_MIN);
+
+    // Thermistor faults read 999, which lands here too - fail to heater off
+    float element = thermistor_read();
+    if (element >= CASCADE_ELEMENT_CEILING) {
+        if (!_ceiling_hit) {
+            char msg[64];
+            snprintf(msg, sizeof(msg), "Element at %.1f°C - ceiling, heater cut", element);
+            serial_send_log("warn", "CASCADE", msg);
+            _ceiling_hit = true;
+        }
+        _integral = 0;
+        _output = 0;
+        return _output;
+    }
+    _ceiling_hit = false;
+
+    float error = _element_target - element;
+    float p_term = CASCADE_INNER_KP * error;
+    float output = p_term + _integral + CASCADE_INNER_KI * error * dt;
+
+    // Integrate only while unsaturated (or unwinding), so full-power
+    // stretches don't leave a windup to overshoot the element with
+    if ((output < PID_OUTPUT_MAX || error < 0) && (output > PID_OUTPUT_MIN || error > 0)) {
+        _integral += CASCADE_INNER_KI * error * dt;
+    }
+
+    _output = constrain(p_term + _integral, (float)PID_OUTPUT_MIN, (float)PID_OUTPUT_MAX);
+    return _output;
+}
+
+float cascade_get_element_target() {
+    return _element_target;
+}
@@ -0,0 +1,23 @@
+#ifndef CASCADE_H
+#define CASCADE_H
+
+#include <Arduino.h>
+
+// ============== Cascade Heater Control ==============
+// Optional inner loop between the chamber PID and the SSR (PID_CASCADE_ENABLED).
+// The chamber PID output (0-255) becomes an element temperature target
+// between CASCADE_ELEMENT_MIN and CASCADE_ELEMENT_CEILING, and a fast PI on
+// the heater thermistor drives the SSR to it. The element can never be
+// asked past the ceiling, and is cut outright if it overshoots, so the
+// chamber loop can demand full power without risking the thermal fuse.
+
+// Clear the inner integrator (call with pid_reset())
+void cascade_reset();
+
+// Map the chamber PID output to SSR drive (0-255); call every loop
+float cascade_update(float outer_output);
+
+// Element temperature the inner loop is holding (°C)
+float cascade_get_element_target();
+
+#endif // CASCADE_H
@@ -0,0 +1,155 @@
+#include "checkpoint.h"
+#include "config.h"
+#include "state.h"
+#include "serial_comm.h"
+#include <EEPROM.h>
+
+// ============== Configuration ==============
+
+#define CHECKPOINT_MAGIC        0x4D435231  // "MCR1"
+
+// ============== Internal State ==============
+
+static RoastCheckpoint _last_written;
+static bool _have_last = false;
+static uint8_t _next_slot = 0;
+static uint32_t _generation = 0;
+static unsigned long _last_write_time = 0;
+
+// ============== Helpers ==============
+
+static uint32_t _crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t _checkpoint_crc(const RoastCheckpoint& ckpt) {
+    return _crc32((const uint8_t*)&ckpt, offsetof(RoastCheckpoint, crc));
+}
+
+static int _slot_address(uint8_t slot) {
+    return CHECKPOINT_EEPROM_BASE + slot * sizeof(RoastCheckpoint);
+}
+
+static bool _is_active_state(uint8_t stateId) {
+    return stateId == (uint8_t)RoasterState::PREHEAT ||
+           stateId == (uint8_t)RoasterState::ROASTING ||
+           stateId == (uint8_t)RoasterState::COOLING;
+}
+
+static bool _is_valid(const RoastCheckpoint& ckpt) {
+    if (ckpt.magic != CHECKPOINT_MAGIC) return false;
+    if (ckpt.crc != _checkpoint_crc(ckpt)) return false;
+    if (ckpt.stateId > (uint8_t)RoasterState::ERROR) return false;
+    if (ckpt.fanSpeed > FAN_MAX_DUTY) return false;
+    if (!(ckpt.setpoint >= 0 && ckpt.setpoint < MAX_CHAMBER_TEMP)) return false;
+    if (!(ckpt.preheatTarget >= 0 && ckpt.preheatTarget < MAX_CHAMBER_TEMP)) return false;
+    return true;
+}
+
+static void _capture(RoastCheckpoint& ckpt) {
+    memset(&ckpt, 0, sizeof(ckpt));
+    ckpt.magic = CHECKPOINT_MAGIC;
+    ckpt.stateId = (uint8_t)state_get_current();
+    ckpt.fanSpeed = state_get_fan_speed();
+    // While the offer is open, keep the roast's fan speed rather than cooling's
+    if (state_is_resume_pending()) {
+        ckpt.resumable = 1;
+        ckpt.fanSpeed = state_get_resume_fan_speed();
+    }
+    ckpt.firstCrackMarked = state_is_first_crack_marked() ? 1 : 0;
+    ckpt.setpoint = state_get_setpoint();
+    ckpt.preheatTarget = state_get_preheat_target();
+    ckpt.roastElapsedMs = state_get_roast_time_ms();
+    ckpt.firstCrackTimeMs = state_get_first_crack_time_ms();
+}
+
+static void _write(RoastCheckpoint& ckpt) {
+    ckpt.generation = ++_generation;
+    ckpt.crc = _checkpoint_crc(ckpt);
+
+    // EEPROM.put only rewrites bytes that changed; rotating slots spreads
+    // the remaining wear across CHECKPOINT_SLOTS records
+    EEPROM.put(_slot_address(_next_slot), ckpt);
+    _next_slot = (_next_slot + 1) % CHECKPOINT_SLOTS;
+
+    _last_written = ckpt;
+    _have_last = true;
+    _last_write_time = millis();
+}
+
+// ============== Checkpoint Implementation ==============
+
+void checkpoint_init() {
+    _have_last = false;
+    _next_slot = 0;
+    _generation = 0;
+    _last_write_time = 0;
+
+    for (uint8_t slot = 0; slot < CHECKPOINT_SLOTS; slot++) {
+        RoastCheckpoint ckpt;
+        EEPROM.get(_slot_address(slot), ckpt);
+        if (!_is_valid(ckpt)) continue;
+
+        if (!_have_last || ckpt.generation > _last_written.generation) {
+            _last_written = ckpt;
+            _have_last = true;
+            _generation = ckpt.generation;
+            _next_slot = (slot + 1) % CHECKPOINT_SLOTS;
+        }
+    }
+}
+
+bool checkpoint_load(RoastCheckpoint& out) {
+    if (!_have_last || !_is_active_state(_last_written.stateId)) {
+        return false;
+    }
+    out = _last_written;
+    return true;
+}
+
+void checkpoint_update() {
+    RoastCheckpoint now;
+    _capture(now);
+
+    bool active = _is_active_state(now.stateId);
+
+    // Nothing to do while idle once an inactive record is stored
+    if (!active && (!_have_last || !_is_active_state(_last_written.stateId))) {
+        return;
+    }
+
+    bool changed = !_have_last ||
+                   now.stateId != _last_written.stateId ||
+                   now.fanSpeed != _last_written.fanSpeed ||
+                   now.firstCrackMarked != _last_written.firstCrackMarked ||
+                   now.resumable != _last_written.resumable ||
+                   now.setpoint != _last_written.setpoint ||
+                   now.preheatTarget != _last_written.preheatTarget;
+
+    if (changed || millis() - _last_write_time >= CHECKPOINT_INTERVAL_MS) {
+        _write(now);
+    }
+}
+
+void checkpoint_clear() {
+    if (!_have_last || !_is_active_state(_last_written.stateId)) {
+        return;
+    }
+
+    RoastCheckpoint ckpt;
+    memset(&ckpt, 0, sizeof(ckpt));
+    ckpt.magic = CHECKPOINT_MAGIC;
+    ckpt.stateId = (uint8_t)RoasterState::OFF;
+    ckpt.setpoint = DEFAULT_ROAST_SETPOINT;
+    ckpt.preheatTarget = DEFAULT_PREHEAT_TEMP;
+    _write(ckpt);
+
+    serial_send_log("debug", "CKPT", "Roast checkpoint cleared");
+}
@@ -0,0 +1,41 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <Arduino.h>
+
+// ============== Roast Checkpoint ==============
+
+// Snapshot of an active roast persisted to EEPROM so a reset or brownout
+// mid-roast can be recovered on the next boot
+struct RoastCheckpoint {
+    uint32_t magic;
+    uint32_t generation;        // Incremented per write - newest valid slot wins
+    uint8_t stateId;            // RoasterState at time of write (OFF = no roast)
+    uint8_t fanSpeed;
+    uint8_t firstCrackMarked;
+    uint8_t resumable;          // Roast resume offer still open (survives a second reset)
+    float setpoint;
+    float preheatTarget;
+    uint32_t roastElapsedMs;    // Time since PREHEAT started
+    uint32_t firstCrackTimeMs;
+    uint32_t crc;               // CRC32 of all preceding fields
+};
+
+// ============== Checkpoint Interface ==============
+
+// Scan EEPROM slots for the newest valid checkpoint (call once at boot)
+void checkpoint_init();
+
+// Copy the newest valid checkpoint from the last scan
+// Returns false if none exists or it does not describe an active roast
+bool checkpoint_load(RoastCheckpoint& out);
+
+// Persist roast progress (call every loop iteration)
+// Writes on state/setpoint/first-crack changes and every CHECKPOINT_INTERVAL_MS
+// while a roast is active; writes a single inactive record when it ends
+void checkpoint_update();
+
+// Invalidate any stored roast so the next boot starts cold
+void checkpoint_clear();
+
+#endif // CHECKPOINT_H
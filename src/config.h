@@ -18,6 +18,9 @@
 // SSR Heater Control
 #define PIN_HEATER_SSR  6     // SSR control (PWM/digital)
 
+// Blower tachometer (open-collector, external interrupt pin)
+#define PIN_FAN_TACH    2
+
 // ============== Thermistor Constants ==============
 #define THERMISTOR_VCC          5.0       // Supply voltage
 #define THERMISTOR_R1           100000.0  // Fixed resistor (100kΩ)
@@ -43,10 +46,48 @@
 #define PID_OUTPUT_MIN          0.0
 #define PID_OUTPUT_MAX          255.0
 
+// ============== Cascade Control ==============
+// Chamber PID sets an element temperature, an inner PI on the thermistor
+// holds it (cascade.h). The chamber gains above then act on element °C
+// rather than SSR duty and may need retuning when this is enabled.
+#define PID_CASCADE_ENABLED     0         // 1 = chamber PID -> element target -> SSR
+#define CASCADE_ELEMENT_MIN     100.0     // °C - element target at chamber PID output 0
+#define CASCADE_ELEMENT_CEILING 280.0     // °C - element target at full output; SSR cut above
+#define CASCADE_INNER_INTERVAL_MS 200     // Inner loop period
+#define CASCADE_INNER_KP        6.0       // SSR counts (0-255) per °C of element error
+#define CASCADE_INNER_KI        1.5       // SSR counts per °C-second
+
+// ============== Preheat Strategy ==============
+// Full power to a switch point predicted from a learned plant model, coast,
+// then the PID holds (preheat.h). The model defaults below are only used
+// until the first preheat completes; learned values live in EEPROM.
+#define PREHEAT_MIN_TIME_ENABLED 1        // 0 = PID from the start (ready detection still runs)
+#define PREHEAT_READY_BAND      3.0       // °C either side of the target counted as ready
+#define PREHEAT_READY_HOLD_MS   30000     // Time within the band before PREHEAT_READY
+#define PREHEAT_SWITCH_MARGIN   2.0       // °C short of the predicted coast, for model error
+#define PREHEAT_PEAK_DROP       0.5       // °C below the coast peak that ends the coast
+#define PREHEAT_RATE_WINDOW_MS  5000      // Full-power rise measurement period
+#define PREHEAT_MODEL_RATE      0.5       // °C/s at full power near the target
+#define PREHEAT_MODEL_LAG_S     20.0      // s of rise after the heater cuts
+#define PREHEAT_MODEL_HOLD      90.0      // PID output (0-255) that holds the target
+#define PREHEAT_MODEL_EEPROM    512       // EEPROM byte offset of the learned model
+
+// ============== Coordinated Fan/Heater ==============
+// While ROASTING the fan helps the heater hold the setpoint (coordinated.h):
+// fan moves are fed forward to the PID, and a saturated heater borrows
+// airflow within COORD_FAN_RANGE of the operator's speed.
+#define COORD_CONTROL_ENABLED   0         // 1 = fan as second actuator while roasting
+#define COORD_INTERVAL_MS       1000      // Coordinator period
+#define COORD_FAN_STEP          2         // % fan per tick while borrowing or returning
+#define COORD_FAN_RANGE         20        // % either side of the operator's fan speed
+#define COORD_TEMP_BAND         2.0       // °C error tolerated before the fan is used
+#define COORD_FAN_HEAT_GAIN     2.0       // PID output counts per % fan (decoupler)
+
 // ============== Safety Limits ==============
 #define MAX_CHAMBER_TEMP        260.0     // °C - absolute max chamber temp
 #define WARN_CHAMBER_TEMP       250.0     // °C - warning threshold
 #define MIN_FAN_WHEN_HEATING    40        // % - minimum fan when heater enabled
+#define FAULT_HISTORY_SIZE      8         // Recent faults retained for getFaultHistory
 
 // ============== Temperature Targets ==============
 #define DEFAULT_PREHEAT_TEMP    180.0     // °C - default preheat target
@@ -54,12 +95,14 @@
 #define COOLING_TARGET_TEMP     50.0      // °C - temp to consider cooling complete
 
 // ============== Timing ==============
-#define TEMP_READ_INTERVAL_MS   1000      // Read temperature every 1 second
 #define STATE_SEND_INTERVAL_MS  1000      // Send state update every 1 second
 #define PREHEAT_TIMEOUT_MS      900000    // 15 minutes max preheat time
 #define PID_WINDOW_SIZE_MS      2000      // 2 second PWM window for heater
 #define DISCONNECT_TIMEOUT_MS   5000      // 5 seconds before auto-cooling on disconnect
 #define COMMAND_COOLDOWN_MS     100       // Minimum time between commands
+#define BOOT_SENSOR_SETTLE_MS   100       // MAX31855 first conversion after power-up
+#define BOOT_RESTORE_WAIT_MS    3000      // Max wait for a valid chamber reading before roast restore
+#define SELFTEST_BUDGET_US      2000      // Max time per boot self-test step
 
 // ============== Fan Limits ==============
 #define FAN_MIN_DUTY            0         // % - minimum fan speed
@@ -69,13 +112,87 @@
 #define FAN_COOLING_DUTY        100       // % - during cooling (max)
 #define FAN_ROAST_MIN_DUTY      30        // % - minimum while roasting
 
+// ============== Fan Output ==============
+#define FAN_PWM_FREQ_HZ         20000     // GPT carrier on ENA - above hearing, within the L298N's range
+#define FAN_PWM_CLOCK_HZ        48000000  // GPT count clock (PCLKD, undivided) - 2400 steps at 20 kHz
+#define FAN_DUTY_FULL           65535     // Full scale of fan_set_duty()
+#define FAN_SLEW_PERCENT_PER_S  50        // Output ramp rate (0 -> 100% in 2 s)
+#define FAN_KICK_BELOW_DUTY     26214     // Starts from rest below 40% get a kick-start...
+#define FAN_KICK_DUTY           45875     // ...of 70%...
+#define FAN_KICK_MS             300       // ...for this long
+
+// ============== Fan Speed Loop ==============
+#define FAN_TACH_ENABLED        0         // 1 once the blower tach is wired to PIN_FAN_TACH
+#define FAN_TACH_PULSES_PER_REV 2         // Tach edges per revolution
+#define FAN_TACH_MIN_PERIOD_US  500       // Shorter edge spacing is noise (> 60000 RPM)
+#define FAN_TACH_TIMEOUT_US     500000    // No edge for this long = 0 RPM
+#define FAN_MAX_RPM             3000      // RPM at 100% - the speed target is percent of this
+#define FAN_CONTROL_INTERVAL_MS 100       // PI update period
+#define FAN_SPEED_KP            4.0       // Duty counts per RPM of error
+#define FAN_SPEED_KI            8.0       // Duty counts per RPM-second of error
+#define FAN_TRIM_MAX            16384     // PI correction limit around the commanded duty (25%)
+#define FAN_SPINUP_MS           3000      // Grace after a start or speed change before judging speed
+#define FAN_STALL_MS            1000      // 0 RPM for this long while driven = stalled
+#define FAN_UNDERSPEED_RATIO    0.6       // Below this fraction of target...
+#define FAN_UNDERSPEED_MS       3000      // ...for this long = underspeed
+
 // ============== Temperature Filtering ==============
-#define LPF_ALPHA               0.15      // Low-pass filter coefficient (0.0-1.0)
-                                          // Lower = smoother, slower response
+#define LPF_TIME_CONSTANT_MS    1500      // Low-pass filter time constant (weighted by actual dt)
+                                          // Lower = faster response, noisier
+
+// ============== Temperature Sampling ==============
+// Thermocouple reads are scheduled by sampling.cpp, fast where the roast
+// moves quickly and slow where nothing happens; everything else uses the
+// latest sample.
+#define SAMPLE_FAST_MS          50        // 20 Hz - charge, setpoint crossings, first crack
+#define SAMPLE_NORMAL_MS        250       // 4 Hz - heating, cooling, manual
+#define SAMPLE_SLOW_MS          1000      // 1 Hz - OFF, FAN_ONLY, ERROR and steady holds
+#define SAMPLE_CHARGE_MS        90000     // Fast after charge (through the turning point)
+#define SAMPLE_CROSSING_BAND    5.0       // °C from the setpoint counted as a crossing...
+#define SAMPLE_HOLD_ROR         3.0       // ...unless |RoR| (°C/min) is below this - a steady hold
+#define SAMPLE_FC_APPROACH_TEMP 190.0     // °C chamber - fast from here until first crack is marked
+#define SAMPLE_FC_AFTER_MS      60000     // Fast this long after first crack is marked
+#define SAMPLE_SSR_GUARD_MS     20        // Keep reads this far from SSR switching (0 = don't align)
+
+// ============== Self-Test Limits ==============
+#define SELFTEST_CJ_MIN_TEMP    -10.0     // °C - plausible cold junction (board ambient)
+#define SELFTEST_CJ_MAX_TEMP    70.0      // °C
+#define SELFTEST_ADC_OPEN_MAX   5         // Thermistor ADC at or below = open circuit
+#define SELFTEST_ADC_SHORT_MIN  1018      // Thermistor ADC at or above = short circuit
 
 // ============== Rate of Rise ==============
 #define ROR_SAMPLE_INTERVAL_MS  30000     // 30 seconds between RoR calculations
 
+// ============== Telemetry ==============
+#define TELEMETRY_RING_SIZE     120       // Sequenced samples retained for resend (~2 min at 1 Hz)
+#define TELEMETRY_RESEND_BURST  4         // Max replayed frames sent per serial_comm_update()
+
+// ============== Transport ==============
+#define TRANSPORT_FRAME_SIZE    768       // Max bytes per outbound NDJSON line
+#define TRANSPORT_SINK_QUEUE    3         // Frames queued per network client
+#define TRANSPORT_MAX_SINKS     (1 + WIFI_MAX_CLIENTS)  // USB + network clients
+#define TRANSPORT_FRAME_POOL    (WIFI_MAX_CLIENTS * TRANSPORT_SINK_QUEUE + 1)
+#define WIFI_SERVER_PORT        81        // TCP/WebSocket server (docs/websocket-schema.md)
+#define WIFI_MAX_CLIENTS        2         // Concurrent network clients
+#define WIFI_RETRY_INTERVAL_MS  30000     // Reconnect attempt interval (only while OFF)
+#define WIFI_JOIN_TIMEOUT_MS    15000     // Give up on a join that has not associated
+#define WIFI_STATUS_POLL_MS     500       // Link status query interval (one modem round trip)
+#define WIFI_HOSTNAME           "mcroaster"  // mDNS name (mcroaster.local)
+
+// ============== Artisan TC4 Protocol ==============
+#define TC4_AUTODETECT          1         // 1 = a link whose lines start A-Z speaks TC4 (Artisan) instead of NDJSON
+
+// ============== Roast Checkpoint ==============
+#define CHECKPOINT_INTERVAL_MS  5000      // Persist roast progress every 5 seconds
+#define CHECKPOINT_SLOTS        8         // Rotating EEPROM slots (spreads flash wear)
+#define CHECKPOINT_EEPROM_BASE  0         // EEPROM byte offset of slot 0
+#define RESUME_WINDOW_MS        60000     // Time operator has to confirm a roast resume
+
+// ============== Profile Replay ==============
+#define PROFILE_MAX_POINTS      360       // Reference curve points (30 min at 5 s)
+#define PROFILE_MAX_FAN_EVENTS  32        // Recorded fan changes replayed after charge
+#define PROFILE_MIN_STEP_MS     1000      // Finest point spacing accepted
+
 // ============== Firmware ==============
 #define FIRMWARE_VERSION        "3.0.0"   // WebSerial version
 
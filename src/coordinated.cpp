@@ -0,0 +1,70 @@
+#include "coordinated.h"
+#include "config.h"
+#include "hardware.h"
+#include "pid_control.h"
+
+// ============== Internal State ==============
+
+static uint8_t _operator_fan = FAN_ROAST_DEFAULT;   // Where the fan returns to
+static uint8_t _fan = FAN_ROAST_DEFAULT;            // What the coordinator commands
+static unsigned long _last_update = 0;
+
+// ============== Coordination ==============
+
+#if COORD_CONTROL_ENABLED
+// Move the fan and pre-compensate the heater for the changed heat loss
+static void _apply(int fan) {
+    fan = constrain(fan, FAN_ROAST_MIN_DUTY, FAN_MAX_DUTY);
+    if (fan == _fan) return;
+    pid_bias_output(COORD_FAN_HEAT_GAIN * (fan - _fan));
+    _fan = fan;
+    fan_set_speed(fan);
+}
+#endif
+
+void coord_reset(uint8_t operator_fan) {
+    _operator_fan = operator_fan;
+    _fan = operator_fan;
+    _last_update = millis();
+}
+
+void coord_set_operator_fan(uint8_t percent) {
+    _operator_fan = percent;
+#if COORD_CONTROL_ENABLED
+    _apply(percent);
+#else
+    _fan = percent;
+    fan_set_speed(percent);
+#endif
+}
+
+void coord_update(float chamber_temp, float setpoint) {
+#if COORD_CONTROL_ENABLED
+    unsigned long now = millis();
+    if (now - _last_update < COORD_INTERVAL_MS) {
+        return;
+    }
+    _last_update = now;
+
+    float output = pid_get_output();
+    float error = setpoint - chamber_temp;
+    int fan = _fan;
+
+    if (output >= PID_OUTPUT_MAX * 0.95 && error > COORD_TEMP_BAND) {
+        // Heater flat out and still short - less airflow loses less heat
+        fan -= COORD_FAN_STEP;
+    } else if (output <= PID_OUTPUT_MAX * 0.05 && error < -COORD_TEMP_BAND) {
+        // Heater off and still hot - shed heat with more airflow
+        fan += COORD_FAN_STEP;
+    } else if (output > PID_OUTPUT_MAX * 0.2 && output < PID_OUTPUT_MAX * 0.8) {
+        // Heater has authority again - hand the fan back a step at a time
+        fan += constrain((int)_operator_fan - fan, -COORD_FAN_STEP, COORD_FAN_STEP);
+    }
+
+    fan = constrain(fan, (int)_operator_fan - COORD_FAN_RANGE, (int)_operator_fan + COORD_FAN_RANGE);
+    _apply(fan);
+#else
+    (void)chamber_temp;
+    (void)setpoint;
+#endif
+}
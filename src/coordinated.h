@@ -0,0 +1,33 @@
+#ifndef COORDINATED_H
+#define COORDINATED_H
+
+#include <Arduino.h>
+
+// ============== Coordinated Fan/Heater Control ==============
+// While ROASTING (COORD_CONTROL_ENABLED), the fan becomes a second
+// actuator for the chamber setpoint instead of a knob the PID fights:
+//
+//   - decoupling: every fan move shifts the PID output by
+//     COORD_FAN_HEAT_GAIN per percent, so the heater compensates for the
+//     change in convective loss before the temperature moves
+//   - mid-ranging: when the heater saturates and the error stays outside
+//     COORD_TEMP_BAND, the fan steps toward less (heater flat out) or more
+//     (heater off) airflow, within COORD_FAN_RANGE of the operator's
+//     speed and never below FAN_ROAST_MIN_DUTY for bed agitation
+//   - once the heater has authority again the fan walks back to the
+//     operator's (or profile's) speed
+//
+// One comparison chain per COORD_INTERVAL_MS tick - bounded time on the MCU.
+// Setpoint trajectories (profile replay) carry the RoR target.
+
+// Start a roast around this fan speed (ROASTING entry)
+void coord_reset(uint8_t operator_fan);
+
+// Operator or profile fan while ROASTING - applied directly when
+// coordination is off, otherwise the speed the coordinator returns to
+void coord_set_operator_fan(uint8_t percent);
+
+// One control tick, after the PID has run (call every loop while ROASTING)
+void coord_update(float chamber_temp, float setpoint);
+
+#endif // COORDINATED_H
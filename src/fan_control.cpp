@@ -0,0 +1,119 @@
+#include "fan_control.h"
+#include "config.h"
+#include "hardware.h"
+#include "serial_comm.h"
+
+// ============== Internal State ==============
+
+static uint16_t _target_rpm = 0;
+static float _integral = 0;             // Duty counts
+static unsigned long _last_update = 0;
+static unsigned long _target_changed = 0;   // Start of the spin-up grace
+static unsigned long _stopped_since = 0;    // 0 while turning
+static unsigned long _slow_since = 0;       // 0 while at speed
+static bool _stalled = false;
+static bool _underspeed = false;
+
+// ============== Speed Checks ==============
+
+static void _set_stalled(bool stalled) {
+    if (stalled == _stalled) return;
+    _stalled = stalled;
+    serial_send_log(stalled ? "error" : "info", "FAN", stalled ? "Fan stalled" : "Fan turning again");
+}
+
+static void _set_underspeed(bool underspeed, uint16_t rpm) {
+    if (underspeed == _underspeed) return;
+    _underspeed = underspeed;
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Fan %s: %u of %u RPM", underspeed ? "underspeed" : "back to speed",
+             rpm, _target_rpm);
+    serial_send_log(underspeed ? "warn" : "info", "FAN", msg);
+}
+
+// Time-qualified so spin-up, kick-start and tach jitter don't trip them
+static void _check_speed(uint16_t rpm, unsigned long now) {
+    if (_target_rpm == 0 || now - _target_changed < FAN_SPINUP_MS) {
+        _stopped_since = 0;
+        _slow_since = 0;
+        _set_stalled(false);
+        _set_underspeed(false, rpm);
+        return;
+    }
+
+    if (rpm == 0) {
+        if (_stopped_since == 0) _stopped_since = now;
+    } else {
+        _stopped_since = 0;
+    }
+    _set_stalled(_stopped_since != 0 && now - _stopped_since >= FAN_STALL_MS);
+
+    if (rpm < _target_rpm * FAN_UNDERSPEED_RATIO) {
+        if (_slow_since == 0) _slow_since = now;
+    } else {
+        _slow_since = 0;
+    }
+    _set_underspeed(_slow_since != 0 && now - _slow_since >= FAN_UNDERSPEED_MS, rpm);
+}
+
+// ============== Fan Speed Loop Implementation ==============
+
+void fan_control_init() {
+    _target_rpm = 0;
+    _integral = 0;
+    _last_update = millis();
+    _target_changed = _last_update;
+    _stopped_since = 0;
+    _slow_since = 0;
+    _stalled = false;
+    _underspeed = false;
+}
+
+void fan_control_update() {
+#if FAN_TACH_ENABLED
+    unsigned long now = millis();
+    if (now - _last_update < FAN_CONTROL_INTERVAL_MS) {
+        return;
+    }
+    float dt = (now - _last_update) / 1000.0;
+    _last_update = now;
+
+    uint16_t target = fan_is_enabled() ? (uint32_t)fan_get_speed() * FAN_MAX_RPM / 100 : 0;
+    if (target != _target_rpm) {
+        // Only a speed-up needs fresh grace; slowing down can't look like a stall
+        if (target > _target_rpm) _target_changed = now;
+        _target_rpm = target;
+    }
+
+    uint16_t rpm = fan_get_rpm();
+    _check_speed(rpm, now);
+
+    if (_target_rpm == 0) {
+        _integral = 0;
+        return;
+    }
+
+    float error = (float)_target_rpm - rpm;
+    // The output ramp is what limits speed while it runs - don't wind up on it
+    if (!fan_is_ramping()) {
+        _integral += FAN_SPEED_KI * error * dt;
+    }
+    _integral = constrain(_integral, -(float)FAN_TRIM_MAX, (float)FAN_TRIM_MAX);
+
+    float trim = constrain((float)(FAN_SPEED_KP * error) + _integral, -(float)FAN_TRIM_MAX, (float)FAN_TRIM_MAX);
+    float duty = constrain(fan_get_duty() + trim, 0.0f, (float)FAN_DUTY_FULL);
+    fan_set_output_duty((uint16_t)duty);
+#endif
+}
+
+uint16_t fan_control_get_target_rpm() {
+    return _target_rpm;
+}
+
+bool fan_control_is_stalled() {
+    return _stalled;
+}
+
+bool fan_control_is_underspeed() {
+    return _underspeed;
+}
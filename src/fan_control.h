@@ -0,0 +1,30 @@
+#ifndef FAN_CONTROL_H
+#define FAN_CONTROL_H
+
+#include <Arduino.h>
+
+// ============== Fan Speed Loop Interface ==============
+// Inner PI loop that holds the blower at the commanded speed using the
+// tach, so airflow no longer drifts with supply voltage, bean load and
+// motor temperature. The commanded percent (fan_set_speed) becomes an
+// RPM target of percent x FAN_MAX_RPM; the commanded duty is the
+// feed-forward and the loop trims around it by up to FAN_TRIM_MAX.
+// Without FAN_TACH_ENABLED the fan stays open-loop and never reports a
+// stall.
+
+// Initialize the loop (open-loop until the fan is driven)
+void fan_control_init();
+
+// Run the PI update and stall checks (call every loop iteration)
+void fan_control_update();
+
+// Current RPM target (0 when the fan is off)
+uint16_t fan_control_get_target_rpm();
+
+// Blower not turning although driven (after the spin-up grace)
+bool fan_control_is_stalled();
+
+// Blower turning well below its target (after the spin-up grace)
+bool fan_control_is_underspeed();
+
+#endif // FAN_CONTROL_H
@@ -2,65 +2,139 @@
 #include "config.h"
 #include "serial_comm.h"
 #include <SPI.h>
+#include <pwm.h>
 
 // ============== Internal State ==============
 
 // Fan state
 static bool _fan_enabled = false;
 static uint8_t _fan_speed = 0;  // 0-100%
-
-// Debug: track actual PWM value written
-static uint8_t _fan_pwm_written = 0;
+static uint16_t _fan_duty = 0;  // 0-FAN_DUTY_FULL, applied while enabled
+
+// ENA is driven by a GPT channel at FAN_PWM_FREQ_HZ; one duty step per
+// timer count. analogWrite() is the fallback if the channel won't start.
+static PwmOut _fan_pwm(PIN_FAN_ENA);
+static const uint32_t _fan_period_counts = FAN_PWM_CLOCK_HZ / FAN_PWM_FREQ_HZ;
+static bool _fan_pwm_started = false;
+
+// Debug: track actual duty written
+static uint16_t _fan_duty_written = 0;
+
+// Output stage: the written duty follows the requested one at no more than
+// FAN_SLEW_PERCENT_PER_S, after a kick-start pulse when starting from rest
+static uint16_t _fan_output_target = 0;
+static unsigned long _fan_ramp_last = 0;
+static bool _fan_kicking = false;
+static unsigned long _fan_kick_start = 0;
+
+#if FAN_TACH_ENABLED
+// Tachometer: the ISR timestamps falling edges; RPM comes from their spacing
+static volatile uint32_t _tach_last_us = 0;
+static volatile uint32_t _tach_period_us = 0;
+static volatile uint32_t _tach_pulses = 0;
+#endif
 
 // Heater state
 static bool _heater_enabled = false;
 static uint8_t _heater_power = 0;    // 0-100% for display
 static float _heater_pid_output = 0; // 0-255 from PID
 static unsigned long _heater_window_start = 0;
+static bool _ssr_on = false;
+static unsigned long _ssr_edge_time = 0;    // Last SSR switch (0 = never)
 
 // Thermocouple state
 static uint8_t _thermo_fault = 0;
+static float _cold_junction = NAN;   // From the last thermocouple_read() frame
 static float _filtered_temp = 0;
 static bool _filter_initialized = false;
+static unsigned long _filter_time = 0;      // Last sample that reached the filter
+static unsigned long _last_sample_ms = 0;
+static uint32_t _sample_count = 0;
+static float _sample_prev[2] = { NAN, NAN };    // Last two raw reads, newest first
+static ThermocoupleStats _stats[2];             // [0] heater off, [1] heater on
 
 // Rate of Rise state
 static float _ror_last_temp = 0;
 static unsigned long _ror_last_time = 0;
 static float _ror_value = 0;
 
-// ============== Initialization ==============
+// ============== Fan Output ==============
 
-void hardware_init() {
-    serial_send_log("info", "HW", "Hardware init starting");
+static void _fan_write(uint16_t duty) {
+    if (_fan_pwm_started) {
+        _fan_pwm.pulseWidth_raw((uint32_t)duty * _fan_period_counts / FAN_DUTY_FULL);
+    } else {
+        analogWrite(PIN_FAN_ENA, duty >> 8);
+    }
+    _fan_duty_written = duty;
+}
 
-    // Initialize SPI for MAX31855
-    pinMode(PIN_THERMO_CS, OUTPUT);
-    digitalWrite(PIN_THERMO_CS, HIGH);
-    SPI.begin();
-    serial_send_log("debug", "HW", "SPI initialized for thermocouple");
+#if FAN_TACH_ENABLED
+static void _tach_isr() {
+    uint32_t now = micros();
+    uint32_t period = now - _tach_last_us;
+    if (period < FAN_TACH_MIN_PERIOD_US) return;
+    _tach_period_us = period;
+    _tach_last_us = now;
+    _tach_pulses++;
+}
+#endif
+
+// Requested output duty; fan_update() moves the pin there
+static void _fan_request(uint16_t duty) {
+    // A low duty may not break the blower free from rest - pulse it first
+    if (_fan_duty_written == 0 && !_fan_kicking && duty > 0 && duty < FAN_KICK_BELOW_DUTY) {
+        _fan_write(FAN_KICK_DUTY);
+        _fan_kicking = true;
+        _fan_kick_start = millis();
+    }
+    _fan_output_target = duty;
+}
 
-    // Initialize fan pins (L298N)
-    char msg[64];
-    snprintf(msg, sizeof(msg), "Fan pins: ENA=%d IN1=%d IN2=%d", PIN_FAN_ENA, PIN_FAN_IN1, PIN_FAN_IN2);
-    serial_send_log("debug", "HW", msg);
+// ============== Initialization ==============
 
-    pinMode(PIN_FAN_ENA, OUTPUT);
+void hardware_safe_outputs() {
+    // Heater first - the SSR must never float high after reset
+    digitalWrite(PIN_HEATER_SSR, LOW);
+    pinMode(PIN_HEATER_SSR, OUTPUT);
+    digitalWrite(PIN_HEATER_SSR, LOW);
+
+    // Fan off (L298N both direction inputs low = coast)
     pinMode(PIN_FAN_IN1, OUTPUT);
     pinMode(PIN_FAN_IN2, OUTPUT);
-
-    // Start with fan off
     digitalWrite(PIN_FAN_IN1, LOW);
     digitalWrite(PIN_FAN_IN2, LOW);
-    analogWrite(PIN_FAN_ENA, 0);
-    _fan_pwm_written = 0;
+    if (_fan_pwm_started) {
+        _fan_write(0);
+    } else {
+        // Plain GPIO - analogWrite() here would claim ENA's GPT channel
+        // before hardware_init() can hand it to the PwmOut carrier
+        pinMode(PIN_FAN_ENA, OUTPUT);
+        digitalWrite(PIN_FAN_ENA, LOW);
+        _fan_duty_written = 0;
+    }
 
-    serial_send_log("debug", "HW", "Fan pins configured, initial state LOW");
+    // Deselect the thermocouple amplifier
+    pinMode(PIN_THERMO_CS, OUTPUT);
+    digitalWrite(PIN_THERMO_CS, HIGH);
+}
 
-    // Initialize heater SSR pin
-    pinMode(PIN_HEATER_SSR, OUTPUT);
-    digitalWrite(PIN_HEATER_SSR, LOW);
-    snprintf(msg, sizeof(msg), "Heater SSR pin %d configured", PIN_HEATER_SSR);
-    serial_send_log("debug", "HW", msg);
+void hardware_init() {
+    hardware_safe_outputs();
+
+    // Move ENA from analogWrite() to the high-frequency GPT carrier
+    _fan_pwm_started = _fan_pwm.begin(_fan_period_counts, 0, true);
+    if (!_fan_pwm_started) {
+        serial_send_log("warn", "HW", "Fan GPT PWM unavailable - using analogWrite");
+    }
+
+#if FAN_TACH_ENABLED
+    pinMode(PIN_FAN_TACH, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(PIN_FAN_TACH), _tach_isr, FALLING);
+#endif
+
+    // Initialize SPI for MAX31855
+    SPI.begin();
 
     // Initialize thermistor pin
     pinMode(PIN_THERMISTOR, INPUT);
@@ -68,7 +142,10 @@ void hardware_init() {
     // Initialize heater window
     _heater_window_start = millis();
 
-    serial_send_log("info", "HW", "Hardware init complete");
+    char msg[80];
+    snprintf(msg, sizeof(msg), "Hardware ready (SSR=%d ENA=%d IN1=%d IN2=%d CS=%d)",
+             PIN_HEATER_SSR, PIN_FAN_ENA, PIN_FAN_IN1, PIN_FAN_IN2, PIN_THERMO_CS);
+    serial_send_log("info", "HW", msg);
 }
 
 // ============== Fan Control ==============
@@ -78,45 +155,126 @@ void fan_enable() {
     // Set direction (forward)
     digitalWrite(PIN_FAN_IN1, HIGH);
     digitalWrite(PIN_FAN_IN2, LOW);
-    // Apply current speed
-    uint8_t pwm = map(_fan_speed, 0, 100, 0, 255);
-    analogWrite(PIN_FAN_ENA, pwm);
-    _fan_pwm_written = pwm;
+    // Ramp up to the current speed (fan_update)
+    _fan_request(_fan_duty);
 
     char msg[64];
-    snprintf(msg, sizeof(msg), "Fan enabled at %d%% (PWM=%d)", _fan_speed, pwm);
+    snprintf(msg, sizeof(msg), "Fan enabled at %d%% (duty=%u)", _fan_speed, _fan_duty);
     serial_send_log("info", "HW", msg);
 }
 
 void fan_disable() {
+    // Cutting drive is always safe - no ramp down
     _fan_enabled = false;
+    _fan_kicking = false;
+    _fan_output_target = 0;
     digitalWrite(PIN_FAN_IN1, LOW);
     digitalWrite(PIN_FAN_IN2, LOW);
-    analogWrite(PIN_FAN_ENA, 0);
-    _fan_pwm_written = 0;
+    _fan_write(0);
     serial_send_log("info", "HW", "Fan disabled");
 }
 
 void fan_set_speed(uint8_t percent) {
     if (percent > 100) percent = 100;
-    _fan_speed = percent;
+    fan_set_duty((uint32_t)percent * FAN_DUTY_FULL / 100);
 
     char msg[64];
     if (_fan_enabled) {
-        uint8_t pwm = map(percent, 0, 100, 0, 255);
-        analogWrite(PIN_FAN_ENA, pwm);
-        _fan_pwm_written = pwm;
-        snprintf(msg, sizeof(msg), "Fan speed set to %d%% (PWM=%d)", percent, pwm);
+        snprintf(msg, sizeof(msg), "Fan speed set to %d%% (duty=%u)", percent, _fan_duty);
     } else {
         snprintf(msg, sizeof(msg), "Fan speed set to %d%% (pending - fan disabled)", percent);
     }
     serial_send_log("debug", "HW", msg);
 }
 
+void fan_set_duty(uint16_t duty) {
+    _fan_duty = duty;
+    _fan_speed = ((uint32_t)duty * 100 + FAN_DUTY_FULL / 2) / FAN_DUTY_FULL;
+    if (_fan_enabled) {
+        _fan_request(duty);
+    }
+}
+
 uint8_t fan_get_speed() {
     return _fan_speed;
 }
 
+uint16_t fan_get_duty() {
+    return _fan_duty;
+}
+
+void fan_set_output_duty(uint16_t duty) {
+    if (_fan_enabled) {
+        _fan_request(duty);
+    }
+}
+
+void fan_update() {
+    unsigned long now = millis();
+
+    if (_fan_kicking) {
+        if (now - _fan_kick_start < FAN_KICK_MS) return;
+        // Pulse over - drop straight to the requested duty
+        _fan_kicking = false;
+        _fan_write(_fan_output_target);
+    }
+
+    if (!_fan_enabled || _fan_duty_written == _fan_output_target) {
+        _fan_ramp_last = now;
+        return;
+    }
+
+    // Keep the timestamp until a whole count is due, so a fast loop still moves
+    uint32_t step = (uint32_t)FAN_DUTY_FULL * FAN_SLEW_PERCENT_PER_S / 100 * (now - _fan_ramp_last) / 1000;
+    if (step == 0) return;
+    _fan_ramp_last = now;
+
+    uint16_t current = _fan_duty_written;
+    if (_fan_output_target > current) {
+        _fan_write((uint32_t)(_fan_output_target - current) > step ? current + step : _fan_output_target);
+    } else {
+        _fan_write((uint32_t)(current - _fan_output_target) > step ? current - step : _fan_output_target);
+    }
+}
+
+void fan_skip_ramp() {
+    if (!_fan_enabled) return;
+    _fan_kicking = false;
+    _fan_write(_fan_output_target);
+}
+
+bool fan_is_ramping() {
+    return _fan_kicking || (_fan_enabled && _fan_duty_written != _fan_output_target);
+}
+
+uint16_t fan_get_output_duty() {
+    return _fan_duty_written;
+}
+
+uint16_t fan_get_rpm() {
+#if FAN_TACH_ENABLED
+    noInterrupts();
+    uint32_t last = _tach_last_us;
+    uint32_t period = _tach_period_us;
+    interrupts();
+
+    if (period == 0 || micros() - last > FAN_TACH_TIMEOUT_US) {
+        return 0;
+    }
+    return (uint16_t)(60000000UL / ((uint32_t)FAN_TACH_PULSES_PER_REV * period));
+#else
+    return 0;
+#endif
+}
+
+uint32_t fan_get_tach_pulses() {
+#if FAN_TACH_ENABLED
+    return _tach_pulses;
+#else
+    return 0;
+#endif
+}
+
 bool fan_is_enabled() {
     return _fan_enabled;
 }
@@ -124,8 +282,14 @@ bool fan_is_enabled() {
 void fan_debug_dump() {
     char msg[128];
     serial_send_log("debug", "HW", "=== FAN DEBUG DUMP ===");
-    snprintf(msg, sizeof(msg), "Fan enabled: %s, speed: %d%%, PWM written: %d",
-             _fan_enabled ? "YES" : "NO", _fan_speed, _fan_pwm_written);
+    snprintf(msg, sizeof(msg), "Fan enabled: %s, speed: %d%%, duty written: %u",
+             _fan_enabled ? "YES" : "NO", _fan_speed, _fan_duty_written);
+    serial_send_log("debug", "HW", msg);
+    snprintf(msg, sizeof(msg), "PWM: %s, %lu Hz, %lu counts/period", _fan_pwm_started ? "GPT" : "analogWrite",
+             (unsigned long)FAN_PWM_FREQ_HZ, (unsigned long)_fan_period_counts);
+    serial_send_log("debug", "HW", msg);
+    snprintf(msg, sizeof(msg), "Tach: %u RPM, %lu pulses (%s)", fan_get_rpm(), (unsigned long)fan_get_tach_pulses(),
+             FAN_TACH_ENABLED ? "enabled" : "disabled in config.h");
     serial_send_log("debug", "HW", msg);
     snprintf(msg, sizeof(msg), "Pins: ENA=%d IN1=%d IN2=%d", PIN_FAN_ENA, PIN_FAN_IN1, PIN_FAN_IN2);
     serial_send_log("debug", "HW", msg);
@@ -135,12 +299,12 @@ void fan_debug_dump() {
     if (_fan_enabled) {
         digitalWrite(PIN_FAN_IN1, HIGH);
         digitalWrite(PIN_FAN_IN2, LOW);
-        analogWrite(PIN_FAN_ENA, _fan_pwm_written);
+        _fan_write(_fan_duty_written);
         serial_send_log("debug", "HW", "Wrote: IN1=HIGH, IN2=LOW, ENA=PWM");
     } else {
         digitalWrite(PIN_FAN_IN1, LOW);
         digitalWrite(PIN_FAN_IN2, LOW);
-        analogWrite(PIN_FAN_ENA, 0);
+        _fan_write(0);
         serial_send_log("debug", "HW", "Wrote: IN1=LOW, IN2=LOW, ENA=0");
     }
 }
@@ -157,7 +321,7 @@ void fan_test_direct() {
     // Set all HIGH
     digitalWrite(PIN_FAN_IN1, HIGH);
     digitalWrite(PIN_FAN_IN2, HIGH);
-    analogWrite(PIN_FAN_ENA, 255);
+    _fan_write(FAN_DUTY_FULL);
 
     serial_send_log("debug", "HW", "Pins set HIGH for 5 seconds");
 
@@ -166,13 +330,27 @@ void fan_test_direct() {
     // Restore to safe state
     digitalWrite(PIN_FAN_IN1, LOW);
     digitalWrite(PIN_FAN_IN2, LOW);
-    analogWrite(PIN_FAN_ENA, 0);
+    _fan_write(0);
 
     serial_send_log("info", "HW", "Direct pin test complete");
 }
 
 // ============== Heater Control ==============
 
+// Drive the SSR, noting when it actually changes state
+static void _ssr_write(bool on) {
+    digitalWrite(PIN_HEATER_SSR, on ? HIGH : LOW);
+    if (on != _ssr_on) {
+        _ssr_on = on;
+        _ssr_edge_time = millis();
+    }
+}
+
+// SSR on-time within each PID_WINDOW_SIZE_MS window
+static unsigned long _heater_on_time() {
+    return map((int)_heater_pid_output, 0, 255, 0, PID_WINDOW_SIZE_MS);
+}
+
 void heater_enable() {
     _heater_enabled = true;
     _heater_window_start = millis();
@@ -183,7 +361,7 @@ void heater_disable() {
     _heater_enabled = false;
     _heater_pid_output = 0;
     _heater_power = 0;
-    digitalWrite(PIN_HEATER_SSR, LOW);
+    _ssr_write(false);
     serial_send_log("info", "HW", "Heater disabled");
 }
 
@@ -208,7 +386,16 @@ void heater_set_pid_output(float output) {
 
 void heater_update() {
     if (!_heater_enabled) {
-        digitalWrite(PIN_HEATER_SSR, LOW);
+        _ssr_write(false);
+        return;
+    }
+
+    // The fan output slews up from rest - no heat until the blower is
+    // actually at MIN_FAN_WHEN_HEATING (or its lower commanded speed)
+    uint32_t airflow = (uint32_t)MIN_FAN_WHEN_HEATING * FAN_DUTY_FULL / 100;
+    if (_fan_output_target < airflow) airflow = _fan_output_target;
+    if (_fan_duty_written < airflow) {
+        _ssr_write(false);
         return;
     }
 
@@ -222,15 +409,25 @@ void heater_update() {
         windowTime = 0;
     }
 
-    // Calculate on-time from PID output
-    unsigned long onTime = map((int)_heater_pid_output, 0, 255, 0, PID_WINDOW_SIZE_MS);
-
     // Set SSR state based on window position
-    if (windowTime < onTime) {
-        digitalWrite(PIN_HEATER_SSR, HIGH);
-    } else {
-        digitalWrite(PIN_HEATER_SSR, LOW);
-    }
+    _ssr_write(windowTime < _heater_on_time());
+}
+
+bool heater_near_switching(unsigned long guard_ms) {
+    unsigned long now = millis();
+
+    // Just switched - the mains transient is still settling
+    if (_ssr_edge_time != 0 && now - _ssr_edge_time < guard_ms) return true;
+    if (!_heater_enabled) return false;
+
+    // Fully off or fully on windows have no edges
+    unsigned long onTime = _heater_on_time();
+    if (onTime == 0 || onTime >= PID_WINDOW_SIZE_MS) return false;
+
+    // Next edge: off at onTime, on again when the window restarts
+    unsigned long position = (now - _heater_window_start) % PID_WINDOW_SIZE_MS;
+    unsigned long next = position < onTime ? onTime - position : PID_WINDOW_SIZE_MS - position;
+    return next < guard_ms;
 }
 
 uint8_t heater_get_power() {
@@ -276,6 +473,13 @@ float thermocouple_read() {
         raw = _read_max31855_raw();
     }
 
+    // Every frame carries the cold junction too - keep it for free
+    int16_t cj12 = (raw >> 4) & 0x0FFF;
+    if (cj12 & 0x800) {
+        cj12 |= 0xF000;
+    }
+    _cold_junction = cj12 * 0.0625;
+
     if (raw & 0x10000) {
         _thermo_fault = raw & 0x07;
         return NAN;
@@ -291,6 +495,10 @@ float thermocouple_read() {
     return temp14 * 0.25;
 }
 
+uint32_t thermocouple_read_raw() {
+    return _read_max31855_raw();
+}
+
 uint8_t thermocouple_get_fault() {
     return _thermo_fault;
 }
@@ -306,32 +514,92 @@ float thermocouple_read_cold_junction() {
     return temp12 * 0.0625;
 }
 
-float thermocouple_read_filtered() {
+float thermocouple_last_cold_junction() {
+    return _cold_junction;
+}
+
+static void _update_ror(unsigned long now);
+
+// Split by SSR state: samples, faults, and read noise from the second
+// difference of consecutive reads (cancels a steady ramp; var = 6 sigma^2)
+static void _update_stats(float raw) {
+    ThermocoupleStats& stats = _stats[_ssr_on ? 1 : 0];
+    stats.samples++;
+    if (isnan(raw)) {
+        stats.faults++;
+    } else if (!isnan(_sample_prev[0]) && !isnan(_sample_prev[1])) {
+        float d2 = raw - 2 * _sample_prev[0] + _sample_prev[1];
+        stats.noiseSumSq += d2 * d2 / 6.0;
+        stats.noiseCount++;
+    }
+    _sample_prev[1] = _sample_prev[0];
+    _sample_prev[0] = raw;
+}
+
+void thermocouple_sample() {
+    unsigned long now = millis();
     float raw = thermocouple_read();
+    _sample_count++;
+    _last_sample_ms = now ? now : 1;
+    _update_stats(raw);
 
+    // A faulted read leaves the filter holding the last good value
     if (isnan(raw)) {
-        return _filtered_temp;
+        return;
     }
 
     if (!_filter_initialized) {
         _filtered_temp = raw;
         _filter_initialized = true;
-        return raw;
+    } else {
+        // Samples arrive at varying intervals - weight each by its age
+        float dt = now - _filter_time;
+        float alpha = dt / (LPF_TIME_CONSTANT_MS + dt);
+        _filtered_temp = (alpha * raw) + ((1.0 - alpha) * _filtered_temp);
     }
+    _filter_time = now;
+
+    _update_ror(now);
+}
+
+unsigned long thermocouple_last_sample_ms() {
+    return _last_sample_ms;
+}
 
-    _filtered_temp = (LPF_ALPHA * raw) + ((1.0 - LPF_ALPHA) * _filtered_temp);
+uint32_t thermocouple_sample_count() {
+    return _sample_count;
+}
+
+float thermocouple_read_filtered() {
     return _filtered_temp;
 }
 
+const ThermocoupleStats& thermocouple_get_stats(bool heater_on) {
+    return _stats[heater_on ? 1 : 0];
+}
+
+float thermocouple_noise_rms(const ThermocoupleStats& stats) {
+    return stats.noiseCount ? sqrt(stats.noiseSumSq / stats.noiseCount) : NAN;
+}
+
 void thermocouple_reset_filter() {
     _filter_initialized = false;
     _filtered_temp = 0;
+    _last_sample_ms = 0;
+}
+
+bool thermocouple_has_reading() {
+    return _filter_initialized;
 }
 
 // ============== Thermistor Reading ==============
 
+int thermistor_read_adc() {
+    return analogRead(PIN_THERMISTOR);
+}
+
 float thermistor_read() {
-    int adcValue = analogRead(PIN_THERMISTOR);
+    int adcValue = thermistor_read_adc();
 
     if (adcValue == 0) return 999.0;
 
@@ -351,14 +619,15 @@ float thermistor_read() {
 
 // ============== Rate of Rise ==============
 
-float calculate_ror() {
-    float current_temp = thermocouple_read_filtered();
-    unsigned long current_time = millis();
+// Difference over the actual elapsed time between samples, so a varying
+// sample rate doesn't skew the result
+static void _update_ror(unsigned long current_time) {
+    float current_temp = _filtered_temp;
 
     if (_ror_last_time == 0) {
         _ror_last_temp = current_temp;
         _ror_last_time = current_time;
-        return 0;
+        return;
     }
 
     unsigned long elapsed = current_time - _ror_last_time;
@@ -371,7 +640,9 @@ float calculate_ror() {
         _ror_last_temp = current_temp;
         _ror_last_time = current_time;
     }
+}
 
+float calculate_ror() {
     return _ror_value;
 }
 
@@ -4,13 +4,34 @@
 #include <Arduino.h>
 
 // ============== Initialization ==============
+// Drive heater SSR and fan outputs low - call first thing after reset
+void hardware_safe_outputs();
 void hardware_init();
 
 // ============== Fan Control ==============
 void fan_enable();
 void fan_disable();
 void fan_set_speed(uint8_t percent);  // 0-100
+void fan_set_duty(uint16_t duty);     // 0-FAN_DUTY_FULL, for fine airflow steps
 uint8_t fan_get_speed();
+uint16_t fan_get_duty();
+
+// Output duty only - the speed loop's trimmed command. fan_get_speed() and
+// fan_get_duty() keep reporting what was commanded.
+void fan_set_output_duty(uint16_t duty);
+uint16_t fan_get_output_duty();
+
+// Output stage: duty changes are slew-limited and a start from rest below
+// FAN_KICK_BELOW_DUTY gets a FAN_KICK_MS boost first. fan_update() advances
+// both without blocking; fan_skip_ramp() applies the target at once for
+// safety transitions (fan_disable() never ramps).
+void fan_update();                    // Call every loop
+void fan_skip_ramp();
+bool fan_is_ramping();
+
+// Measured blower speed from the tach (0 if stopped, or no tach fitted)
+uint16_t fan_get_rpm();
+uint32_t fan_get_tach_pulses();
 bool fan_is_enabled();
 
 // Debug functions for motor controller troubleshooting
@@ -21,17 +42,23 @@ void fan_test_direct();  // Direct pin test (5 sec HIGH on all fan pins)
 void heater_enable();
 void heater_disable();
 void heater_set_power(uint8_t percent);  // 0-100 (for manual mode)
-void heater_update();                     // Call in loop for time-proportioning
+void heater_update();                     // Call in loop for time-proportioning (off until the fan output is up)
 uint8_t heater_get_power();
 bool heater_is_enabled();
 
 // Set the PID output value (0-255) which heater_update() will use
 void heater_set_pid_output(float output);
 
+// True within guard_ms of an SSR transition, past or scheduled
+bool heater_near_switching(unsigned long guard_ms);
+
 // ============== Temperature Reading ==============
 // Raw thermocouple reading (°C or NAN on error)
 float thermocouple_read();
 
+// Unprocessed 32-bit MAX31855 frame (for self-test diagnostics)
+uint32_t thermocouple_read_raw();
+
 // Get fault code from last thermocouple read (0 = no fault)
 // Bit 0: Open circuit, Bit 1: Short to GND, Bit 2: Short to VCC
 uint8_t thermocouple_get_fault();
@@ -39,16 +66,48 @@ uint8_t thermocouple_get_fault();
 // Cold junction temperature (internal reference)
 float thermocouple_read_cold_junction();
 
-// Low-pass filtered thermocouple reading
+// Cold junction from the most recent thermocouple_read() (no SPI access)
+float thermocouple_last_cold_junction();
+
+// Take one sample: SPI read, filter and RoR step weighted by the time
+// since the last one (scheduled by sampling.cpp)
+void thermocouple_sample();
+
+// millis() of the latest sample; 0 after a filter reset (sample due now)
+unsigned long thermocouple_last_sample_ms();
+
+// Samples taken so far, so per-sample checks can skip repeat calls
+uint32_t thermocouple_sample_count();
+
+// Low-pass filtered temperature from the latest sample (no SPI access)
 float thermocouple_read_filtered();
 void thermocouple_reset_filter();
 
+// True once a valid sample has reached the filter since the last reset
+bool thermocouple_has_reading();
+
+// Sample statistics since boot, split by whether the SSR was conducting
+struct ThermocoupleStats {
+    uint32_t samples;
+    uint32_t faults;            // Reads with the MAX31855 fault bit set
+    uint32_t noiseCount;
+    float noiseSumSq;           // See thermocouple_noise_rms()
+};
+
+const ThermocoupleStats& thermocouple_get_stats(bool heater_on);
+
+// Estimated read noise (°C RMS), NAN until enough samples
+float thermocouple_noise_rms(const ThermocoupleStats& stats);
+
 // Thermistor reading for heater safety (°C)
 float thermistor_read();
 
+// Raw thermistor ADC value (0-1023)
+int thermistor_read_adc();
+
 // ============== Rate of Rise ==============
-// Returns rate of temperature change in °C/min
-// Returns 0 if not enough time has elapsed since last sample
+// Rate of temperature change in °C/min over ROR_SAMPLE_INTERVAL_MS,
+// updated by thermocouple_sample(); 0 until the first interval completes
 float calculate_ror();
 void reset_ror();
 
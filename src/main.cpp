@@ -5,8 +5,14 @@
 #include "hardware.h"
 #include "state.h"
 #include "pid_control.h"
+#include "fan_control.h"
+#include "preheat.h"
+#include "sampling.h"
 #include "safety.h"
 #include "serial_comm.h"
+#include "checkpoint.h"
+#include "profile.h"
+#include "boot.h"
 
 // ============== Global Objects ==============
 
@@ -45,38 +51,51 @@ void updateMatrixForState() {
 // ============== Setup ==============
 
 void setup() {
-    // Initialize serial communication first
-    serial_comm_init();
-
-    delay(1000);
+    // Drive heater and fan outputs low before anything else runs
+    hardware_safe_outputs();
+    boot_mark(BootPhase::OUTPUTS_SAFE);
 
-    // Initialize LED matrix
-    matrix.begin();
-    matrix.loadFrame(LEDMATRIX_BOOTLOADER_ON);
+    // Initialize serial communication (non-blocking, host may not be attached)
+    serial_comm_init();
+    boot_mark(BootPhase::SERIAL_INIT);
 
     // Initialize hardware
     hardware_init();
+    boot_mark(BootPhase::HARDWARE_INIT);
 
     // Initialize PID controller
     pid_init();
 
+    // Load the learned preheat model
+    preheat_init();
+
+    // Thermocouple acquisition schedule
+    sampling_init();
+
+    // Initialize fan speed loop (tach feedback)
+    fan_control_init();
+
     // Initialize safety system
     safety_init();
 
     // Initialize state machine
     state_init();
 
-    // Test temperature sensors
-    delay(100);
+    // No reference profile until the host uploads one
+    profile_init();
 
-    float chamberTemp = thermocouple_read();
-    float heaterTemp = thermistor_read();
+    // Locate any roast checkpoint (restored by boot_update once sensors settle)
+    checkpoint_init();
+    boot_mark(BootPhase::CONTROL_INIT);
 
-    // Show ready state
-    matrix.loadFrame(LEDMATRIX_EMOJI_SAD);  // OFF state
+    // Initialize LED matrix
+    matrix.begin();
+    updateMatrixForState();
+    boot_mark(BootPhase::DISPLAY_INIT);
 
-    // Announce ready state
+    // Announce ready state - sensor probe runs from loop()
     serial_send_connected();
+    boot_mark(BootPhase::SETUP_DONE);
 }
 
 // ============== Main Loop ==============
@@ -84,15 +103,32 @@ void setup() {
 static RoasterState lastState = RoasterState::OFF;
 
 void loop() {
+    // Deferred boot work (sensor probe, roast restore)
+    boot_update();
+
     // Handle serial communication
     serial_comm_update();
 
+    // Sample the thermocouple when the acquisition schedule says so
+    sampling_update();
+
     // Update safety system
     safety_update();
 
     // Update state machine
     state_update();
 
+    // Hold the commanded fan speed against the tach
+    fan_control_update();
+
+    // Advance the fan output ramp / kick-start
+    fan_update();
+
+    // Persist roast progress for warm restart (not before restore has run)
+    if (boot_is_complete()) {
+        checkpoint_update();
+    }
+
     // Update LED matrix if state changed
     RoasterState currentState = state_get_current();
     if (currentState != lastState) {
@@ -43,6 +43,10 @@ void pid_set_setpoint(float setpoint) {
     serial_send_log("debug", "PID", msg);
 }
 
+void pid_track_setpoint(float setpoint) {
+    _setpoint = setpoint;
+}
+
 float pid_get_setpoint() {
     return _setpoint;
 }
@@ -135,6 +139,12 @@ float pid_get_output() {
     return _output;
 }
 
+void pid_bias_output(float counts) {
+    if (_ki <= 0) return;
+    float max_integral = PID_OUTPUT_MAX / _ki;
+    _integral = constrain(_integral + counts / _ki, -max_integral, max_integral);
+}
+
 void pid_reset() {
     _integral = 0;
     _last_error = 0;
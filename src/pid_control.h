@@ -12,6 +12,9 @@ void pid_init();
 void pid_set_setpoint(float setpoint);
 float pid_get_setpoint();
 
+// Move the setpoint along a trajectory (called every tick, so not logged)
+void pid_track_setpoint(float setpoint);
+
 // Set PID tuning parameters
 void pid_set_tunings(float kp, float ki, float kd);
 
@@ -28,6 +31,10 @@ void pid_update(float current_temp);
 // Get the current PID output (0-255)
 float pid_get_output();
 
+// Shift the output by `counts` through the integral (bumpless feed-forward
+// for a known disturbance, e.g. a fan change)
+void pid_bias_output(float counts);
+
 // Reset the PID controller (clears integral term)
 void pid_reset();
 
@@ -0,0 +1,221 @@
+#include "preheat.h"
+#include "config.h"
+#include "checkpoint.h"
+#include "pid_control.h"
+#include "serial_comm.h"
+#include <EEPROM.h>
+
+// ============== Configuration ==============
+
+#define PREHEAT_MODEL_MAGIC     0x4D435048  // "MCPH"
+
+static_assert(PREHEAT_MODEL_EEPROM >= CHECKPOINT_EEPROM_BASE + CHECKPOINT_SLOTS * sizeof(RoastCheckpoint),
+              "Preheat model overlaps the checkpoint slots");
+
+// ============== Internal State ==============
+
+// Learned plant model, persisted across power cycles
+struct PreheatModel {
+    uint32_t magic;
+    float rate;                 // °C/s at full power near the switch point
+    float lagS;                 // Seconds of rise still to come after the heater cuts
+    float holdOutput;           // PID output (0-255) that holds the target
+};
+
+enum class PreheatPhase : uint8_t {
+    START,
+    RAMP,
+    COAST,
+    HOLD
+};
+
+static PreheatModel _model;
+static PreheatPhase _phase = PreheatPhase::START;
+static float _target = DEFAULT_PREHEAT_TEMP;
+static float _last_temp = 0;
+
+static float _rate = 0;                 // Measured full-power rise, °C/s
+static float _rate_ref_temp = 0;
+static unsigned long _rate_ref_time = 0;
+
+static float _switch_temp = 0;          // Where the ramp actually ended
+static float _switch_rate = 0;
+static unsigned long _switch_time = 0;
+static float _peak = 0;
+
+static unsigned long _band_since = 0;   // 0 while outside the ready band
+static float _band_output_sum = 0;
+static uint16_t _band_output_count = 0;
+static bool _ready = false;
+
+// ============== Model ==============
+
+static bool _model_valid(const PreheatModel& m) {
+    return m.magic == PREHEAT_MODEL_MAGIC &&
+           m.rate > 0.01 && m.rate < 10.0 &&
+           m.lagS >= 0 && m.lagS < 300.0 &&
+           m.holdOutput >= PID_OUTPUT_MIN && m.holdOutput <= PID_OUTPUT_MAX;
+}
+
+// Move a model parameter halfway toward the latest observation
+static float _learn(float current, float observed) {
+    return current + (observed - current) * 0.5;
+}
+
+void preheat_init() {
+    EEPROM.get(PREHEAT_MODEL_EEPROM, _model);
+    char msg[80];
+    if (_model_valid(_model)) {
+        snprintf(msg, sizeof(msg), "Model: %.2f°C/s, lag %.0fs, hold %.0f",
+                 _model.rate, _model.lagS, _model.holdOutput);
+    } else {
+        _model.magic = PREHEAT_MODEL_MAGIC;
+        _model.rate = PREHEAT_MODEL_RATE;
+        _model.lagS = PREHEAT_MODEL_LAG_S;
+        _model.holdOutput = PREHEAT_MODEL_HOLD;
+        snprintf(msg, sizeof(msg), "No learned model - using defaults");
+    }
+    serial_send_log("info", "PREHEAT", msg);
+}
+
+// ============== Phases ==============
+
+// Chamber temperature at which full power must stop to coast onto the target
+static float _switch_point() {
+    return _target - _rate * _model.lagS - PREHEAT_SWITCH_MARGIN;
+}
+
+static void _measure_rate(float chamber_temp, unsigned long now) {
+    if (now - _rate_ref_time < PREHEAT_RATE_WINDOW_MS) return;
+    float observed = (chamber_temp - _rate_ref_temp) * 1000.0 / (now - _rate_ref_time);
+    if (observed > 0) _rate = _learn(_rate, observed);
+    _rate_ref_temp = chamber_temp;
+    _rate_ref_time = now;
+}
+
+static void _hand_off(float chamber_temp) {
+    _phase = PreheatPhase::HOLD;
+    pid_reset();
+    pid_auto_tune(chamber_temp);
+    pid_bias_output(_model.holdOutput);
+}
+
+static void _end_coast(float chamber_temp) {
+    if (_switch_rate > 0) {
+        _model.lagS = _learn(_model.lagS, (_peak - _switch_temp) / _switch_rate);
+    }
+    char msg[80];
+    snprintf(msg, sizeof(msg), "Coasted %.1f°C to %.1f°C - PID holding", _peak - _switch_temp, _peak);
+    serial_send_log("info", "PREHEAT", msg);
+    _hand_off(chamber_temp);
+}
+
+static void _check_ready(float chamber_temp, float output, unsigned long now) {
+    if (fabs(chamber_temp - _target) > PREHEAT_READY_BAND) {
+        _band_since = 0;
+        _band_output_sum = 0;
+        _band_output_count = 0;
+        return;
+    }
+    if (_band_since == 0) _band_since = now;
+    if (_band_output_count < UINT16_MAX) {
+        _band_output_sum += output;
+        _band_output_count++;
+    }
+    if (now - _band_since < PREHEAT_READY_HOLD_MS) return;
+
+    _ready = true;
+    _model.holdOutput = _learn(_model.holdOutput, _band_output_sum / _band_output_count);
+    if (_model_valid(_model)) {
+        EEPROM.put(PREHEAT_MODEL_EEPROM, _model);
+    }
+    serial_send_event("PREHEAT_READY", nullptr);
+    serial_send_log("info", "PREHEAT", "Ready");
+}
+
+// ============== Preheat Implementation ==============
+
+void preheat_begin(float target) {
+    _target = target;
+    _phase = PreheatPhase::START;
+    _ready = false;
+    _band_since = 0;
+    _band_output_sum = 0;
+    _band_output_count = 0;
+}
+
+float preheat_update(float chamber_temp) {
+    // Thermocouple fault - heater off, safety takes it from here
+    if (isnan(chamber_temp)) return PID_OUTPUT_MIN;
+
+    unsigned long now = millis();
+    _last_temp = chamber_temp;
+
+    if (_phase == PreheatPhase::START) {
+        _rate = _model.rate;
+        _rate_ref_temp = chamber_temp;
+        _rate_ref_time = now;
+#if PREHEAT_MIN_TIME_ENABLED
+        _phase = chamber_temp < _switch_point() ? PreheatPhase::RAMP : PreheatPhase::HOLD;
+#else
+        _phase = PreheatPhase::HOLD;
+#endif
+    }
+
+    if (_phase == PreheatPhase::RAMP) {
+        _measure_rate(chamber_temp, now);
+        if (chamber_temp < _switch_point()) {
+            return PID_OUTPUT_MAX;
+        }
+        _model.rate = _learn(_model.rate, _rate);
+        _switch_temp = chamber_temp;
+        _switch_rate = _rate;
+        _switch_time = now;
+        _peak = chamber_temp;
+        _phase = PreheatPhase::COAST;
+
+        char msg[64];
+        snprintf(msg, sizeof(msg), "Full power off at %.1f°C (%.2f°C/s)", chamber_temp, _rate);
+        serial_send_log("info", "PREHEAT", msg);
+    }
+
+    if (_phase == PreheatPhase::COAST) {
+        if (chamber_temp > _peak) _peak = chamber_temp;
+        bool peaked = _peak - chamber_temp >= PREHEAT_PEAK_DROP;
+        if (!peaked && chamber_temp < _target) {
+            return PID_OUTPUT_MIN;
+        }
+        _end_coast(chamber_temp);
+    }
+
+    pid_update(chamber_temp);
+    float output = pid_get_output();
+    if (!_ready) {
+        _check_ready(chamber_temp, output, now);
+    }
+    return output;
+}
+
+bool preheat_is_ready() {
+    return _ready;
+}
+
+int32_t preheat_get_eta_ms() {
+    if (_ready) return 0;
+
+    float hold_s = PREHEAT_READY_HOLD_MS / 1000.0;
+    float coast_s = _model.lagS;
+    switch (_phase) {
+        case PreheatPhase::RAMP:
+            if (_rate <= 0) return PREHEAT_ETA_UNKNOWN;
+            return (int32_t)(((_switch_point() - _last_temp) / _rate + coast_s + hold_s) * 1000.0);
+        case PreheatPhase::COAST:
+            coast_s -= (millis() - _switch_time) / 1000.0;
+            return (int32_t)(((coast_s > 0 ? coast_s : 0) + hold_s) * 1000.0);
+        case PreheatPhase::HOLD:
+            if (_band_since == 0 || millis() - _band_since >= PREHEAT_READY_HOLD_MS) return PREHEAT_ETA_UNKNOWN;
+            return (int32_t)(PREHEAT_READY_HOLD_MS - (millis() - _band_since));
+        default:
+            return PREHEAT_ETA_UNKNOWN;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef PREHEAT_H
+#define PREHEAT_H
+
+#include <Arduino.h>
+#include "telemetry_schema.h"
+
+// ============== Minimum-Time Preheat ==============
+// Drives the heater through PREHEAT (PREHEAT_MIN_TIME_ENABLED):
+//
+//   RAMP   full power until the chamber reaches the switch point,
+//          target - rate * lag - PREHEAT_SWITCH_MARGIN, where rate is the
+//          full-power rise measured now and lag the learned thermal lag
+//   COAST  heater off while stored heat carries the chamber toward the
+//          target; ends at the peak, or at the target
+//   HOLD   the PID takes over with its integral preloaded to the learned
+//          holding output, so the handoff neither dips nor overshoots
+//
+// Ready is PREHEAT_READY_BAND held for PREHEAT_READY_HOLD_MS, announced once
+// with a PREHEAT_READY roast event. Each preheat refines the model (lag
+// from the observed coast, holding output from the ready window) and saves
+// it to EEPROM. With the strategy disabled the PID runs from the start and
+// only ready detection applies.
+
+#define PREHEAT_ETA_UNKNOWN     TELEMETRY_NULL_I32  // No prediction (not preheating, or no rate yet)
+
+// Load the learned plant model from EEPROM (call once at boot)
+void preheat_init();
+
+// Start (or retarget) a preheat; the phase is chosen on the next update
+void preheat_begin(float target);
+
+// Heater demand (0-255) for this tick; runs the PID once it holds
+float preheat_update(float chamber_temp);
+
+// True once the chamber has settled within the ready band
+bool preheat_is_ready();
+
+// Predicted milliseconds until ready, or PREHEAT_ETA_UNKNOWN
+int32_t preheat_get_eta_ms();
+
+#endif // PREHEAT_H
@@ -0,0 +1,198 @@
+#include "profile.h"
+#include "config.h"
+#include "serial_comm.h"
+
+// ============== Internal State ==============
+
+static int16_t _points[PROFILE_MAX_POINTS];     // Reference temperature, 0.1°C
+static uint16_t _point_count = 0;               // Expected by the upload
+static uint16_t _received = 0;
+static uint16_t _step_ms = 0;
+
+static uint16_t _fan_at_sec[PROFILE_MAX_FAN_EVENTS];
+static uint8_t _fan_speed[PROFILE_MAX_FAN_EVENTS];
+static uint8_t _fan_count = 0;
+static uint8_t _fan_next = 0;
+
+static bool _loaded = false;
+static bool _active = false;
+static unsigned long _start_time = 0;
+static const char* _error = "";
+
+static bool _reject(const char* reason) {
+    _error = reason;
+    serial_send_log("warn", "PROFILE", reason);
+    return false;
+}
+
+// ============== Upload ==============
+
+void profile_init() {
+    _point_count = 0;
+    _received = 0;
+    _step_ms = 0;
+    _fan_count = 0;
+    _fan_next = 0;
+    _loaded = false;
+    _active = false;
+    _error = "";
+}
+
+bool profile_begin(uint16_t points, uint16_t stepMs) {
+    if (_active) return _reject("Cannot replace a profile during replay");
+    if (points < 2 || points > PROFILE_MAX_POINTS) return _reject("Profile point count out of range");
+    if (stepMs < PROFILE_MIN_STEP_MS) return _reject("Profile step too short");
+
+    profile_init();
+    _point_count = points;
+    _step_ms = stepMs;
+    return true;
+}
+
+bool profile_add_points(uint16_t offset, const int16_t* deciTemps, uint16_t count) {
+    if (_point_count == 0 || _loaded) return _reject("No profile upload in progress");
+    if (offset != _received) return _reject("Profile chunk out of order");
+    if (count > _point_count - _received) return _reject("Profile chunk past the declared length");
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (deciTemps[i] < 0 || deciTemps[i] > (int16_t)(MAX_CHAMBER_TEMP * 10)) {
+            return _reject("Profile temperature outside the safe range");
+        }
+        _points[_received++] = deciTemps[i];
+    }
+    return true;
+}
+
+bool profile_add_fan(uint16_t atSec, uint8_t speed) {
+    if (_point_count == 0 || _loaded) return _reject("No profile upload in progress");
+    if (_fan_count >= PROFILE_MAX_FAN_EVENTS) return _reject("Too many profile fan events");
+    if (_fan_count > 0 && atSec < _fan_at_sec[_fan_count - 1]) return _reject("Profile fan events out of order");
+
+    _fan_at_sec[_fan_count] = atSec;
+    _fan_speed[_fan_count] = speed > FAN_MAX_DUTY ? FAN_MAX_DUTY : speed;
+    _fan_count++;
+    return true;
+}
+
+bool profile_end() {
+    if (_point_count == 0) return _reject("No profile upload in progress");
+    if (_received != _point_count) return _reject("Profile upload incomplete");
+
+    _loaded = true;
+    _error = "";
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Profile armed: %u points, %lu s, %u fan changes",
+             _point_count, (unsigned long)(profile_get_duration_ms() / 1000), _fan_count);
+    serial_send_log("info", "PROFILE", msg);
+    return true;
+}
+
+void profile_clear() {
+    if (_active) {
+        serial_send_log("info", "PROFILE", "Replay stopped - profile cleared");
+    }
+    profile_init();
+}
+
+const char* profile_get_error() {
+    return _error;
+}
+
+// ============== Status ==============
+
+bool profile_is_loaded() {
+    return _loaded;
+}
+
+bool profile_is_active() {
+    return _active;
+}
+
+uint16_t profile_get_points() {
+    return _point_count;
+}
+
+uint16_t profile_get_received() {
+    return _received;
+}
+
+uint16_t profile_get_step_ms() {
+    return _step_ms;
+}
+
+uint8_t profile_get_fan_events() {
+    return _fan_count;
+}
+
+uint32_t profile_get_duration_ms() {
+    return _point_count > 1 ? (uint32_t)(_point_count - 1) * _step_ms : 0;
+}
+
+// ============== Replay ==============
+
+void profile_start() {
+    if (!_loaded) return;
+    _active = true;
+    _start_time = millis();
+    _fan_next = 0;
+    serial_send_log("info", "PROFILE", "Replay started at charge");
+}
+
+void profile_stop() {
+    if (!_active) return;
+    _active = false;
+    serial_send_log("info", "PROFILE", "Replay stopped");
+}
+
+uint32_t profile_get_elapsed_ms() {
+    return _active ? millis() - _start_time : 0;
+}
+
+float profile_update() {
+    uint32_t elapsed = millis() - _start_time;
+    uint32_t index = elapsed / _step_ms;
+    if (index >= (uint32_t)_point_count - 1) {
+        return _points[_point_count - 1] * 0.1f;
+    }
+
+    // Linear interpolation between the two surrounding points
+    float frac = (float)(elapsed - index * _step_ms) / _step_ms;
+    float a = _points[index];
+    float b = _points[index + 1];
+    return (a + (b - a) * frac) * 0.1f;
+}
+
+bool profile_take_fan(uint8_t& speed) {
+    if (!_active || _fan_next >= _fan_count) return false;
+    if (millis() - _start_time < (uint32_t)_fan_at_sec[_fan_next] * 1000) return false;
+
+    speed = _fan_speed[_fan_next++];
+    return true;
+}
+
+int32_t profile_get_lead_ms(float chamberTemp) {
+    if (!_active || isnan(chamberTemp)) return PROFILE_LEAD_UNKNOWN;
+
+    int32_t elapsed = (int32_t)(millis() - _start_time);
+    int16_t target = (int16_t)(chamberTemp * 10);
+    int32_t best = PROFILE_LEAD_UNKNOWN;
+    int32_t best_dist = INT32_MAX;
+
+    // The curve dips after charge and then rises, so a temperature can be
+    // crossed more than once - take the crossing closest to now
+    for (uint16_t i = 0; i + 1 < _point_count; i++) {
+        int16_t a = _points[i];
+        int16_t b = _points[i + 1];
+        if ((target < a && target < b) || (target > a && target > b)) continue;
+
+        int32_t cross = (int32_t)i * _step_ms;
+        if (a != b) cross += (int32_t)((int32_t)(target - a) * (int32_t)_step_ms / (b - a));
+        int32_t dist = cross > elapsed ? cross - elapsed : elapsed - cross;
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = cross - elapsed;
+        }
+    }
+    return best;
+}
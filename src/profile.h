@@ -0,0 +1,75 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <Arduino.h>
+#include "telemetry_schema.h"
+
+// ============== Reference Profile Replay ==============
+
+// A logged roast's chamber curve, time-aligned to its charge, used as the
+// live setpoint trajectory. The host uploads it decimated to a fixed step
+// in deci-degrees (profileBegin / profileData / profileFan / profileEnd);
+// the device interpolates between points every control tick, so a replay
+// keeps running if the host link drops.
+
+#define PROFILE_LEAD_UNKNOWN    TELEMETRY_NULL_I32  // Reference never reaches the current temperature
+
+// Forget any loaded profile
+void profile_init();
+
+// ============== Upload ==============
+
+// Start a new upload of `points` samples spaced `stepMs` apart
+// (rejected while a replay is running)
+bool profile_begin(uint16_t points, uint16_t stepMs);
+
+// Store reference temperatures (0.1°C units) starting at point `offset`;
+// chunks must arrive in order
+bool profile_add_points(uint16_t offset, const int16_t* deciTemps, uint16_t count);
+
+// Add a fan change `atSec` seconds after charge; events must be in time order
+bool profile_add_fan(uint16_t atSec, uint8_t speed);
+
+// Finish the upload; the profile is armed if every point arrived
+bool profile_end();
+
+// Discard the profile (stops a running replay)
+void profile_clear();
+
+// Reason the last upload step was rejected ("" if none)
+const char* profile_get_error();
+
+// ============== Status ==============
+
+bool profile_is_loaded();           // Complete profile armed for the next charge
+bool profile_is_active();           // Replaying now
+uint16_t profile_get_points();
+uint16_t profile_get_received();
+uint16_t profile_get_step_ms();
+uint8_t profile_get_fan_events();
+uint32_t profile_get_duration_ms();
+
+// ============== Replay ==============
+
+// Begin following the reference (called on charge / ROASTING entry)
+void profile_start();
+
+// Stop following; the profile stays loaded for the next roast
+void profile_stop();
+
+// Reference temperature at the current offset from charge, interpolated
+// between points and held at the last point once the curve ends
+float profile_update();
+
+// True once per recorded fan change that has come due
+bool profile_take_fan(uint8_t& speed);
+
+// Time since charge while replaying
+uint32_t profile_get_elapsed_ms();
+
+// How far the roast is ahead (+) or behind (-) the reference, in ms: the
+// offset at which the reference passed the current chamber temperature,
+// taking the crossing nearest the current offset, minus the current offset
+int32_t profile_get_lead_ms(float chamberTemp);
+
+#endif // PROFILE_H
@@ -1,6 +1,7 @@
 #include "safety.h"
 #include "config.h"
 #include "hardware.h"
+#include "fan_control.h"
 #include "state.h"
 #include "serial_comm.h"
 
@@ -11,6 +12,11 @@ static char _fault_code[32] = "";
 static char _fault_message[128] = "";
 static bool _fault_fatal = false;
 
+// Fault history ring (oldest entry at _history_start)
+static FaultRecord _history[FAULT_HISTORY_SIZE];
+static uint8_t _history_start = 0;
+static uint8_t _history_count = 0;
+
 // Forward declaration from state.cpp
 extern void state_enter_error(const char* code, const char* message, bool fatal);
 
@@ -21,6 +27,8 @@ void safety_init() {
     _fault_code[0] = '\0';
     _fault_message[0] = '\0';
     _fault_fatal = false;
+    _history_start = 0;
+    _history_count = 0;
     
     serial_send_log("info", "SAFETY", "Safety system initialized");
 }
@@ -94,11 +102,44 @@ void safety_trigger_fault(const char* code, const char* message, bool fatal) {
     snprintf(log_msg, sizeof(log_msg), "FAULT: %s - %s (Fatal: %s)", 
              _fault_code, _fault_message, _fault_fatal ? "YES" : "NO");
     serial_send_log("error", "SAFETY", log_msg);
+
+    safety_record_fault(code, fatal);
     
     // Enter error state
     state_enter_error(code, message, fatal);
 }
 
+// ============== Fault History ==============
+
+void safety_record_fault(const char* code, bool fatal) {
+    uint8_t slot;
+    if (_history_count < FAULT_HISTORY_SIZE) {
+        slot = (_history_start + _history_count) % FAULT_HISTORY_SIZE;
+        _history_count++;
+    } else {
+        // Full - overwrite the oldest entry
+        slot = _history_start;
+        _history_start = (_history_start + 1) % FAULT_HISTORY_SIZE;
+    }
+
+    FaultRecord& record = _history[slot];
+    record.timestampMs = millis();
+    strncpy(record.code, code, sizeof(record.code) - 1);
+    record.code[sizeof(record.code) - 1] = '\0';
+    record.fatal = fatal;
+}
+
+uint8_t safety_get_fault_history_count() {
+    return _history_count;
+}
+
+const FaultRecord* safety_get_fault_history(uint8_t index) {
+    if (index >= _history_count) {
+        return nullptr;
+    }
+    return &_history[(_history_start + index) % FAULT_HISTORY_SIZE];
+}
+
 // ============== Individual Safety Checks ==============
 
 bool safety_check_chamber_temp(float temp) {
@@ -135,6 +176,19 @@ bool safety_check_fan_for_heater(uint8_t fan_percent, bool heater_on) {
             "Fan speed too low or disabled while heater is on", true);
         return false;
     }
+
+    // The commanded speed means nothing if the tach says the blower isn't turning
+    if (fan_control_is_stalled()) {
+        safety_trigger_fault("FAN_STALL",
+            "Fan stalled while heater is on", true);
+        return false;
+    }
+
+    if (fan_control_is_underspeed()) {
+        safety_trigger_fault("FAN_UNDERSPEED",
+            "Fan well below commanded speed while heater is on", false);
+        return false;
+    }
     
     return true;
 }
@@ -144,8 +198,16 @@ bool safety_check_thermocouple() {
     static uint8_t good_count = 0;
     static uint8_t last_fault = 0;
     static bool warning_logged = false;
-    const uint8_t FAULT_THRESHOLD = 10;  // Require 10 consecutive faults (more tolerant)
+    const uint8_t FAULT_THRESHOLD = 10;  // 10 consecutive faulted samples (~0.5 s at the fault sample rate)
     const uint8_t GOOD_THRESHOLD = 3;    // Require 3 good reads to clear
+    static uint32_t last_sample = 0;
+
+    // Count each sample once, however often we're called between them
+    uint32_t sample = thermocouple_sample_count();
+    if (sample == last_sample) {
+        return true;
+    }
+    last_sample = sample;
     
     uint8_t fault = thermocouple_get_fault();
     
@@ -26,13 +26,30 @@ void safety_clear_fault();
 // Manually trigger a fault
 void safety_trigger_fault(const char* code, const char* message, bool fatal = true);
 
+// ============== Fault History ==============
+
+struct FaultRecord {
+    uint32_t timestampMs;
+    char code[32];
+    bool fatal;
+};
+
+// Record a fault in history without entering ERROR (e.g. self-test findings)
+// safety_trigger_fault() records automatically
+void safety_record_fault(const char* code, bool fatal);
+
+// Number of retained records and access by index (0 = oldest)
+uint8_t safety_get_fault_history_count();
+const FaultRecord* safety_get_fault_history(uint8_t index);
+
 // ============== Individual Safety Checks ==============
 
 // Check if chamber temperature is within limits
 // Returns true if safe
 bool safety_check_chamber_temp(float temp);
 
-// Check if fan speed is adequate for heater operation
+// Check if fan speed is adequate for heater operation (commanded speed,
+// plus tach stall / underspeed when FAN_TACH_ENABLED)
 // Returns true if safe
 bool safety_check_fan_for_heater(uint8_t fan_percent, bool heater_on);
 
@@ -0,0 +1,109 @@
+#include "sampling.h"
+#include "config.h"
+#include "hardware.h"
+#include "state.h"
+#include "serial_comm.h"
+
+// ============== Internal State ==============
+
+static uint16_t _interval = SAMPLE_SLOW_MS;
+static RoasterState _last_state = RoasterState::OFF;
+static unsigned long _charge_time = 0;      // ROASTING entry (charge)
+static uint32_t _deferred = 0;
+static bool _deferring = false;
+
+// ============== Policy ==============
+
+static uint16_t _choose_interval(unsigned long now) {
+    RoasterState state = state_get_current();
+    if (state != _last_state) {
+        if (state == RoasterState::ROASTING) _charge_time = now;
+        _last_state = state;
+    }
+
+    // A faulted read must repeat quickly so the safety monitor's
+    // consecutive-fault count trips in a fraction of a second
+    if (thermocouple_get_fault()) return SAMPLE_FAST_MS;
+
+    switch (state) {
+        case RoasterState::OFF:
+        case RoasterState::FAN_ONLY:
+        case RoasterState::ERROR:
+            return SAMPLE_SLOW_MS;
+        case RoasterState::COOLING:
+        case RoasterState::MANUAL:
+            return SAMPLE_NORMAL_MS;
+        default:
+            break;
+    }
+
+    float temp = thermocouple_read_filtered();
+    if (state == RoasterState::ROASTING) {
+        // Charge drop and turning point
+        if (now - _charge_time < SAMPLE_CHARGE_MS) return SAMPLE_FAST_MS;
+
+        // Approaching first crack, and the development just after it
+        if (state_is_first_crack_marked()) {
+            if (state_get_roast_time_ms() - state_get_first_crack_time_ms() < SAMPLE_FC_AFTER_MS) {
+                return SAMPLE_FAST_MS;
+            }
+        } else if (temp >= SAMPLE_FC_APPROACH_TEMP) {
+            return SAMPLE_FAST_MS;
+        }
+    }
+
+    // Near the setpoint: moving through it is a crossing, sitting on it a hold
+    if (fabs(temp - state_get_control_setpoint()) <= SAMPLE_CROSSING_BAND) {
+        return fabs(calculate_ror()) < SAMPLE_HOLD_ROR ? SAMPLE_SLOW_MS : SAMPLE_FAST_MS;
+    }
+    return SAMPLE_NORMAL_MS;
+}
+
+// ============== Sampling Implementation ==============
+
+void sampling_init() {
+    _interval = SAMPLE_SLOW_MS;
+    _last_state = RoasterState::OFF;
+    _charge_time = 0;
+    _deferred = 0;
+    _deferring = false;
+    thermocouple_reset_filter();
+}
+
+void sampling_update() {
+    unsigned long now = millis();
+    unsigned long last = thermocouple_last_sample_ms();
+    if (last != 0 && now - last < _interval) {
+        return;
+    }
+
+    // Wait out an SSR edge - one blocks at most 2 x guard, the cap covers
+    // back-to-back edges at extreme duty cycles
+    if (last != 0 && heater_near_switching(SAMPLE_SSR_GUARD_MS) &&
+        now - last < _interval + 4UL * SAMPLE_SSR_GUARD_MS) {
+        if (!_deferring) {
+            _deferring = true;
+            _deferred++;
+        }
+        return;
+    }
+    _deferring = false;
+
+    thermocouple_sample();
+
+    uint16_t interval = _choose_interval(now);
+    if (interval != _interval) {
+        _interval = interval;
+        char msg[40];
+        snprintf(msg, sizeof(msg), "Sampling every %u ms", interval);
+        serial_send_log("debug", "SAMPLE", msg);
+    }
+}
+
+uint16_t sampling_get_interval_ms() {
+    return _interval;
+}
+
+uint32_t sampling_get_deferred() {
+    return _deferred;
+}
@@ -0,0 +1,33 @@
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <Arduino.h>
+
+// ============== Adaptive Temperature Sampling ==============
+// Decides when the thermocouple is read; all other code uses the latest
+// sample (thermocouple_read_filtered(), calculate_ror()). The interval
+// follows the process:
+//
+//   SAMPLE_FAST_MS    charge, setpoint crossings, around first crack, and
+//                     after any faulted read (until a good one)
+//   SAMPLE_NORMAL_MS  heating, cooling and manual control
+//   SAMPLE_SLOW_MS    OFF, FAN_ONLY, ERROR and steady holds at setpoint
+//
+// The filter and RoR weight each sample by its actual age, so the rate
+// can change at any time without skewing either. A due sample is held back
+// while the heater SSR is within SAMPLE_SSR_GUARD_MS of switching, so reads
+// land between mains transients rather than on them.
+
+// Start at the slow rate with a sample due immediately
+void sampling_init();
+
+// Take a sample if one is due (call every loop, before safety and state)
+void sampling_update();
+
+// Interval currently in force (ms)
+uint16_t sampling_get_interval_ms();
+
+// Samples held back off an SSR transition since boot
+uint32_t sampling_get_deferred();
+
+#endif // SAMPLING_H
@@ -0,0 +1,163 @@
+#include "selftest.h"
+#include "config.h"
+#include "hardware.h"
+
+// ============== Internal State ==============
+
+static SelfTestResult _results[(int)SelfTestId::COUNT];
+static uint8_t _next_test = 0;
+
+// Last MAX31855 frame, shared by the thermocouple tests
+static uint32_t _max31855_raw = 0;
+
+// ============== Individual Tests ==============
+
+static SelfTestStatus _test_max31855_present(float& value) {
+    _max31855_raw = thermocouple_read_raw();
+
+    // Report the decoded probe temperature for context
+    int16_t temp14 = (_max31855_raw >> 18) & 0x3FFF;
+    if (temp14 & 0x2000) temp14 |= 0xC000;
+    value = temp14 * 0.25;
+
+    // MISO floating high or held low means no chip is answering
+    if (_max31855_raw == 0x00000000 || _max31855_raw == 0xFFFFFFFF) {
+        return SelfTestStatus::FAIL;
+    }
+
+    // D17 and D3 are reserved and always read 0 on a healthy part
+    if (_max31855_raw & 0x00020008) {
+        return SelfTestStatus::FAIL;
+    }
+    return SelfTestStatus::PASS;
+}
+
+static SelfTestStatus _test_max31855_fault(float& value) {
+    uint8_t fault = (_max31855_raw & 0x10000) ? (_max31855_raw & 0x07) : 0;
+    value = fault;
+
+    if (fault == 0) return SelfTestStatus::PASS;
+
+    // Short to GND is tolerated at runtime as noise - mirror that here
+    if (fault == 0x02) return SelfTestStatus::WARN;
+    return SelfTestStatus::FAIL;
+}
+
+static SelfTestStatus _test_cold_junction(float& value) {
+    float cj = thermocouple_read_cold_junction();
+    value = cj;
+
+    if (cj < SELFTEST_CJ_MIN_TEMP || cj > SELFTEST_CJ_MAX_TEMP) {
+        return SelfTestStatus::WARN;
+    }
+    return SelfTestStatus::PASS;
+}
+
+static SelfTestStatus _test_thermistor(float& value) {
+    int adc = thermistor_read_adc();
+    value = adc;
+
+    // thermistor_read() reports 999.0 for these - the element overtemp
+    // check and the cascade loop would both run blind, so no heating
+    if (adc <= SELFTEST_ADC_OPEN_MAX || adc >= SELFTEST_ADC_SHORT_MIN) {
+        return SelfTestStatus::FAIL;
+    }
+    return SelfTestStatus::PASS;
+}
+
+static SelfTestStatus _test_fan_pins(float& value) {
+    // ENA stays at 0 so toggling direction cannot spin the motor
+    const uint8_t pins[2] = { PIN_FAN_IN1, PIN_FAN_IN2 };
+    uint8_t failures = 0;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        digitalWrite(pins[i], HIGH);
+        if (digitalRead(pins[i]) != HIGH) failures |= (1 << (i * 2));
+        digitalWrite(pins[i], LOW);
+        if (digitalRead(pins[i]) != LOW) failures |= (1 << (i * 2 + 1));
+    }
+
+    value = failures;
+    return failures ? SelfTestStatus::FAIL : SelfTestStatus::PASS;
+}
+
+static SelfTestStatus _test_ssr_readback(float& value) {
+    // Only verify the idle level - pulsing the SSR would fire the heater
+    int level = digitalRead(PIN_HEATER_SSR);
+    value = level;
+    return (level == LOW && !heater_is_enabled()) ? SelfTestStatus::PASS : SelfTestStatus::FAIL;
+}
+
+// ============== Self-Test Implementation ==============
+
+void selftest_begin() {
+    for (uint8_t i = 0; i < (uint8_t)SelfTestId::COUNT; i++) {
+        _results[i].status = SelfTestStatus::PENDING;
+        _results[i].durationUs = 0;
+        _results[i].value = 0;
+    }
+    _next_test = 0;
+    _max31855_raw = 0;
+}
+
+bool selftest_step() {
+    if (_next_test >= (uint8_t)SelfTestId::COUNT) {
+        return true;
+    }
+
+    SelfTestResult& result = _results[_next_test];
+    unsigned long start = micros();
+
+    switch ((SelfTestId)_next_test) {
+        case SelfTestId::MAX31855_PRESENT: result.status = _test_max31855_present(result.value); break;
+        case SelfTestId::MAX31855_FAULT:   result.status = _test_max31855_fault(result.value);   break;
+        case SelfTestId::COLD_JUNCTION:    result.status = _test_cold_junction(result.value);    break;
+        case SelfTestId::THERMISTOR:       result.status = _test_thermistor(result.value);       break;
+        case SelfTestId::FAN_PINS:         result.status = _test_fan_pins(result.value);         break;
+        case SelfTestId::SSR_READBACK:     result.status = _test_ssr_readback(result.value);     break;
+        default: break;
+    }
+
+    result.durationUs = micros() - start;
+
+    // A test that blows its budget points at a hung bus - flag it
+    if (result.durationUs > SELFTEST_BUDGET_US && result.status == SelfTestStatus::PASS) {
+        result.status = SelfTestStatus::WARN;
+    }
+
+    _next_test++;
+    return _next_test >= (uint8_t)SelfTestId::COUNT;
+}
+
+bool selftest_passed() {
+    for (uint8_t i = 0; i < (uint8_t)SelfTestId::COUNT; i++) {
+        if (_results[i].status == SelfTestStatus::FAIL) return false;
+    }
+    return true;
+}
+
+const SelfTestResult& selftest_get_result(SelfTestId id) {
+    return _results[(int)id];
+}
+
+const char* selftest_get_name(SelfTestId id) {
+    switch (id) {
+        case SelfTestId::MAX31855_PRESENT: return "max31855Present";
+        case SelfTestId::MAX31855_FAULT:   return "max31855Fault";
+        case SelfTestId::COLD_JUNCTION:    return "coldJunction";
+        case SelfTestId::THERMISTOR:       return "thermistor";
+        case SelfTestId::FAN_PINS:         return "fanPins";
+        case SelfTestId::SSR_READBACK:     return "ssrReadback";
+        default:                           return "unknown";
+    }
+}
+
+const char* selftest_get_status_name(SelfTestStatus status) {
+    switch (status) {
+        case SelfTestStatus::PENDING: return "pending";
+        case SelfTestStatus::PASS:    return "pass";
+        case SelfTestStatus::WARN:    return "warn";
+        case SelfTestStatus::FAIL:    return "fail";
+        default:                      return "unknown";
+    }
+}
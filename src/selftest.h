@@ -0,0 +1,47 @@
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+#include <Arduino.h>
+
+// ============== Self-Test Enumerations ==============
+enum class SelfTestId {
+    MAX31855_PRESENT = 0,   // SPI frame is not stuck and reserved bits are clear
+    MAX31855_FAULT,         // Open circuit / short to GND / short to VCC bits
+    COLD_JUNCTION,          // Internal reference within plausible ambient range
+    THERMISTOR,             // ADC not pinned at open or short rail
+    FAN_PINS,               // L298N direction pins read back as driven
+    SSR_READBACK,           // Heater SSR pin reads back LOW
+    COUNT
+};
+
+enum class SelfTestStatus {
+    PENDING = 0,
+    PASS,
+    WARN,                   // Degraded but safe to operate
+    FAIL                    // Heater operation unsafe
+};
+
+struct SelfTestResult {
+    SelfTestStatus status;
+    uint32_t durationUs;
+    float value;            // Test-specific measurement (°C, fault bits, ADC count)
+};
+
+// ============== Self-Test Interface ==============
+
+// Reset all results to PENDING
+void selftest_begin();
+
+// Run the next pending test (one per call, each bounded by SELFTEST_BUDGET_US)
+// Returns true once every test has run
+bool selftest_step();
+
+// True if no test reported FAIL
+bool selftest_passed();
+
+// Result accessors
+const SelfTestResult& selftest_get_result(SelfTestId id);
+const char* selftest_get_name(SelfTestId id);
+const char* selftest_get_status_name(SelfTestStatus status);
+
+#endif // SELFTEST_H
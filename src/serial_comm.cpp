@@ -3,67 +3,143 @@
 #include "state.h"
 #include "hardware.h"
 #include "safety.h"
+#include "telemetry.h"
+#include "boot.h"
+#include "selftest.h"
+#include "transport.h"
+#include "profile.h"
+#include "preheat.h"
+#include "sampling.h"
+#include "downsample.h"
+#include "telemetry_codec.h"
 
 // ============== Configuration ==============
 
-#define SERIAL_BAUD_RATE        115200
 #define SERIAL_TIMEOUT_MS       5000      // 5 seconds without data = disconnected
 #define STATE_UPDATE_INTERVAL   1000      // Send state every 1 second
 #define INPUT_BUFFER_SIZE       512
+#define PROFILE_CHUNK_MAX       100       // Values per profileData/profileFan line
 
 // ============== Internal State ==============
 
-static char inputBuffer[INPUT_BUFFER_SIZE];
-static size_t bufferIndex = 0;
+// One line buffer per transport sink so interleaved clients don't mix bytes
+static char inputBuffer[TRANSPORT_MAX_SINKS][INPUT_BUFFER_SIZE];
+static size_t bufferIndex[TRANSPORT_MAX_SINKS];
 static unsigned long lastDataReceived = 0;
 static unsigned long lastStateUpdate = 0;
 static bool connectionActive = false;
 
+// Pending resend range (inclusive), drained a few frames per update
+static uint32_t resendNextSeq = 0;
+static uint32_t resendEndSeq = 0;
+
+// Pending downsampled history: one bit per retained sample, set for the
+// samples picked by the reducer (bit 0 = historyFromSeq)
+static Downsampler historyReducer;
+static uint8_t historyMask[(TELEMETRY_RING_SIZE + 7) / 8];
+static uint32_t historyFromSeq = 0;
+static uint32_t historyToSeq = 0;
+static uint32_t historyNextSeq = 0;
+
+// Line protocol spoken on each sink, picked by the first byte of each line
+enum class LinkProtocol : uint8_t {
+    JSON,       // NDJSON commands, receives every broadcast frame
+    TC4         // Artisan TC4 commands, muted from broadcasts
+};
+static LinkProtocol linkProtocol[TRANSPORT_MAX_SINKS];
+
+// TC4 session settings (Artisan sends these once after opening the port)
+static char tc4Channels[5] = "1200";    // Logical channel -> physical sensor ('0' = off)
+static bool tc4Fahrenheit = false;
+static float tc4Setpoint = 0;           // Last PID;SV, used by PID;ON / PID;GO
+
 // ============== Forward Declarations ==============
 
 static void parseCommand(const String& command);
+static void selectProtocol(uint8_t sink, int c);
+static void parseTc4Command(uint8_t sink, const char* line);
+static void sendStateFrame(const TelemetrySample& sample, bool replay);
+static void queueResend(uint32_t fromSeq, uint32_t toSeq);
+static void serviceResend();
+static void queueHistory(uint32_t points, DownsampleMode mode);
+static void serviceHistory();
+static void sendFrame(const String& json, bool droppable);
+static uint16_t parseIntArray(const String& message, const char* key, int16_t* out, uint16_t max);
 
 // ============== Serial Communication Interface ==============
 
 void serial_comm_init() {
-    Serial.begin(SERIAL_BAUD_RATE);
-    bufferIndex = 0;
     lastDataReceived = 0;
     lastStateUpdate = 0;
     connectionActive = false;
-
-    // Clear any pending data
-    while (Serial.available()) {
-        Serial.read();
+    resendNextSeq = 0;
+    resendEndSeq = 0;
+    historyNextSeq = 0;
+    telemetry_init();
+
+    // USB is always present; WiFi registers its client slots when configured
+    transport_init();
+    transport_usb_init();
+    transport_wifi_init();
+
+    for (uint8_t i = 0; i < TRANSPORT_MAX_SINKS; i++) {
+        bufferIndex[i] = 0;
+        linkProtocol[i] = LinkProtocol::JSON;
     }
 }
 
 void serial_comm_update() {
-    // Read incoming bytes and accumulate in buffer
-    while (Serial.available()) {
-        char c = Serial.read();
-
-        // Update activity timestamp when we receive data
-        lastDataReceived = millis();
-        if (!connectionActive) {
-            connectionActive = true;
-            serial_send_connected();
+    // Service network links and flush queued frames
+    transport_wifi_update();
+    transport_update();
+
+    // Read incoming bytes from every sink and accumulate per-sink lines
+    for (uint8_t i = 0; i < transport_sink_count(); i++) {
+        TransportSink* sink = transport_get_sink(i);
+        if (!sink->connected()) {
+            bufferIndex[i] = 0;
+            linkProtocol[i] = LinkProtocol::JSON;
+            sink->muted = false;
+            continue;
         }
 
-        if (c == '\n') {
-            // Complete line received - parse as command
-            inputBuffer[bufferIndex] = '\0';
-            if (bufferIndex > 0) {
-                parseCommand(String(inputBuffer));
+        int c;
+        while ((c = sink->read()) >= 0) {
+            // Before the handshake below, so a TC4 peer never sees NDJSON
+            if (bufferIndex[i] == 0) {
+                selectProtocol(i, c);
             }
-            bufferIndex = 0;
-        } else if (c != '\r') {
-            // Add to buffer if not carriage return
-            if (bufferIndex < INPUT_BUFFER_SIZE - 1) {
-                inputBuffer[bufferIndex++] = c;
-            } else {
-                // Buffer overflow - reset
-                bufferIndex = 0;
+
+            // Update activity timestamp when we receive data
+            lastDataReceived = millis();
+            if (!connectionActive) {
+                connectionActive = true;
+                serial_send_connected();
+                if (boot_is_complete()) {
+                    serial_send_boot_report();
+                    serial_send_selftest();
+                }
+            }
+
+            if (c == '\n') {
+                // Complete line received - parse as command
+                inputBuffer[i][bufferIndex[i]] = '\0';
+                if (bufferIndex[i] > 0) {
+                    if (linkProtocol[i] == LinkProtocol::TC4) {
+                        parseTc4Command(i, inputBuffer[i]);
+                    } else {
+                        parseCommand(String(inputBuffer[i]));
+                    }
+                }
+                bufferIndex[i] = 0;
+            } else if (c != '\r') {
+                // Add to buffer if not carriage return
+                if (bufferIndex[i] < INPUT_BUFFER_SIZE - 1) {
+                    inputBuffer[i][bufferIndex[i]++] = c;
+                } else {
+                    // Buffer overflow - reset
+                    bufferIndex[i] = 0;
+                }
             }
         }
     }
@@ -79,6 +155,10 @@ void serial_comm_update() {
         serial_send_state();
         lastStateUpdate = millis();
     }
+
+    // Drain any pending retransmission or history request
+    serviceResend();
+    serviceHistory();
 }
 
 bool serial_is_active() {
@@ -93,55 +173,52 @@ unsigned long serial_get_last_activity_ms() {
 
 void serial_send_state() {
     RoasterState state = state_get_current();
-    float chamberTemp = thermocouple_read_filtered();
-    float heaterTemp = thermistor_read();
 
-    String json = "{\"type\":\"roasterState\",\"timestamp\":";
-    json += String(millis());
-    json += ",\"payload\":{";
-    json += "\"state\":\"";
-    json += state_get_name(state);
-    json += "\",\"stateId\":";
-    json += String((int)state);
-    json += ",\"chamberTemp\":";
-    json += isnan(chamberTemp) ? "null" : String(chamberTemp, 1);
-    json += ",\"heaterTemp\":";
-    json += String(heaterTemp, 1);
-    json += ",\"setpoint\":";
-    json += String(state_get_setpoint(), 1);
-    json += ",\"fanSpeed\":";
-    json += String(state_get_fan_speed());
-    json += ",\"heaterPower\":";
-    json += String(state_get_heater_power());
-    json += ",\"heaterEnabled\":";
-    json += heater_is_enabled() ? "true" : "false";
-    json += ",\"pidEnabled\":";
-    json += state_is_pid_enabled() ? "true" : "false";
-    json += ",\"roastTimeMs\":";
-    json += String(state_get_roast_time_ms());
-    json += ",\"firstCrackMarked\":";
-    json += state_is_first_crack_marked() ? "true" : "false";
-    json += ",\"firstCrackTimeMs\":";
-    json += state_is_first_crack_marked() ? String(state_get_first_crack_time_ms()) : "null";
-    json += ",\"ror\":";
-    json += String(calculate_ror(), 1);
-
-    // Error info
-    if (state == RoasterState::ERROR) {
-        json += ",\"error\":{\"code\":\"";
-        json += state_get_error_code();
-        json += "\",\"message\":\"";
-        json += state_get_error_message();
-        json += "\",\"fatal\":";
-        json += state_is_error_fatal() ? "true" : "false";
-        json += "}";
+    TelemetrySample sample;
+    sample.timestampMs = millis();
+    sample.stateId = (uint8_t)state;
+    sample.chamberTemp = thermocouple_read_filtered();
+    sample.heaterTemp = thermistor_read();
+    sample.setpoint = state_get_control_setpoint();
+    sample.fanSpeed = state_get_fan_speed();
+    sample.heaterPower = state_get_heater_power();
+    sample.roastTimeMs = state_get_roast_time_ms();
+    sample.firstCrackTimeMs = state_get_first_crack_time_ms();
+    sample.ror = calculate_ror();
+    sample.flags = 0;
+    if (heater_is_enabled())          sample.flags |= TELEMETRY_FLAG_HEATER_ENABLED;
+    if (state_is_pid_enabled())       sample.flags |= TELEMETRY_FLAG_PID_ENABLED;
+    if (state_is_first_crack_marked()) sample.flags |= TELEMETRY_FLAG_FIRST_CRACK;
+    if (state_is_resume_pending())    sample.flags |= TELEMETRY_FLAG_RESUME_AVAILABLE;
+    if (profile_is_active())          sample.flags |= TELEMETRY_FLAG_PROFILE_ACTIVE;
+    sample.profileLeadMs = profile_get_lead_ms(sample.chamberTemp);
+    bool preheating = state == RoasterState::PREHEAT;
+    if (preheating && preheat_is_ready()) sample.flags |= TELEMETRY_FLAG_PREHEAT_READY;
+    sample.preheatEtaMs = preheating ? preheat_get_eta_ms() : PREHEAT_ETA_UNKNOWN;
+
+    telemetry_record(sample);
+    sendStateFrame(sample, false);
+}
+
+static void sendStateFrame(const TelemetrySample& sample, bool replay) {
+    static char frame[TELEMETRY_JSON_MAX + 160];
+    char tail[160];
+
+    // Error info (not retained in the ring - replayed frames report null)
+    if ((RoasterState)sample.stateId == RoasterState::ERROR && !replay) {
+        snprintf(tail, sizeof(tail), "\"error\":{\"code\":\"%s\",\"message\":\"%s\",\"fatal\":%s}",
+                 state_get_error_code(), state_get_error_message(), state_is_error_fatal() ? "true" : "false");
     } else {
-        json += ",\"error\":null";
+        strcpy(tail, "\"error\":null");
     }
 
-    json += "}}";
+    size_t len = telemetry_encode_json(sample, replay, tail, frame, sizeof(frame));
+    if (len == 0) {
+        return;
+    }
 
-    Serial.println(json);
+    // Telemetry is recoverable via resend, so slow network sinks may shed it
+    transport_send(frame, len, true);
 }
 
 void serial_send_error(int code, const char* message) {
@@ -153,7 +230,7 @@ void serial_send_error(int code, const char* message) {
     json += message;
     json += "\"}}";
 
-    Serial.println(json);
+    sendFrame(json, false);
 }
 
 void serial_send_event(const char* event, const char* data) {
@@ -173,7 +250,7 @@ void serial_send_event(const char* event, const char* data) {
     }
     json += "}}";
 
-    Serial.println(json);
+    sendFrame(json, false);
 }
 
 void serial_send_connected() {
@@ -181,9 +258,135 @@ void serial_send_connected() {
     json += String(millis());
     json += ",\"payload\":{\"firmware\":\"";
     json += FIRMWARE_VERSION;
-    json += "\"}}";
+    json += "\",\"seq\":";
+    json += String(telemetry_latest_seq());
+    json += "}}";
+
+    sendFrame(json, false);
+}
+
+void serial_send_boot_report() {
+    String json = "{\"type\":\"bootReport\",\"timestamp\":";
+    json += String(millis());
+    json += ",\"payload\":{\"phasesUs\":{";
+    for (int i = 0; i < (int)BootPhase::COUNT; i++) {
+        if (i > 0) json += ",";
+        json += "\"";
+        json += boot_get_phase_name((BootPhase)i);
+        json += "\":";
+        json += String(boot_get_phase_us((BootPhase)i));
+    }
+    json += "},\"resumed\":";
+    json += boot_was_resumed() ? "true" : "false";
+    json += "}}";
+
+    sendFrame(json, false);
+}
+
+void serial_send_selftest() {
+    String json = "{\"type\":\"selfTest\",\"timestamp\":";
+    json += String(millis());
+    json += ",\"payload\":{\"passed\":";
+    json += selftest_passed() ? "true" : "false";
+    json += ",\"tests\":[";
+    for (int i = 0; i < (int)SelfTestId::COUNT; i++) {
+        const SelfTestResult& result = selftest_get_result((SelfTestId)i);
+        if (i > 0) json += ",";
+        json += "{\"name\":\"";
+        json += selftest_get_name((SelfTestId)i);
+        json += "\",\"status\":\"";
+        json += selftest_get_status_name(result.status);
+        json += "\",\"durationUs\":";
+        json += String(result.durationUs);
+        json += ",\"value\":";
+        json += isnan(result.value) ? "null" : String(result.value, 2);
+        json += "}";
+    }
+    json += "]}}";
+
+    sendFrame(json, false);
+}
+
+void serial_send_fault_history() {
+    String json = "{\"type\":\"faultHistory\",\"timestamp\":";
+    json += String(millis());
+    json += ",\"payload\":{\"faults\":[";
+    for (uint8_t i = 0; i < safety_get_fault_history_count(); i++) {
+        const FaultRecord* record = safety_get_fault_history(i);
+        if (i > 0) json += ",";
+        json += "{\"timestampMs\":";
+        json += String(record->timestampMs);
+        json += ",\"code\":\"";
+        json += record->code;
+        json += "\",\"fatal\":";
+        json += record->fatal ? "true" : "false";
+        json += "}";
+    }
+    json += "]}}";
 
-    Serial.println(json);
+    sendFrame(json, false);
+}
+
+static void appendSensorStats(String& json, const char* key, const ThermocoupleStats& stats) {
+    json += ",\"";
+    json += key;
+    json += "\":{\"samples\":";
+    json += String(stats.samples);
+    json += ",\"faults\":";
+    json += String(stats.faults);
+    json += ",\"noiseRms\":";
+    float noise = thermocouple_noise_rms(stats);
+    json += isnan(noise) ? "null" : String(noise, 3);
+    json += "}";
+}
+
+void serial_send_sensor_stats() {
+    String json = "{\"type\":\"sensorStats\",\"timestamp\":";
+    json += String(millis());
+    json += ",\"payload\":{\"ssrGuardMs\":";
+    json += String(SAMPLE_SSR_GUARD_MS);
+    json += ",\"deferred\":";
+    json += String(sampling_get_deferred());
+    json += ",\"intervalMs\":";
+    json += String(sampling_get_interval_ms());
+    appendSensorStats(json, "heaterOn", thermocouple_get_stats(true));
+    appendSensorStats(json, "heaterOff", thermocouple_get_stats(false));
+    json += "}}";
+
+    sendFrame(json, false);
+}
+
+void serial_send_profile_status() {
+    String json = "{\"type\":\"profileStatus\",\"timestamp\":";
+    json += String(millis());
+    json += ",\"payload\":{\"loaded\":";
+    json += profile_is_loaded() ? "true" : "false";
+    json += ",\"active\":";
+    json += profile_is_active() ? "true" : "false";
+    json += ",\"points\":";
+    json += String(profile_get_points());
+    json += ",\"received\":";
+    json += String(profile_get_received());
+    json += ",\"stepMs\":";
+    json += String(profile_get_step_ms());
+    json += ",\"fanEvents\":";
+    json += String(profile_get_fan_events());
+    json += ",\"durationMs\":";
+    json += String(profile_get_duration_ms());
+    json += ",\"elapsedMs\":";
+    json += String(profile_get_elapsed_ms());
+    json += ",\"error\":";
+    const char* error = profile_get_error();
+    if (error[0]) {
+        json += "\"";
+        json += error;
+        json += "\"";
+    } else {
+        json += "null";
+    }
+    json += "}}";
+
+    sendFrame(json, false);
 }
 
 void serial_send_log(const char* level, const char* source, const char* message) {
@@ -203,7 +406,129 @@ void serial_send_log(const char* level, const char* source, const char* message)
     }
     json += "\"}}";
 
-    Serial.println(json);
+    // Debug chatter may be shed by slow network sinks
+    sendFrame(json, strcmp(level, "debug") == 0);
+}
+
+static void sendFrame(const String& json, bool droppable) {
+    transport_send(json.c_str(), json.length(), droppable);
+}
+
+// ============== Telemetry Resend ==============
+
+static void queueResend(uint32_t fromSeq, uint32_t toSeq) {
+    uint32_t latest = telemetry_latest_seq();
+    if (fromSeq == 0 || fromSeq > toSeq || fromSeq > latest) {
+        return;
+    }
+    if (toSeq > latest) {
+        toSeq = latest;
+    }
+
+    // Report any part of the range that has already been evicted
+    uint32_t oldest = telemetry_oldest_seq();
+    if (fromSeq < oldest) {
+        String json = "{\"type\":\"resendMiss\",\"timestamp\":";
+        json += String(millis());
+        json += ",\"payload\":{\"fromSeq\":";
+        json += String(fromSeq);
+        json += ",\"toSeq\":";
+        json += String(toSeq < oldest ? toSeq : oldest - 1);
+        json += "}}";
+        sendFrame(json, false);
+
+        if (toSeq < oldest) {
+            return;
+        }
+        fromSeq = oldest;
+    }
+
+    // A new request replaces whatever was still pending
+    resendNextSeq = fromSeq;
+    resendEndSeq = toSeq;
+}
+
+static void serviceResend() {
+    for (uint8_t sent = 0; sent < TELEMETRY_RESEND_BURST; sent++) {
+        if (resendNextSeq == 0 || resendNextSeq > resendEndSeq) {
+            resendNextSeq = 0;
+            return;
+        }
+
+        // Samples may be evicted while a long range is draining
+        const TelemetrySample* sample = telemetry_find(resendNextSeq);
+        if (sample) {
+            sendStateFrame(*sample, true);
+        }
+        resendNextSeq++;
+    }
+}
+
+// ============== Downsampled History ==============
+
+static void markHistorySample(uint32_t index, void* context) {
+    (void)context;
+    historyMask[index / 8] |= (uint8_t)(1 << (index % 8));
+}
+
+// Reduce the whole retained ring to about `points` frames (state changes
+// and first crack always kept) and queue them as replay frames
+static void queueHistory(uint32_t points, DownsampleMode mode) {
+    uint32_t fromSeq = telemetry_oldest_seq();
+    uint32_t toSeq = telemetry_latest_seq();
+    if (fromSeq == 0) {
+        return;
+    }
+
+    memset(historyMask, 0, sizeof(historyMask));
+    uint32_t count = toSeq - fromSeq + 1;
+    historyReducer.begin(mode, count, points, markHistorySample, nullptr);
+
+    const TelemetrySample* first = telemetry_find(fromSeq);
+    const TelemetrySample* prev = nullptr;
+    for (uint32_t seq = fromSeq; seq <= toSeq; seq++) {
+        const TelemetrySample* sample = telemetry_find(seq);
+        bool pinned = prev && (sample->stateId != prev->stateId ||
+                               ((sample->flags ^ prev->flags) & TELEMETRY_FLAG_FIRST_CRACK));
+        historyReducer.push((float)(sample->timestampMs - first->timestampMs), sample->chamberTemp, pinned);
+        prev = sample;
+    }
+    historyReducer.finish();
+
+    historyFromSeq = fromSeq;
+    historyToSeq = toSeq;
+    historyNextSeq = fromSeq;
+}
+
+static void serviceHistory() {
+    uint8_t sent = 0;
+    while (historyNextSeq != 0 && sent < TELEMETRY_RESEND_BURST) {
+        if (historyNextSeq > historyToSeq) {
+            String json = "{\"type\":\"historyEnd\",\"timestamp\":";
+            json += String(millis());
+            json += ",\"payload\":{\"fromSeq\":";
+            json += String(historyFromSeq);
+            json += ",\"toSeq\":";
+            json += String(historyToSeq);
+            json += ",\"points\":";
+            json += String(historyReducer.emitted());
+            json += "}}";
+            sendFrame(json, false);
+            historyNextSeq = 0;
+            return;
+        }
+
+        uint32_t bit = historyNextSeq - historyFromSeq;
+        if (historyMask[bit / 8] & (1 << (bit % 8))) {
+            // Samples may be evicted while the history is draining
+            const TelemetrySample* sample = telemetry_find(historyNextSeq);
+            if (sample) {
+                sendStateFrame(*sample, true);
+                sent++;
+            }
+        }
+        historyNextSeq++;
+    }
 }
 
 // ============== Command Parsing ==============
@@ -233,6 +558,9 @@ static void parseCommand(const String& message) {
         state_handle_event(RoasterEvent::FIRST_CRACK);
         serial_send_event("FIRST_CRACK", nullptr);
     }
+    else if (message.indexOf("\"type\":\"resumeRoast\"") >= 0) {
+        state_handle_event(RoasterEvent::RESUME_ROAST);
+    }
     else if (message.indexOf("\"type\":\"stop\"") >= 0) {
         state_handle_event(RoasterEvent::STOP);
     }
@@ -280,6 +608,80 @@ static void parseCommand(const String& message) {
     else if (message.indexOf("\"type\":\"getState\"") >= 0) {
         serial_send_state();
     }
+    else if (message.indexOf("\"type\":\"getSelfTest\"") >= 0) {
+        if (boot_is_complete()) {
+            serial_send_selftest();
+        }
+    }
+    else if (message.indexOf("\"type\":\"getFaultHistory\"") >= 0) {
+        serial_send_fault_history();
+    }
+    else if (message.indexOf("\"type\":\"getSensorStats\"") >= 0) {
+        serial_send_sensor_stats();
+    }
+    else if (message.indexOf("\"type\":\"resend\"") >= 0) {
+        int fromIdx = message.indexOf("\"fromSeq\":");
+        int toIdx = message.indexOf("\"toSeq\":");
+        if (fromIdx >= 0 && toIdx >= 0) {
+            uint32_t fromSeq = (uint32_t)message.substring(fromIdx + 10).toInt();
+            uint32_t toSeq = (uint32_t)message.substring(toIdx + 8).toInt();
+            queueResend(fromSeq, toSeq);
+        }
+    }
+    else if (message.indexOf("\"type\":\"downloadHistory\"") >= 0) {
+        // {"points":n,"mode":"lttb"|"minmax"} - replaces any pending download
+        int pointsIdx = message.indexOf("\"points\":");
+        long points = pointsIdx >= 0 ? message.substring(pointsIdx + 9).toInt() : 0;
+        DownsampleMode mode = message.indexOf("\"mode\":\"minmax\"") >= 0 ? DownsampleMode::MIN_MAX
+                                                                         : DownsampleMode::LTTB;
+        if (points <= 0 || points > TELEMETRY_RING_SIZE) {
+            points = TELEMETRY_RING_SIZE;
+        }
+        queueHistory((uint32_t)points, mode);
+    }
+    else if (message.indexOf("\"type\":\"profileBegin\"") >= 0) {
+        int pointsIdx = message.indexOf("\"points\":");
+        int stepIdx = message.indexOf("\"stepMs\":");
+        long points = pointsIdx >= 0 ? message.substring(pointsIdx + 9).toInt() : 0;
+        long stepMs = stepIdx >= 0 ? message.substring(stepIdx + 9).toInt() : 0;
+        if (points < 0 || points > 65535 || stepMs < 0 || stepMs > 65535 ||
+            !profile_begin((uint16_t)points, (uint16_t)stepMs)) {
+            serial_send_profile_status();
+        }
+    }
+    else if (message.indexOf("\"type\":\"profileData\"") >= 0) {
+        // {"offset":n,"temps":[deci-°C,...]} - chunked to fit the line buffer
+        int16_t temps[PROFILE_CHUNK_MAX];
+        int offsetIdx = message.indexOf("\"offset\":");
+        long offset = offsetIdx >= 0 ? message.substring(offsetIdx + 9).toInt() : -1;
+        uint16_t count = parseIntArray(message, "\"temps\":[", temps, PROFILE_CHUNK_MAX);
+        if (offset < 0 || offset > 65535 || !profile_add_points((uint16_t)offset, temps, count)) {
+            serial_send_profile_status();
+        }
+    }
+    else if (message.indexOf("\"type\":\"profileFan\"") >= 0) {
+        // {"events":[atSec,speed,atSec,speed,...]}
+        int16_t values[PROFILE_CHUNK_MAX];
+        uint16_t count = parseIntArray(message, "\"events\":[", values, PROFILE_CHUNK_MAX);
+        for (uint16_t i = 0; i + 1 < count; i += 2) {
+            int16_t speed = values[i + 1] > FAN_MAX_DUTY ? FAN_MAX_DUTY : values[i + 1];
+            if (values[i] < 0 || speed < 0 || !profile_add_fan((uint16_t)values[i], (uint8_t)speed)) {
+                serial_send_profile_status();
+                break;
+            }
+        }
+    }
+    else if (message.indexOf("\"type\":\"profileEnd\"") >= 0) {
+        profile_end();
+        serial_send_profile_status();
+    }
+    else if (message.indexOf("\"type\":\"clearProfile\"") >= 0) {
+        profile_clear();
+        serial_send_profile_status();
+    }
+    else if (message.indexOf("\"type\":\"getProfile\"") >= 0) {
+        serial_send_profile_status();
+    }
     else if (message.indexOf("\"type\":\"debugFan\"") >= 0) {
         fan_debug_dump();
     }
@@ -288,3 +690,167 @@ static void parseCommand(const String& message) {
     }
     // Unknown command - ignore silently
 }
+
+// ============== TC4 Personality ==============
+// Artisan polls TC4 boards (aArtisanQ_PID) with "CMD;arg;arg" lines. Only
+// READ, CHAN, FILT and UNITS are answered: Artisan reads exactly one line
+// after those and none after the output commands, so a stray reply would
+// be taken as the next READ.
+
+static void selectProtocol(uint8_t sink, int c) {
+#if TC4_AUTODETECT
+    // NDJSON lines always start with '{', TC4 commands with a capital
+    if (c == '{') {
+        linkProtocol[sink] = LinkProtocol::JSON;
+    } else if (c >= 'A' && c <= 'Z') {
+        linkProtocol[sink] = LinkProtocol::TC4;
+    } else {
+        return;
+    }
+    transport_get_sink(sink)->muted = linkProtocol[sink] == LinkProtocol::TC4;
+#else
+    (void)sink;
+    (void)c;
+#endif
+}
+
+// True if `line` is `command` alone or followed by ';'
+static bool tc4Is(const char* line, const char* command) {
+    size_t len = strlen(command);
+    return strncmp(line, command, len) == 0 && (line[len] == '\0' || line[len] == ';');
+}
+
+static float tc4Temp(float celsius) {
+    return tc4Fahrenheit ? celsius * 9.0f / 5.0f + 32.0f : celsius;
+}
+
+static void sendTc4Reply(uint8_t sink, const char* line) {
+    transport_send_to(sink, line, strlen(line));
+}
+
+// "ambient,T1..T4 (active channels only),heater,fan,setpoint" from the
+// last recorded sample - no sensor reads, so polling costs the control
+// loop nothing
+static void sendTc4Read(uint8_t sink) {
+    const TelemetrySample* sample = telemetry_find(telemetry_latest_seq());
+    TelemetrySample empty = {};
+    if (!sample) {
+        sample = &empty;
+    }
+
+    char reply[96];
+    int len = snprintf(reply, sizeof(reply), "%.1f", tc4Temp(thermocouple_last_cold_junction()));
+    for (uint8_t i = 0; i < 4 && len < (int)sizeof(reply); i++) {
+        float temp;
+        switch (tc4Channels[i]) {
+            case '0': continue;
+            case '1': temp = sample->chamberTemp; break;
+            case '2': temp = sample->heaterTemp; break;
+            default:  temp = 0; break;   // No sensor on TC4 ports 3/4
+        }
+        len += snprintf(reply + len, sizeof(reply) - len, ",%.1f", tc4Temp(temp));
+    }
+    if (len < (int)sizeof(reply)) {
+        snprintf(reply + len, sizeof(reply) - len, ",%u,%u,%.1f", sample->heaterPower, sample->fanSpeed,
+                 tc4Temp(sample->setpoint));
+    }
+    sendTc4Reply(sink, reply);
+}
+
+static void parseTc4Pid(const char* arg) {
+    RoasterState state = state_get_current();
+
+    if (tc4Is(arg, "SV")) {
+        float value = atof(arg + 3);
+        if (tc4Fahrenheit) {
+            value = (value - 32.0f) * 5.0f / 9.0f;
+        }
+        tc4Setpoint = value;
+        state_handle_event(RoasterEvent::SET_SETPOINT, value);
+    }
+    else if (tc4Is(arg, "ON")) {
+        // Hand the heater to our PID: preheat to the last SV
+        if (state == RoasterState::MANUAL) {
+            state_handle_event(RoasterEvent::EXIT_MANUAL);
+        }
+        state_handle_event(RoasterEvent::START_PREHEAT, tc4Setpoint);
+    }
+    else if (tc4Is(arg, "GO")) {
+        state_handle_event(RoasterEvent::LOAD_BEANS, tc4Setpoint);
+    }
+    else if (tc4Is(arg, "OFF") || tc4Is(arg, "STOP")) {
+        if (state == RoasterState::ROASTING) {
+            state_handle_event(RoasterEvent::END_ROAST);
+        } else if (state == RoasterState::PREHEAT) {
+            state_handle_event(RoasterEvent::STOP);
+        }
+    }
+    // PID;T (tunings) is ignored - pid_auto_tune() schedules the gains
+}
+
+static void parseTc4Command(uint8_t sink, const char* line) {
+    const char* arg = strchr(line, ';');
+    arg = arg ? arg + 1 : "";
+
+    if (tc4Is(line, "READ")) {
+        sendTc4Read(sink);
+    }
+    else if (tc4Is(line, "CHAN")) {
+        for (uint8_t i = 0; i < 4; i++) {
+            char c = *arg ? *arg++ : '0';   // Short lists leave the rest off
+            tc4Channels[i] = (c >= '0' && c <= '4') ? c : '0';
+        }
+        char reply[40];
+        snprintf(reply, sizeof(reply), "# Active channels set to %s", tc4Channels);
+        sendTc4Reply(sink, reply);
+    }
+    else if (tc4Is(line, "FILT")) {
+        // Our own low-pass filter (LPF_TIME_CONSTANT_MS) already applies
+        sendTc4Reply(sink, "# Filter levels ignored");
+    }
+    else if (tc4Is(line, "UNITS")) {
+        tc4Fahrenheit = arg[0] == 'F';
+        sendTc4Reply(sink, tc4Fahrenheit ? "# Changed units to F" : "# Changed units to C");
+    }
+    else if (tc4Is(line, "OT1")) {
+        // Heater slider: direct power needs MANUAL, which is entered from OFF
+        float power = atof(arg);
+        if (power > 0 && state_get_current() == RoasterState::OFF) {
+            state_handle_event(RoasterEvent::ENTER_MANUAL);
+        }
+        state_handle_event(RoasterEvent::SET_HEATER_POWER, power);
+    }
+    else if (tc4Is(line, "IO3")) {
+        float speed = atof(arg);
+        if (speed > 0 && state_get_current() == RoasterState::OFF) {
+            state_handle_event(RoasterEvent::START_FAN_ONLY, speed);
+        } else {
+            state_handle_event(RoasterEvent::SET_FAN_SPEED, speed);
+        }
+    }
+    else if (tc4Is(line, "PID")) {
+        parseTc4Pid(arg);
+    }
+    // Other TC4 commands (OT2, DCFA, ...) - ignore silently
+}
+
+// Read up to `max` integers from the JSON array that follows `key`
+// (key includes the opening bracket); returns the count read
+static uint16_t parseIntArray(const String& message, const char* key, int16_t* out, uint16_t max) {
+    int idx = message.indexOf(key);
+    if (idx < 0) return 0;
+
+    const char* p = message.c_str() + idx + strlen(key);
+    uint16_t count = 0;
+    while (count < max) {
+        char* end;
+        long value = strtol(p, &end, 10);
+        if (end == p) break;
+        out[count++] = (int16_t)constrain(value, -32768L, 32767L);
+        p = end;
+        while (*p == ' ') p++;
+        if (*p != ',') break;
+        p++;
+    }
+    return count;
+}
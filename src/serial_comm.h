@@ -24,6 +24,21 @@ void serial_send_event(const char* event, const char* data);
 // Send connection acknowledgment with firmware version
 void serial_send_connected();
 
+// Send boot phase timings (sent once boot completes and on each new connection)
+void serial_send_boot_report();
+
+// Send boot self-test results
+void serial_send_selftest();
+
+// Send the recent fault history
+void serial_send_fault_history();
+
+// Send thermocouple sample statistics, split by heater SSR state
+void serial_send_sensor_stats();
+
+// Send the reference profile upload / replay status
+void serial_send_profile_status();
+
 // Send a log message (replaces Serial.print for debug output)
 // level: "debug", "info", "warn", "error"
 void serial_send_log(const char* level, const char* source, const char* message);
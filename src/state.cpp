@@ -2,8 +2,13 @@
 #include "config.h"
 #include "hardware.h"
 #include "pid_control.h"
+#include "cascade.h"
+#include "coordinated.h"
+#include "preheat.h"
 #include "safety.h"
 #include "serial_comm.h"
+#include "checkpoint.h"
+#include "profile.h"
 
 // ============== Internal State ==============
 
@@ -31,9 +36,21 @@ static uint8_t _manual_heater_power = 0;
 // Fan-only mode settings
 static uint8_t _fan_only_speed = 50;
 
+// Warm-restart resume offer (roast recovered from checkpoint)
+static bool _resume_pending = false;
+static unsigned long _resume_offer_time = 0;
+static uint8_t _resume_fan_speed = FAN_ROAST_DEFAULT;
+
+// Chamber loop: runs once per thermocouple sample, its demand held between
+static uint32_t _control_sample = 0;
+static float _heat_demand = 0;
+
 // ============== Forward Declarations ==============
 static void _enter_state(RoasterState new_state);
 static void _exit_state(RoasterState old_state);
+static void _run_heat_control(float chamber_temp);
+static void _drive_heater(float demand);
+static bool _new_sample();
 
 // ============== State Machine Interface ==============
 
@@ -56,6 +73,52 @@ void state_init() {
     serial_send_log("info", "STATE", "State machine initialized - OFF");
 }
 
+bool state_resume(const RoastCheckpoint& ckpt) {
+    RoasterState saved = (RoasterState)ckpt.stateId;
+    if (saved != RoasterState::PREHEAT &&
+        saved != RoasterState::ROASTING &&
+        saved != RoasterState::COOLING) {
+        return false;
+    }
+
+    // Without a valid conversion the outage cannot be judged - stay cold
+    if (!thermocouple_has_reading()) {
+        serial_send_log("warn", "STATE", "Roast checkpoint discarded (no chamber reading)");
+        checkpoint_clear();
+        return false;
+    }
+
+    // A cold chamber means the outage was long - the roast is not recoverable
+    if (thermocouple_read_filtered() < COOLING_TARGET_TEMP) {
+        serial_send_log("info", "STATE", "Stale roast checkpoint discarded (chamber cold)");
+        checkpoint_clear();
+        return false;
+    }
+
+    _setpoint = ckpt.setpoint;
+    _preheat_target = ckpt.preheatTarget;
+    _roast_start_time = millis() - ckpt.roastElapsedMs;
+    _preheat_start_time = _roast_start_time;
+    _first_crack_marked = ckpt.firstCrackMarked != 0;
+    _first_crack_time = ckpt.firstCrackTimeMs;
+
+    // Never re-enable the heater without the operator - cool first
+    _enter_state(RoasterState::COOLING);
+
+    if (saved == RoasterState::ROASTING || ckpt.resumable) {
+        _resume_pending = true;
+        _resume_offer_time = millis();
+        _resume_fan_speed = ckpt.fanSpeed;
+        serial_send_log("warn", "STATE", "Roast interrupted by reset - cooling, resume available");
+    } else {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "Recovered %s after reset - cooling", state_get_name(saved));
+        serial_send_log("warn", "STATE", msg);
+    }
+
+    return true;
+}
+
 void state_update() {
     // Read current temperature
     float chamber_temp = thermocouple_read_filtered();
@@ -72,10 +135,11 @@ void state_update() {
             break;
 
         case RoasterState::PREHEAT:
-            // Run PID to reach preheat temperature
-            pid_update(chamber_temp);
-            heater_set_pid_output(pid_get_output());
-            heater_update();
+            // Full power, coast, then PID hold onto the preheat target
+            if (_new_sample()) {
+                _heat_demand = preheat_update(chamber_temp);
+            }
+            _drive_heater(_heat_demand);
             
             // Check for preheat timeout
             if (millis() - _preheat_start_time > PREHEAT_TIMEOUT_MS) {
@@ -84,13 +148,27 @@ void state_update() {
             break;
             
         case RoasterState::ROASTING:
-            // Run PID to maintain setpoint
-            pid_update(chamber_temp);
-            heater_set_pid_output(pid_get_output());
-            heater_update();
+            // Follow the reference curve, reapplying its fan changes
+            if (profile_is_active()) {
+                pid_track_setpoint(profile_update());
+                uint8_t speed;
+                if (profile_take_fan(speed)) {
+                    coord_set_operator_fan(speed < FAN_ROAST_MIN_DUTY ? FAN_ROAST_MIN_DUTY : speed);
+                }
+            }
+
+            // Run PID to maintain setpoint, letting the fan help when enabled
+            _run_heat_control(chamber_temp);
+            coord_update(chamber_temp, pid_get_setpoint());
             break;
             
         case RoasterState::COOLING:
+            // Withdraw an unanswered resume offer
+            if (_resume_pending && millis() - _resume_offer_time > RESUME_WINDOW_MS) {
+                _resume_pending = false;
+                serial_send_log("info", "STATE", "Roast resume window expired");
+            }
+
             // Check if cooling is complete
             if (chamber_temp < COOLING_TARGET_TEMP) {
                 state_handle_event(RoasterEvent::COOL_COMPLETE);
@@ -109,6 +187,37 @@ void state_update() {
     }
 }
 
+// True once per thermocouple sample. The chamber value is held between
+// samples (sampling.cpp), so the PID only steps on fresh data and its dt is
+// the sample spacing - stepping every loop would see a 1 ms jump per sample
+// and kick the derivative term into the output limits.
+static bool _new_sample() {
+    uint32_t count = thermocouple_sample_count();
+    if (count == _control_sample) return false;
+    _control_sample = count;
+    return true;
+}
+
+// Chamber PID to the heater
+static void _run_heat_control(float chamber_temp) {
+    if (_new_sample()) {
+        pid_update(chamber_temp);
+        _heat_demand = pid_get_output();
+    }
+    _drive_heater(_heat_demand);
+}
+
+// Heater demand (0-255) straight to the SSR, or through the element loop
+// (cascade.h - it reads the thermistor itself on its own interval)
+static void _drive_heater(float demand) {
+#if PID_CASCADE_ENABLED
+    heater_set_pid_output(cascade_update(demand));
+#else
+    heater_set_pid_output(demand);
+#endif
+    heater_update();
+}
+
 void state_handle_event(RoasterEvent event, float value) {
     char msg[64];
     snprintf(msg, sizeof(msg), "Event: %d in state: %s", (int)event, state_get_name(_current_state));
@@ -209,7 +318,13 @@ void state_handle_event(RoasterEvent event, float value) {
                 if (_current_state == RoasterState::PREHEAT) {
                     _preheat_target = value;
                     pid_set_setpoint(value);
+                    preheat_begin(value);
                 } else if (_current_state == RoasterState::ROASTING) {
+                    // A manual setpoint takes over from the reference curve
+                    if (profile_is_active()) {
+                        profile_stop();
+                        serial_send_log("info", "STATE", "Profile replay cancelled by setpoint change");
+                    }
                     pid_set_setpoint(value);
                 }
                 char msg[48];
@@ -235,7 +350,11 @@ void state_handle_event(RoasterEvent event, float value) {
                     if (speed < FAN_ROAST_MIN_DUTY) {
                         speed = FAN_ROAST_MIN_DUTY;
                     }
-                    fan_set_speed(speed);
+                    if (_current_state == RoasterState::ROASTING) {
+                        coord_set_operator_fan(speed);
+                    } else {
+                        fan_set_speed(speed);
+                    }
                 }
                 char msg[48];
                 snprintf(msg, sizeof(msg), "Fan speed changed to %d", speed);
@@ -268,6 +387,24 @@ void state_handle_event(RoasterEvent event, float value) {
             }
             break;
             
+        case RoasterEvent::RESUME_ROAST:
+            if (_current_state == RoasterState::COOLING && _resume_pending) {
+                // ROASTING entry resets first crack - carry recovered values across
+                bool first_crack_marked = _first_crack_marked;
+                unsigned long first_crack_time = _first_crack_time;
+
+                _enter_state(RoasterState::ROASTING);
+
+                _first_crack_marked = first_crack_marked;
+                _first_crack_time = first_crack_time;
+                uint8_t speed = _resume_fan_speed;
+                if (speed < FAN_ROAST_MIN_DUTY) speed = FAN_ROAST_MIN_DUTY;
+                coord_set_operator_fan(speed);
+
+                serial_send_log("info", "STATE", "Roast resumed by operator");
+            }
+            break;
+
         case RoasterEvent::NONE:
         default:
             break;
@@ -300,6 +437,13 @@ float state_get_setpoint() {
     return _setpoint;
 }
 
+float state_get_control_setpoint() {
+    if (_current_state == RoasterState::ROASTING && profile_is_active()) {
+        return pid_get_setpoint();
+    }
+    return state_get_setpoint();
+}
+
 void state_set_setpoint(float setpoint) {
     _setpoint = setpoint;
 }
@@ -357,6 +501,14 @@ bool state_is_pid_enabled() {
             _current_state == RoasterState::ROASTING);
 }
 
+bool state_is_resume_pending() {
+    return _resume_pending;
+}
+
+uint8_t state_get_resume_fan_speed() {
+    return _resume_fan_speed;
+}
+
 bool state_allows_setpoint_change() {
     return (_current_state == RoasterState::OFF ||
             _current_state == RoasterState::PREHEAT ||
@@ -408,11 +560,13 @@ static void _exit_state(RoasterState old_state) {
             break;
             
         case RoasterState::ROASTING:
-            // Roast complete
+            // Roast complete - the profile stays armed for the next charge
+            profile_stop();
             break;
             
         case RoasterState::COOLING:
-            // Cooling complete
+            // Leaving COOLING by any path withdraws a resume offer
+            _resume_pending = false;
             break;
             
         case RoasterState::MANUAL:
@@ -477,7 +631,10 @@ static void _enter_state(RoasterState new_state) {
             // Configure and enable PID for preheat target
             pid_set_setpoint(_preheat_target);
             pid_reset();
+            _heat_demand = 0;
+            cascade_reset();
             pid_enable();
+            preheat_begin(_preheat_target);
             
             // Enable heater (controlled by PID)
             heater_enable();
@@ -495,10 +652,13 @@ static void _enter_state(RoasterState new_state) {
             // Configure PID for roast setpoint
             pid_set_setpoint(_setpoint);
             pid_reset();
+            _heat_demand = 0;
+            cascade_reset();
             pid_enable();
 
             // Set fan to roasting default (90%)
             fan_set_speed(FAN_ROAST_DEFAULT);
+            coord_reset(FAN_ROAST_DEFAULT);
             fan_enable();
             
             // Heater continues (controlled by PID)
@@ -506,8 +666,14 @@ static void _enter_state(RoasterState new_state) {
             
             // Reset RoR calculation for new roast
             reset_ror();
+
+            // Charge is offset zero of an armed reference curve
+            if (profile_is_loaded()) {
+                profile_start();
+                pid_track_setpoint(profile_update());
+            }
             
-            snprintf(msg, sizeof(msg), "Roasting at setpoint %.1f°C", _setpoint);
+            snprintf(msg, sizeof(msg), "Roasting at setpoint %.1f°C", pid_get_setpoint());
             serial_send_log("info", "STATE", msg);
             break;
             
@@ -516,9 +682,10 @@ static void _enter_state(RoasterState new_state) {
             heater_disable();
             pid_disable();
             
-            // Fan at maximum for cooling
+            // Fan at maximum for cooling - no ramp, the beans are hot now
             fan_set_speed(FAN_COOLING_DUTY);
             fan_enable();
+            fan_skip_ramp();
             
             serial_send_log("info", "STATE", "Cooling - heater OFF, fan MAX");
             break;
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 
+struct RoastCheckpoint;  // checkpoint.h
+
 // ============== State Enumeration ==============
 enum class RoasterState {
     OFF = 0,
@@ -32,7 +34,8 @@ enum class RoasterEvent {
     SET_SETPOINT,
     SET_FAN_SPEED,
     SET_HEATER_POWER,
-    DISCONNECTED
+    DISCONNECTED,
+    RESUME_ROAST        // Operator confirms resuming a roast recovered after reset
 };
 
 // ============== State Machine Interface ==============
@@ -40,6 +43,13 @@ enum class RoasterEvent {
 // Initialize the state machine
 void state_init();
 
+// Recover an interrupted roast from a boot-time checkpoint (call after state_init
+// and once the sampler has a valid chamber reading)
+// COOLING and PREHEAT resume into COOLING; ROASTING, or a checkpoint whose offer
+// was still open, resumes into COOLING with a RESUME_ROAST offer open for
+// RESUME_WINDOW_MS. Returns true if resumed.
+bool state_resume(const RoastCheckpoint& ckpt);
+
 // Update the state machine (call every loop iteration)
 void state_update();
 
@@ -58,6 +68,10 @@ const char* state_get_name(RoasterState state);
 float state_get_setpoint();
 void state_set_setpoint(float setpoint);
 
+// Setpoint the PID is tracking right now - the reference curve while a
+// profile replays, otherwise the same as state_get_setpoint()
+float state_get_control_setpoint();
+
 // Preheat target temperature (°C)
 float state_get_preheat_target();
 void state_set_preheat_target(float target);
@@ -81,6 +95,12 @@ bool state_is_error_fatal();
 // PID status
 bool state_is_pid_enabled();
 
+// True while a recovered roast is waiting for RESUME_ROAST confirmation
+bool state_is_resume_pending();
+
+// Fan speed the roast resumes at (valid while a resume is pending)
+uint8_t state_get_resume_fan_speed();
+
 // Check if state allows parameter changes
 bool state_allows_setpoint_change();
 bool state_allows_fan_change();
@@ -0,0 +1,41 @@
+#include "telemetry.h"
+#include "config.h"
+
+// ============== Internal State ==============
+
+static TelemetrySample _ring[TELEMETRY_RING_SIZE];
+static uint32_t _next_seq = 1;
+static uint16_t _count = 0;
+
+// ============== Telemetry Ring Implementation ==============
+
+void telemetry_init() {
+    _next_seq = 1;
+    _count = 0;
+}
+
+uint32_t telemetry_record(TelemetrySample& sample) {
+    sample.seq = _next_seq++;
+    _ring[sample.seq % TELEMETRY_RING_SIZE] = sample;
+    if (_count < TELEMETRY_RING_SIZE) {
+        _count++;
+    }
+    return sample.seq;
+}
+
+const TelemetrySample* telemetry_find(uint32_t seq) {
+    if (_count == 0 || seq < telemetry_oldest_seq() || seq > telemetry_latest_seq()) {
+        return nullptr;
+    }
+    return &_ring[seq % TELEMETRY_RING_SIZE];
+}
+
+uint32_t telemetry_oldest_seq() {
+    if (_count == 0) return 0;
+    return _next_seq - _count;
+}
+
+uint32_t telemetry_latest_seq() {
+    if (_count == 0) return 0;
+    return _next_seq - 1;
+}
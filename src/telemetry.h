@@ -0,0 +1,29 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+// ============== Telemetry Sample ==============
+// TelemetrySample and the TELEMETRY_FLAG_* bits are defined by the frame
+// schema in lib/protocol, which also encodes them for serial_comm.cpp
+
+#include "telemetry_schema.h"
+
+// ============== Telemetry Ring Interface ==============
+
+// Initialize the retention ring (sequence restarts at 1)
+void telemetry_init();
+
+// Assign the next sequence number to a sample and store it in the ring.
+// Returns the assigned sequence number.
+uint32_t telemetry_record(TelemetrySample& sample);
+
+// Look up a retained sample by sequence number
+// Returns nullptr if the sample was never recorded or has been evicted
+const TelemetrySample* telemetry_find(uint32_t seq);
+
+// Oldest and newest sequence numbers still retained (0 if ring is empty)
+uint32_t telemetry_oldest_seq();
+uint32_t telemetry_latest_seq();
+
+#endif // TELEMETRY_H
@@ -0,0 +1,180 @@
+#include "transport.h"
+#include "config.h"
+#include <string.h>
+
+// ============== Internal State ==============
+
+static TransportFrame _pool[TRANSPORT_FRAME_POOL];
+static TransportSink* _sinks[TRANSPORT_MAX_SINKS];
+static uint8_t _sink_count = 0;
+
+// ============== Frame Pool ==============
+
+static TransportFrame* _frame_acquire() {
+    for (uint8_t i = 0; i < TRANSPORT_FRAME_POOL; i++) {
+        if (_pool[i].refs == 0) {
+            return &_pool[i];
+        }
+    }
+    return nullptr;
+}
+
+void transport_frame_retain(TransportFrame* frame) {
+    frame->refs++;
+}
+
+void transport_frame_release(TransportFrame* frame) {
+    if (frame->refs > 0) {
+        frame->refs--;
+    }
+}
+
+// ============== Frame Queue ==============
+
+TransportFrame* frame_queue_front(FrameQueue& q) {
+    return q.count ? q.frames[q.head] : nullptr;
+}
+
+void frame_queue_pop(FrameQueue& q) {
+    if (q.count == 0) return;
+    transport_frame_release(q.frames[q.head]);
+    q.head = (q.head + 1) % TRANSPORT_SINK_QUEUE;
+    q.count--;
+    q.offset = 0;
+}
+
+void frame_queue_clear(FrameQueue& q) {
+    while (q.count) {
+        frame_queue_pop(q);
+    }
+}
+
+// Make room for one more frame under DROP_OLDEST. Returns false if the
+// queue is full of frames that must not be dropped.
+static bool _frame_queue_shed(TransportSink* sink) {
+    FrameQueue& q = sink->queue;
+
+    // Never shed the head once it is partially written - that would corrupt the stream
+    uint8_t first = (q.offset > 0) ? 1 : 0;
+    for (uint8_t i = first; i < q.count; i++) {
+        uint8_t idx = (q.head + i) % TRANSPORT_SINK_QUEUE;
+        if (!q.frames[idx]->droppable) continue;
+
+        transport_frame_release(q.frames[idx]);
+        for (uint8_t j = i; j + 1 < q.count; j++) {
+            q.frames[(q.head + j) % TRANSPORT_SINK_QUEUE] = q.frames[(q.head + j + 1) % TRANSPORT_SINK_QUEUE];
+        }
+        q.count--;
+        sink->dropped++;
+        return true;
+    }
+    return false;
+}
+
+static void _frame_queue_push(TransportSink* sink, TransportFrame* frame) {
+    FrameQueue& q = sink->queue;
+
+    if (q.count >= TRANSPORT_SINK_QUEUE && !_frame_queue_shed(sink)) {
+        if (frame->droppable) {
+            sink->dropped++;
+            return;
+        }
+        // Peer cannot keep up with frames that must be delivered
+        sink->disconnect();
+        return;
+    }
+
+    transport_frame_retain(frame);
+    q.frames[(q.head + q.count) % TRANSPORT_SINK_QUEUE] = frame;
+    q.count++;
+}
+
+// ============== Transport Implementation ==============
+
+void transport_init() {
+    for (uint8_t i = 0; i < TRANSPORT_FRAME_POOL; i++) {
+        _pool[i].refs = 0;
+        _pool[i].len = 0;
+    }
+    _sink_count = 0;
+}
+
+int transport_register(TransportSink* sink) {
+    if (_sink_count >= TRANSPORT_MAX_SINKS) {
+        return -1;
+    }
+    _sinks[_sink_count] = sink;
+    return _sink_count++;
+}
+
+void transport_update() {
+    for (uint8_t i = 0; i < _sink_count; i++) {
+        if (_sinks[i]->policy() != BackpressurePolicy::BLOCK) {
+            _sinks[i]->poll();
+        }
+    }
+}
+
+// Pool is sized for every queued sink to be full plus one in flight,
+// so this only fails if that invariant is broken
+static TransportFrame* _frame_fill(const char* data, size_t len, bool droppable) {
+    TransportFrame* frame = _frame_acquire();
+    if (!frame || len > sizeof(frame->data)) {
+        return nullptr;
+    }
+
+    memcpy(frame->data, data, len);
+    frame->len = len;
+    frame->droppable = droppable;
+    return frame;
+}
+
+static void _deliver(TransportSink* sink, TransportFrame* frame) {
+    if (sink->policy() == BackpressurePolicy::BLOCK) {
+        sink->write_now(frame);
+    } else {
+        _frame_queue_push(sink, frame);
+    }
+}
+
+void transport_send(const char* data, size_t len, bool droppable) {
+    TransportFrame* frame = _frame_fill(data, len, droppable);
+    if (!frame) {
+        return;
+    }
+
+    // Hold a reference across the fan-out so a queued sink finishing
+    // early cannot return the frame to the pool underneath us
+    transport_frame_retain(frame);
+
+    for (uint8_t i = 0; i < _sink_count; i++) {
+        TransportSink* sink = _sinks[i];
+        if (!sink->connected() || sink->muted) continue;
+        _deliver(sink, frame);
+    }
+
+    transport_frame_release(frame);
+}
+
+void transport_send_to(uint8_t index, const char* data, size_t len) {
+    if (index >= _sink_count || !_sinks[index]->connected()) {
+        return;
+    }
+
+    TransportFrame* frame = _frame_fill(data, len, false);
+    if (!frame) {
+        return;
+    }
+
+    transport_frame_retain(frame);
+    _deliver(_sinks[index], frame);
+    transport_frame_release(frame);
+}
+
+uint8_t transport_sink_count() {
+    return _sink_count;
+}
+
+TransportSink* transport_get_sink(uint8_t index) {
+    return index < _sink_count ? _sinks[index] : nullptr;
+}
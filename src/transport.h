@@ -0,0 +1,106 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+// Transport core is kept free of Arduino dependencies so the fan-out and
+// backpressure logic can be driven by a loopback sink on a host build.
+
+// ============== Shared Frames ==============
+
+// One outbound NDJSON line (without newline), serialized once and
+// referenced by every sink queue that still has to write it
+struct TransportFrame {
+    char data[TRANSPORT_FRAME_SIZE];
+    uint16_t len;
+    uint8_t refs;           // Queued sinks still holding this frame
+    bool droppable;         // Telemetry that may be shed under backpressure
+};
+
+// Take/release a reference to a frame (frame returns to the pool at 0)
+void transport_frame_retain(TransportFrame* frame);
+void transport_frame_release(TransportFrame* frame);
+
+// ============== Sinks ==============
+
+// What a sink does when it cannot keep up
+enum class BackpressurePolicy {
+    BLOCK,          // Write synchronously, stalling the caller (USB CDC)
+    DROP_OLDEST,    // Shed the oldest droppable frame; disconnect if none
+};
+
+// Bounded per-sink FIFO of frame references
+struct FrameQueue {
+    TransportFrame* frames[TRANSPORT_SINK_QUEUE];
+    uint8_t head;
+    uint8_t count;
+    uint16_t offset;        // Bytes of the head frame already written
+};
+
+class TransportSink {
+public:
+    virtual ~TransportSink() {}
+
+    virtual const char* name() const = 0;
+    virtual BackpressurePolicy policy() const = 0;
+
+    // True while a peer is attached and frames should be offered
+    virtual bool connected() = 0;
+
+    // BLOCK sinks: write the whole frame now (newline appended by the sink)
+    virtual void write_now(const TransportFrame* frame) { (void)frame; }
+
+    // Queued sinks: accept/keep-alive and write as much as fits without blocking
+    virtual void poll() {}
+
+    // Next inbound command byte, or -1 if none is available
+    virtual int read() = 0;
+
+    // Drop the peer (queued sinks release their frames here)
+    virtual void disconnect() {}
+
+    FrameQueue queue = {};
+    uint32_t dropped = 0;   // Frames shed by backpressure since boot
+    bool muted = false;     // Skipped by transport_send (peer speaks another line protocol)
+};
+
+// ============== Transport Interface ==============
+
+// Reset the frame pool and sink table
+void transport_init();
+
+// Add a sink (up to TRANSPORT_MAX_SINKS). Returns its index or -1.
+int transport_register(TransportSink* sink);
+
+// Poll every sink (call every loop iteration)
+void transport_update();
+
+// Broadcast one line to every connected sink
+// droppable frames (periodic telemetry) may be shed by slow queued sinks
+void transport_send(const char* data, size_t len, bool droppable);
+
+// Send one line to a single sink only, even if muted (replies in a
+// per-sink protocol). Never dropped by backpressure.
+void transport_send_to(uint8_t index, const char* data, size_t len);
+
+// Sink table access (for per-sink input handling)
+uint8_t transport_sink_count();
+TransportSink* transport_get_sink(uint8_t index);
+
+// ============== Backends ==============
+
+// USB CDC (Serial) sink - always registered
+void transport_usb_init();
+
+// WiFi TCP/WebSocket server - only active when src/secrets.h exists
+void transport_wifi_init();
+void transport_wifi_update();
+
+// Frame queue helpers used by queued sink implementations
+TransportFrame* frame_queue_front(FrameQueue& q);
+void frame_queue_pop(FrameQueue& q);
+void frame_queue_clear(FrameQueue& q);
+
+#endif // TRANSPORT_H
@@ -0,0 +1,37 @@
+#include <Arduino.h>
+#include "transport.h"
+
+#define SERIAL_BAUD_RATE        115200
+
+// ============== USB CDC Sink ==============
+
+// Serial writes block when the host stops reading - this keeps the
+// original println() behaviour for the primary control link
+class UsbSink : public TransportSink {
+public:
+    const char* name() const override { return "usb"; }
+    BackpressurePolicy policy() const override { return BackpressurePolicy::BLOCK; }
+    bool connected() override { return true; }
+
+    void write_now(const TransportFrame* frame) override {
+        Serial.write((const uint8_t*)frame->data, frame->len);
+        Serial.write((const uint8_t*)"\r\n", 2);
+    }
+
+    int read() override {
+        return Serial.available() ? Serial.read() : -1;
+    }
+};
+
+static UsbSink _usb_sink;
+
+void transport_usb_init() {
+    Serial.begin(SERIAL_BAUD_RATE);
+
+    // Clear any pending data
+    while (Serial.available()) {
+        Serial.read();
+    }
+
+    transport_register(&_usb_sink);
+}
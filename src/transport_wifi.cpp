@@ -0,0 +1,429 @@
+#include <Arduino.h>
+#include "transport.h"
+#include "config.h"
+#include "state.h"
+#include "boot.h"
+#include "serial_comm.h"
+
+#if __has_include("secrets.h")
+#define TRANSPORT_WIFI_AVAILABLE 1
+#include <WiFiS3.h>
+#include <WiFiUdp.h>
+#include <ArduinoMDNS.h>
+#include "secrets.h"
+#else
+#define TRANSPORT_WIFI_AVAILABLE 0
+#endif
+
+#if TRANSPORT_WIFI_AVAILABLE
+
+// ============== SHA-1 / Base64 (WebSocket handshake only) ==============
+
+static uint32_t _rol(uint32_t v, uint8_t bits) {
+    return (v << bits) | (v >> (32 - bits));
+}
+
+static void _sha1(const uint8_t* msg, size_t len, uint8_t out[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint8_t block[64];
+    size_t total = ((len + 8) / 64 + 1) * 64;
+
+    for (size_t off = 0; off < total; off += 64) {
+        for (uint8_t i = 0; i < 64; i++) {
+            size_t pos = off + i;
+            if (pos < len)                 block[i] = msg[pos];
+            else if (pos == len)           block[i] = 0x80;
+            else if (pos >= total - 8)     block[i] = (uint8_t)(((uint64_t)len * 8) >> ((total - 1 - pos) * 8));
+            else                           block[i] = 0;
+        }
+
+        uint32_t w[80];
+        for (uint8_t i = 0; i < 16; i++) {
+            w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+                   ((uint32_t)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+        }
+        for (uint8_t i = 16; i < 80; i++) {
+            w[i] = _rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (uint8_t i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            uint32_t t = _rol(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = _rol(b, 30); b = a; a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for (uint8_t i = 0; i < 20; i++) {
+        out[i] = (uint8_t)(h[i / 4] >> (24 - (i % 4) * 8));
+    }
+}
+
+static void _base64(const uint8_t* in, size_t len, char* out) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out[o++] = table[(v >> 18) & 0x3F];
+        out[o++] = table[(v >> 12) & 0x3F];
+        out[o++] = (i + 1 < len) ? table[(v >> 6) & 0x3F] : '=';
+        out[o++] = (i + 2 < len) ? table[v & 0x3F] : '=';
+    }
+    out[o] = '\0';
+}
+
+// ============== Network Client Sink ==============
+
+// One accepted TCP connection. The first byte decides the framing:
+// "GET" starts a WebSocket upgrade, anything else is raw NDJSON over TCP.
+class NetClientSink : public TransportSink {
+public:
+    const char* name() const override { return "tcp"; }
+    BackpressurePolicy policy() const override { return BackpressurePolicy::DROP_OLDEST; }
+
+    bool connected() override {
+        return _active && (_mode == Mode::RAW || _mode == Mode::WEBSOCKET);
+    }
+
+    bool is_free() const { return !_active; }
+    bool owns(WiFiClient& client) { return _active && _client == client; }
+
+    void attach(WiFiClient& client) {
+        _client = client;
+        _active = true;
+        _mode = Mode::DETECT;
+        _line_len = 0;
+        _key[0] = '\0';
+        _rx = RxState::HEADER;
+        _newline_pending = false;
+        _header_sent = false;
+        frame_queue_clear(queue);
+    }
+
+    void disconnect() override {
+        if (!_active) return;
+        frame_queue_clear(queue);
+        _client.stop();
+        _active = false;
+    }
+
+    void poll() override {
+        if (!_active) return;
+        if (!_client.connected()) {
+            disconnect();
+            return;
+        }
+
+        // One frame per poll keeps the loop bounded when the peer is slow
+        TransportFrame* frame = frame_queue_front(queue);
+        if (!frame) return;
+
+        if (!_header_sent && _mode == Mode::WEBSOCKET) {
+            uint8_t header[4];
+            uint8_t header_len = 2;
+            header[0] = 0x81;  // FIN + text frame
+            if (frame->len < 126) {
+                header[1] = frame->len;
+            } else {
+                header[1] = 126;
+                header[2] = frame->len >> 8;
+                header[3] = frame->len & 0xFF;
+                header_len = 4;
+            }
+            _client.write(header, header_len);
+            _header_sent = true;
+        }
+
+        size_t written = _client.write((const uint8_t*)frame->data + queue.offset, frame->len - queue.offset);
+        queue.offset += written;
+        if (queue.offset >= frame->len) {
+            if (_mode == Mode::RAW) {
+                _client.write((uint8_t)'\n');
+            }
+            frame_queue_pop(queue);
+            _header_sent = false;
+        }
+    }
+
+    int read() override {
+        if (!_active) return -1;
+
+        // Text frames end with an implicit line break for the command parser
+        if (_newline_pending) {
+            _newline_pending = false;
+            return '\n';
+        }
+
+        while (_client.available()) {
+            int c = _client.read();
+            if (c < 0) return -1;
+
+            switch (_mode) {
+                case Mode::DETECT:
+                    if (c == 'G') {
+                        _mode = Mode::HTTP;
+                        _line_len = 0;
+                        _http_byte(c);
+                        break;
+                    }
+                    _mode = Mode::RAW;
+                    return c;
+
+                case Mode::RAW:
+                    return c;
+
+                case Mode::HTTP:
+                    _http_byte(c);
+                    break;
+
+                case Mode::WEBSOCKET: {
+                    int out = _ws_byte((uint8_t)c);
+                    if (out >= 0) return out;
+                    break;
+                }
+            }
+
+            if (!_active) return -1;
+        }
+        return -1;
+    }
+
+private:
+    enum class Mode { DETECT, HTTP, RAW, WEBSOCKET };
+    enum class RxState { HEADER, LENGTH, EXT_LENGTH, MASK, PAYLOAD };
+
+    void _http_byte(int c) {
+        if (c == '\r') return;
+        if (c != '\n') {
+            if (_line_len < sizeof(_line) - 1) _line[_line_len++] = c;
+            return;
+        }
+
+        _line[_line_len] = '\0';
+        if (_line_len == 0) {
+            _finish_handshake();
+            return;
+        }
+        if (strncasecmp(_line, "Sec-WebSocket-Key:", 18) == 0) {
+            const char* value = _line + 18;
+            while (*value == ' ') value++;
+            strncpy(_key, value, sizeof(_key) - 1);
+            _key[sizeof(_key) - 1] = '\0';
+        }
+        _line_len = 0;
+    }
+
+    void _finish_handshake() {
+        if (_key[0] == '\0') {
+            const char* reject = "HTTP/1.1 400 Bad Request\r\n\r\n";
+            _client.write((const uint8_t*)reject, strlen(reject));
+            disconnect();
+            return;
+        }
+
+        char combined[64];
+        snprintf(combined, sizeof(combined), "%s258EAFA5-E914-47DA-95CA-C5AB0DC85B11", _key);
+        uint8_t digest[20];
+        _sha1((const uint8_t*)combined, strlen(combined), digest);
+        char accept[32];
+        _base64(digest, sizeof(digest), accept);
+
+        char response[160];
+        snprintf(response, sizeof(response),
+                 "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                 "Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n", accept);
+        _client.write((const uint8_t*)response, strlen(response));
+        _mode = Mode::WEBSOCKET;
+        _rx = RxState::HEADER;
+    }
+
+    // Decode one byte of a client frame; returns a payload byte or -1
+    int _ws_byte(uint8_t c) {
+        switch (_rx) {
+            case RxState::HEADER:
+                _opcode = c & 0x0F;
+                _fin = c & 0x80;
+                _rx = RxState::LENGTH;
+                return -1;
+
+            case RxState::LENGTH:
+                _remaining = c & 0x7F;
+                _ext_left = (_remaining == 126) ? 2 : (_remaining == 127) ? 8 : 0;
+                if (_ext_left) _remaining = 0;
+                _rx = _ext_left ? RxState::EXT_LENGTH : RxState::MASK;
+                _mask_idx = 0;
+                return -1;
+
+            case RxState::EXT_LENGTH:
+                _remaining = (_remaining << 8) | c;
+                if (--_ext_left == 0) _rx = RxState::MASK;
+                return -1;
+
+            case RxState::MASK:
+                _mask[_mask_idx++] = c;
+                if (_mask_idx == 4) {
+                    _mask_idx = 0;
+                    _control_len = 0;
+                    _rx = RxState::PAYLOAD;
+                    if (_remaining == 0) _end_frame();
+                }
+                return -1;
+
+            case RxState::PAYLOAD: {
+                uint8_t b = c ^ _mask[_mask_idx++ & 3];
+                _remaining--;
+                int out = -1;
+                if (_opcode == 0x1 || _opcode == 0x0) {
+                    out = b;
+                } else if (_control_len < sizeof(_control)) {
+                    _control[_control_len++] = b;
+                }
+                if (_remaining == 0) _end_frame();
+                return out;
+            }
+        }
+        return -1;
+    }
+
+    void _end_frame() {
+        _rx = RxState::HEADER;
+        if ((_opcode == 0x1 || _opcode == 0x0) && _fin) {
+            _newline_pending = true;
+        } else if (_opcode == 0x9) {
+            // Ping - echo payload back as pong
+            uint8_t header[2] = { 0x8A, _control_len };
+            _client.write(header, 2);
+            _client.write(_control, _control_len);
+        } else if (_opcode == 0x8) {
+            uint8_t close[2] = { 0x88, 0x00 };
+            _client.write(close, 2);
+            disconnect();
+        }
+    }
+
+    WiFiClient _client;
+    bool _active = false;
+    Mode _mode = Mode::DETECT;
+
+    char _line[128];
+    uint8_t _line_len = 0;
+    char _key[32];
+
+    RxState _rx = RxState::HEADER;
+    uint8_t _opcode = 0;
+    bool _fin = false;
+    uint64_t _remaining = 0;
+    uint8_t _ext_left = 0;
+    uint8_t _mask[4];
+    uint8_t _mask_idx = 0;
+    uint8_t _control[125];
+    uint8_t _control_len = 0;
+    bool _newline_pending = false;
+    bool _header_sent = false;
+};
+
+// ============== Internal State ==============
+
+static NetClientSink _clients[WIFI_MAX_CLIENTS];
+static WiFiServer _server(WIFI_SERVER_PORT);
+static WiFiUDP _mdns_udp;
+static MDNS _mdns(_mdns_udp);
+static bool _server_started = false;
+static unsigned long _last_attempt = 0;
+static bool _attempted = false;
+static bool _joining = false;
+static bool _connected = false;
+static unsigned long _last_status = 0;
+
+// Each status query is a round trip to the WiFi modem - poll, don't spin
+static void _poll_status() {
+    if (millis() - _last_status < WIFI_STATUS_POLL_MS) return;
+    _last_status = millis();
+
+    _connected = WiFi.status() == WL_CONNECTED;
+    if (!_connected) _server_started = false;
+    if (!_joining) return;
+
+    if (_connected) {
+        _joining = false;
+    } else if (millis() - _last_attempt >= WIFI_JOIN_TIMEOUT_MS) {
+        _joining = false;
+        serial_send_log("warn", "WIFI", "WiFi connect failed - will retry");
+    }
+}
+
+// ============== WiFi Transport Interface ==============
+
+void transport_wifi_init() {
+    // begin() returns once the modem has the request; the join is polled
+    WiFi.setTimeout(0);
+    for (uint8_t i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        transport_register(&_clients[i]);
+    }
+}
+
+void transport_wifi_update() {
+    _poll_status();
+    if (!_connected) {
+        if (_joining) return;
+
+        // Not before boot has restored any interrupted roast, and only while
+        // nothing is heating - the modem exchange still costs the loop a few ms
+        if (!boot_is_complete() || state_is_resume_pending()) return;
+        if (state_get_current() != RoasterState::OFF) return;
+        if (_attempted && millis() - _last_attempt < WIFI_RETRY_INTERVAL_MS) return;
+
+        _attempted = true;
+        _joining = true;
+        _last_attempt = millis();
+        _last_status = _last_attempt;
+        WiFi.begin(ssid, password);
+        return;
+    }
+
+    if (!_server_started) {
+        _server.begin();
+        _mdns.begin(WiFi.localIP(), WIFI_HOSTNAME);
+        _mdns.addServiceRecord(WIFI_HOSTNAME "._ws", WIFI_SERVER_PORT, MDNSServiceTCP);
+        _server_started = true;
+
+        IPAddress ip = WiFi.localIP();
+        char msg[64];
+        snprintf(msg, sizeof(msg), "Listening on %d.%d.%d.%d:%d (%s.local)",
+                 ip[0], ip[1], ip[2], ip[3], WIFI_SERVER_PORT, WIFI_HOSTNAME);
+        serial_send_log("info", "WIFI", msg);
+    }
+
+    _mdns.run();
+
+    // available() keeps returning a client while it has unread data
+    WiFiClient incoming = _server.available();
+    if (!incoming) return;
+
+    for (uint8_t i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        if (_clients[i].owns(incoming)) return;
+    }
+    for (uint8_t i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        if (_clients[i].is_free()) {
+            _clients[i].attach(incoming);
+            serial_send_log("info", "WIFI", "Network client connected");
+            return;
+        }
+    }
+    incoming.stop();  // All slots busy
+}
+
+#else
+
+// No credentials - USB is the only transport
+void transport_wifi_init() {}
+void transport_wifi_update() {}
+
+#endif // TRANSPORT_WIFI_AVAILABLE